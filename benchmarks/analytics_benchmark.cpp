@@ -0,0 +1,209 @@
+// Compares the columnar analytics store with row objects for the daily
+// reports over scores and sessions. Run from the project root:
+//
+//   g++ benchmarks/analytics_benchmark.cpp src/analytics/AnalyticsStore.cpp src/analytics/Kernels.cpp -o analytics_benchmark.exe -Isrc -std=c++20 -O2 -march=native
+//   ./analytics_benchmark.exe [rows] [load_rows]
+//
+// Reports run over rows scores (default 20 million) in 100,000 sessions of
+// four game types. Loading is compared on those sessions and a scores.csv of
+// load_rows lines (default 2 million) written to the temporary directory.
+
+#include "CSVParser.h"
+#include "GameSession.h"
+#include "Score.h"
+#include "analytics/AnalyticsStore.h"
+#include "analytics/Kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+
+namespace {
+
+const int SESSIONS = 100000;
+const int PLAYERS = 50000;
+const char* const GAME_TYPES[] = {"Chess", "Checkers", "Go", "Backgammon"};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::uint64_t nextRandom(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+struct Row {
+    int player_id;
+    int session_id;
+    int score;
+};
+
+Row randomRow(std::uint64_t& state) {
+    std::uint64_t bits = nextRandom(state);
+    return {static_cast<int>(bits % PLAYERS) + 1, static_cast<int>((bits >> 20) % SESSIONS) + 1,
+            static_cast<int>((bits >> 40) % 1000)};
+}
+
+std::string sessionTime(int session, int minutes) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "2024-%02d-%02d %02d:%02d:00", session % 12 + 1, session % 28 + 1,
+                  session % 24, minutes);
+    return text;
+}
+
+// The totals the reports come to, for checking that both ways agree
+struct Totals {
+    std::int64_t sum = 0;
+    std::int64_t by_type[4] = {};
+    std::int64_t player_sum = 0;
+    std::int64_t minutes = 0;
+    std::int32_t median = 0;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t rows = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+    std::size_t load_rows = (argc > 2) ? std::strtoull(argv[2], nullptr, 10) : 2000000;
+    if (rows == 0 || load_rows == 0) {
+        std::cerr << "Usage: " << argv[0] << " [rows] [load_rows]" << std::endl;
+        return 1;
+    }
+
+    // The same data both ways: row objects as the game holds them, and columns
+    std::vector<std::unique_ptr<GameSession>> sessions;
+    std::vector<Score> score_rows;
+    AnalyticsStore store;
+    for (int session = 1; session <= SESSIONS; ++session) {
+        const char* type = GAME_TYPES[session % 4];
+        std::string start = sessionTime(session, 0);
+        std::string end = sessionTime(session, session % 60);
+        sessions.push_back(std::make_unique<GameSession>(session, type, start, end));
+        store.addSession(session, type, start, end);
+    }
+    score_rows.reserve(rows);
+    store.reserveScores(rows);
+    std::uint64_t state = 7;
+    for (std::size_t i = 0; i < rows; ++i) {
+        Row row = randomRow(state);
+        score_rows.emplace_back(static_cast<int>(i), row.player_id, row.session_id, row.score);
+        store.addScore(static_cast<std::int32_t>(i), row.player_id, row.session_id, row.score);
+    }
+
+    // Row by row: look each score's session up by ID and its type by name
+    auto start = std::chrono::steady_clock::now();
+    Totals rows_totals;
+    {
+        std::unordered_map<int, const GameSession*> session_by_id;
+        for (const auto& session : sessions) {
+            session_by_id[session->getSessionID()] = session.get();
+        }
+        std::unordered_map<std::string, std::int64_t> by_type;
+        std::unordered_map<int, std::int64_t> by_player;
+        std::vector<int> values;
+        for (const Score& score : score_rows) {
+            rows_totals.sum += score.getScoreValue();
+            by_type[session_by_id[score.getSessionID()]->getGameType()] += score.getScoreValue();
+            by_player[score.getPlayerID()] += score.getScoreValue();
+            values.push_back(score.getScoreValue());
+        }
+        for (int type = 0; type < 4; ++type) {
+            rows_totals.by_type[type] = by_type[GAME_TYPES[type]];
+        }
+        for (const auto& [player, sum] : by_player) {
+            rows_totals.player_sum += sum;
+        }
+        std::nth_element(values.begin(), values.begin() + (values.size() - 1) / 2, values.end());
+        rows_totals.median = values[(values.size() - 1) / 2];
+        for (const auto& session : sessions) {
+            // Minutes past the hour, the only part that differs
+            rows_totals.minutes += std::stoi(session->getEndTime().substr(14, 2)) -
+                                   std::stoi(session->getStartTime().substr(14, 2));
+        }
+    }
+    double rows_seconds = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    Totals column_totals;
+    {
+        column_totals.sum = store.totalScore().sum;
+        std::vector<AnalyticsStore::GroupStats> by_type = store.scoreByGameType();
+        for (int type = 0; type < 4; ++type) {
+            // Sessions were added in order, so type codes follow session 1's type
+            column_totals.by_type[(type + 1) % 4] = by_type[type].sum;
+        }
+        for (const auto& [player, stats] : store.scoreByPlayer()) {
+            column_totals.player_sum += stats.sum;
+        }
+        store.scorePercentile(50, column_totals.median);
+        for (std::int64_t seconds : store.sessionDurations()) {
+            column_totals.minutes += seconds / 60;
+        }
+    }
+    double column_seconds = secondsSince(start);
+
+    bool same = rows_totals.sum == column_totals.sum && rows_totals.player_sum == column_totals.player_sum &&
+                rows_totals.median == column_totals.median && rows_totals.minutes == column_totals.minutes &&
+                std::equal(rows_totals.by_type, rows_totals.by_type + 4, column_totals.by_type);
+    // Column passes: the total, session and score for game types, player and
+    // score for players, and two over the scores for the median
+    double gigabytes = static_cast<double>(rows) * 8 * sizeof(std::int32_t) / 1e9;
+
+    // Loading: the game's CSV reader and std::stoi, against the store's reader
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "quanta_analytics_benchmark";
+    std::filesystem::create_directories(directory);
+    {
+        std::ofstream session_file(directory / "game_sessions.csv");
+        session_file << "session_id,game_type,start_time,end_time\n";
+        for (const auto& session : sessions) {
+            session_file << session->getSessionID() << ',' << session->getGameType() << ','
+                         << session->getStartTime() << ',' << session->getEndTime() << '\n';
+        }
+        std::ofstream score_file(directory / "scores.csv");
+        score_file << "score_id,player_id,session_id,score\n";
+        state = 7;
+        for (std::size_t i = 0; i < load_rows; ++i) {
+            Row row = randomRow(state);
+            score_file << i << ',' << row.player_id << ',' << row.session_id << ',' << row.score << '\n';
+        }
+    }
+    start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<GameSession>> loaded_sessions;
+    for (const auto& line : CSVParser::readCSV((directory / "game_sessions.csv").string())) {
+        if (line.size() == 4 && line[0] != "session_id") {
+            loaded_sessions.push_back(std::make_unique<GameSession>(std::stoi(line[0]), line[1], line[2], line[3]));
+        }
+    }
+    std::vector<Score> loaded_rows;
+    for (const auto& line : CSVParser::readCSV((directory / "scores.csv").string())) {
+        if (line.size() == 4 && line[0] != "score_id") {
+            loaded_rows.emplace_back(std::stoi(line[0]), std::stoi(line[1]), std::stoi(line[2]), std::stoi(line[3]));
+        }
+    }
+    double csv_load_seconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    AnalyticsStore loaded_store;
+    bool loaded = loaded_store.loadCSV(directory.string());
+    double store_load_seconds = secondsSince(start);
+    std::filesystem::remove_all(directory);
+    same = same && loaded && loaded_store.getScoreCount() == loaded_rows.size();
+
+    std::cout << "Reports over " << rows << " scores (" << AnalyticsKernels::getInstructionSet() << "):" << std::endl;
+    std::cout << "  row objects:     " << rows_seconds << " s" << std::endl;
+    std::cout << "  columns:         " << column_seconds << " s (" << gigabytes / column_seconds << " GB/s)"
+              << std::endl;
+    std::cout << "  speedup:         " << rows_seconds / column_seconds << "x" << std::endl;
+    std::cout << "Loading " << load_rows << " scores and " << SESSIONS << " sessions from CSV:" << std::endl;
+    std::cout << "  readCSV + stoi:  " << csv_load_seconds << " s" << std::endl;
+    std::cout << "  AnalyticsStore:  " << store_load_seconds << " s" << std::endl;
+    std::cout << "  speedup:         " << csv_load_seconds / store_load_seconds << "x" << std::endl;
+    std::cout << "Results " << (same ? "match" : "DIFFER") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+// Times line of sight for many players walking a large map. Run from the project root:
+//
+//   g++ benchmarks/fov_benchmark.cpp src/Terrain.cpp src/vision/FieldOfView.cpp -o fov_benchmark.exe -Isrc -std=c++20 -O2 -march=native
+//   ./fov_benchmark.exe [side] [players] [steps] [rubble]
+//
+// The map is side x side tiles (default 2048) of 12 x 12 rooms joined by
+// doorways, with pillars scattered through them; with rubble=1 a random
+// eighth of the tiles are walls instead, which breaks sight into many more
+// pieces. Each of players (default 1000) players takes steps (default 50)
+// random steps, recomputing sight after each, with FieldOfView and with the
+// same shadowcasting done a tile at a time.
+
+#include "Terrain.h"
+#include "vision/FieldOfView.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+const int RADIUS = 16;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::uint64_t nextRandom(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Symmetric shadowcasting a tile at a time, reading the terrain's tiles and
+// marking a byte per tile seen, as a straightforward version would
+class TileByTile {
+public:
+    TileByTile(const Terrain& terrain) : terrain(terrain), seen((2 * RADIUS + 1) * (2 * RADIUS + 1)) {}
+
+    std::size_t update(int x, int y) {
+        std::fill(seen.begin(), seen.end(), 0);
+        origin_x = x;
+        origin_y = y;
+        mark(0, 0);
+        for (quadrant = 0; quadrant < 4; ++quadrant) {
+            scan(1, -1, 1, 1, 1);
+        }
+        std::size_t count = 0;
+        for (char tile : seen) {
+            count += tile;
+        }
+        return count;
+    }
+
+private:
+    void at(int depth, int column, int& x, int& y) const {
+        switch (quadrant) {
+            case 0: x = column; y = -depth; break;
+            case 1: x = depth; y = column; break;
+            case 2: x = column; y = depth; break;
+            default: x = -depth; y = column; break;
+        }
+    }
+
+    void mark(int dx, int dy) {
+        if (dx * dx + dy * dy <= RADIUS * (RADIUS + 1)) {
+            seen[(dy + RADIUS) * (2 * RADIUS + 1) + dx + RADIUS] = 1;
+        }
+    }
+
+    static int floorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+    void scan(int depth, int start_rise, int start_run, int end_rise, int end_run) {
+        if (depth > RADIUS) {
+            return;
+        }
+        int first = floorDiv(2 * depth * start_rise + start_run, 2 * start_run);
+        int last = -floorDiv(-(2 * depth * end_rise - end_run), 2 * end_run);
+        int previous = -1; // Nothing yet, floor or wall
+        for (int column = first; column <= last; ++column) {
+            int dx, dy;
+            at(depth, column, dx, dy);
+            bool wall = terrain.getTile(origin_x + dx, origin_y + dy) != Terrain::FLOOR_TILE;
+            bool clear = column * start_run >= depth * start_rise && column * end_run <= depth * end_rise;
+            if (wall || clear) {
+                mark(dx, dy);
+            }
+            if (previous == 1 && !wall) {
+                start_rise = 2 * column - 1;
+                start_run = 2 * depth;
+            }
+            if (previous == 0 && wall) {
+                scan(depth + 1, start_rise, start_run, 2 * column - 1, 2 * depth);
+            }
+            previous = wall ? 1 : 0;
+        }
+        if (previous == 0) {
+            scan(depth + 1, start_rise, start_run, end_rise, end_run);
+        }
+    }
+
+    const Terrain& terrain;
+    std::vector<char> seen;
+    int origin_x = 0;
+    int origin_y = 0;
+    int quadrant = 0;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int side = argc > 1 ? std::atoi(argv[1]) : 2048;
+    int players = argc > 2 ? std::atoi(argv[2]) : 1000;
+    int steps = argc > 3 ? std::atoi(argv[3]) : 50;
+    bool rubble = argc > 4 && std::atoi(argv[4]) != 0;
+    if (side < 64 || players < 1 || steps < 1) {
+        std::cerr << "Usage: " << argv[0] << " [side >= 64] [players >= 1] [steps >= 1] [rubble]" << std::endl;
+        return 1;
+    }
+
+    std::uint64_t state = 1;
+    Terrain terrain;
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            bool wall = rubble ? nextRandom(state) % 8 == 0
+                               : ((x % 12 == 0 && y % 12 != 6) || (y % 12 == 0 && x % 12 != 6) || nextRandom(state) % 64 == 0);
+            terrain.setTile(x, y, wall ? Terrain::WALL_TILE : Terrain::FLOOR_TILE);
+        }
+    }
+
+    // Every player walks the same path under both versions
+    std::vector<int> path_x(static_cast<std::size_t>(players) * steps), path_y(path_x.size());
+    for (int player = 0; player < players; ++player) {
+        int x = static_cast<int>(nextRandom(state) % side), y = static_cast<int>(nextRandom(state) % side);
+        for (int step = 0; step < steps; ++step) {
+            x = std::clamp(x + static_cast<int>(nextRandom(state) % 3) - 1, 0, side - 1);
+            y = std::clamp(y + static_cast<int>(nextRandom(state) % 3) - 1, 0, side - 1);
+            path_x[player * steps + step] = x;
+            path_y[player * steps + step] = y;
+        }
+    }
+
+    // The first sight of each player allocates their explored map, so it is timed apart
+    std::vector<FieldOfView> sights(players, FieldOfView(RADIUS));
+    auto start = std::chrono::steady_clock::now();
+    for (int player = 0; player < players; ++player) {
+        sights[player].update(terrain, path_x[player * steps], path_y[player * steps]);
+    }
+    double first_sight = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    std::size_t recomputed = 0;
+    for (int step = 1; step < steps; ++step) {
+        for (int player = 0; player < players; ++player) {
+            recomputed += sights[player].update(terrain, path_x[player * steps + step], path_y[player * steps + step]);
+        }
+    }
+    double bitboard = secondsSince(start);
+    std::size_t explored_bytes = 0;
+    for (const FieldOfView& sight : sights) {
+        explored_bytes += sight.getExplored().getBytes();
+    }
+
+    TileByTile reference(terrain);
+    std::size_t seen = 0;
+    start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step) {
+        for (int player = 0; player < players; ++player) {
+            seen += reference.update(path_x[player * steps + step], path_y[player * steps + step]);
+        }
+    }
+    double tiles = secondsSince(start);
+    std::size_t total = static_cast<std::size_t>(players) * steps;
+
+    std::cout << (rubble ? "Rubble map " : "Map of rooms ") << side << " x " << side << ", " << players << " players, " << steps << " steps, radius "
+              << RADIUS << " (" << FieldOfView::getInstructionSet() << ")" << std::endl;
+    std::cout << "  FieldOfView:  " << bitboard / recomputed * 1e6 << " us per recomputation (" << recomputed << " of "
+              << total - players << " steps moved the player), " << first_sight / players * 1e6
+              << " us for a player's first" << std::endl;
+    std::cout << "  tile by tile: " << tiles / total * 1e6 << " us per step" << std::endl;
+    std::cout << "  explored maps: " << explored_bytes / players << " bytes per player, "
+              << static_cast<double>(explored_bytes) * 8 / players / (static_cast<double>(side) * side)
+              << " bits per tile (" << seen << " tiles seen)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Measures what a log call costs the thread making it: filtered out by the
+// level, written through the background log, and formatted and written to a
+// file on the spot. Run from the project root:
+//
+//   g++ benchmarks/log_benchmark.cpp src/log/*.cpp -o log_benchmark.exe -Isrc -std=c++20 -O2 -pthread
+//   ./log_benchmark.exe [records] [threads]
+//
+// Each of threads (default 1) logs records (default 100,000) records of a
+// number and a room description, as loading a world does with --verbose.
+
+#include "log/Log.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const std::string DESCRIPTION = "You are in the Library of Core Beliefs. Ancient, sturdy shelves hold the foundational books.";
+
+const int CHUNK = 256;
+
+// Runs log(i) records times on each thread, in chunks with an optional pause
+// between them, and returns the nanoseconds per call with the pauses left out
+template <typename Call>
+double timeCalls(int records, int threads, std::chrono::microseconds pause, Call log) {
+    std::vector<double> seconds(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            for (int first = 0; first < records; first += CHUNK) {
+                auto start = std::chrono::steady_clock::now();
+                for (int i = first; i < std::min(records, first + CHUNK); ++i) {
+                    log(i);
+                }
+                seconds[t] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                if (pause.count() > 0) {
+                    std::this_thread::sleep_for(pause);
+                }
+            }
+        });
+    }
+    double total = 0;
+    for (int t = 0; t < threads; ++t) {
+        workers[t].join();
+        total += seconds[t];
+    }
+    return total / threads / records * 1e9;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int records = (argc > 1) ? std::atoi(argv[1]) : 100000;
+    int threads = (argc > 2) ? std::atoi(argv[2]) : 1;
+    if (records <= 0 || threads <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [records] [threads]" << std::endl;
+        return 1;
+    }
+    std::string path = (std::filesystem::temp_directory_path() / "log_benchmark.log").string();
+    std::filesystem::remove(path);
+
+    Log::open(path, LogLevel::Info);
+    auto room_loaded = [](int i) { Log::info("Room loaded", {{"id", i}, {"description", DESCRIPTION}}); };
+    double filtered = timeCalls(records, threads, std::chrono::microseconds(0), [](int i) {
+        Log::debug("Room loaded", {{"id", i}, {"description", DESCRIPTION}});
+    });
+    // Paused now and then, as a loader does other work between records, so the log's thread keeps up
+    double logged = timeCalls(records, threads, std::chrono::microseconds(200), room_loaded);
+    std::uint64_t dropped_paced = Log::getDroppedCount();
+    double burst = timeCalls(records, threads, std::chrono::microseconds(0), room_loaded);
+    Log::close();
+    std::uint64_t dropped_burst = Log::getDroppedCount() - dropped_paced;
+
+    std::ofstream direct(path, std::ios::app);
+    double synchronous = timeCalls(records, 1, std::chrono::microseconds(0), [&direct](int i) {
+        direct << "INFO  Room loaded id=" << i << " description=\"" << DESCRIPTION << "\"" << std::endl;
+    });
+    direct.close();
+    std::filesystem::remove(path);
+
+    std::cout << records << " records on each of " << threads << " threads" << std::endl;
+    std::cout << "  below the level:           " << filtered << " ns a call" << std::endl;
+    std::cout << "  logged:                    " << logged << " ns a call, " << dropped_paced << " records dropped" << std::endl;
+    std::cout << "  logged in one burst:       " << burst << " ns a call, " << dropped_burst << " records dropped" << std::endl;
+    std::cout << "  formatted and written now: " << synchronous << " ns a call, on one thread" << std::endl;
+    return 0;
+}
@@ -0,0 +1,63 @@
+// Measures what updating a metric costs the thread doing it, with threads
+// counting on per-thread shards and, for comparison, on one shared atomic.
+// Run from the project root:
+//
+//   g++ benchmarks/metrics_benchmark.cpp src/metrics/*.cpp -o metrics_benchmark.exe -Isrc -std=c++20 -O2 -pthread
+//   ./metrics_benchmark.exe [updates] [max_threads]
+//
+// Each thread makes updates (default 10,000,000) updates, for 1, 2, 4 ...
+// up to max_threads threads (default the number of cores).
+
+#include "metrics/Metrics.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Runs update(i) updates times on each of threads threads and returns the nanoseconds per update
+template <typename Update>
+double timeUpdates(int updates, int threads, Update update) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (int i = 0; i < updates; ++i) {
+                update(i);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    // Threads run side by side, so the wall time is the time one thread took for its updates
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / updates * 1e9;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int updates = (argc > 1) ? std::atoi(argv[1]) : 10000000;
+    int max_threads = (argc > 2) ? std::atoi(argv[2]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (updates <= 0 || max_threads <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [updates] [max_threads]" << std::endl;
+        return 1;
+    }
+
+    Counter counter("benchmark_updates_total", "Updates made");
+    Histogram histogram("benchmark_values", "Values recorded");
+    std::atomic<std::uint64_t> shared{0};
+    std::cout << updates << " updates on each thread, ns an update" << std::endl;
+    std::cout << "threads  sharded counter  shared atomic  histogram" << std::endl;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double sharded = timeUpdates(updates, threads, [&](int) { counter.add(); });
+        double contended = timeUpdates(updates, threads, [&](int) { shared.fetch_add(1, std::memory_order_relaxed); });
+        double recorded = timeUpdates(updates, threads, [&](int i) { histogram.record(static_cast<std::uint64_t>(i & 0xFFFF)); });
+        std::cout << "  " << threads << "\t   " << sharded << "\t\t    " << contended << "\t   " << recorded << std::endl;
+    }
+    std::cout << "Counted " << counter.get() << ", " << histogram.getCount() << " values recorded" << std::endl;
+    return 0;
+}
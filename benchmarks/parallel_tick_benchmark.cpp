@@ -0,0 +1,129 @@
+// Measures how a session's character turns scale with threads on a large
+// generated world, and how sessions sharing the world's threads fare when they
+// take their turns at once. Every run must leave the characters in the same
+// rooms. Run from the project root:
+//
+//   g++ benchmarks/parallel_tick_benchmark.cpp src/worldgen/WorldGenerator.cpp src/Room.cpp src/objects/*.cpp src/players/*.cpp src/world/WorldOverlay.cpp src/text/*.cpp src/npc/*.cpp src/concurrency/*.cpp -o parallel_tick_benchmark.exe -Isrc -std=c++20 -O2 -pthread
+//   ./parallel_tick_benchmark.exe [side] [turns] [max_threads]
+//
+// The world is side x side rooms (default 1000, a million rooms) with a
+// character in one room in five. The characters are set up as SharedWorld
+// sets them up, and ticked through NpcSession, as the game ticks them.
+
+#include "concurrency/WorkStealingScheduler.h"
+#include "npc/NpcSession.h"
+#include "npc/NpcSystem.h"
+#include "objects/Character.h"
+#include "worldgen/WorldGenerator.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const std::size_t REGION_ROOMS = 4096; // As SharedWorld::NPC_REGION_ROOMS
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// FNV-1a over every character's room
+std::uint64_t positionHash(const NpcSession& session) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (std::size_t npc = 0; npc < session.size(); ++npc) {
+        hash ^= static_cast<std::uint64_t>(session.getRoom(npc)->getId());
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Plays a fresh session's turns, returning the moves made
+std::size_t play(NpcSession& session, std::uint64_t seed, const Room* player_room, int turns) {
+    session.reseed(seed);
+    std::size_t moves = 0;
+    for (int turn = 0; turn < turns; ++turn) {
+        moves += session.tick(player_room).size();
+    }
+    return moves;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    WorldGenOptions options;
+    options.width = options.height = (argc > 1) ? std::atoi(argv[1]) : 1000;
+    options.character_chance = 0.2;
+    int turns = (argc > 2) ? std::atoi(argv[2]) : 100;
+    int max_threads = (argc > 3) ? std::atoi(argv[3]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (options.width <= 0 || turns <= 0 || max_threads <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [side] [turns] [max_threads]" << std::endl;
+        return 1;
+    }
+
+    // Sessions never change the world, so one serves every run
+    World world = WorldGenerator::generate(options);
+    NpcSystem npcs;
+    for (const auto& room : world.rooms) {
+        for (Character* character : room->getCharacters()) {
+            npcs.add(character, room.get());
+        }
+    }
+    npcs.setRoomsShared(true);
+    auto start = std::chrono::steady_clock::now();
+    std::size_t regions = npcs.partition(world.rooms, REGION_ROOMS);
+    double partition_s = secondsSince(start);
+    const Room* player_room = world.rooms[world.rooms.size() / 2].get();
+    std::cout << "World of " << world.rooms.size() << " rooms, " << npcs.size() << " characters (" << npcs.getMoverCount()
+              << " movers) in " << regions << " regions, partitioned in " << partition_s << " s" << std::endl;
+
+    std::cout << "One session:" << std::endl;
+    double serial_s = 0;
+    std::uint64_t serial_hash = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        WorkStealingScheduler scheduler(static_cast<std::size_t>(threads));
+        NpcSession session(npcs, &scheduler);
+        start = std::chrono::steady_clock::now();
+        std::size_t moves = play(session, options.seed, player_room, turns);
+        double tick_s = secondsSince(start);
+        std::uint64_t hash = positionHash(session);
+        if (threads == 1) {
+            serial_s = tick_s;
+            serial_hash = hash;
+        }
+        std::cout << "  " << threads << " thread" << (threads == 1 ? ": " : "s:") << "  " << tick_s * 1e3 / turns
+                  << " ms/turn, " << moves / turns << " moves/turn, speedup " << serial_s / tick_s << "x, "
+                  << scheduler.getStealCount() << " steals, " << (hash == serial_hash ? "same world" : "DIFFERENT WORLD")
+                  << std::endl;
+    }
+
+    // As in a server: each session takes its turns on its own thread, and
+    // the one that finds the world's threads busy decides its moves alone
+    std::cout << "Sessions at once, sharing " << max_threads << " thread" << (max_threads == 1 ? "" : "s") << ":" << std::endl;
+    WorkStealingScheduler scheduler(static_cast<std::size_t>(max_threads));
+    for (int session_count = 2; session_count <= 2 * max_threads; session_count *= 2) {
+        std::vector<std::unique_ptr<NpcSession>> sessions;
+        for (int i = 0; i < session_count; ++i) {
+            sessions.push_back(std::make_unique<NpcSession>(npcs, &scheduler));
+        }
+        std::vector<std::thread> players;
+        start = std::chrono::steady_clock::now();
+        for (auto& session : sessions) {
+            players.emplace_back([&session, &options, player_room, turns] { play(*session, options.seed, player_room, turns); });
+        }
+        for (std::thread& player : players) {
+            player.join();
+        }
+        double tick_s = secondsSince(start);
+        bool same = true;
+        for (const auto& session : sessions) {
+            same = same && positionHash(*session) == serial_hash;
+        }
+        std::cout << "  " << session_count << " sessions: " << tick_s * 1e3 / (static_cast<double>(turns) * session_count)
+                  << " ms/turn, " << serial_s * session_count / tick_s << "x one session on one thread, "
+                  << (same ? "same world" : "DIFFERENT WORLD") << std::endl;
+    }
+    return 0;
+}
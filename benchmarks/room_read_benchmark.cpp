@@ -0,0 +1,132 @@
+// Measures how reads of the room graph scale with threads while a writer keeps
+// changing exits, with the exits published read-copy-update and with one
+// reader-writer lock around the world. Run from the project root:
+//
+//   g++ benchmarks/room_read_benchmark.cpp src/worldgen/WorldGenerator.cpp src/Room.cpp src/objects/*.cpp src/players/*.cpp src/world/WorldOverlay.cpp src/text/*.cpp src/npc/*.cpp src/concurrency/*.cpp -o room_read_benchmark.exe -Isrc -std=c++20 -O2 -pthread
+//   ./room_read_benchmark.exe [side] [max_threads] [writes_per_second]
+//
+// The world is side x side generated rooms (default 300). Each reader walks
+// the world as a session does, a turn of 64 exit lookups at a time, while one
+// writer adds and removes exits at random (default 10,000 times a second).
+
+#include "concurrency/Epoch.h"
+#include "worldgen/WorldGenerator.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+
+namespace {
+
+const int LOOKUPS_PER_TURN = 64;
+const std::chrono::milliseconds RUN_TIME{500};
+const char* const DIRECTIONS[] = {"north", "south", "east", "west"};
+
+// Walks from room to room, taking a random exit each lookup and jumping to a
+// random room at a dead end. Returns the number of lookups made.
+template <typename Turn>
+std::uint64_t walk(const World& world, std::uint64_t seed, const std::atomic<bool>& stop, Turn turn) {
+    std::mt19937_64 rng(seed);
+    Room* room = world.rooms[rng() % world.rooms.size()].get();
+    std::uint64_t lookups = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        turn([&] {
+            for (int i = 0; i < LOOKUPS_PER_TURN; ++i) {
+                Room* next = room->getExit(DIRECTIONS[rng() % 4]);
+                room = next ? next : world.rooms[rng() % world.rooms.size()].get();
+            }
+        });
+        lookups += LOOKUPS_PER_TURN;
+    }
+    return lookups;
+}
+
+// Adds or removes a random exit at the given rate until stopped
+template <typename Write>
+void writeExits(const World& world, int writes_per_second, const std::atomic<bool>& stop, Write write) {
+    using Clock = std::chrono::steady_clock;
+    std::mt19937_64 rng(1);
+    auto interval = std::chrono::nanoseconds(1000000000 / writes_per_second);
+    Clock::time_point next = Clock::now();
+    while (!stop.load(std::memory_order_relaxed)) {
+        Room* room = world.rooms[rng() % world.rooms.size()].get();
+        Room* to = world.rooms[rng() % world.rooms.size()].get();
+        const char* direction = DIRECTIONS[rng() % 4];
+        bool add = rng() % 2 == 0;
+        write([&] {
+            if (add) {
+                room->addExit(direction, to);
+            } else {
+                room->removeExit(direction);
+            }
+        });
+        next += interval;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+// Runs readers and the writer for RUN_TIME and returns the lookups per second
+template <typename Turn, typename Write>
+double run(const World& world, int threads, int writes_per_second, Turn turn, Write write) {
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> lookups{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < threads; ++i) {
+        readers.emplace_back([&, i] { lookups += walk(world, i + 1, stop, turn); });
+    }
+    std::thread writer([&] { writeExits(world, writes_per_second, stop, write); });
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(RUN_TIME);
+    stop = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    writer.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return lookups.load() / elapsed;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    WorldGenOptions options;
+    options.width = options.height = (argc > 1) ? std::atoi(argv[1]) : 300;
+    int max_threads = (argc > 2) ? std::atoi(argv[2]) : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    int writes_per_second = (argc > 3) ? std::atoi(argv[3]) : 10000;
+    if (options.width <= 0 || max_threads <= 0 || writes_per_second <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [side] [max_threads] [writes_per_second]" << std::endl;
+        return 1;
+    }
+
+    // The same world for both: shared, its exits are published; not, they change in place under the lock
+    World world = WorldGenerator::generate(options);
+    std::cout << world.rooms.size() << " rooms, " << writes_per_second << " exit changes a second" << std::endl;
+    std::cout << "threads  read-copy-update    reader-writer lock   (million lookups a second)" << std::endl;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        for (const auto& room : world.rooms) {
+            room->setShared(true);
+        }
+        std::mutex writer_mutex;
+        double rcu = run(world, threads, writes_per_second,
+            [](auto&& lookups) { ReadSection reading; lookups(); },
+            [&](auto&& change) { std::lock_guard<std::mutex> lock(writer_mutex); change(); });
+
+        for (const auto& room : world.rooms) {
+            room->setShared(false);
+        }
+        Epoch::synchronize();
+        std::shared_mutex world_lock;
+        double locked = run(world, threads, writes_per_second,
+            [&](auto&& lookups) { std::shared_lock<std::shared_mutex> lock(world_lock); lookups(); },
+            [&](auto&& change) { std::unique_lock<std::shared_mutex> lock(world_lock); change(); });
+
+        std::cout << "  " << threads << "\t " << rcu / 1e6 << "\t\t     " << locked / 1e6 << std::endl;
+    }
+    Epoch::synchronize();
+    std::cout << "Retired versions left unfreed: " << Epoch::getPendingCount() << std::endl;
+    return 0;
+}
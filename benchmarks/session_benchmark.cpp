@@ -0,0 +1,96 @@
+// Measures the memory each game session costs when many play one world at
+// once. Run from the project root:
+//
+//   g++ benchmarks/session_benchmark.cpp src/worldgen/WorldGenerator.cpp src/Game.cpp src/Room.cpp src/Terrain.cpp src/SQLParser.cpp src/objects/*.cpp src/players/*.cpp src/platform/*.cpp src/input/*.cpp src/dialogue/*.cpp src/save/*.cpp src/memory/*.cpp src/ui/*.cpp src/text/*.cpp src/search/*.cpp src/npc/*.cpp src/concurrency/*.cpp src/vision/*.cpp src/world/*.cpp src/log/*.cpp src/metrics/*.cpp src/storage/StorageEngine.cpp src/storage/SSTable.cpp src/storage/WorldStore.cpp src/replay/InputRecording.cpp -o session_benchmark.exe -Isrc -std=c++20 -O2 -pthread
+//   ./session_benchmark.exe [side] [sessions] [moves]
+//
+// The world is side x side generated rooms (default 300). Each of sessions
+// (default 1000) headless games over one shared world makes moves (default
+// 200) random moves, and the heap growth per session is compared with games
+// that each load a private copy of the world, as every game did before
+// worlds were shared.
+
+#include "Game.h"
+#include "memory/MemoryStats.h"
+#include "worldgen/WorldGenerator.h"
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+volatile sig_atomic_t g_signal_received = 0;
+
+namespace {
+
+std::size_t liveBytes() {
+    std::size_t bytes = 0;
+    for (int tag = 0; tag < static_cast<int>(MemTag::Count); ++tag) {
+        bytes += MemoryStats::get(static_cast<MemTag>(tag)).live_bytes;
+    }
+    return bytes;
+}
+
+// Wanders at random, answering "1" now and then to resolve a challenge and
+// taking whatever a room holds, so that the sessions change the world.
+void wander(Game& game, int moves, std::uint64_t seed) {
+    static const char* const commands[] = {"north", "south", "east", "west", "take "};
+    std::mt19937_64 rng(seed);
+    for (int i = 0; i < moves; ++i) {
+        game.submitLine(i % 16 == 15 ? "1" : commands[rng() % 5]);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    WorldGenOptions options;
+    options.width = options.height = (argc > 1) ? std::atoi(argv[1]) : 300;
+    int sessions = (argc > 2) ? std::atoi(argv[2]) : 1000;
+    int moves = (argc > 3) ? std::atoi(argv[3]) : 200;
+    if (options.width <= 0 || sessions <= 0 || moves < 0) {
+        std::cerr << "Usage: " << argv[0] << " [side] [sessions] [moves]" << std::endl;
+        return 1;
+    }
+
+    std::size_t before_world = liveBytes();
+    auto world = std::make_shared<const SharedWorld>(WorldGenerator::generate(options));
+    world->getSearch().getIndex(); // The index is part of the world
+    std::size_t world_bytes = liveBytes() - before_world;
+
+    std::size_t before_sessions = liveBytes();
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<Game>> games;
+    for (int i = 0; i < sessions; ++i) {
+        games.push_back(std::make_unique<Game>(world, headless));
+    }
+    std::size_t fresh_bytes = liveBytes() - before_sessions;
+    std::size_t overlay_bytes = 0;
+    for (int i = 0; i < sessions; ++i) {
+        wander(*games[i], moves, i + 1);
+        overlay_bytes += games[i]->getOverlay().getBytes();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::size_t played_bytes = liveBytes() - before_sessions;
+    games.clear();
+
+    // A few games with private worlds, since each costs a whole world
+    const int PRIVATE_GAMES = 4;
+    std::size_t before_private = liveBytes();
+    std::vector<std::unique_ptr<Game>> private_games;
+    for (int i = 0; i < PRIVATE_GAMES; ++i) {
+        private_games.push_back(std::make_unique<Game>(std::make_shared<const SharedWorld>(WorldGenerator::generate(options)), headless));
+        wander(*private_games.back(), moves, i + 1);
+    }
+    std::size_t private_bytes = liveBytes() - before_private;
+
+    std::cout << world->getRooms().size() << " rooms, " << world->getCharacters().size() << " characters, "
+              << world->getTools().size() << " tools; " << sessions << " sessions of " << moves << " moves" << std::endl;
+    std::cout << "  shared world:            " << world_bytes / 1024 << " KiB, loaded once" << std::endl;
+    std::cout << "  per session, new:        " << fresh_bytes / sessions << " bytes" << std::endl;
+    std::cout << "  per session, played:     " << played_bytes / sessions << " bytes, of which "
+              << overlay_bytes / sessions << " are its changes to the world" << std::endl;
+    std::cout << "  per session with a private world: " << private_bytes / PRIVATE_GAMES / 1024 << " KiB" << std::endl;
+    std::cout << "  " << elapsed / sessions * 1e3 << " ms to start and play a shared session" << std::endl;
+    return 0;
+}
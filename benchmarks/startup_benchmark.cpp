@@ -0,0 +1,57 @@
+// Compares game startup from the CSV files with startup from the embedded
+// world tables. Run from the project root so that sql/ can be found:
+//
+//   g++ benchmarks/startup_benchmark.cpp src/Game.cpp src/Room.cpp src/Terrain.cpp src/SQLParser.cpp src/objects/*.cpp src/players/*.cpp src/platform/*.cpp src/input/*.cpp src/dialogue/*.cpp src/save/*.cpp src/memory/*.cpp src/ui/*.cpp src/text/*.cpp src/search/*.cpp src/npc/*.cpp src/concurrency/*.cpp src/vision/*.cpp src/world/*.cpp src/log/*.cpp src/metrics/*.cpp src/storage/StorageEngine.cpp src/storage/SSTable.cpp src/storage/WorldStore.cpp src/replay/InputRecording.cpp -o startup_benchmark.exe -Isrc -std=c++20 -O2
+//   ./startup_benchmark.exe [iterations]
+
+#include "Game.h"
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <streambuf>
+
+volatile sig_atomic_t g_signal_received = 0;
+
+namespace {
+
+// Swallows the loading messages so that console output is not measured.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+template <typename MakeGame>
+double averageMicroseconds(int iterations, MakeGame makeGame) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        makeGame();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = (argc > 1) ? std::atoi(argv[1]) : 200;
+    if (iterations <= 0) {
+        iterations = 200;
+    }
+
+    NullBuffer null_buffer;
+    std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+    std::streambuf* cerr_buffer = std::cerr.rdbuf(&null_buffer);
+
+    double csv = averageMicroseconds(iterations, [] { Game game; });
+    double embedded = averageMicroseconds(iterations, [] { Game game(embeddedWorld); });
+
+    std::cout.rdbuf(cout_buffer);
+    std::cerr.rdbuf(cerr_buffer);
+
+    std::cout << "Startup over " << iterations << " iterations:" << std::endl;
+    std::cout << "  loadDataFromCSV:   " << csv << " us" << std::endl;
+    std::cout << "  embedded tables:   " << embedded << " us" << std::endl;
+    std::cout << "  speedup:           " << (embedded > 0 ? csv / embedded : 0) << "x" << std::endl;
+    return 0;
+}
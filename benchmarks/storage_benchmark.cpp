@@ -0,0 +1,169 @@
+// Compares loading a generated world from CSV files with loading it from a
+// world store, and measures the store's lookups, range scans and durable
+// writes. Run from the project root:
+//
+//   g++ benchmarks/storage_benchmark.cpp src/worldgen/WorldGenerator.cpp src/Game.cpp src/Room.cpp src/Terrain.cpp src/SQLParser.cpp src/objects/*.cpp src/players/*.cpp src/platform/*.cpp src/input/*.cpp src/dialogue/*.cpp src/save/*.cpp src/memory/*.cpp src/ui/*.cpp src/text/*.cpp src/search/*.cpp src/npc/*.cpp src/concurrency/*.cpp src/vision/*.cpp src/world/*.cpp src/log/*.cpp src/metrics/*.cpp src/storage/StorageEngine.cpp src/storage/SSTable.cpp src/storage/WorldStore.cpp src/replay/InputRecording.cpp -o storage_benchmark.exe -Isrc -std=c++20 -O2 -pthread
+//   ./storage_benchmark.exe [side] [terrain_side]
+//
+// The world is side x side rooms (default 300) and the terrain
+// terrain_side x terrain_side tiles (default 1000).
+
+#include "CSVParser.h"
+#include "Game.h"
+#include "storage/WorldStore.h"
+#include "worldgen/WorldGenerator.h"
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <streambuf>
+
+volatile sig_atomic_t g_signal_received = 0;
+
+namespace {
+
+// Swallows loading messages so that the terminal is not measured.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    WorldGenOptions options;
+    options.width = options.height = (argc > 1) ? std::atoi(argv[1]) : 300;
+    int terrain_side = (argc > 2) ? std::atoi(argv[2]) : 1000;
+    if (options.width <= 0 || terrain_side <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [side] [terrain_side]" << std::endl;
+        return 1;
+    }
+    std::filesystem::path root = std::filesystem::temp_directory_path() / "quanta_pie_storage_benchmark";
+    std::filesystem::remove_all(root);
+    std::string csv_dir = (root / "csv").string();
+    std::string store_dir = (root / "store").string();
+    std::filesystem::create_directories(csv_dir);
+
+    NullBuffer null_buffer;
+    std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+    std::streambuf* cerr_buffer = std::cerr.rdbuf(&null_buffer);
+
+    World world = WorldGenerator::generate(options);
+    std::size_t room_count = world.rooms.size();
+    WorldGenerator::writeCSV(world, csv_dir);
+    auto start = std::chrono::steady_clock::now();
+    {
+        WorldStore store;
+        store.open(store_dir);
+        store.importCSV(csv_dir);
+    }
+    double import_seconds = secondsSince(start);
+
+    // Reading every table, as rows of strings
+    start = std::chrono::steady_clock::now();
+    std::size_t csv_rows = 0;
+    for (const WorldStore::Table& table : WorldStore::getTables()) {
+        csv_rows += CSVParser::readCSV(csv_dir + "/" + table.name + ".csv").size();
+    }
+    double csv_read_seconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    std::size_t store_rows = 0;
+    {
+        WorldStore store;
+        store.open(store_dir);
+        for (const WorldStore::Table& table : WorldStore::getTables()) {
+            store.scan(table.name, {}, {}, [&store_rows](const WorldStore::Row&) {
+                ++store_rows;
+                return true;
+            });
+        }
+    }
+    double store_read_seconds = secondsSince(start);
+
+    // Starting the game
+    start = std::chrono::steady_clock::now();
+    std::size_t csv_game_rooms = Game(csv_dir, headless).getRoomCount();
+    double csv_game_seconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    std::size_t store_game_rooms = Game(store_dir, headless).getRoomCount();
+    double store_game_seconds = secondsSince(start);
+
+    WorldStore store;
+    store.open(store_dir);
+
+    // Point lookups of random rooms
+    const int lookups = 100000;
+    std::mt19937_64 rng(7);
+    WorldStore::Row row;
+    std::size_t found = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; ++i) {
+        found += store.get("rooms", {static_cast<std::int32_t>(rng() % room_count) + 1}, row);
+    }
+    double lookup_seconds = secondsSince(start);
+
+    // Terrain: bulk load, then read a 100 x 100 window
+    std::vector<WorldStore::Row> tiles;
+    for (int x = 0; x < terrain_side; ++x) {
+        for (int y = 0; y < terrain_side; ++y) {
+            bool wall = x == 0 || y == 0 || x == terrain_side - 1 || y == terrain_side - 1 || rng() % 10 == 0;
+            tiles.push_back({std::to_string(x), std::to_string(y), wall ? "#" : "."});
+        }
+    }
+    start = std::chrono::steady_clock::now();
+    store.bulkLoad("terrain", std::move(tiles));
+    double terrain_load_seconds = secondsSince(start);
+    const int window = std::min(100, terrain_side);
+    int window_x = (terrain_side - window) / 2;
+    std::size_t window_tiles = 0;
+    double window_seconds[2]; // Reading the blocks from disk, then from the block cache
+    for (double& seconds : window_seconds) {
+        window_tiles = 0;
+        start = std::chrono::steady_clock::now();
+        store.scanTerrain(window_x, window_x, window_x + window - 1, window_x + window - 1, [&](int, int, char) {
+            ++window_tiles;
+            return true;
+        });
+        seconds = secondsSince(start);
+    }
+
+    // Writes, each forced to disk before it returns
+    const int durable_writes = 200;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < durable_writes; ++i) {
+        store.put("scores", {std::to_string(1000000 + i), "1", "101", std::to_string(i)});
+    }
+    double durable_seconds = secondsSince(start);
+
+    std::cout.rdbuf(cout_buffer);
+    std::cerr.rdbuf(cerr_buffer);
+    std::filesystem::remove_all(root);
+
+    bool same = csv_game_rooms == store_game_rooms && found == static_cast<std::size_t>(lookups) &&
+                window_tiles == static_cast<std::size_t>(window) * window;
+    std::cout << "World of " << room_count << " rooms; " << csv_rows << " CSV lines, " << store_rows << " stored rows"
+              << std::endl;
+    std::cout << "  import CSV into the store:  " << import_seconds << " s" << std::endl;
+    std::cout << "  read every table, CSV:      " << csv_read_seconds << " s" << std::endl;
+    std::cout << "  read every table, store:    " << store_read_seconds << " s ("
+              << csv_read_seconds / store_read_seconds << "x)" << std::endl;
+    std::cout << "  start the game, CSV:        " << csv_game_seconds << " s" << std::endl;
+    std::cout << "  start the game, store:      " << store_game_seconds << " s ("
+              << csv_game_seconds / store_game_seconds << "x)" << std::endl;
+    std::cout << "  room lookup:                " << lookup_seconds / lookups * 1e6 << " us ("
+              << store.getEngine().getCacheHits() << " cache hits, " << store.getEngine().getCacheMisses()
+              << " misses)" << std::endl;
+    std::cout << "Terrain of " << terrain_side * terrain_side << " tiles" << std::endl;
+    std::cout << "  bulk load:                  " << terrain_load_seconds << " s" << std::endl;
+    std::cout << "  " << window << " x " << window << " window:           " << window_seconds[0] * 1e3 << " ms, "
+              << window_seconds[1] * 1e3 << " ms cached" << std::endl;
+    std::cout << "  durable write:              " << durable_seconds / durable_writes * 1e3 << " ms" << std::endl;
+    std::cout << "Results " << (same ? "match" : "DIFFER") << std::endl;
+    return same ? 0 : 1;
+}
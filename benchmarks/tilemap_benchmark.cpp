@@ -0,0 +1,133 @@
+// Compares drawing the terrain tile by tile with TileMapView on a large map.
+// Run from the project root:
+//
+//   g++ benchmarks/tilemap_benchmark.cpp src/Terrain.cpp src/ui/TileMapView.cpp -o tilemap_benchmark.exe -Isrc -std=c++20 -O2
+//   ./tilemap_benchmark.exe [side] [steps]
+//
+// The map is side x side tiles (default 4000) of rooms walled off from each
+// other with doorways. A walk of steps moves (default 2000) is drawn three
+// ways: the whole map a tile at a time with a cursor move before each, as a
+// naive renderer would; only the viewport, still a tile at a time; and with
+// TileMapView. Output goes to a string rather than the terminal, so the
+// times are the renderer's own.
+
+#include "Terrain.h"
+#include "ui/TileMapView.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+const int VIEW_WIDTH = 60;
+const int VIEW_HEIGHT = 9;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The escape sequence PosixConsole writes to move the cursor
+void moveCursor(std::string& out, int x, int y) {
+    out += "\x1b[";
+    out += std::to_string(y + 1);
+    out += ';';
+    out += std::to_string(x + 1);
+    out += 'H';
+}
+
+// Position of the walker after a step; it snakes along the rows of the map
+void walk(int step, int side, int& x, int& y) {
+    int row = step / (side - 2);
+    int column = step % (side - 2);
+    y = 1 + row % (side - 2);
+    x = 1 + (row % 2 == 0 ? column : side - 3 - column);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int side = argc > 1 ? std::atoi(argv[1]) : 4000;
+    int steps = argc > 2 ? std::atoi(argv[2]) : 2000;
+    if (side < 16 || steps < 1) {
+        std::cerr << "Usage: " << argv[0] << " [side >= 16] [steps >= 1]" << std::endl;
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Terrain terrain;
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            bool wall = (x % 12 == 0 && y % 12 != 6) || (y % 12 == 0 && x % 12 != 6);
+            terrain.setTile(x, y, wall ? '#' : '.');
+        }
+    }
+    std::cout << "Map of " << side << " x " << side << " tiles built in " << secondsSince(start) << " s" << std::endl;
+
+    std::string out;
+    std::size_t checksum = 0;
+    int x, y;
+
+    // The whole map, cursor move and tile by tile; timed on a few frames only
+    int map_frames = std::min(steps, 3);
+    start = std::chrono::steady_clock::now();
+    for (int step = 0; step < map_frames; ++step) {
+        walk(step, side, x, y);
+        out.clear();
+        for (int row = 0; row < side; ++row) {
+            for (int column = 0; column < side; ++column) {
+                moveCursor(out, column, row);
+                out += (column == x && row == y) ? TileMapView::PLAYER_TILE : terrain.getTile(column, row);
+            }
+        }
+        checksum += out.size();
+    }
+    double whole_map = secondsSince(start) / map_frames;
+
+    // The viewport only, still one cursor move and tile at a time
+    start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step) {
+        walk(step, side, x, y);
+        int origin_x = std::clamp(x - VIEW_WIDTH / 2, 0, side - VIEW_WIDTH);
+        int origin_y = std::clamp(y - VIEW_HEIGHT / 2, 0, side - VIEW_HEIGHT);
+        out.clear();
+        for (int row = 0; row < VIEW_HEIGHT; ++row) {
+            for (int column = 0; column < VIEW_WIDTH; ++column) {
+                int map_x = origin_x + column, map_y = origin_y + row;
+                moveCursor(out, column, row);
+                out += (map_x == x && map_y == y) ? TileMapView::PLAYER_TILE : terrain.getTile(map_x, map_y);
+            }
+        }
+        checksum += out.size();
+    }
+    double viewport_tiles = secondsSince(start) / steps;
+
+    // TileMapView: runs, scrolling, and a cursor move per line
+    TileMapView view(terrain);
+    view.resize(VIEW_WIDTH, VIEW_HEIGHT);
+    std::size_t rows_drawn = 0;
+    start = std::chrono::steady_clock::now();
+    for (int step = 0; step < steps; ++step) {
+        walk(step, side, x, y);
+        const std::vector<std::string>& lines = view.update(x, y);
+        rows_drawn += view.getRowsDrawn();
+        out.clear();
+        for (std::size_t row = 0; row < lines.size(); ++row) {
+            moveCursor(out, 0, static_cast<int>(row));
+            out += lines[row];
+        }
+        checksum += out.size();
+    }
+    double view_frame = secondsSince(start) / steps;
+
+    std::cout << "Per frame, over a walk of " << steps << " steps:" << std::endl;
+    std::cout << "  whole map, tile by tile:  " << whole_map * 1e6 << " us" << std::endl;
+    std::cout << "  viewport, tile by tile:   " << viewport_tiles * 1e6 << " us" << std::endl;
+    std::cout << "  TileMapView:              " << view_frame * 1e6 << " us ("
+              << static_cast<double>(rows_drawn) / steps << " rows drawn per frame)" << std::endl;
+    std::cout << "TileMapView is " << whole_map / view_frame << "x faster than drawing the map and "
+              << viewport_tiles / view_frame << "x faster than drawing the viewport tile by tile" << std::endl;
+    std::cout << "(checksum " << checksum << ")" << std::endl;
+    return 0;
+}
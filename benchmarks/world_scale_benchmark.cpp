@@ -0,0 +1,148 @@
+// Measures world generation, loading, navigation, rendering and character turns on a large
+// procedurally generated world. Run from the project root:
+//
+//   g++ benchmarks/world_scale_benchmark.cpp src/worldgen/WorldGenerator.cpp src/Game.cpp src/Room.cpp src/Terrain.cpp src/SQLParser.cpp src/objects/*.cpp src/players/*.cpp src/platform/*.cpp src/input/*.cpp src/dialogue/*.cpp src/save/*.cpp src/memory/*.cpp src/ui/*.cpp src/text/*.cpp src/search/*.cpp src/npc/*.cpp src/concurrency/*.cpp src/vision/*.cpp src/world/*.cpp src/log/*.cpp src/metrics/*.cpp src/storage/StorageEngine.cpp src/storage/SSTable.cpp src/storage/WorldStore.cpp src/replay/InputRecording.cpp -o world_scale_benchmark.exe -Isrc -std=c++20 -O2 -pthread
+//   ./world_scale_benchmark.exe [side] [moves]
+//
+// The world is side x side rooms (default 1000, a million rooms).
+
+#include "Game.h"
+#include "worldgen/WorldGenerator.h"
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <streambuf>
+
+volatile sig_atomic_t g_signal_received = 0;
+
+namespace {
+
+// Swallows loading messages and screen output so that the terminal is not measured.
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Wanders at random; blocked directions cost a turn without moving, like a
+// player's typo. Every so often it answers "1", which resolves the starting
+// room's challenge if the walk has wandered back into it.
+double wander(Game& game, int moves, std::uint64_t seed) {
+    static const char* const directions[] = {"north", "south", "east", "west"};
+    std::mt19937_64 rng(seed);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < moves; ++i) {
+        game.submitLine(i % 16 == 15 ? "1" : directions[rng() % 4]);
+    }
+    return secondsSince(start);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    WorldGenOptions options;
+    options.width = options.height = (argc > 1) ? std::atoi(argv[1]) : 1000;
+    int moves = (argc > 2) ? std::atoi(argv[2]) : 100000;
+    if (options.width <= 0 || moves <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [side] [moves]" << std::endl;
+        return 1;
+    }
+    std::filesystem::path csv_dir = std::filesystem::temp_directory_path() / "quanta_pie_world_scale";
+    std::filesystem::create_directories(csv_dir);
+
+    NullBuffer null_buffer;
+    std::streambuf* cout_buffer = std::cout.rdbuf(&null_buffer);
+    std::streambuf* cerr_buffer = std::cerr.rdbuf(&null_buffer);
+
+    auto start = std::chrono::steady_clock::now();
+    World world = WorldGenerator::generate(options);
+    double generate_s = secondsSince(start);
+    std::size_t rooms = world.rooms.size();
+
+    start = std::chrono::steady_clock::now();
+    bool written = WorldGenerator::writeCSV(world, csv_dir.string());
+    double write_s = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    auto shared = std::make_shared<const SharedWorld>(std::move(world));
+    Game generated(shared);
+    double adopt_s = secondsSince(start);
+
+    // The index is built in the background; the first search waits for it.
+    start = std::chrono::steady_clock::now();
+    generated.search("library", 10);
+    double index_wait_s = secondsSince(start);
+    static const char* const queries[] = {"library", "misty cavern", "compass of calm", "sector 3-7", "clock"};
+    const int searches = 1000;
+    std::size_t search_hits = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < searches; ++i) {
+        search_hits += generated.search(queries[i % 5], 10).size();
+    }
+    double search_s = secondsSince(start);
+
+    // Characters' turns away from the player, in a session of their own like the game's
+    NpcSession npcs(shared->getNpcs(), shared->getNpcThreads());
+    npcs.reseed(options.seed);
+    const int npc_turns = 100;
+    std::size_t npc_moves = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < npc_turns; ++i) {
+        npc_moves += npcs.tick(nullptr).size();
+    }
+    double npc_s = secondsSince(start);
+    double wander_s = wander(generated, moves, options.seed);
+
+    // The first frames after loading also pay, once, for the allocator sorting
+    // the blocks freed when the world's text was compressed; leave them out.
+    for (int i = 0; i < 16; ++i) {
+        generated.displayGameScreen();
+    }
+    int renders = std::max(1, moves / 100);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < renders; ++i) {
+        generated.displayGameScreen();
+    }
+    double render_s = secondsSince(start);
+
+    const TextStore& text = generated.getTextStore();
+    start = std::chrono::steady_clock::now();
+    std::size_t decoded_bytes = 0;
+    for (TextId id = 0; id < text.size(); ++id) {
+        decoded_bytes += text.get(id).size();
+    }
+    double decode_s = secondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    Game loaded(csv_dir.string(), headless);
+    double load_s = secondsSince(start);
+    bool load_ok = loaded.getRoomCount() == rooms;
+
+    std::cout.rdbuf(cout_buffer);
+    std::cerr.rdbuf(cerr_buffer);
+    std::filesystem::remove_all(csv_dir);
+
+    std::cout << "World of " << rooms << " rooms:" << std::endl;
+    std::cout << "  generate (in memory):   " << generate_s << " s" << std::endl;
+    std::cout << "  write CSV:              " << (written ? write_s : 0) << " s" << (written ? "" : " (failed)") << std::endl;
+    std::cout << "  Game(World):            " << adopt_s << " s" << std::endl;
+    std::cout << "  search index ready:     " << index_wait_s << " s after Game(World)" << std::endl;
+    std::cout << "  search:                 " << search_s * 1e3 / searches << " ms/query, top 10 (" << search_hits << " hits)" << std::endl;
+    std::cout << "  loadDataFromCSV:        " << load_s << " s" << (load_ok ? "" : " (room count mismatch)") << std::endl;
+    std::cout << "  navigation:             " << wander_s * 1e6 / moves << " us/move over " << moves << " moves" << std::endl;
+    std::cout << "  character turns:        " << npc_s * 1e3 / npc_turns << " ms/turn for " << npcs.size() << " characters ("
+              << shared->getNpcs().getMoverCount() << " movers, " << npc_moves / npc_turns << " moves/turn)" << std::endl;
+    std::cout << "  rendering:              " << render_s * 1e6 / renders << " us/frame over " << renders << " frames" << std::endl;
+    std::cout << "  text:                   " << text.getStoredBytes() << " bytes stored for " << text.getOriginalBytes()
+              << " (" << static_cast<double>(text.getOriginalBytes()) / std::max<std::size_t>(1, text.getStoredBytes()) << "x)" << std::endl;
+    std::cout << "  text decode:            " << decode_s * 1e9 / std::max<std::size_t>(1, text.size()) << " ns/text over "
+              << text.size() << " texts (" << decoded_bytes << " bytes)" << std::endl;
+    return 0;
+}
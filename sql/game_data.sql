@@ -1,4 +1,4 @@
--- SQL script for TissDB game data.
+-- SQL script for the game data.
 -- This script is no longer used to populate the game world with data.
 -- All game data is now loaded from the CSV files in this directory.
 -- This file is kept for historical purposes and to show the table schema.
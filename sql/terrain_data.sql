@@ -1,5 +1,5 @@
--- Terrain data for the game world, stored in tissdb.
--- tissdb is a tile-based storage system.
+-- Terrain data for the game world. Load it with the game's integration build,
+-- or into a world database with `quanta_storage import <directory> sql/terrain_data.sql`.
 
 CREATE TABLE terrain (
     x_coord INT NOT NULL,
@@ -5,11 +5,12 @@
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <cctype>
 
 namespace CSVParser {
 
     // Function to split a string by a delimiter, handling quoted fields
-    std::vector<std::string> split(const std::string& s, char delimiter) {
+    inline std::vector<std::string> split(const std::string& s, char delimiter) {
         std::vector<std::string> tokens;
         std::string currentToken;
         bool inQuote = false;
@@ -35,8 +36,17 @@ namespace CSVParser {
         return tokens;
     }
 
+    // Function to interpret a boolean field such as is_locked: TRUE, true or 1
+    inline bool parseBool(const std::string& field) {
+        std::string value;
+        for (char c : field) {
+            value += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return value == "true" || value == "1";
+    }
+
     // Function to read a CSV file and return its content as a vector of string vectors
-    std::vector<std::vector<std::string>> readCSV(const std::string& filename) {
+    inline std::vector<std::vector<std::string>> readCSV(const std::string& filename) {
         std::vector<std::vector<std::string>> data;
         std::ifstream file(filename);
 
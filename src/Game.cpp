@@ -3,10 +3,17 @@
 #include "Room.h"
 #include "objects/Character.h"
 #include "objects/Challenge.h"
-#include "GameSession.h"
-#include "Score.h"
-#include "CSVParser.h"
-#include "platform/WindowsConsole.h" // Include the Windows-specific console implementation
+#include "dialogue/Scripts.h"
+#include "platform/Console.h" // Console::create() picks the platform implementation
+#include "platform/NullConsole.h"
+#include "replay/InputRecording.h"
+#include "memory/MemoryStats.h"
+#include "concurrency/Epoch.h"
+#include "log/Log.h"
+#include "metrics/Metrics.h"
+#include "realtime/TripleBuffer.h"
+#include "realtime/SpscQueue.h"
+#include "realtime/FixedStepClock.h"
 #include <iostream>
 #include <string>
 #include <vector>
@@ -14,276 +21,288 @@
 #include <memory>
 #include <algorithm> // Required for std::transform
 #include <cctype>    // Required for ::tolower
-Game::Game() : console(std::make_unique<WindowsConsole>()), player(nullptr), gameOver(false), current_challenge(nullptr) {
-    createWorld("sql/game_data.sql"); // This will be ignored now, but keeping for compatibility
-}
-
-Game::Game(const std::string& sql_file_path) : console(std::make_unique<WindowsConsole>()), player(nullptr), gameOver(false), current_challenge(nullptr) {
-    createWorld(sql_file_path); // This will be ignored now, but keeping for compatibility
-}
-
-Game::~Game() = default; // Explicitly defaulted in .cpp file
-
-void Game::createWorld(const std::string& sql_file_path) {
-    // Load all game data from the CSV files
-    loadDataFromCSV();
-
-    // Assign the first loaded player as the main player character.
-    if (!allPlayers.empty()) {
-        player = std::move(allPlayers[0]); // Transfer ownership
-        // Assign the first loaded room as the starting location for the main player.
-        if (!allRooms.empty()) {
-            player->setCurrentRoom(allRooms[0].get()); // Pass raw pointer to Room
-            // Example: Add a challenge to the starting room
-            if (allRooms[0]->getChallenge() == nullptr) {
-                std::vector<CBTChoice> choices;
-                CBTChoice choice1;
-                choice1.description = "Challenge the thought";
-                choice1.action = [this]() { // Lambda captures 'this' (Game instance)
-                    this->player->incrementScore(10);
-                    this->current_challenge = nullptr; // Resolve challenge
-                    // Add more complex outcomes here
-                };
-                choices.push_back(choice1);
-
-                CBTChoice choice2;
-                choice2.description = "Accept the thought";
-                choice2.action = [this]() { // Lambda captures 'this' (Game instance)
-                    this->player->incrementScore(-5);
-                    this->current_challenge = nullptr; // Resolve challenge
-                    // Add more complex outcomes here
-                };
-                choices.push_back(choice2);
-                allRooms[0]->setChallenge(std::make_unique<Challenge>("You feel overwhelmed by the vastness of the void.", choices));
-            }
-        }
+#include <unordered_map>
+#include <atomic>
+#include <deque>
+#include <thread>
+
+namespace {
+
+// What every session adds to the runtime metrics
+Counter turns_taken("quanta_turns_total", "Turns taken, across every session");
+Histogram input_latency("quanta_process_input_seconds", "Time to carry out one command", "", 1e-9);
+Histogram frame_latency("quanta_frame_render_seconds", "Time to draw one frame to the console", "", 1e-9);
+Counter console_bytes("quanta_console_bytes_written_total", "Bytes of screen text written to the console");
+Gauge active_sessions("quanta_active_sessions", "Games being played");
+Gauge active_challenges("quanta_active_challenges", "Sessions waiting for the answer to a challenge");
+
+} // namespace
+
+Game::Game() : Game(std::string()) {}
+
+Game::Game(const std::string& sql_file_path) : Game(SharedWorld::load(sql_file_path), Console::create(), true) {}
+
+Game::Game(EmbeddedWorldTag) : Game(SharedWorld::loadEmbedded(), Console::create(), true) {}
+
+Game::Game(const std::string& sql_file_path, HeadlessTag) : Game(SharedWorld::load(sql_file_path), std::make_unique<NullConsole>(), false) {}
+
+Game::Game(World world) : Game(std::make_shared<const SharedWorld>(std::move(world)), Console::create(), true) {}
+
+Game::Game(std::shared_ptr<const SharedWorld> world) : Game(std::move(world), Console::create(), true) {}
+
+Game::Game(std::shared_ptr<const SharedWorld> world, HeadlessTag) : Game(std::move(world), std::make_unique<NullConsole>(), false) {}
+
+Game::Game(std::shared_ptr<const SharedWorld> world, std::unique_ptr<Console> console, bool rendering_enabled)
+    : console(std::move(console)), world(std::move(world)), player(nullptr), npcs(this->world->getNpcs(), this->world->getNpcThreads()), gameOver(false), current_challenge(nullptr), prompt_row(0), prompt_drawn_length(0), rendering_enabled(rendering_enabled) {
+    setUpPlayer();
+    active_sessions.add(1);
+}
+
+Game::~Game() {
+    active_sessions.add(-1);
+    setChallenge(nullptr);
+}
+
+void Game::setUpPlayer() {
+    MemoryScope scope(MemTag::Session);
+    // Every session plays the world's first player, changing only its own view of the world
+    player = std::make_unique<Player>(world->getPlayer());
+    player->setWorldOverlay(&overlay);
+    placeOnMap();
+    npcs.reseed(rng_seed); // The characters start where the world places them, in every session
+    world_version = world->getVersion();
+}
+
+void Game::start() {
+    Log::info("Game started", {{"seed", rng_seed}, {"real_time", real_time}});
+    printWelcomeMessage();
+    if (real_time) {
+        realTimeLoop();
     } else {
-        // Fallback: if no players or rooms are loaded, create defaults.
-        if (allRooms.empty()) {
-            allRooms.push_back(std::make_unique<Room>("A non-descript, empty void."));
-        }
-        player = std::make_unique<Player>(0, "Default Player", "unknown", allRooms[0].get());
-        allPlayers.push_back(std::move(player)); // Add to allPlayers, then move back to player
-        player = std::move(allPlayers[0]);
+        gameLoop();
     }
+    Log::info("Game ended", {{"score", player->getScore()}});
 }
 
-void Game::loadDataFromCSV() {
-    // Load Rooms
-    std::vector<std::vector<std::string>> roomData = CSVParser::readCSV("sql/rooms.csv");
-    std::cout << "Loading Rooms..." << std::endl;
-    for (size_t i = 1; i < roomData.size(); ++i) { // Skip header row
-        if (roomData[i].size() > 1) {
-            std::cout << "Room Description: " << roomData[i][1] << std::endl;
-            allRooms.push_back(std::make_unique<Room>(roomData[i][1]));
-        } else {
-            std::cerr << "Error: Malformed room data at row " << i << std::endl;
-        }
-    }
-
-    // Load Characters
-    std::vector<std::vector<std::string>> characterData = CSVParser::readCSV("sql/characters.csv");
-    std::cout << "Loading Characters..." << std::endl;
-    for (size_t i = 1; i < characterData.size(); ++i) { // Skip header row
-        if (characterData[i].size() > 4) {
-            std::string name = characterData[i][1];
-            std::string description = characterData[i][2];
-            int initialRoomId = std::stoi(characterData[i][3]);
-            std::string dialogue = characterData[i][4];
-            std::cout << "Character Name: " << name << ", Description: " << description << ", Dialogue: " << dialogue << std::endl;
-            auto newCharacter = std::make_unique<Character>(std::stoi(characterData[i][0]), name, description, initialRoomId, dialogue);
-            if (initialRoomId > 0 && initialRoomId <= allRooms.size()) {
-                allRooms[initialRoomId - 1]->addCharacter(newCharacter.get()); // Pass raw pointer to Room
+void Game::setRealTime(bool enabled) {
+    real_time = enabled;
+}
+
+const std::vector<std::string>& Game::getRoomInfoLines() {
+    return room_panel.refresh([this](std::vector<std::string>& lines) {
+        if (!player) return;
+
+        if (current_challenge) {
+            lines.push_back("----------------------------------------");
+            lines.push_back("               CHALLENGE!               ");
+            lines.push_back("----------------------------------------");
+            appendWrapped(lines, "A sudden thought crosses your mind, demanding a response.");
+            appendWrapped(lines, "Thought: " + current_challenge->getThought());
+            lines.push_back("");
+            appendWrapped(lines, "How do you respond? (Enter the number of your choice)");
+            for (size_t i = 0; i < current_challenge->getChoices().size(); ++i) {
+                appendWrapped(lines, std::to_string(i + 1) + ". " + current_challenge->getChoices()[i].description);
             }
-            allCharacters.push_back(std::move(newCharacter));
+            lines.push_back("----------------------------------------");
         } else {
-            std::cerr << "Error: Malformed character data at row " << i << std::endl;
+            lines = roomLines(player->getCurrentRoom());
+            const Terrain& terrain = world->getTerrain();
+            if (!terrain.empty()) {
+                if (sight.update(terrain, map_x, map_y)) {
+                    map_view.redrawRows(sight.getNewlyExploredTop(), sight.getNewlyExploredBottom());
+                }
+                const std::vector<std::string>& map_lines = map_view.update(map_x, map_y);
+                lines.push_back(""); // Empty line for spacing
+                lines.insert(lines.end(), map_lines.begin(), map_lines.end());
+            }
+            if (!messages.empty()) {
+                lines.push_back(""); // Empty line for spacing
+                for (const std::string& message : messages) {
+                    appendWrapped(lines, message);
+                }
+            }
+            if (dialogue.isAwaitingChoice()) {
+                const std::vector<std::string>& choices = dialogue.getChoices();
+                lines.push_back("");
+                appendWrapped(lines, "How do you respond? (Enter the number of your choice)");
+                for (size_t i = 0; i < choices.size(); ++i) {
+                    appendWrapped(lines, std::to_string(i + 1) + ". " + choices[i]);
+                }
+            }
         }
-    }
+    });
+}
 
-    // Load Players
-    std::vector<std::vector<std::string>> playerData = CSVParser::readCSV("sql/players.csv");
-    std::cout << "Loading Players..." << std::endl;
-    for (size_t i = 1; i < playerData.size(); ++i) { // Skip header row
-        if (playerData[i].size() > 2) {
-            allPlayers.push_back(std::make_unique<Player>(std::stoi(playerData[i][0]), playerData[i][1], playerData[i][2], nullptr));
-        } else {
-            std::cerr << "Error: Malformed player data at row " << i << std::endl;
-        }
-    }
+namespace {
 
-    // Load Game Sessions
-    std::vector<std::vector<std::string>> gameSessionData = CSVParser::readCSV("sql/game_sessions.csv");
-    std::cout << "Loading Game Sessions..." << std::endl;
-    for (size_t i = 1; i < gameSessionData.size(); ++i) { // Skip header row
-        if (gameSessionData[i].size() > 3) {
-            allGameSessions.push_back(std::make_unique<GameSession>(std::stoi(gameSessionData[i][0]), gameSessionData[i][1], gameSessionData[i][2], gameSessionData[i][3]));
-        } else {
-            std::cerr << "Error: Malformed game session data at row " << i << std::endl;
-        }
-    }
+// Identifies one text field of a world object in the layout cache. Objects
+// are at least 8-byte aligned, leaving the low bits free for the field.
+std::uint64_t textId(const void* owner, int field) {
+    return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(owner)) | static_cast<std::uint64_t>(field);
+}
 
-    // Load Scores
-    std::vector<std::vector<std::string>> scoreData = CSVParser::readCSV("sql/scores.csv");
-    std::cout << "Loading Scores..." << std::endl;
-    for (size_t i = 1; i < scoreData.size(); ++i) { // Skip header row
-        if (scoreData[i].size() > 3) {
-            allScores.push_back(std::make_unique<Score>(std::stoi(scoreData[i][0]), std::stoi(scoreData[i][1]), std::stoi(scoreData[i][2]), std::stoi(scoreData[i][3])));
-        } else {
-            std::cerr << "Error: Malformed score data at row " << i << std::endl;
+} // namespace
+
+std::vector<std::string> Game::buildRoomLines(Room* room) {
+    std::vector<std::string> lines;
+    // Text is only decoded when its wrapped lines are not cached
+    auto append = [this, &lines](std::uint64_t text_id, auto text) {
+        const std::vector<std::string>* wrapped = layout.find(text_id, game_area_width);
+        if (!wrapped) {
+            wrapped = &layout.wrap(text_id, text(), game_area_width);
         }
-    }
+        lines.insert(lines.end(), wrapped->begin(), wrapped->end());
+    };
+    lines.push_back(""); // Empty line for spacing
+    append(textId(room, 0), [room] { return room->getDescription(); });
 
-    // Load Tools
-    std::vector<std::vector<std::string>> toolData = CSVParser::readCSV("sql/tools.csv");
-    std::cout << "Loading Tools..." << std::endl;
-    for (size_t i = 1; i < toolData.size(); ++i) { // Skip header row
-        if (toolData[i].size() > 3) {
-            allTools.push_back(std::make_unique<Tool>(std::stoi(toolData[i][0]), toolData[i][1], toolData[i][2], std::stoi(toolData[i][3])));
-        } else {
-            std::cerr << "Error: Malformed tool data at row " << i << std::endl;
+    const auto& characters = overlay.getCharacters(*room);
+    if (!characters.empty()) {
+        lines.push_back(""); // Empty line for spacing
+        for (const Character* character : characters) {
+            append(textId(character, 0), [character] { return character->getDescription(); });
+            append(textId(character, 1), [character] { return "They say: \"" + character->getDialogue() + "\""; });
         }
     }
 
-    // Load RoomObjects
-    std::vector<std::vector<std::string>> roomObjectData = CSVParser::readCSV("sql/room_objects.csv");
-    std::cout << "Loading RoomObjects..." << std::endl;
-    for (size_t i = 1; i < roomObjectData.size(); ++i) { // Skip header row
-        if (roomObjectData[i].size() > 3) {
-            allRoomObjects.push_back(std::make_unique<RoomObject>(std::stoi(roomObjectData[i][0]), roomObjectData[i][1], roomObjectData[i][2], std::stoi(roomObjectData[i][3])));
-        } else {
-            std::cerr << "Error: Malformed room object data at row " << i << std::endl;
+    const auto& objects = overlay.getObjects(*room);
+    if (!objects.empty()) {
+        std::string seen = "You see:";
+        for (size_t i = 0; i < objects.size(); ++i) {
+            seen += (i == 0 ? " " : ", ") + objects[i]->getName();
         }
+        lines.push_back(""); // Empty line for spacing
+        appendWrapped(lines, seen);
     }
 
-    // Load Exits (after all rooms are loaded)
-    std::vector<std::vector<std::string>> exitData = CSVParser::readCSV("sql/exits.csv");
-    std::cout << "Loading Exits..." << std::endl;
-    for (size_t i = 1; i < exitData.size(); ++i) { // Skip header row
-        if (exitData[i].size() > 3) {
-            int fromRoomId = std::stoi(exitData[i][1]);
-            int toRoomId = std::stoi(exitData[i][2]);
-            std::string direction = exitData[i][3];
+    lines.push_back(""); // Empty line for spacing
+    lines.push_back("It's you!");
+    lines.push_back(player->getRepresentation());
+    lines.push_back(""); // Empty line for spacing
 
-            if (fromRoomId > 0 && fromRoomId <= allRooms.size() &&
-                toRoomId > 0 && toRoomId <= allRooms.size()) {
-                allRooms[fromRoomId - 1]->addExit(direction, allRooms[toRoomId - 1].get());
-            } else {
-                std::cerr << "Error: Invalid room ID in exit data at row " << i << std::endl;
-            }
-        } else {
-            std::cerr << "Error: Malformed exit data at row " << i << std::endl;
-        }
+    std::stringstream ss_exits;
+    ss_exits << "Available exits:";
+    for (auto const& [direction, exit] : room->getAllExits()) { // Use getAllExits
+        ss_exits << " " << direction;
     }
+    appendWrapped(lines, ss_exits.str());
+    return lines;
 }
 
-void Game::start() {
-    printWelcomeMessage();
-    gameLoop();
+void Game::appendWrapped(std::vector<std::string>& lines, const std::string& text) const {
+    if (TextLayout::displayWidth(text) <= game_area_width) {
+        lines.push_back(text);
+        return;
+    }
+    std::vector<std::string> wrapped = TextLayout::wrap(text, game_area_width);
+    lines.insert(lines.end(), std::make_move_iterator(wrapped.begin()), std::make_move_iterator(wrapped.end()));
 }
 
-std::vector<std::string> Game::getRoomInfoLines() {
-    std::vector<std::string> lines;
-    if (!player) return lines;
+const std::vector<std::string>& Game::roomLines(Room* room) {
+    MemoryScope scope(MemTag::Rendering);
+    auto it = prerendered.find(room);
+    if (it == prerendered.end()) {
+        it = prerendered.emplace(room, buildRoomLines(room)).first;
+    }
+    return it->second;
+}
 
-    if (current_challenge) {
-        lines.push_back("----------------------------------------");
-        lines.push_back("               CHALLENGE!               ");
-        lines.push_back("----------------------------------------");
-        lines.push_back("A sudden thought crosses your mind, demanding a response.");
-        lines.push_back("Thought: " + current_challenge->getThought());
-        lines.push_back("");
-        lines.push_back("How do you respond? (Enter the number of your choice)");
-        for (size_t i = 0; i < current_challenge->getChoices().size(); ++i) {
-            lines.push_back(std::to_string(i + 1) + ". " + current_challenge->getChoices()[i].description);
-        }
-        lines.push_back("----------------------------------------");
-    } else {
-        Room* currentRoom = player->getCurrentRoom();
-        lines.push_back(""); // Empty line for spacing
-        lines.push_back(currentRoom->getDescription());
-
-        const auto& characters = currentRoom->getCharacters();
-        if (!characters.empty()) {
-            lines.push_back(""); // Empty line for spacing
-            for (const auto& character : characters) {
-                lines.push_back(character->getDescription());
-                lines.push_back("They say: \"" + character->getDialogue() + "\"");
-            }
-        }
+void Game::followWorldChanges() {
+    std::uint64_t version = world->getVersion();
+    if (version != world_version) {
+        world_version = version;
+        // Any room's exits may have changed, and with them its render and the map
+        prerendered.clear();
+        side_panel.markDirty();
+        room_panel.markDirty();
+    }
+}
 
-        lines.push_back(""); // Empty line for spacing
-        lines.push_back("It's you!");
-        lines.push_back(player->getRepresentation());
-        lines.push_back(""); // Empty line for spacing
+void Game::schedulePrerender() {
+    ReadSection reading;
+    // Keep the renders of the current room and its neighbours, which are the
+    // only rooms the next frame can show, and queue any that are missing.
+    Room* current = player->getCurrentRoom();
+    std::unordered_map<const Room*, std::vector<std::string>> kept;
+    prerender_queue.clear();
 
-        std::stringstream ss_exits;
-        ss_exits << "Available exits:";
-        for (auto const& [direction, room] : currentRoom->getAllExits()) { // Use getAllExits
-            ss_exits << " " << direction;
+    auto keep = [&](Room* room) {
+        auto it = prerendered.find(room);
+        if (it != prerendered.end()) {
+            kept.emplace(room, std::move(it->second));
+        } else if (kept.count(room) == 0) {
+            prerender_queue.push_back(room);
         }
-        lines.push_back(ss_exits.str());
+    };
+    keep(current);
+    for (auto const& [direction, exit] : current->getAllExits()) {
+        keep(exit);
     }
-    return lines;
+    prerendered.swap(kept);
 }
 
-std::vector<std::string> Game::getSidePanelLines() {
-    std::vector<std::string> lines;
-    if (!player) return lines;
-
-    Room* currentRoom = player->getCurrentRoom();
-
-    lines.push_back("----------------------------------------");
-    lines.push_back("               GAME INFO                ");
-    lines.push_back("----------------------------------------");
-    lines.push_back("Score: " + std::to_string(player->getScore()));
-    lines.push_back("----------------------------------------");
-    lines.push_back("            COMMANDS                    ");
-    lines.push_back("  - To move, type a direction:");
-    lines.push_back("    'north', 'south', 'east', 'west'");
-    lines.push_back("  - Other commands:");
-    lines.push_back("    'look', 'dance', 'quit'");
-    lines.push_back("----------------------------------------");
-    lines.push_back("               MAP                      ");
-    lines.push_back("----------------------------------------");
-
-    // Simple map representation
-    std::map<std::string, Room*> exits = currentRoom->getAllExits();
-
-    lines.push_back("       ");
-    if (exits.count("north")) lines.back() += "[N]"; else lines.back() += "   ";
-    lines.push_back("       |");
-    lines.push_back("       |");
-    std::string middle_map_line = "";
-    if (exits.count("west")) middle_map_line += "[W]---"; else middle_map_line += "      ";
-    middle_map_line += "[X]"; // Current room
-    if (exits.count("east")) middle_map_line += "---[E]";
-    lines.push_back(middle_map_line);
-    lines.push_back("       |");
-    lines.push_back("       |");
-    lines.push_back("       ");
-    if (exits.count("south")) lines.back() += "[S]"; else lines.back() += "   ";
-
-    lines.push_back("----------------------------------------");
-    return lines;
+bool Game::runIdleWork() {
+    if (prerender_queue.empty()) {
+        return false;
+    }
+    // One room per call keeps each step to a few microseconds, so a key
+    // press is never kept waiting behind background work.
+    Room* room = prerender_queue.back();
+    prerender_queue.pop_back();
+    if (prerendered.count(room) == 0) {
+        ReadSection reading;
+        MemoryScope scope(MemTag::Rendering);
+        // Building the lines reads the room's description, characters and
+        // exits, which also brings that data into cache before the move.
+        prerendered.emplace(room, buildRoomLines(room));
+    }
+    return true;
+}
+
+const std::vector<std::string>& Game::getSidePanelLines() {
+    static const std::vector<std::string> none;
+    if (!player) return none;
+    return side_panel.update(player->getScore(), player->getCurrentRoom());
 }
 
 void Game::displayGameScreen() {
+    if (!rendering_enabled) {
+        return;
+    }
+    ReadSection reading;
+    MemoryScope scope(MemTag::Rendering);
+    HistogramTimer timer(frame_latency);
+    followWorldChanges();
+    fitToConsole(console->getWidth());
+    drawScreen(getRoomInfoLines(), getSidePanelLines(), game_area_width);
+}
+
+void Game::fitToConsole(int console_width) {
+    // Follow terminal resizes. Room views are rebuilt for the new width from
+    // the layout cache, which keeps the wraps for every width it has seen.
+    int width = std::clamp(console_width - SIDE_PANEL_WIDTH - PANEL_GAP, MIN_GAME_AREA_WIDTH, MAX_GAME_AREA_WIDTH);
+    if (width != game_area_width) {
+        game_area_width = width;
+        map_view.resize(width, MAP_VIEW_HEIGHT);
+        prerendered.clear();
+        room_panel.markDirty();
+    }
+}
+
+void Game::drawScreen(const std::vector<std::string>& room_lines, const std::vector<std::string>& side_panel_lines, int area_width) {
     // Clear screen using the console abstraction
     console->clear();
 
-    std::vector<std::string> room_lines = getRoomInfoLines();
-    std::vector<std::string> side_panel_lines = getSidePanelLines();
-
     // Determine max height
     size_t max_height = std::max(room_lines.size(), side_panel_lines.size());
 
-    const int GAME_AREA_WIDTH = 60; // Adjust as needed
-    const int SIDE_PANEL_START_X = GAME_AREA_WIDTH + 2; // 2 spaces between game area and side panel
+    const int SIDE_PANEL_START_X = area_width + PANEL_GAP;
 
+    static const std::string blank;
+    std::size_t bytes = 0;
     for (size_t i = 0; i < max_height; ++i) {
-        std::string room_line = (i < room_lines.size()) ? room_lines[i] : "";
-        std::string side_panel_line = (i < side_panel_lines.size()) ? side_panel_lines[i] : "";
+        const std::string& room_line = (i < room_lines.size()) ? room_lines[i] : blank;
+        const std::string& side_panel_line = (i < side_panel_lines.size()) ? side_panel_lines[i] : blank;
 
         // Print room line
         console->setCursorPosition(0, i);
@@ -292,9 +311,30 @@ void Game::displayGameScreen() {
         // Print side panel line
         console->setCursorPosition(SIDE_PANEL_START_X, i);
         std::cout << side_panel_line;
+        bytes += room_line.size() + side_panel_line.size();
     }
+    console_bytes.add(bytes);
     // Set cursor position for input prompt
-    console->setCursorPosition(0, max_height + 1);
+    prompt_row = static_cast<int>(max_height) + 1;
+    prompt_drawn_length = 0;
+    console->setCursorPosition(0, prompt_row);
+}
+
+void Game::drawPrompt() {
+    if (!rendering_enabled) {
+        return;
+    }
+    MemoryScope scope(MemTag::Rendering);
+    const std::string& text = lineEditor.getBuffer();
+    console->setCursorPosition(0, prompt_row);
+    std::cout << "> " << text;
+    if (text.size() < prompt_drawn_length) {
+        std::cout << std::string(prompt_drawn_length - text.size(), ' '); // Erase leftover characters
+    }
+    console_bytes.add(2 + std::max(text.size(), prompt_drawn_length));
+    prompt_drawn_length = text.size();
+    console->setCursorPosition(2 + static_cast<int>(lineEditor.getCursor()), prompt_row);
+    std::cout << std::flush;
 }
 
 void Game::printWelcomeMessage() {
@@ -309,43 +349,314 @@ void Game::printWelcomeMessage() {
     std::cout << "Basic commands are listed in the HELP panel on the right." << std::endl;
     std::cout << std::endl;
     std::cout << "Press Enter to begin..." << std::endl;
-    std::string dummy;
-    std::getline(std::cin, dummy); // Wait for user to press Enter
+    int key = Console::NO_INPUT;
+    while (key != '\r' && key != '\n' && key != Console::END_OF_INPUT && !g_signal_received) {
+        key = console->pollChar(100); // Wait for user to press Enter
+    }
 
     displayGameScreen(); // Initial display
 }
 
 void Game::gameLoop() {
+    // How long to wait for a key when there is no background work to do,
+    // which bounds how late a Ctrl+C is noticed.
+    const int IDLE_POLL_MS = 50;
+
+    schedulePrerender();
+    drawPrompt();
     while (!gameOver) {
         if (g_signal_received) { // Check for signal
             gameOver = true;
             continue;
         }
 
-        displayGameScreen(); // Refresh screen at the start of every turn
+        // Only block when idle; with background work queued, poll without
+        // waiting and do one short step of work between key presses.
+        int key = console->pollChar(prerender_queue.empty() ? IDLE_POLL_MS : 0);
+        if (key == Console::NO_INPUT) {
+            runIdleWork();
+            continue;
+        }
 
-        std::cout << "> ";
-        std::string input_line;
-        if (!std::getline(std::cin, input_line)) {
-            // Handle EOF (Ctrl+D on Unix, Ctrl+Z on Windows)
-            if (std::cin.eof()) {
+        switch (lineEditor.handleKey(key)) {
+            case LineEditor::Result::Edited:
+                drawPrompt(); // Echo immediately
+                break;
+            case LineEditor::Result::Submitted: {
+                std::uint64_t allocations_before = MemoryStats::getTotalAllocations();
+                submitLine(lineEditor.takeLine());
+                if (!gameOver) {
+                    displayGameScreen(); // Refresh screen at the start of every turn
+                    schedulePrerender();
+                    drawPrompt();
+                }
+                last_turn_allocations = MemoryStats::getTotalAllocations() - allocations_before;
+                break;
+            }
+            case LineEditor::Result::EndOfInput:
+                // Handle EOF (Ctrl+D on Unix, Ctrl+Z on Windows)
                 gameOver = true;
                 std::cout << std::endl << "Exiting game due to end-of-file." << std::endl;
-                continue;
+                break;
+            case LineEditor::Result::Unchanged:
+                break;
+        }
+    }
+    if (recorder) {
+        recorder->finish(getStateHash());
+    }
+    std::cout << std::endl << "Thank you for playing Quanta_Pie!" << std::endl;
+}
+
+struct Game::RealTimeLink {
+    // One screen's worth of the game, built by the simulation thread
+    struct Frame {
+        std::vector<std::string> room_lines;
+        std::vector<std::string> side_panel_lines;
+        int area_width = MAX_GAME_AREA_WIDTH;
+        bool game_over = false;
+    };
+
+    TripleBuffer<Frame> frames;               // Simulation to renderer, latest frame only
+    SpscQueue<std::string, 16> commands;      // Renderer to simulation, every line typed
+    std::atomic<int> console_width{80};
+    std::atomic<bool> stop{false};            // Set by the renderer when the player leaves
+};
+
+void Game::realTimeLoop() {
+    using Clock = std::chrono::steady_clock;
+    RealTimeLink link;
+    link.console_width = console->getWidth();
+    std::thread simulation(&Game::runSimulation, this, std::ref(link));
+
+    // Nothing here waits on the simulation: keys are polled without blocking,
+    // commands are queued, and a frame is drawn only when a new one is ready.
+    std::deque<std::string> typed; // Commands the queue had no room for yet
+    Clock::time_point next_frame = Clock::now();
+    bool running = true;
+    while (running && !g_signal_received) {
+        link.console_width.store(console->getWidth(), std::memory_order_relaxed);
+        bool prompt_changed = false;
+        for (int key = console->pollChar(0); key != Console::NO_INPUT && running; key = console->pollChar(0)) {
+            switch (lineEditor.handleKey(key)) {
+                case LineEditor::Result::Edited:
+                    prompt_changed = true;
+                    break;
+                case LineEditor::Result::Submitted:
+                    typed.push_back(lineEditor.takeLine());
+                    prompt_changed = true;
+                    break;
+                case LineEditor::Result::EndOfInput:
+                    running = false;
+                    std::cout << std::endl << "Exiting game due to end-of-file." << std::endl;
+                    break;
+                case LineEditor::Result::Unchanged:
+                    break;
             }
         }
+        while (!typed.empty() && link.commands.tryPush(typed.front())) {
+            typed.pop_front();
+        }
 
-        // Convert input to lowercase for case-insensitive comparison
-        std::transform(input_line.begin(), input_line.end(), input_line.begin(),
-                       [](unsigned char c){ return std::tolower(c); });
+        if (link.frames.update()) {
+            const RealTimeLink::Frame& frame = link.frames.getReadBuffer();
+            if (frame.game_over) {
+                break;
+            }
+            MemoryScope scope(MemTag::Rendering);
+            HistogramTimer timer(frame_latency);
+            drawScreen(frame.room_lines, frame.side_panel_lines, frame.area_width);
+            prompt_changed = true;
+        }
+        if (prompt_changed) {
+            drawPrompt();
+        }
 
-        if (input_line == "quit") {
-            gameOver = true;
-        } else {
-            processInput(input_line);
+        // A late frame is not made up for; the next one is simply due a frame after it
+        next_frame = std::max(next_frame + RENDER_INTERVAL, Clock::now());
+        std::this_thread::sleep_until(next_frame);
+    }
+    link.stop.store(true);
+    simulation.join();
+    gameOver = true;
+    std::cout << std::endl << "Thank you for playing Quanta_Pie!" << std::endl;
+}
+
+void Game::runSimulation(RealTimeLink& link) {
+    using Clock = std::chrono::steady_clock;
+    FixedStepClock clock(SIMULATION_STEP, Clock::now());
+    std::uint32_t steps_to_turn = STEPS_PER_TURN;
+    std::uint64_t shown_room_version = 0, shown_side_panel_version = 0; // Panel versions last published
+
+    while (!link.stop.load(std::memory_order_relaxed)) {
+        {
+            ReadSection reading; // Closed before the thread sleeps, so it never holds up reclaiming
+            followWorldChanges();
+            for (std::uint32_t due = clock.takeDueSteps(Clock::now()); due > 0 && !gameOver; --due) {
+                fitToConsole(link.console_width.load(std::memory_order_relaxed));
+                std::string command;
+                while (!gameOver && link.commands.tryPop(command)) {
+                    if (runCommand(std::move(command))) {
+                        collectDialogueOutput();
+                    }
+                }
+                if (!gameOver && --steps_to_turn == 0) {
+                    steps_to_turn = STEPS_PER_TURN;
+                    advanceTurn();
+                    if (messages.size() > MAX_REAL_TIME_MESSAGES) {
+                        messages.erase(messages.begin(), messages.end() - MAX_REAL_TIME_MESSAGES);
+                    }
+                }
+            }
+
+            // Publish only frames that differ, so an idle screen is not redrawn
+            {
+                MemoryScope scope(MemTag::Rendering);
+                const std::vector<std::string>& room_lines = getRoomInfoLines();
+                const std::vector<std::string>& side_panel_lines = getSidePanelLines();
+                if (gameOver || room_panel.getVersion() != shown_room_version || side_panel.getVersion() != shown_side_panel_version) {
+                    RealTimeLink::Frame& frame = link.frames.getWriteBuffer();
+                    frame.room_lines = room_lines;
+                    frame.side_panel_lines = side_panel_lines;
+                    frame.area_width = game_area_width;
+                    frame.game_over = gameOver;
+                    link.frames.publish();
+                    shown_room_version = room_panel.getVersion();
+                    shown_side_panel_version = side_panel.getVersion();
+                }
+            }
+        }
+        if (gameOver) {
+            return;
+        }
+        std::this_thread::sleep_until(clock.getNextStepTime());
+    }
+}
+
+void Game::submitLine(const std::string& line) {
+    if (recorder) {
+        recorder->recordLine(line);
+    }
+    handleLine(line);
+}
+
+bool Game::isGameOver() const {
+    return gameOver;
+}
+
+std::uint64_t Game::getStateHash() const {
+    // FNV-1a over the state that input can change
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (value >> (8 * i)) & 0xff;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    if (player) {
+        Room* current = player->getCurrentRoom();
+        const auto& rooms = world->getRooms();
+        std::uint64_t room_index = rooms.size();
+        for (size_t i = 0; i < rooms.size(); ++i) {
+            if (rooms[i].get() == current) {
+                room_index = i;
+                break;
+            }
+        }
+        mix(room_index);
+        mix(static_cast<std::uint64_t>(player->getScore()));
+        for (const Tool* tool : player->getTools()) {
+            mix(static_cast<std::uint64_t>(tool->getId()));
         }
     }
-    std::cout << "Thank you for playing Quanta_Pie!" << std::endl;
+    mix(gameOver);
+    mix(current_challenge != nullptr);
+    mix(dialogue.getActiveCount());
+    mix(dialogue.isAwaitingChoice());
+    mix(dialogue.getTurn());
+    for (std::size_t npc = 0; npc < npcs.size(); ++npc) {
+        mix(static_cast<std::uint64_t>(npcs.getRoom(npc)->getId()));
+    }
+    return hash;
+}
+
+std::uint64_t Game::getSeed() const {
+    return rng_seed;
+}
+
+void Game::setSeed(std::uint64_t seed) {
+    rng_seed = seed;
+    rng.seed(seed);
+    npcs.reseed(seed);
+}
+
+const std::string& Game::getWorldSource() const {
+    return world->getSource();
+}
+
+void Game::setRecorder(InputRecorder* recorder) {
+    this->recorder = recorder;
+}
+
+void Game::handleLine(std::string input_line) {
+    // The world's exits may change while the turn runs; it reads one version of each
+    ReadSection reading;
+    followWorldChanges();
+    // Every command is one turn
+    if (runCommand(std::move(input_line))) {
+        advanceTurn();
+    }
+}
+
+bool Game::runCommand(std::string input_line) {
+    MemoryScope scope(MemTag::Session);
+    // Convert input to lowercase for case-insensitive comparison
+    std::transform(input_line.begin(), input_line.end(), input_line.begin(),
+                   [](unsigned char c){ return std::tolower(c); });
+
+    messages.clear(); // Messages are shown for one turn only
+    room_panel.markDirty();
+    if (input_line == "quit") {
+        gameOver = true;
+        return false;
+    }
+    HistogramTimer timer(input_latency);
+    processInput(input_line);
+    return true;
+}
+
+void Game::setChallenge(const Challenge* challenge) {
+    if ((challenge != nullptr) != (current_challenge != nullptr)) {
+        active_challenges.add(challenge ? 1 : -1);
+    }
+    current_challenge = challenge;
+}
+
+void Game::collectDialogueOutput() {
+    for (std::string& line : dialogue.takeOutput()) {
+        messages.push_back(std::move(line));
+        room_panel.markDirty();
+    }
+}
+
+void Game::advanceTurn() {
+    MemoryScope scope(MemTag::Session);
+    turns_taken.add();
+    // Scripts waiting on turns() may resume
+    bool was_awaiting_choice = dialogue.isAwaitingChoice();
+    dialogue.advanceTurn();
+    collectDialogueOutput();
+    if (dialogue.isAwaitingChoice() != was_awaiting_choice) {
+        room_panel.markDirty();
+    }
+    moveCharacters();
+    if (save_file && !save_file->save(captureSaveState())) {
+        // Stop rather than fail quietly every turn while the player's progress goes unsaved
+        Log::error("Autosave failed", {{"path", save_file->getPath()}});
+        messages.push_back("Your progress could not be saved to " + save_file->getPath() + ". Autosave is now off.");
+        save_file.reset();
+    }
 }
 
 void Game::processInput(const std::string& input) {
@@ -356,6 +667,7 @@ void Game::processInput(const std::string& input) {
 
     // If a challenge is active, process input as a choice number
     if (current_challenge) {
+        MemoryScope challenge_scope(MemTag::Challenge);
         int choice_num = -1;
         try {
             // Attempt to convert the entire input string to a number
@@ -369,8 +681,14 @@ void Game::processInput(const std::string& input) {
         }
 
         if (choice_num > 0 && static_cast<size_t>(choice_num) <= current_challenge->getChoices().size()) {
-            // Execute the chosen action. The lambda will set current_challenge to nullptr.
-            current_challenge->getChoices()[choice_num - 1].action();
+            // Apply the choice's outcome; choosing resolves the challenge for this session
+            const CBTChoice& choice = current_challenge->getChoices()[choice_num - 1];
+            player->incrementScore(choice.score_change);
+            if (choice.action) {
+                choice.action();
+            }
+            overlay.resolveChallenge(*player->getCurrentRoom());
+            setChallenge(nullptr);
         } else {
             // Invalid choice. We can add a message to the player here.
             // For now, doing nothing is fine, the screen will just refresh.
@@ -378,6 +696,16 @@ void Game::processInput(const std::string& input) {
         return; // Stop further processing after handling challenge input
     }
 
+    // A conversation waiting for an answer takes numbered input. Anything
+    // else is a normal command and leaves the conversation where it is.
+    if (dialogue.isAwaitingChoice() && !lowerInput.empty() && std::isdigit(static_cast<unsigned char>(lowerInput[0]))) {
+        unsigned long choice_num = std::strtoul(lowerInput.c_str(), nullptr, 10);
+        if (choice_num == 0 || !dialogue.choose(choice_num - 1)) {
+            messages.push_back("Please choose one of the numbered responses.");
+        }
+        return;
+    }
+
     // Process normal game commands
     if (lowerInput == "help") {
         // The help panel is always visible. This command is a no-op.
@@ -385,22 +713,333 @@ void Game::processInput(const std::string& input) {
         // 'look' simply forces a screen refresh, which happens on every loop.
     } else if (lowerInput == "dance") {
         // This is a temporary message, will be replaced by combat/action messages
-        std::cout << "You do a little jig. It's surprisingly uplifting." << std::endl;
+        messages.push_back("You do a little jig. It's surprisingly uplifting.");
+    } else if (lowerInput == "talk" || lowerInput.rfind("talk ", 0) == 0) {
+        talk(lowerInput.size() > 5 ? lowerInput.substr(5) : std::string());
+    } else if (lowerInput.rfind("take ", 0) == 0) {
+        takeTool(lowerInput.substr(5));
+    } else if (lowerInput.rfind("drop ", 0) == 0) {
+        dropTool(lowerInput.substr(5));
+    } else if (lowerInput == "inventory" || lowerInput == "inv") {
+        showInventory();
+    } else if (lowerInput == "memstats") {
+        showMemoryStats();
+    } else if (lowerInput.rfind("search ", 0) == 0) {
+        showSearchResults(lowerInput.substr(7));
     } else {
         // Any other command is assumed to be a move attempt.
         Room* current = player->getCurrentRoom();
-        Room* nextRoom = current->getExit(lowerInput);
+        Room* nextRoom = overlay.getExit(*current, lowerInput, player->getToolBits());
 
         if (nextRoom != nullptr) {
+            if (current->getExitKey(lowerInput) != 0) {
+                overlay.unlockExit(*current, lowerInput); // Opened with its key, it stays open
+            }
             player->setCurrentRoom(nextRoom);
             player->incrementScore(); // Increment score on successful move
-            // Check for challenge in the new room
-            if (nextRoom->getChallenge() != nullptr) {
-                current_challenge = std::make_unique<Challenge>(*nextRoom->getChallenge());
+            stepOnMap(lowerInput);
+            // Check for a challenge in the new room this session has not resolved yet
+            setChallenge(overlay.getChallenge(*nextRoom));
+        } else if (int key_tool_id = current->getExitKey(lowerInput)) {
+            std::string key_name = "the right key";
+            for (const auto& tool : world->getTools()) {
+                if (tool->getId() == key_tool_id) {
+                    key_name = "the " + tool->getName();
+                    break;
+                }
             }
+            messages.push_back("The way " + lowerInput + " is locked. It needs " + key_name + ".");
         } else {
             // We can add a message to a message buffer to be displayed on the next screen refresh
             // For now, we'll just let the screen refresh, which shows the command was ineffective.
         }
     }
-}
\ No newline at end of file
+}
+
+void Game::talk(const std::string& name) {
+    const auto& characters = overlay.getCharacters(*player->getCurrentRoom());
+    Character* target = nullptr;
+    for (Character* character : characters) {
+        std::string lowerName = character->getName();
+        std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(),
+                       [](unsigned char c){ return std::tolower(c); });
+        if (name.empty() || lowerName.find(name) != std::string::npos) {
+            target = character;
+            break;
+        }
+    }
+
+    if (target == nullptr) {
+        messages.push_back(name.empty() ? "There is no one here to talk to." : "You don't see them here.");
+        return;
+    }
+    if (dialogue.isAwaitingChoice()) {
+        messages.push_back("You are already in the middle of a conversation.");
+        return;
+    }
+
+    Dialogue conversation = DialogueScripts::conversationWith(*target, *player);
+    if (conversation) {
+        dialogue.start(std::move(conversation));
+    } else {
+        // Characters without a script just repeat their line
+        messages.push_back(target->getName() + ": \"" + target->getDialogue() + "\"");
+    }
+}
+
+namespace {
+
+bool nameMatches(const std::string& name, const std::string& query) {
+    std::string lowerName = name;
+    std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(),
+                   [](unsigned char c){ return std::tolower(c); });
+    return lowerName.find(query) != std::string::npos;
+}
+
+} // namespace
+
+void Game::takeTool(const std::string& name) {
+    Room* room = player->getCurrentRoom();
+    for (RoomObject* object : overlay.getObjects(*room)) {
+        Tool* tool = dynamic_cast<Tool*>(object);
+        if (tool && nameMatches(tool->getName(), name)) {
+            player->takeTool(tool); // Also removes it from the room
+            moved_tools[tool->getId()] = SaveState::CARRIED;
+            prerendered.erase(room);
+            messages.push_back("You take the " + tool->getName() + ".");
+            return;
+        }
+    }
+    messages.push_back("You don't see that here.");
+}
+
+void Game::dropTool(const std::string& name) {
+    for (Tool* tool : player->getTools()) {
+        if (nameMatches(tool->getName(), name)) {
+            player->dropTool(tool); // Also adds it to the room
+            moved_tools[tool->getId()] = player->getCurrentRoom()->getId();
+            prerendered.erase(player->getCurrentRoom());
+            messages.push_back("You put down the " + tool->getName() + ".");
+            return;
+        }
+    }
+    messages.push_back("You aren't carrying that.");
+}
+
+void Game::showInventory() {
+    const auto& tools = player->getTools();
+    if (tools.empty()) {
+        messages.push_back("You aren't carrying anything.");
+        return;
+    }
+    messages.push_back("You are carrying:");
+    for (const Tool* tool : tools) {
+        messages.push_back("  " + tool->getName());
+    }
+}
+
+Room* Game::findRoom(int room_id) const {
+    return world->findRoom(room_id);
+}
+
+void Game::placeOnMap() {
+    const Terrain& terrain = world->getTerrain();
+    map_view.resize(game_area_width, MAP_VIEW_HEIGHT);
+    map_view.setFog(&sight.getExplored());
+    for (int y = 0; y < terrain.getHeight(); ++y) {
+        for (int x = 0; x < terrain.getWidth(); ++x) {
+            if (terrain.getTile(x, y) == Terrain::FLOOR_TILE) {
+                map_x = x;
+                map_y = y;
+                return;
+            }
+        }
+    }
+}
+
+void Game::stepOnMap(const std::string& direction) {
+    const Terrain& terrain = world->getTerrain();
+    int x = map_x, y = map_y;
+    if (direction == "north") {
+        --y;
+    } else if (direction == "south") {
+        ++y;
+    } else if (direction == "east") {
+        ++x;
+    } else if (direction == "west") {
+        --x;
+    }
+    if (terrain.getTile(x, y) == Terrain::FLOOR_TILE) {
+        map_x = x;
+        map_y = y;
+    }
+}
+
+std::size_t Game::getRoomCount() const {
+    return world->getRooms().size();
+}
+
+bool Game::enableAutosave(const std::string& save_file_path) {
+    save_file = std::make_unique<SaveFile>(save_file_path);
+    std::ifstream existing(save_file_path, std::ios::binary);
+    if (!existing.is_open()) {
+        return save_file->save(captureSaveState()); // Start a new save
+    }
+    existing.close();
+
+    SaveState state;
+    if (!save_file->load(state)) {
+        save_file.reset(); // Never overwrite a save we could not read
+        return false;
+    }
+    applySaveState(state);
+    return true;
+}
+
+SaveState Game::captureSaveState() const {
+    SaveState state;
+    if (!player) {
+        return state;
+    }
+    Room* current = player->getCurrentRoom();
+    state.room_id = current ? current->getId() : 0;
+    state.score = player->getScore();
+    state.tool_locations = moved_tools; // Kept up to date as tools are taken and dropped
+    return state;
+}
+
+void Game::applySaveState(const SaveState& state) {
+    if (!player) {
+        return;
+    }
+    Room* room = findRoom(state.room_id);
+    if (room) {
+        player->setCurrentRoom(room);
+    }
+    player->setScore(state.score);
+
+    for (const auto& tool : world->getTools()) {
+        auto saved = state.tool_locations.find(tool->getId());
+        if (saved == state.tool_locations.end()) {
+            continue; // Not moved before the save, or added to the world since; leave it where it is
+        }
+        // Take the tool from wherever it is now: carried, put down this session, or where the world placed it
+        auto moved = moved_tools.find(tool->getId());
+        int current = moved != moved_tools.end() ? moved->second : tool->getInitialRoomId();
+        if (current == SaveState::CARRIED) {
+            player->dropTool(tool.get()); // Puts it in the player's room, from which it is removed below
+            current = player->getCurrentRoom()->getId();
+        }
+        if (Room* from = findRoom(current)) {
+            overlay.removeObject(*from, tool.get());
+        }
+        if (saved->second == SaveState::CARRIED) {
+            player->takeTool(tool.get());
+        } else if (Room* location = findRoom(saved->second)) {
+            overlay.addObject(*location, tool.get());
+        }
+        moved_tools[tool->getId()] = saved->second;
+    }
+    prerendered.clear();
+    room_panel.markDirty();
+}
+
+void Game::showMemoryStats() {
+    std::ostringstream table;
+    MemoryStats::dump(table);
+    std::string line;
+    std::istringstream lines(table.str());
+    while (std::getline(lines, line)) {
+        messages.push_back(line);
+    }
+    messages.push_back("Allocations last turn: " + std::to_string(last_turn_allocations));
+    const TextStore& text_store = world->getTextStore();
+    messages.push_back("World text: " + std::to_string(text_store.getStoredBytes()) + " bytes stored for " +
+                       std::to_string(text_store.getOriginalBytes()) + " bytes of prose");
+    messages.push_back("This session's changes to the world: " + std::to_string(overlay.getBytes()) + " bytes in " +
+                       std::to_string(overlay.getChangedRoomCount()) + " rooms");
+}
+
+std::vector<WorldSearch::Result> Game::search(const std::string& query, std::size_t max_results) {
+    return world->getSearch().search(query, max_results);
+}
+
+void Game::showSearchResults(const std::string& query) {
+    const std::size_t MAX_SHOWN = 5;
+    const std::size_t SNIPPET_LENGTH = 40;
+    std::vector<WorldSearch::Result> results = search(query, MAX_SHOWN);
+    if (results.empty()) {
+        messages.push_back("Nothing in this world matches \"" + query + "\".");
+        return;
+    }
+    messages.push_back("Search results for \"" + query + "\":");
+    for (const WorldSearch::Result& result : results) {
+        const WorldSearch::Entry& entry = result.entry;
+        std::string where = "room " + std::to_string(entry.room_id);
+        switch (entry.kind) {
+        case WorldSearch::Kind::Room: {
+            Room* room = findRoom(entry.id);
+            std::string snippet = room ? room->getDescription() : std::string();
+            if (snippet.size() > SNIPPET_LENGTH) {
+                std::size_t cut = snippet.rfind(' ', SNIPPET_LENGTH); // Cut between words, never inside a character
+                snippet = snippet.substr(0, cut == std::string::npos ? 0 : cut) + "...";
+            }
+            messages.push_back("  Room " + std::to_string(entry.id) + ": " + snippet);
+            break;
+        }
+        case WorldSearch::Kind::Character:
+            for (const auto& character : world->getCharacters()) {
+                if (character->getId() == entry.id) {
+                    messages.push_back("  " + character->getName() + ", a character in " + where);
+                }
+            }
+            break;
+        case WorldSearch::Kind::Tool:
+            for (const auto& tool : world->getTools()) {
+                if (tool->getId() == entry.id) {
+                    messages.push_back("  " + tool->getName() + ", a tool first found in " + where);
+                }
+            }
+            break;
+        case WorldSearch::Kind::Object:
+            for (const auto& object : world->getRoomObjects()) {
+                if (object->getId() == entry.id) {
+                    messages.push_back("  " + object->getName() + ", an object in " + where);
+                }
+            }
+            break;
+        }
+    }
+}
+
+void Game::moveCharacters() {
+    Room* here = player->getCurrentRoom();
+    for (const NpcSystem::Move& move : npcs.tick(here)) {
+        overlay.moveCharacter(move.character, *move.from, *move.to);
+        prerendered.erase(move.from); // Both rooms now list different occupants
+        prerendered.erase(move.to);
+        if (move.to == here) {
+            messages.push_back(move.character->getName() + " arrives.");
+            room_panel.markDirty();
+        } else if (move.from == here) {
+            messages.push_back(move.character->getName() + " leaves.");
+            room_panel.markDirty();
+        }
+    }
+}
+
+const NpcSession& Game::getNpcs() const {
+    return npcs;
+}
+
+const WorldOverlay& Game::getOverlay() const {
+    return overlay;
+}
+
+const TextStore& Game::getTextStore() const {
+    return world->getTextStore();
+}
+
+std::uint64_t Game::getLastTurnAllocations() const {
+    return last_turn_allocations;
+}
@@ -4,22 +4,54 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <map>
 #include <memory> // For std::unique_ptr
 #include <csignal> // For sig_atomic_t
+#include <unordered_map>
+#include <random>
+#include <cstdint>
+#include <chrono>
 #include "players/Player.h"
 #include "Room.h"
 #include "GameSession.h"
 #include "Score.h"
+#include "Terrain.h"
 #include "objects/Character.h" // Include full definition of Character
 #include "objects/Challenge.h" // Include Challenge definition
 #include "objects/Tool.h"
 #include "objects/RoomObject.h"
+#include "input/LineEditor.h"
+#include "dialogue/DialogueExecutor.h"
+#include "save/SaveGame.h"
+#include "World.h"
+#include "world/SharedWorld.h"
+#include "world/WorldOverlay.h"
+#include "ui/TextLayout.h"
+#include "ui/Panel.h"
+#include "ui/SidePanel.h"
+#include "ui/TileMapView.h"
+#include "search/WorldSearch.h"
+#include "npc/NpcSession.h"
+#include "vision/FieldOfView.h"
 
 // Forward declaration for the Console class to avoid including platform-specific headers
 class Console;
+class InputRecorder;
 
 extern volatile sig_atomic_t g_signal_received; // Declare global signal flag
 
+/**
+ * @brief Tag type selecting the world tables compiled into the binary.
+ */
+struct EmbeddedWorldTag {};
+inline constexpr EmbeddedWorldTag embeddedWorld{};
+
+/**
+ * @brief Tag type selecting a game with no console and rendering turned off.
+ */
+struct HeadlessTag {};
+inline constexpr HeadlessTag headless{};
+
 /**
  * @class Game
  * @brief Manages the main game loop, world creation, and player interaction.
@@ -37,9 +69,50 @@ public:
 
     /**
      * @brief Constructs a new Game object with a custom SQL file.
+     * @param sql_file_path A SQL dump of INSERT statements to build the world
+     *                      from, a directory of CSV files laid out like sql/, or
+     *                      a world store directory (see WorldStore).
+     *                      If empty, the world is loaded from the CSV files in sql/.
      */
     Game(const std::string& sql_file_path);
 
+    /**
+     * @brief Constructs a new Game object from the world compiled into the binary.
+     *
+     * Uses the tables in embedded/WorldTables.h, so startup reads no files.
+     * Descriptions and dialogue are read in place from the tables, in the
+     * binary's read-only pages, which every process running it shares. Names,
+     * exits and the rest of the world model are built on each process's heap.
+     */
+    explicit Game(EmbeddedWorldTag);
+
+    /**
+     * @brief Constructs a headless Game that is driven through submitLine().
+     *
+     * Nothing is drawn and the terminal is not touched, so the game runs as
+     * fast as its input can be fed, e.g. when replaying a recording.
+     * @param sql_file_path As for Game(const std::string&).
+     */
+    Game(const std::string& sql_file_path, HeadlessTag);
+
+    /**
+     * @brief Constructs a new Game object that takes over an already built world,
+     *        such as one from WorldGenerator.
+     */
+    explicit Game(World world);
+
+    /**
+     * @brief Constructs a new Game object that plays a world other games may be
+     *        playing too. The world is never changed; this game's changes to it
+     *        are kept apart, so it costs memory only for what its player does.
+     */
+    explicit Game(std::shared_ptr<const SharedWorld> world);
+
+    /**
+     * @brief Constructs a headless Game over a shared world, driven through submitLine().
+     */
+    Game(std::shared_ptr<const SharedWorld> world, HeadlessTag);
+
     /**
      * @brief Destroys the Game object, cleaning up allocated resources.
      */
@@ -50,28 +123,191 @@ public:
      */
     void start();
 
+    /**
+     * @brief Makes start() run the game in real time instead of turn by turn.
+     *
+     * The world then advances on its own at a fixed rate on a simulation
+     * thread while the calling thread reads keys and redraws the screen.
+     * Commands take effect on the next simulation step, and the world takes a
+     * turn every second whether or not anything is typed. Recording is not
+     * supported in this mode, since a replay cannot reproduce the timing.
+     */
+    void setRealTime(bool enabled);
+
+    /**
+     * @brief Processes one line of input as if the player had typed it.
+     */
+    void submitLine(const std::string& line);
+
+    bool isGameOver() const;
+
+    /**
+     * @brief Hashes the state a replay must reproduce: the player's room,
+     *        score and tools, and the challenge and conversation state.
+     */
+    std::uint64_t getStateHash() const;
+
+    std::uint64_t getSeed() const;
+
+    /**
+     * @brief Reseeds the game's random number generator; call before any input.
+     */
+    void setSeed(std::uint64_t seed);
+
+    /**
+     * @brief Gets the SQL dump, CSV directory or store the world was loaded from, or empty for sql/.
+     */
+    const std::string& getWorldSource() const;
+
+    /**
+     * @brief Records every line the game loop reads; the recorder must outlive the game loop.
+     */
+    void setRecorder(InputRecorder* recorder);
+
+    /**
+     * @brief Redraws the whole screen: room view, side panel and prompt.
+     */
+    void displayGameScreen();
+
+    std::size_t getRoomCount() const;
+
+    /**
+     * @brief Gets the number of heap allocations made while handling and drawing
+     *        the last line read by the game loop. Steady-state turns should make none.
+     */
+    std::uint64_t getLastTurnAllocations() const;
+
+    /**
+     * @brief Gets the compressed store holding the world's descriptions and dialogue.
+     */
+    const TextStore& getTextStore() const;
+
+    /**
+     * @brief Gets where this game's characters are.
+     */
+    const NpcSession& getNpcs() const;
+
+    /**
+     * @brief Gets what this game has changed of the world it plays.
+     */
+    const WorldOverlay& getOverlay() const;
+
+    /**
+     * @brief Searches the world's descriptions, dialogue and names.
+     * @return The best matches, best first; waits for the index if it is still being built.
+     */
+    std::vector<WorldSearch::Result> search(const std::string& query, std::size_t max_results = 10);
+
+    /**
+     * @brief Restores progress from a save file, if it exists, and saves to it after every turn.
+     * @return false if the file exists but could not be read; the game is then left as loaded.
+     */
+    bool enableAutosave(const std::string& save_file_path);
+
+    /**
+     * @brief Gets the player's progress with rooms and tools referred to by ID.
+     *
+     * Only tools this session has moved are listed; the others are where the world places them.
+     */
+    SaveState captureSaveState() const;
+
+    /**
+     * @brief Moves the player and the tools to where a save game left them.
+     */
+    void applySaveState(const SaveState& state);
+
 private:
-    void createWorld(const std::string& sql_file_path);
+    Game(std::shared_ptr<const SharedWorld> world, std::unique_ptr<Console> console, bool rendering_enabled);
+    void setUpPlayer();
+    struct RealTimeLink; // What the simulation and render threads share in real-time mode
+
     void gameLoop();
+    void realTimeLoop(); // Reads keys and draws frames; runs the simulation on another thread
+    void runSimulation(RealTimeLink& link);
+    void handleLine(std::string input_line);
+    bool runCommand(std::string input_line); // Returns false if the command ends the game
+    void advanceTurn(); // The world's side of a turn: scripts, characters and autosave
+    void collectDialogueOutput();
+    void setChallenge(const Challenge* challenge); // Keeps the count of sessions in a challenge up to date
     void processInput(const std::string& input);
+    void talk(const std::string& name); // Starts a conversation with a character in the current room
+    void takeTool(const std::string& name);
+    void dropTool(const std::string& name);
+    void showInventory();
+    void showMemoryStats();
+    void showSearchResults(const std::string& query);
+    void moveCharacters(); // Runs the characters' turn and reports who came and went
+    void placeOnMap(); // Puts the player on the first floor tile of the terrain
+    void stepOnMap(const std::string& direction); // Moves the player's map position one tile, unless a wall is in the way
+    Room* findRoom(int room_id) const;
     void printWelcomeMessage();
     void printHelp();
-    void loadDataFromCSV();
-    std::vector<std::string> getRoomInfoLines(); // Modified to return lines
-    std::vector<std::string> getSidePanelLines(); // Modified to return lines
-    void displayGameScreen(); // New function to display combined screen
+    const std::vector<std::string>& getRoomInfoLines(); // Rebuilt only after room_panel is marked dirty
+    const std::vector<std::string>& getSidePanelLines();
+    void fitToConsole(int console_width); // Sizes the game area for the terminal
+    void drawScreen(const std::vector<std::string>& room_lines, const std::vector<std::string>& side_panel_lines, int area_width);
+    void drawPrompt(); // Redraws the input line being edited
+    void appendWrapped(std::vector<std::string>& lines, const std::string& text) const; // Wraps to the game area
+
+    // Room renders depend only on room content, which changes only when a tool
+    // is taken or dropped, so they are built ahead of time for the rooms the
+    // player can move to.
+    std::vector<std::string> buildRoomLines(Room* room);
+    const std::vector<std::string>& roomLines(Room* room);
+    void schedulePrerender();
+    bool runIdleWork(); // Does one small step of queued background work, if any
+    void followWorldChanges(); // Drops renders that a change to the shared world's exits has made stale
 
     std::unique_ptr<Console> console; // Platform-agnostic console interface
+    std::shared_ptr<const SharedWorld> world; // Declared before everything that points into it
+    std::uint64_t world_version = 0; // The world's version when renders were last checked against it
+    WorldOverlay overlay; // This session's changes to the world: moved tools and characters, open exits, resolved challenges
     std::unique_ptr<Player> player; // The main player character
-    std::vector<std::unique_ptr<Room>> allRooms;
-    std::vector<std::unique_ptr<Player>> allPlayers;
-    std::vector<std::unique_ptr<GameSession>> allGameSessions;
-    std::vector<std::unique_ptr<Score>> allScores;
-    std::vector<std::unique_ptr<Character>> allCharacters;
-    std::vector<std::unique_ptr<Tool>> allTools;
-    std::vector<std::unique_ptr<RoomObject>> allRoomObjects;
+    NpcSession npcs; // Where this game's characters are, advanced once per turn
     bool gameOver;
-    std::unique_ptr<Challenge> current_challenge; // The currently active CBT challenge
+    const Challenge* current_challenge; // The currently active CBT challenge, held by the world
+
+    LineEditor lineEditor; // The command being typed, fed by Console::pollChar
+    int prompt_row; // Screen row of the input prompt
+    size_t prompt_drawn_length; // Length of the input last echoed, for erasing
+    std::unordered_map<const Room*, std::vector<std::string>> prerendered;
+    std::vector<Room*> prerender_queue; // Rooms waiting to be prerendered in idle time
+
+    std::vector<std::string> messages; // Shown under the room description for one turn
+    Panel room_panel; // Room view, messages and choices; marked dirty by anything that changes them
+    SidePanel side_panel;
+    TileMapView map_view{world->getTerrain()}; // Shown under the room when the world has terrain
+    FieldOfView sight; // What the player sees of the terrain and has explored; the rest of the map is fogged
+    int map_x = 0; // The player's position on the terrain
+    int map_y = 0;
+
+    bool rendering_enabled = true; // False for headless games
+    bool real_time = false;
+    std::uint64_t rng_seed = std::random_device{}();
+    std::mt19937_64 rng{rng_seed}; // All game randomness must come from here for replays to be deterministic
+    InputRecorder* recorder = nullptr;
+    std::unique_ptr<SaveFile> save_file; // Set when autosaving
+    std::map<int, int> moved_tools; // Where this session has put tools: tool_id -> room_id, or SaveState::CARRIED
+    std::uint64_t last_turn_allocations = 0;
+
+    // The game area shrinks from its full width when the terminal is too
+    // narrow for it and the side panel.
+    static constexpr int MAX_GAME_AREA_WIDTH = 60;
+    static constexpr int MIN_GAME_AREA_WIDTH = 20;
+    static constexpr int SIDE_PANEL_WIDTH = 40;
+    static constexpr int PANEL_GAP = 2; // Columns between the game area and the side panel
+    static constexpr int MAP_VIEW_HEIGHT = 9; // Terrain rows shown around the player
+    // Real-time mode: the simulation steps at 20 Hz, the world takes a turn
+    // every 20 steps, and the screen is redrawn at up to 60 Hz.
+    static constexpr std::chrono::milliseconds SIMULATION_STEP{50};
+    static constexpr std::uint32_t STEPS_PER_TURN = 20;
+    static constexpr std::chrono::milliseconds RENDER_INTERVAL{16};
+    static constexpr std::size_t MAX_REAL_TIME_MESSAGES = 6; // Older messages scroll away
+    int game_area_width = MAX_GAME_AREA_WIDTH;
+    // Wrapped room, character and dialogue text, keyed by owner and width.
+    // This is the session's cache of decoded text; misses decode from text_store.
+    TextLayoutCache layout;
+    DialogueExecutor dialogue; // Scripted conversations of this session; declared last so it is destroyed first
 };
 
 #endif // GAME_H
\ No newline at end of file
@@ -3,41 +3,149 @@
 #include "objects/Challenge.h" // Include Challenge.h
 #include "objects/Character.h"
 #include <iostream>
-#include <algorithm> // For std::remove
 
-Room::Room(const std::string& description) : description(description) {}
+Room::Room(const std::string& description) : id(0), description(description) {}
+
+Room::Room(int id, const std::string& description) : id(id), description(description) {}
 
 Room::~Room() = default;
 
-void Room::addExit(const std::string& direction, Room* room) {
-    exits[direction] = room;
+namespace {
+
+const std::map<std::string, Room*> NO_EXITS;
+
+} // namespace
+
+template <typename Change>
+void Room::changeExits(Change apply) {
+    if (!shared) {
+        if (!exits.get()) {
+            exits.publish(std::make_unique<Exits>());
+        }
+        apply(*exits.getUnpublished());
+        return;
+    }
+    const Exits* current = exits.get();
+    auto next = current ? std::make_unique<Exits>(*current) : std::make_unique<Exits>();
+    apply(*next);
+    exits.publish(std::move(next));
+}
+
+void Room::addExit(const std::string& direction, Room* room, int key_tool_id) {
+    changeExits([&](Exits& next) {
+        next.rooms[direction] = room;
+        if (key_tool_id > 0) {
+            next.keys[direction] = key_tool_id;
+        } else {
+            next.keys.erase(direction);
+        }
+    });
+}
+
+void Room::removeExit(const std::string& direction) {
+    const Exits* current = exits.get();
+    if (!current || current->rooms.count(direction) == 0) {
+        return;
+    }
+    changeExits([&](Exits& next) {
+        next.rooms.erase(direction);
+        next.keys.erase(direction);
+    });
 }
 
 Room* Room::getExit(const std::string& direction) {
-    if (exits.count(direction)) {
-        return exits[direction];
+    const Exits* current = exits.get();
+    if (!current) {
+        return nullptr;
+    }
+    auto it = current->rooms.find(direction);
+    return (it != current->rooms.end()) ? it->second : nullptr;
+}
+
+Room* Room::getExit(const std::string& direction, const DynamicBitset& tool_ids) {
+    // The exit and its key are read from the same version
+    const Exits* current = exits.get();
+    if (!current) {
+        return nullptr;
+    }
+    auto it = current->rooms.find(direction);
+    if (it == current->rooms.end()) {
+        return nullptr;
     }
-    return nullptr;
+    // Unlocked exits have key 0, which every player holds, so the lock check
+    // is the same bit test whether or not the exit is locked.
+    int key = 0;
+    if (!current->keys.empty()) {
+        auto key_it = current->keys.find(direction);
+        key = (key_it != current->keys.end()) ? key_it->second : 0;
+    }
+    return tool_ids.test(static_cast<std::size_t>(key)) ? it->second : nullptr;
+}
+
+int Room::getExitKey(const std::string& direction) const {
+    const Exits* current = exits.get();
+    if (!current || current->keys.empty()) {
+        return 0;
+    }
+    auto it = current->keys.find(direction);
+    return (it != current->keys.end()) ? it->second : 0;
+}
+
+int Room::getId() const {
+    return id;
 }
 
 std::string Room::getDescription() const {
-    return description;
+    return text_store ? text_store->get(description_id) : description;
 }
 
-void Room::addObject(RoomObject* object) {
-    objects.push_back(object);
+void Room::compressText(TextStore& store) {
+    if (text_store) {
+        return;
+    }
+    description_id = store.add(std::move(description));
+    description = std::string(); // Release the buffer
+    text_store = &store;
+}
+
+void Room::useText(const TextStore& store, TextId description_id) {
+    description = std::string();
+    this->description_id = description_id;
+    text_store = &store;
+}
+
+SlotHandle Room::addObject(RoomObject* object) {
+    SlotHandle slot = objects.insert(object);
+    object->setSlot(slot);
+    return slot;
 }
 
 void Room::removeObject(RoomObject* object) {
-    objects.erase(std::remove(objects.begin(), objects.end(), object), objects.end());
+    // The object's handle may belong to another room or an inventory, whose
+    // slot here can hold something else.
+    RoomObject* const* held = objects.get(object->getSlot());
+    if (held && *held == object) {
+        objects.erase(object->getSlot());
+        object->setSlot(SlotHandle());
+    }
+}
+
+RoomObject* Room::getObject(SlotHandle handle) const {
+    RoomObject* const* held = objects.get(handle);
+    return held ? *held : nullptr;
+}
+
+bool Room::hasObject(const RoomObject* object) const {
+    return getObject(object->getSlot()) == object;
 }
 
 const std::vector<RoomObject*>& Room::getObjects() const {
-    return objects;
+    return objects.getValues();
 }
 
 const std::map<std::string, Room*>& Room::getAllExits() const {
-    return exits;
+    const Exits* current = exits.get();
+    return current ? current->rooms : NO_EXITS;
 }
 
 void Room::setChallenge(std::unique_ptr<Challenge> challenge) {
@@ -49,17 +157,46 @@ Challenge* Room::getChallenge() const {
 }
 
 void Room::addCharacter(Character* character) {
-    characters.push_back(character);
+    character->setSlot(characters.insert(character));
+}
+
+void Room::removeCharacter(Character* character) {
+    Character* const* here = characters.get(character->getSlot());
+    if (here && *here == character) {
+        characters.erase(character->getSlot());
+        character->setSlot(SlotHandle());
+    }
+}
+
+bool Room::hasCharacter(const Character* character) const {
+    Character* const* here = characters.get(character->getSlot());
+    return here && *here == character;
 }
 
 const std::vector<Character*>& Room::getCharacters() const {
-    return characters;
+    return characters.getValues();
 }
 
 void Room::printExits() const {
     std::cout << "Available exits:";
-    for (auto const& [direction, room] : exits) {
+    for (auto const& [direction, room] : getAllExits()) {
         std::cout << " " << direction;
     }
     std::cout << std::endl;
 }
+
+std::uint32_t Room::getRegion() const {
+    return region;
+}
+
+void Room::setRegion(std::uint32_t region) {
+    this->region = region;
+}
+
+void Room::setShared(bool shared) {
+    this->shared = shared;
+}
+
+bool Room::isShared() const {
+    return shared;
+}
@@ -1,6 +1,7 @@
 #ifndef ROOM_H
 #define ROOM_H
 
+#include <cstdint>
 #include <string>
 #include <map>
 #include <vector>
@@ -8,6 +9,10 @@
 
 #include "objects/RoomObject.h"
 #include "objects/Challenge.h"
+#include "text/TextStore.h"
+#include "util/DynamicBitset.h"
+#include "containers/SlotMap.h"
+#include "concurrency/RcuPointer.h"
 
 // Forward declarations
 class Player;
@@ -20,6 +25,13 @@ class Character;
  *
  * This class stores details about a room, including its description and
  * the exits that connect it to other rooms.
+ *
+ * The exits are kept as one version that a change replaces whole. Until the
+ * room is shared a change edits that version in place; once it is shared
+ * (see setShared()), a change copies it and publishes the copy through an
+ * RcuPointer, so threads reading the room's exits within a ReadSection take
+ * no lock and keep a consistent version while it is replaced. Changes to a
+ * shared room's exits must still come from one thread at a time.
  */
 class Room {
 public:
@@ -28,28 +40,73 @@ public:
      * @param description A text description of the room.
      */
     Room(const std::string& description);
+
+    /**
+     * @brief Constructs a new Room object with the ID it has in the game data.
+     * @param id The room_id from the rooms table.
+     * @param description A text description of the room.
+     */
+    Room(int id, const std::string& description);
     ~Room(); // Destructor
 
+    /**
+     * @brief Gets the room's ID.
+     * @return The room_id from the game data, or 0 for rooms created without one.
+     */
+    int getId() const;
+
     /**
      * @brief Adds an exit to the room.
      * @param direction The direction of the exit (e.g., "north", "south").
      * @param room A pointer to the Room this exit leads to.
+     * @param key_tool_id The ID of the tool that unlocks the exit, or 0 if it is not locked.
+     */
+    void addExit(const std::string& direction, Room* room, int key_tool_id = 0);
+
+    /**
+     * @brief Removes an exit; nothing happens if there is none in that direction.
      */
-    void addExit(const std::string& direction, Room* room);
+    void removeExit(const std::string& direction);
 
     /**
-     * @brief Gets the room connected by an exit in a specific direction.
+     * @brief Gets the room connected by an exit in a specific direction, locked or not.
      * @param direction The direction to check for an exit.
      * @return A pointer to the connected Room, or nullptr if no exit exists.
      */
     Room* getExit(const std::string& direction);
 
+    /**
+     * @brief Gets the room connected by an exit if the given tools can pass it.
+     * @param direction The direction to check for an exit.
+     * @param tool_ids The IDs of the tools held, with bit 0 set (see Player::getToolBits()).
+     * @return A pointer to the connected Room, or nullptr if there is no exit or it is locked.
+     */
+    Room* getExit(const std::string& direction, const DynamicBitset& tool_ids);
+
+    /**
+     * @brief Gets the ID of the tool that unlocks an exit.
+     * @return The key's tool ID, or 0 if the exit is not locked or does not exist.
+     */
+    int getExitKey(const std::string& direction) const;
+
     /**
      * @brief Gets the description of the room.
      * @return The room's description string.
      */
     std::string getDescription() const;
 
+    /**
+     * @brief Moves the description into a TextStore, which must outlive the room.
+     *
+     * getDescription() then decodes it from the store on each call.
+     */
+    void compressText(TextStore& store);
+
+    /**
+     * @brief Reads the description from a TextStore that already holds it, which must outlive the room.
+     */
+    void useText(const TextStore& store, TextId description_id);
+
     /**
      * @brief Prints the available exits from this room to the console.
      */
@@ -58,33 +115,97 @@ public:
     /**
      * @brief Adds an object to the room.
      * @param object A pointer to the RoomObject to add.
+     * @return The object's handle in this room, which it also keeps (RoomObject::getSlot()).
      */
-    void addObject(RoomObject* object);
+    SlotHandle addObject(RoomObject* object);
 
     /**
-     * @brief Removes an object from the room.
-     * @param object A pointer to the RoomObject to remove.
+     * @brief Removes an object from the room in constant time.
+     * @param object A pointer to the RoomObject to remove; nothing happens if it is not in this room.
      */
     void removeObject(RoomObject* object);
 
+    /**
+     * @brief Gets an object in the room by handle.
+     * @return The object, or nullptr if it has left the room since the handle was issued.
+     */
+    RoomObject* getObject(SlotHandle handle) const;
+
+    /**
+     * @brief Checks in constant time whether an object is in the room, by its handle.
+     */
+    bool hasObject(const RoomObject* object) const;
+
     /**
      * @brief Gets all the objects in the room.
-     * @return A constant reference to the vector of objects in the room.
+     * @return A constant reference to the objects, whose order changes when one is removed.
      */
     const std::vector<RoomObject*>& getObjects() const;
-    const std::map<std::string, Room*>& getAllExits() const; // New function to get all exits
+
+    /**
+     * @brief Gets all the exits of the room's current version.
+     *
+     * Once the room is shared, the map is only valid within the ReadSection it was read in.
+     */
+    const std::map<std::string, Room*>& getAllExits() const;
     void setChallenge(std::unique_ptr<Challenge> challenge); // Set a challenge for this room
     Challenge* getChallenge() const; // Get the challenge for this room
 
+    /**
+     * @brief Adds a character to the room; the character keeps its handle here (RoomObject::getSlot()).
+     */
     void addCharacter(Character* character);
+
+    /**
+     * @brief Removes a character from the room in constant time; nothing happens if it is not here.
+     */
+    void removeCharacter(Character* character);
+
+    /**
+     * @brief Checks in constant time whether a character is in the room, by its handle.
+     */
+    bool hasCharacter(const Character* character) const;
+
+    /**
+     * @brief Gets the characters in the room, in an order that changes when one leaves.
+     */
     const std::vector<Character*>& getCharacters() const;
 
+    /**
+     * @brief Gets the region of the world the room is updated with (see NpcSystem::partition()).
+     */
+    std::uint32_t getRegion() const;
+    void setRegion(std::uint32_t region);
+
+    /**
+     * @brief Sets whether other threads may read the room while its exits change.
+     *
+     * Sharing makes each change to the exits copy them, which loading a world
+     * is spared by sharing its rooms only once they are all built.
+     */
+    void setShared(bool shared);
+    bool isShared() const;
+
 private:
+    // The exits as one version: readers of a shared room see both maps of the same one
+    struct Exits {
+        std::map<std::string, Room*> rooms;
+        std::map<std::string, int> keys; // Only the locked exits, usually none
+    };
+
+    template <typename Change>
+    void changeExits(Change apply); // In place until the room is shared, then by publishing a changed copy
+
+    int id;
     std::string description;
-    std::map<std::string, Room*> exits;
-    std::vector<RoomObject*> objects;
-    std::vector<Character*> characters;
+    const TextStore* text_store = nullptr; // Holds the description once compressed
+    TextId description_id = 0;
+    RcuPointer<Exits> exits; // Null until the first exit is added
+    SlotMap<RoomObject*> objects;
+    SlotMap<Character*> characters;
     std::unique_ptr<Challenge> room_challenge; // Optional challenge for the room
+    std::uint32_t region = 0;
+    bool shared = false;
 };
 
 #endif // ROOM_H
\ No newline at end of file
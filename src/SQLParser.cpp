@@ -0,0 +1,351 @@
+#include "SQLParser.h"
+#include <charconv>
+#include <cctype>
+
+namespace {
+
+char toLower(int c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+bool isWordChar(int c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+} // namespace
+
+int SQLValue::toInt(int fallback) const {
+    if (type != Type::Number && type != Type::String) {
+        return fallback;
+    }
+    int result = fallback;
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    if (first != last && *first == '+') {
+        ++first;
+    }
+    if (std::from_chars(first, last, result).ec != std::errc()) {
+        return fallback;
+    }
+    return result;
+}
+
+bool SQLValue::toBool() const {
+    if (type == Type::Boolean) {
+        return text == "true";
+    }
+    if (type == Type::Number) {
+        return toInt() != 0;
+    }
+    return false;
+}
+
+int SQLInsert::columnIndex(const std::string& name) const {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i] == name) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+SQLParser::SQLParser(std::istream& input)
+    : input(input), buffer(BUFFER_SIZE), pos(0), end(0), line(1), backslash_escapes(false), row_count(0) {}
+
+void SQLParser::setBackslashEscapes(bool enabled) {
+    backslash_escapes = enabled;
+}
+
+const std::string& SQLParser::getError() const {
+    return error;
+}
+
+std::size_t SQLParser::getRowCount() const {
+    return row_count;
+}
+
+bool SQLParser::refill() {
+    // Keep any unread bytes so that peekNext() can look across a buffer boundary
+    size_t remaining = end - pos;
+    for (size_t i = 0; i < remaining; ++i) {
+        buffer[i] = buffer[pos + i];
+    }
+    pos = 0;
+    end = remaining;
+    if (!input) {
+        return false;
+    }
+    input.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+    end += static_cast<std::size_t>(input.gcount());
+    return end > remaining;
+}
+
+int SQLParser::peek() {
+    if (pos == end && !refill()) {
+        return EOF;
+    }
+    return static_cast<unsigned char>(buffer[pos]);
+}
+
+int SQLParser::peekNext() {
+    if (end - pos < 2 && !refill()) {
+        return EOF;
+    }
+    return (end - pos < 2) ? EOF : static_cast<unsigned char>(buffer[pos + 1]);
+}
+
+int SQLParser::get() {
+    int c = peek();
+    if (c != EOF) {
+        ++pos;
+        if (c == '\n') {
+            ++line;
+        }
+    }
+    return c;
+}
+
+bool SQLParser::fail(const std::string& message) {
+    error = "line " + std::to_string(line) + ": " + message;
+    return false;
+}
+
+void SQLParser::skipWhitespaceAndComments() {
+    while (true) {
+        int c = peek();
+        if (c == EOF) {
+            return;
+        }
+        if (std::isspace(c)) {
+            get();
+        } else if (c == '-') {
+            // A lone '-' starts a negative number rather than a comment
+            if (peekNext() != '-') {
+                return;
+            }
+            while ((c = get()) != EOF && c != '\n') {}
+        } else if (c == '/') {
+            if (peekNext() != '*') {
+                return;
+            }
+            get();
+            get();
+            int prev = 0;
+            while ((c = get()) != EOF && !(prev == '*' && c == '/')) {
+                prev = c;
+            }
+        } else {
+            return;
+        }
+    }
+}
+
+bool SQLParser::readWord(std::string& out) {
+    out.clear();
+    while (isWordChar(peek())) {
+        out += toLower(get());
+    }
+    return !out.empty();
+}
+
+bool SQLParser::readQuoted(char quote, std::string& out) {
+    out.clear();
+    get(); // Opening quote
+    while (true) {
+        int c = get();
+        if (c == EOF) {
+            return fail("unterminated quoted literal");
+        }
+        if (c == quote) {
+            if (peek() != quote) {
+                return true;
+            }
+            get(); // Doubled quote is an escaped quote
+        } else if (c == '\\' && backslash_escapes && quote == '\'') {
+            c = get();
+            switch (c) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case '0': c = '\0'; break;
+                case EOF: return fail("unterminated quoted literal");
+                default: break;
+            }
+        }
+        out += static_cast<char>(c);
+    }
+}
+
+bool SQLParser::readIdentifier(std::string& out) {
+    // Accept plain, "double-quoted" and `backticked` names, keeping only the
+    // last part of a schema-qualified name such as public.rooms.
+    do {
+        skipWhitespaceAndComments();
+        int c = peek();
+        if (c == '"' || c == '`') {
+            if (!readQuoted(static_cast<char>(c), out)) {
+                return false;
+            }
+            for (char& ch : out) {
+                ch = toLower(static_cast<unsigned char>(ch));
+            }
+        } else if (!readWord(out)) {
+            return fail("expected identifier");
+        }
+        skipWhitespaceAndComments();
+    } while (peek() == '.' && get() == '.');
+    return true;
+}
+
+bool SQLParser::expect(char c) {
+    skipWhitespaceAndComments();
+    if (peek() != static_cast<unsigned char>(c)) {
+        return fail(std::string("expected '") + c + "'");
+    }
+    get();
+    return true;
+}
+
+bool SQLParser::expectKeyword(const char* keyword) {
+    skipWhitespaceAndComments();
+    if (!readWord(word) || word != keyword) {
+        return fail(std::string("expected ") + keyword);
+    }
+    return true;
+}
+
+bool SQLParser::skipStatement() {
+    while (true) {
+        int c = peek();
+        if (c == EOF || c == ';') {
+            get();
+            return true;
+        }
+        if (c == '\'' || c == '"' || c == '`') {
+            if (!readQuoted(static_cast<char>(c), word)) {
+                return false;
+            }
+        } else if (c == '-' || c == '/') {
+            size_t before = pos;
+            skipWhitespaceAndComments();
+            if (pos == before) {
+                get();
+            }
+        } else {
+            get();
+        }
+    }
+}
+
+bool SQLParser::parseValue(SQLValue& value) {
+    skipWhitespaceAndComments();
+    int c = peek();
+    if (c == '\'' || c == '"') {
+        value.type = SQLValue::Type::String;
+        return readQuoted(static_cast<char>(c), value.text);
+    }
+    value.text.clear();
+    if (c == '-' || c == '+' || c == '.' || std::isdigit(c)) {
+        value.type = SQLValue::Type::Number;
+        while ((c = peek()) != EOF && (std::isalnum(c) || c == '.' || c == '-' || c == '+')) {
+            value.text += static_cast<char>(get());
+        }
+        return true;
+    }
+    if (!readWord(value.text)) {
+        return fail("expected value");
+    }
+    if (value.text == "null") {
+        value.type = SQLValue::Type::Null;
+    } else if (value.text == "true" || value.text == "false") {
+        value.type = SQLValue::Type::Boolean;
+    } else {
+        return fail("unexpected keyword '" + value.text + "' in VALUES");
+    }
+    return true;
+}
+
+bool SQLParser::parseInsert(const InsertHandler& onInsert, const RowHandler& onRow) {
+    if (!expectKeyword("into") || !readIdentifier(insert.table)) {
+        return false;
+    }
+
+    insert.columns.clear();
+    if (peek() == '(') {
+        get();
+        do {
+            insert.columns.emplace_back();
+            if (!readIdentifier(insert.columns.back())) {
+                return false;
+            }
+        } while (peek() == ',' && get() == ',');
+        if (!expect(')')) {
+            return false;
+        }
+    }
+
+    if (!expectKeyword("values")) {
+        return false;
+    }
+    if (onInsert) {
+        onInsert(insert);
+    }
+
+    while (true) {
+        if (!expect('(')) {
+            return false;
+        }
+        size_t count = 0;
+        do {
+            if (count == values.size()) {
+                values.emplace_back();
+            }
+            if (!parseValue(values[count++])) {
+                return false;
+            }
+            skipWhitespaceAndComments();
+        } while (peek() == ',' && get() == ',');
+        if (!expect(')')) {
+            return false;
+        }
+
+        // Shrinking keeps the strings of the surviving values, so their
+        // capacity is reused by the next row.
+        values.resize(count);
+        ++row_count;
+        if (onRow) {
+            onRow(values);
+        }
+
+        skipWhitespaceAndComments();
+        int c = get();
+        if (c == ',') {
+            continue;
+        }
+        if (c == ';' || c == EOF) {
+            return true;
+        }
+        return fail("expected ',' or ';' after value list");
+    }
+}
+
+bool SQLParser::parse(const InsertHandler& onInsert, const RowHandler& onRow) {
+    error.clear();
+    while (true) {
+        skipWhitespaceAndComments();
+        if (peek() == EOF) {
+            return true;
+        }
+        if (!readWord(word)) {
+            // Stray punctuation outside any statement, such as an empty ';'
+            if (!skipStatement()) {
+                return false;
+            }
+            continue;
+        }
+        bool ok = (word == "insert") ? parseInsert(onInsert, onRow) : skipStatement();
+        if (!ok) {
+            return false;
+        }
+    }
+}
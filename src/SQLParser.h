@@ -0,0 +1,115 @@
+#ifndef SQL_PARSER_H
+#define SQL_PARSER_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <functional>
+#include <cstddef>
+
+/**
+ * @struct SQLValue
+ * @brief A single literal taken from a VALUES tuple.
+ *
+ * The text buffer is reused from row to row by the parser, so handlers must
+ * copy anything they want to keep.
+ */
+struct SQLValue {
+    enum class Type { Null, Number, String, Boolean };
+
+    Type type = Type::Null;
+    std::string text; // Unquoted contents for strings, the literal for numbers and booleans
+
+    bool isNull() const { return type == Type::Null; }
+    int toInt(int fallback = 0) const;
+    bool toBool() const;
+};
+
+/**
+ * @struct SQLInsert
+ * @brief The target of the INSERT statement currently being streamed.
+ */
+struct SQLInsert {
+    std::string table;                // Lowercased table name, without any schema prefix
+    std::vector<std::string> columns; // Lowercased column names, empty if the statement listed none
+
+    /**
+     * @brief Finds the position of a column in the value tuples.
+     * @param name The lowercased column name.
+     * @return The column index, or -1 if the statement does not list it.
+     */
+    int columnIndex(const std::string& name) const;
+};
+
+/**
+ * @class SQLParser
+ * @brief Streams the `INSERT INTO ... VALUES (...)` subset of SQL dumps.
+ *
+ * The input is read through a fixed-size buffer and every row is handed to
+ * the caller as soon as its closing parenthesis is seen, so memory use does
+ * not depend on the size of the dump. Statements other than INSERT (CREATE
+ * TABLE and friends) are skipped, as are `--` line comments and block comments.
+ */
+class SQLParser {
+public:
+    using InsertHandler = std::function<void(const SQLInsert&)>;
+    using RowHandler = std::function<void(const std::vector<SQLValue>&)>;
+
+    /**
+     * @brief Constructs a parser reading from the given stream.
+     * @param input The stream holding the SQL text.
+     */
+    explicit SQLParser(std::istream& input);
+
+    /**
+     * @brief Treats backslash escapes inside strings as MySQL-style escapes.
+     *
+     * Off by default, in which case only the standard `''` escape is recognised.
+     */
+    void setBackslashEscapes(bool enabled);
+
+    /**
+     * @brief Parses the whole stream.
+     * @param onInsert Called once at the start of every INSERT statement.
+     * @param onRow Called once for every value tuple of the current statement.
+     * @return true on success, false on a syntax error (see getError()).
+     */
+    bool parse(const InsertHandler& onInsert, const RowHandler& onRow);
+
+    const std::string& getError() const;
+    std::size_t getRowCount() const;
+
+private:
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+    int peek();
+    int peekNext();
+    int get();
+    bool refill();
+
+    void skipWhitespaceAndComments();
+    bool readWord(std::string& out);
+    bool readIdentifier(std::string& out);
+    bool readQuoted(char quote, std::string& out);
+    bool expect(char c);
+    bool expectKeyword(const char* keyword);
+    bool skipStatement();
+    bool parseInsert(const InsertHandler& onInsert, const RowHandler& onRow);
+    bool parseValue(SQLValue& value);
+    bool fail(const std::string& message);
+
+    std::istream& input;
+    std::vector<char> buffer;
+    std::size_t pos;
+    std::size_t end;
+    std::size_t line;
+    bool backslash_escapes;
+
+    SQLInsert insert;
+    std::vector<SQLValue> values; // Reused for every row
+    std::string word;
+    std::string error;
+    std::size_t row_count;
+};
+
+#endif // SQL_PARSER_H
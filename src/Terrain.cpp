@@ -0,0 +1,68 @@
+#include "Terrain.h"
+#include <algorithm>
+
+Terrain::Terrain() : width(0), height(0), stride(0), capacity_rows(0) {}
+
+void Terrain::reserve(int min_width, int min_height) {
+    if (min_width <= stride && min_height <= capacity_rows) {
+        return;
+    }
+    int new_stride = std::max(min_width, stride * 2);
+    int new_rows = std::max(min_height, capacity_rows * 2);
+    if (min_width <= stride) {
+        new_stride = stride; // Only rows are needed; avoid re-laying out columns
+    }
+    if (min_height <= capacity_rows) {
+        new_rows = capacity_rows;
+    }
+
+    std::vector<char> grown(static_cast<size_t>(new_stride) * new_rows, EMPTY_TILE);
+    for (int y = 0; y < height; ++y) {
+        std::copy_n(tiles.begin() + static_cast<size_t>(y) * stride, width,
+                    grown.begin() + static_cast<size_t>(y) * new_stride);
+    }
+    tiles.swap(grown);
+    opaque.reserve(new_stride, new_rows);
+    stride = new_stride;
+    capacity_rows = new_rows;
+}
+
+bool Terrain::setTile(int x, int y, char tile) {
+    if (x < 0 || y < 0) {
+        return false;
+    }
+    reserve(x + 1, y + 1);
+    width = std::max(width, x + 1);
+    height = std::max(height, y + 1);
+    tiles[static_cast<size_t>(y) * stride + x] = tile;
+    opaque.set(x, y, tile != FLOOR_TILE);
+    ++version;
+    return true;
+}
+
+char Terrain::getTile(int x, int y) const {
+    if (x < 0 || y < 0 || x >= width || y >= height) {
+        return EMPTY_TILE;
+    }
+    return tiles[static_cast<size_t>(y) * stride + x];
+}
+
+const BitGrid& Terrain::getOpacity() const {
+    return opaque;
+}
+
+std::uint64_t Terrain::getVersion() const {
+    return version;
+}
+
+int Terrain::getWidth() const {
+    return width;
+}
+
+int Terrain::getHeight() const {
+    return height;
+}
+
+bool Terrain::empty() const {
+    return width == 0 || height == 0;
+}
@@ -0,0 +1,66 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include <cstdint>
+#include <vector>
+#include "util/BitGrid.h"
+
+/**
+ * @class Terrain
+ * @brief A dense grid of terrain tiles ('#' for wall, '.' for floor).
+ *
+ * Tiles can be set in any order; the grid grows to fit the largest
+ * coordinates seen so far, which lets it be filled straight from a stream of
+ * (x_coord, y_coord, tile_type) rows without knowing the map size up front.
+ *
+ * Alongside the tiles the terrain keeps a bit per tile saying whether it
+ * blocks sight; only floor tiles let light through. It is kept up to date by
+ * setTile, so line of sight never has to look at the tiles themselves.
+ */
+class Terrain {
+public:
+    static constexpr char EMPTY_TILE = ' ';
+    static constexpr char FLOOR_TILE = '.';
+    static constexpr char WALL_TILE = '#';
+
+    Terrain();
+
+    /**
+     * @brief Sets the tile at a position, growing the grid if needed.
+     * @return false if the coordinates are negative.
+     */
+    bool setTile(int x, int y, char tile);
+
+    /**
+     * @brief Gets the tile at a position.
+     * @return The tile, or EMPTY_TILE if the position is outside the grid.
+     */
+    char getTile(int x, int y) const;
+
+    /**
+     * @brief Gets the bit grid of tiles that block sight, set outside the map too.
+     */
+    const BitGrid& getOpacity() const;
+
+    /**
+     * @brief Gets a number that changes whenever a tile does.
+     */
+    std::uint64_t getVersion() const;
+
+    int getWidth() const;
+    int getHeight() const;
+    bool empty() const;
+
+private:
+    void reserve(int min_width, int min_height);
+
+    int width;           // Logical size, one past the largest coordinate set
+    int height;
+    int stride;          // Allocated row length, grown geometrically
+    int capacity_rows;
+    std::vector<char> tiles; // Row-major, stride * capacity_rows
+    BitGrid opaque{true};    // Grown with tiles, so it is stride * capacity_rows too
+    std::uint64_t version = 0;
+};
+
+#endif // TERRAIN_H
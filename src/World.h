@@ -0,0 +1,27 @@
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <memory>
+#include <vector>
+#include "Room.h"
+#include "objects/Character.h"
+#include "objects/Tool.h"
+#include "objects/RoomObject.h"
+#include "players/Player.h"
+
+/**
+ * @struct World
+ * @brief The content of a game world, built outside Game and handed to it whole.
+ *
+ * Rooms must already be linked by their exits and characters added to their
+ * rooms. Tools are placed in their initial rooms by the Game.
+ */
+struct World {
+    std::vector<std::unique_ptr<Room>> rooms;
+    std::vector<std::unique_ptr<Character>> characters;
+    std::vector<std::unique_ptr<Tool>> tools;
+    std::vector<std::unique_ptr<RoomObject>> room_objects;
+    std::vector<std::unique_ptr<Player>> players; // The first is the one played
+};
+
+#endif // WORLD_H
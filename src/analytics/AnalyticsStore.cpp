@@ -0,0 +1,349 @@
+#include "AnalyticsStore.h"
+#include "Kernels.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+// Rows handled per step when a report needs a key column of its own, so the
+// keys it builds stay in cache until the aggregation reads them.
+constexpr std::size_t CHUNK_ROWS = 4096;
+
+// IDs spanning at most this many values are grouped through a table indexed
+// by ID; wider ranges fall back to a hash map.
+constexpr std::uint64_t MAX_DENSE_KEYS = std::uint64_t{1} << 24;
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    contents.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0, std::ios::beg);
+    file.read(contents.data(), static_cast<std::streamsize>(contents.size()));
+    return static_cast<bool>(file);
+}
+
+// Reads an integer followed by the expected separator, moving past both
+bool readField(const char*& next, const char* end, char separator, std::int32_t& value) {
+    auto [stop, error] = std::from_chars(next, end, value);
+    if (error != std::errc() || stop == end || *stop != separator) {
+        return false;
+    }
+    next = stop + 1;
+    return true;
+}
+
+// Splits a line on commas outside quotes, dropping the quotes around a field
+std::vector<std::string_view> splitFields(std::string_view line) {
+    std::vector<std::string_view> fields;
+    std::size_t start = 0;
+    bool quoted = false;
+    for (std::size_t i = 0; i <= line.size(); ++i) {
+        if (i < line.size() && line[i] == '"') {
+            quoted = !quoted;
+        } else if (i == line.size() || (line[i] == ',' && !quoted)) {
+            std::string_view field = line.substr(start, i - start);
+            if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
+                field = field.substr(1, field.size() - 2);
+            }
+            fields.push_back(field);
+            start = i + 1;
+        }
+    }
+    return fields;
+}
+
+// Days from 1970-01-01 to a date in the proleptic Gregorian calendar
+std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+    unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<std::int64_t>(day_of_era) - 719468;
+}
+
+AnalyticsStore::GroupStats toStats(std::int64_t sum, std::uint64_t count) {
+    AnalyticsStore::GroupStats stats;
+    stats.sum = sum;
+    stats.count = count;
+    return stats;
+}
+
+} // namespace
+
+bool AnalyticsStore::parseTimestamp(std::string_view text, std::int64_t& seconds) {
+    // YYYY-MM-DD HH:MM:SS
+    static constexpr std::string_view FORM = "0000-00-00 00:00:00";
+    if (text.size() != FORM.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < FORM.size(); ++i) {
+        bool digit = text[i] >= '0' && text[i] <= '9';
+        if (FORM[i] == '0' ? !digit : text[i] != FORM[i]) {
+            return false;
+        }
+    }
+    auto number = [text](std::size_t at, std::size_t length) {
+        unsigned value = 0;
+        for (std::size_t i = at; i < at + length; ++i) {
+            value = value * 10 + static_cast<unsigned>(text[i] - '0');
+        }
+        return value;
+    };
+    unsigned year = number(0, 4), month = number(5, 2), day = number(8, 2);
+    unsigned hour = number(11, 2), minute = number(14, 2), second = number(17, 2);
+    static constexpr unsigned DAYS_IN_MONTH[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (month < 1 || month > 12 || day < 1 || day > DAYS_IN_MONTH[month - 1] ||
+        (month == 2 && day == 29 && !leap) || hour > 23 || minute > 59 || second > 59) {
+        return false;
+    }
+    seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+bool AnalyticsStore::addSession(std::int32_t session_id, std::string_view game_type, std::string_view start_time,
+                                std::string_view end_time) {
+    std::int64_t start = 0;
+    std::int64_t end = 0;
+    if (!parseTimestamp(start_time, start) || !parseTimestamp(end_time, end)) {
+        return false;
+    }
+    auto [entry, added] = game_type_codes_by_name.try_emplace(std::string(game_type),
+                                                              static_cast<std::uint32_t>(game_types.size()));
+    if (added) {
+        game_types.emplace_back(game_type);
+    }
+    session_ids.push_back(session_id);
+    game_type_codes.push_back(entry->second);
+    start_times.push_back(start);
+    end_times.push_back(end);
+    return true;
+}
+
+void AnalyticsStore::addScore(std::int32_t score_id, std::int32_t player_id, std::int32_t session_id,
+                              std::int32_t score) {
+    score_ids.push_back(score_id);
+    player_ids.push_back(player_id);
+    score_session_ids.push_back(session_id);
+    scores.push_back(score);
+}
+
+void AnalyticsStore::reserveScores(std::size_t count) {
+    score_ids.reserve(count);
+    player_ids.reserve(count);
+    score_session_ids.reserve(count);
+    scores.reserve(count);
+}
+
+bool AnalyticsStore::loadCSV(const std::string& directory) {
+    std::string text;
+    if (!readFile(directory + "/game_sessions.csv", text)) {
+        std::cerr << "Error: Could not read " << directory << "/game_sessions.csv" << std::endl;
+        return false;
+    }
+    std::size_t line_number = 0;
+    std::size_t start = 0;
+    while (start < text.size()) {
+        std::size_t end = std::min(text.find('\n', start), text.size());
+        std::string_view line(text.data() + start, end - start);
+        start = end + 1;
+        if (++line_number == 1 || line.empty() || line == "\r") {
+            continue; // The header, or a blank line
+        }
+        if (line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        std::vector<std::string_view> fields = splitFields(line);
+        std::int32_t session_id = 0;
+        if (fields.size() != 4 ||
+            std::from_chars(fields[0].data(), fields[0].data() + fields[0].size(), session_id).ec != std::errc() ||
+            !addSession(session_id, fields[1], fields[2], fields[3])) {
+            std::cerr << "Error: game_sessions.csv line " << line_number
+                      << " is not session_id,game_type,start_time,end_time" << std::endl;
+            return false;
+        }
+    }
+
+    if (!readFile(directory + "/scores.csv", text)) {
+        std::cerr << "Error: Could not read " << directory << "/scores.csv" << std::endl;
+        return false;
+    }
+    reserveScores(getScoreCount() + static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')));
+    // The scores file can run to gigabytes, so its fields are read in place
+    // rather than split into strings
+    const char* next = text.data();
+    const char* end = text.data() + text.size();
+    next = std::find(next, end, '\n');
+    next += next != end;
+    line_number = 1;
+    while (next != end) {
+        ++line_number;
+        if (*next == '\n' || *next == '\r') {
+            next = std::find(next, end, '\n');
+            next += next != end;
+            continue;
+        }
+        std::int32_t score_id, player_id, session_id, score;
+        if (!readField(next, end, ',', score_id) || !readField(next, end, ',', player_id) ||
+            !readField(next, end, ',', session_id)) {
+            std::cerr << "Error: scores.csv line " << line_number << " is not score_id,player_id,session_id,score"
+                      << std::endl;
+            return false;
+        }
+        auto [stop, error] = std::from_chars(next, end, score);
+        if (stop != end && *stop == '\r') {
+            ++stop;
+        }
+        if (error != std::errc() || (stop != end && *stop != '\n')) {
+            std::cerr << "Error: scores.csv line " << line_number << " is not score_id,player_id,session_id,score"
+                      << std::endl;
+            return false;
+        }
+        addScore(score_id, player_id, session_id, score);
+        next = stop + (stop != end);
+    }
+    return true;
+}
+
+std::size_t AnalyticsStore::getScoreCount() const {
+    return scores.size();
+}
+
+std::size_t AnalyticsStore::getSessionCount() const {
+    return session_ids.size();
+}
+
+const std::vector<std::string>& AnalyticsStore::getGameTypes() const {
+    return game_types;
+}
+
+AnalyticsStore::GroupStats AnalyticsStore::totalScore() const {
+    return toStats(AnalyticsKernels::sum(scores.data(), scores.size()), scores.size());
+}
+
+std::vector<AnalyticsStore::GroupStats> AnalyticsStore::scoreByGameType() const {
+    // One group per game type, and one more for scores of unknown sessions
+    std::size_t type_count = game_types.size();
+    std::vector<std::int64_t> sums(type_count + 1, 0);
+    std::vector<std::uint64_t> counts(type_count + 1, 0);
+
+    std::int32_t low = 0, high = 0;
+    AnalyticsKernels::minMax(session_ids.data(), session_ids.size(), low, high);
+    std::uint64_t span = static_cast<std::uint64_t>(std::int64_t{high} - low) + 1;
+    if (session_ids.empty() || scores.empty()) {
+        // Nothing to group
+    } else if (span <= MAX_DENSE_KEYS) {
+        // Turn session IDs into game types by table lookup, a chunk at a
+        // time, then total each chunk by type
+        std::vector<std::uint32_t> type_of(span + 1, static_cast<std::uint32_t>(type_count));
+        for (std::size_t i = 0; i < session_ids.size(); ++i) {
+            type_of[session_ids[i] - low] = game_type_codes[i];
+        }
+        std::vector<std::uint32_t> offsets(CHUNK_ROWS);
+        std::vector<std::uint32_t> keys(CHUNK_ROWS);
+        for (std::size_t start = 0; start < scores.size(); start += CHUNK_ROWS) {
+            std::size_t rows = std::min(CHUNK_ROWS, scores.size() - start);
+            const std::int32_t* sessions = score_session_ids.data() + start;
+            for (std::size_t i = 0; i < rows; ++i) {
+                std::int64_t offset = std::int64_t{sessions[i]} - low;
+                offsets[i] = offset >= 0 && static_cast<std::uint64_t>(offset) < span
+                                 ? static_cast<std::uint32_t>(offset)
+                                 : static_cast<std::uint32_t>(span);
+            }
+            AnalyticsKernels::gather(type_of.data(), offsets.data(), rows, keys.data());
+            AnalyticsKernels::groupSum(keys.data(), scores.data() + start, rows, type_count + 1, sums.data(),
+                                       counts.data());
+        }
+    } else {
+        std::unordered_map<std::int32_t, std::uint32_t> type_of;
+        for (std::size_t i = 0; i < session_ids.size(); ++i) {
+            type_of[session_ids[i]] = game_type_codes[i];
+        }
+        for (std::size_t i = 0; i < scores.size(); ++i) {
+            auto found = type_of.find(score_session_ids[i]);
+            std::uint32_t type = found != type_of.end() ? found->second : static_cast<std::uint32_t>(type_count);
+            sums[type] += scores[i];
+            ++counts[type];
+        }
+    }
+
+    std::vector<GroupStats> by_type;
+    for (std::size_t type = 0; type < type_count; ++type) {
+        by_type.push_back(toStats(sums[type], counts[type]));
+    }
+    return by_type;
+}
+
+std::vector<std::pair<std::int32_t, AnalyticsStore::GroupStats>> AnalyticsStore::scoreByPlayer() const {
+    std::vector<std::pair<std::int32_t, GroupStats>> by_player;
+    if (scores.empty()) {
+        return by_player;
+    }
+    std::int32_t low = 0, high = 0;
+    AnalyticsKernels::minMax(player_ids.data(), player_ids.size(), low, high);
+    std::uint64_t span = static_cast<std::uint64_t>(std::int64_t{high} - low) + 1;
+    if (span <= MAX_DENSE_KEYS) {
+        std::vector<std::int64_t> sums(span, 0);
+        std::vector<std::uint64_t> counts(span, 0);
+        std::vector<std::uint32_t> keys(CHUNK_ROWS);
+        for (std::size_t start = 0; start < scores.size(); start += CHUNK_ROWS) {
+            std::size_t rows = std::min(CHUNK_ROWS, scores.size() - start);
+            const std::int32_t* players = player_ids.data() + start;
+            for (std::size_t i = 0; i < rows; ++i) {
+                keys[i] = static_cast<std::uint32_t>(players[i] - low);
+            }
+            AnalyticsKernels::groupSum(keys.data(), scores.data() + start, rows, span, sums.data(), counts.data());
+        }
+        for (std::size_t key = 0; key < span; ++key) {
+            if (counts[key]) {
+                by_player.emplace_back(static_cast<std::int32_t>(low + static_cast<std::int64_t>(key)),
+                                       toStats(sums[key], counts[key]));
+            }
+        }
+    } else {
+        std::unordered_map<std::int32_t, GroupStats> totals;
+        for (std::size_t i = 0; i < scores.size(); ++i) {
+            GroupStats& stats = totals[player_ids[i]];
+            stats.sum += scores[i];
+            ++stats.count;
+        }
+        by_player.assign(totals.begin(), totals.end());
+        std::sort(by_player.begin(), by_player.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+    return by_player;
+}
+
+bool AnalyticsStore::scorePercentile(double percent, std::int32_t& score) const {
+    if (scores.empty() || !(percent >= 0.0 && percent <= 100.0)) {
+        return false;
+    }
+    // Nearest rank: the smallest score with at least percent% of scores at or below it
+    std::size_t rank = static_cast<std::size_t>(std::ceil(percent / 100.0 * static_cast<double>(scores.size())));
+    rank = std::clamp<std::size_t>(rank, 1, scores.size());
+    score = AnalyticsKernels::select(scores.data(), scores.size(), rank - 1);
+    return true;
+}
+
+std::vector<std::int64_t> AnalyticsStore::sessionDurations() const {
+    std::vector<std::int64_t> durations(session_ids.size());
+    AnalyticsKernels::subtract(end_times.data(), start_times.data(), durations.size(), durations.data());
+    return durations;
+}
+
+std::vector<AnalyticsStore::GroupStats> AnalyticsStore::durationByGameType() const {
+    std::vector<GroupStats> by_type(game_types.size());
+    std::vector<std::int64_t> durations = sessionDurations();
+    for (std::size_t i = 0; i < durations.size(); ++i) {
+        by_type[game_type_codes[i]].sum += durations[i];
+        ++by_type[game_type_codes[i]].count;
+    }
+    return by_type;
+}
@@ -0,0 +1,116 @@
+#ifndef ANALYTICS_STORE_H
+#define ANALYTICS_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class AnalyticsStore
+ * @brief The scores and game sessions tables held column by column, for reports.
+ *
+ * Every column is a plain array of fixed-width values, so a report reads
+ * only the columns it needs, front to back, through AnalyticsKernels.
+ * Session game types are stored as small integer codes into a dictionary of
+ * the distinct names, and start and end times as seconds since 1970-01-01
+ * (the times in the data carry no zone, and are treated as UTC).
+ *
+ * Reports are computed on demand and cost one or two passes over the
+ * columns involved; nothing is cached between them.
+ */
+class AnalyticsStore {
+public:
+    /**
+     * @brief A sum and the number of values in it.
+     */
+    struct GroupStats {
+        std::int64_t sum = 0;
+        std::uint64_t count = 0;
+
+        double average() const { return count ? static_cast<double>(sum) / static_cast<double>(count) : 0.0; }
+    };
+
+    /**
+     * @brief Reads a time written as "YYYY-MM-DD HH:MM:SS".
+     * @return false if the text is not a valid time in that form.
+     */
+    static bool parseTimestamp(std::string_view text, std::int64_t& seconds);
+
+    /**
+     * @brief Adds a session.
+     * @return false if either time cannot be read; nothing is added.
+     */
+    bool addSession(std::int32_t session_id, std::string_view game_type, std::string_view start_time,
+                    std::string_view end_time);
+
+    void addScore(std::int32_t score_id, std::int32_t player_id, std::int32_t session_id, std::int32_t score);
+    void reserveScores(std::size_t count);
+
+    /**
+     * @brief Adds the sessions and scores in a directory's game_sessions.csv and scores.csv.
+     * @return false if a file is missing or a line cannot be read.
+     */
+    bool loadCSV(const std::string& directory);
+
+    std::size_t getScoreCount() const;
+    std::size_t getSessionCount() const;
+
+    /**
+     * @brief Gets the distinct game types; a type's position is its code.
+     */
+    const std::vector<std::string>& getGameTypes() const;
+
+    GroupStats totalScore() const;
+
+    /**
+     * @brief Totals the scores by the game type of their session, indexed by game type code.
+     *
+     * Scores whose session is not in the store are left out.
+     */
+    std::vector<GroupStats> scoreByGameType() const;
+
+    /**
+     * @brief Totals the scores of each player, in order of player ID.
+     */
+    std::vector<std::pair<std::int32_t, GroupStats>> scoreByPlayer() const;
+
+    /**
+     * @brief Finds the score at a percentile, by the nearest-rank method.
+     * @param percent From 0 to 100; 50 is the median.
+     * @return false if there are no scores or percent is out of range.
+     */
+    bool scorePercentile(double percent, std::int32_t& score) const;
+
+    /**
+     * @brief Computes each session's length in seconds, in the order the sessions were added.
+     */
+    std::vector<std::int64_t> sessionDurations() const;
+
+    /**
+     * @brief Totals the session lengths in seconds by game type, indexed by game type code.
+     */
+    std::vector<GroupStats> durationByGameType() const;
+
+private:
+    // Scores
+    std::vector<std::int32_t> score_ids;
+    std::vector<std::int32_t> player_ids;
+    std::vector<std::int32_t> score_session_ids;
+    std::vector<std::int32_t> scores;
+
+    // Sessions
+    std::vector<std::int32_t> session_ids;
+    std::vector<std::uint32_t> game_type_codes;
+    std::vector<std::int64_t> start_times;
+    std::vector<std::int64_t> end_times;
+
+    // Game type dictionary
+    std::vector<std::string> game_types;
+    std::unordered_map<std::string, std::uint32_t> game_type_codes_by_name;
+};
+
+#endif // ANALYTICS_STORE_H
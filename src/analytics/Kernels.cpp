@@ -0,0 +1,279 @@
+#include "Kernels.h"
+#include <algorithm>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ANALYTICS_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ANALYTICS_SSE2 1
+#endif
+
+namespace {
+
+#if ANALYTICS_AVX2 || ANALYTICS_SSE2
+// At most this many groups are summed with vector compares, one pass over a
+// block per group; beyond it a scattered add per row is cheaper.
+constexpr std::size_t MAX_VECTOR_GROUPS = 8;
+
+// Rows per block when summing by group, small enough to stay in L1 cache
+// across one pass per group
+constexpr std::size_t GROUP_BLOCK_ROWS = 4096;
+#endif
+
+#if ANALYTICS_AVX2
+std::int64_t horizontalSum(__m256i lanes) {
+    alignas(32) std::int64_t parts[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(parts), lanes);
+    return parts[0] + parts[1] + parts[2] + parts[3];
+}
+
+// Adds eight 32-bit values to four 64-bit lanes
+__m256i addWidened(__m256i acc, __m256i values) {
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(values)));
+    return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(values, 1)));
+}
+#elif ANALYTICS_SSE2
+std::int64_t horizontalSum(__m128i lanes) {
+    alignas(16) std::int64_t parts[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(parts), lanes);
+    return parts[0] + parts[1];
+}
+
+// Adds four 32-bit values to two 64-bit lanes; SSE2 has no sign-extending load
+__m128i addWidened(__m128i acc, __m128i values) {
+    __m128i sign = _mm_srai_epi32(values, 31);
+    acc = _mm_add_epi64(acc, _mm_unpacklo_epi32(values, sign));
+    return _mm_add_epi64(acc, _mm_unpackhi_epi32(values, sign));
+}
+#endif
+
+#if ANALYTICS_AVX2 || ANALYTICS_SSE2
+// Sums one block of rows for each of a few groups
+void groupSumBlock(const std::uint32_t* keys, const std::int32_t* values, std::size_t count,
+                   std::size_t group_count, std::int64_t* sums, std::uint64_t* counts) {
+    for (std::size_t group = 0; group < group_count; ++group) {
+        std::size_t i = 0;
+        std::int64_t sum = 0;
+        std::uint64_t matched = 0;
+#if ANALYTICS_AVX2
+        __m256i key = _mm256_set1_epi32(static_cast<int>(group));
+        __m256i sum_lanes = _mm256_setzero_si256();
+        __m256i count_lanes = _mm256_setzero_si256();
+        for (; i + 8 <= count; i += 8) {
+            __m256i mask = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), key);
+            __m256i selected = _mm256_and_si256(mask, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+            sum_lanes = addWidened(sum_lanes, selected);
+            count_lanes = _mm256_sub_epi32(count_lanes, mask); // A match is -1
+        }
+        sum = horizontalSum(sum_lanes);
+        alignas(32) std::uint32_t lane_counts[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lane_counts), count_lanes);
+        for (std::uint32_t lane : lane_counts) {
+            matched += lane;
+        }
+#elif ANALYTICS_SSE2
+        __m128i key = _mm_set1_epi32(static_cast<int>(group));
+        __m128i sum_lanes = _mm_setzero_si128();
+        __m128i count_lanes = _mm_setzero_si128();
+        for (; i + 4 <= count; i += 4) {
+            __m128i mask = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), key);
+            __m128i selected = _mm_and_si128(mask, _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)));
+            sum_lanes = addWidened(sum_lanes, selected);
+            count_lanes = _mm_sub_epi32(count_lanes, mask); // A match is -1
+        }
+        sum = horizontalSum(sum_lanes);
+        alignas(16) std::uint32_t lane_counts[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lane_counts), count_lanes);
+        for (std::uint32_t lane : lane_counts) {
+            matched += lane;
+        }
+#endif
+        for (; i < count; ++i) {
+            if (keys[i] == group) {
+                sum += values[i];
+                ++matched;
+            }
+        }
+        sums[group] += sum;
+        counts[group] += matched;
+    }
+}
+#endif
+
+} // namespace
+
+namespace AnalyticsKernels {
+
+const char* getInstructionSet() {
+#if ANALYTICS_AVX2
+    return "avx2";
+#elif ANALYTICS_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+std::int64_t sum(const std::int32_t* values, std::size_t count) {
+    std::size_t i = 0;
+    std::int64_t total = 0;
+#if ANALYTICS_AVX2
+    // Two accumulators keep two additions in flight
+    __m256i a = _mm256_setzero_si256();
+    __m256i b = _mm256_setzero_si256();
+    for (; i + 16 <= count; i += 16) {
+        a = addWidened(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+        b = addWidened(b, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i + 8)));
+    }
+    total = horizontalSum(_mm256_add_epi64(a, b));
+#elif ANALYTICS_SSE2
+    __m128i a = _mm_setzero_si128();
+    __m128i b = _mm_setzero_si128();
+    for (; i + 8 <= count; i += 8) {
+        a = addWidened(a, _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)));
+        b = addWidened(b, _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i + 4)));
+    }
+    total = horizontalSum(_mm_add_epi64(a, b));
+#endif
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+void minMax(const std::int32_t* values, std::size_t count, std::int32_t& min, std::int32_t& max) {
+    if (count == 0) {
+        return;
+    }
+    std::int32_t low = values[0];
+    std::int32_t high = values[0];
+    std::size_t i = 0;
+#if ANALYTICS_AVX2
+    if (count >= 8) {
+        __m256i lows = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+        __m256i highs = lows;
+        for (i = 8; i + 8 <= count; i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+            lows = _mm256_min_epi32(lows, v);
+            highs = _mm256_max_epi32(highs, v);
+        }
+        alignas(32) std::int32_t lane_lows[8], lane_highs[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lane_lows), lows);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lane_highs), highs);
+        for (int lane = 0; lane < 8; ++lane) {
+            low = lane_lows[lane] < low ? lane_lows[lane] : low;
+            high = lane_highs[lane] > high ? lane_highs[lane] : high;
+        }
+    }
+#elif ANALYTICS_SSE2
+    if (count >= 4) {
+        // SSE2 has no 32-bit min or max; select with a compare mask instead
+        __m128i lows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+        __m128i highs = lows;
+        for (i = 4; i + 4 <= count; i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+            __m128i below = _mm_cmplt_epi32(v, lows);
+            lows = _mm_or_si128(_mm_and_si128(below, v), _mm_andnot_si128(below, lows));
+            __m128i above = _mm_cmpgt_epi32(v, highs);
+            highs = _mm_or_si128(_mm_and_si128(above, v), _mm_andnot_si128(above, highs));
+        }
+        alignas(16) std::int32_t lane_lows[4], lane_highs[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lane_lows), lows);
+        _mm_store_si128(reinterpret_cast<__m128i*>(lane_highs), highs);
+        for (int lane = 0; lane < 4; ++lane) {
+            low = lane_lows[lane] < low ? lane_lows[lane] : low;
+            high = lane_highs[lane] > high ? lane_highs[lane] : high;
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        low = values[i] < low ? values[i] : low;
+        high = values[i] > high ? values[i] : high;
+    }
+    min = low;
+    max = high;
+}
+
+void groupSum(const std::uint32_t* keys, const std::int32_t* values, std::size_t count,
+              std::size_t group_count, std::int64_t* sums, std::uint64_t* counts) {
+#if ANALYTICS_AVX2 || ANALYTICS_SSE2
+    if (group_count <= MAX_VECTOR_GROUPS) {
+        for (std::size_t start = 0; start < count; start += GROUP_BLOCK_ROWS) {
+            std::size_t rows = count - start < GROUP_BLOCK_ROWS ? count - start : GROUP_BLOCK_ROWS;
+            groupSumBlock(keys + start, values + start, rows, group_count, sums, counts);
+        }
+        return;
+    }
+#else
+    static_cast<void>(group_count); // Only the vector paths need it
+#endif
+    for (std::size_t i = 0; i < count; ++i) {
+        sums[keys[i]] += values[i];
+        ++counts[keys[i]];
+    }
+}
+
+void subtract(const std::int64_t* to, const std::int64_t* from, std::size_t count, std::int64_t* out) {
+    std::size_t i = 0;
+#if ANALYTICS_AVX2
+    for (; i + 4 <= count; i += 4) {
+        __m256i difference = _mm256_sub_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(to + i)),
+                                              _mm256_loadu_si256(reinterpret_cast<const __m256i*>(from + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), difference);
+    }
+#elif ANALYTICS_SSE2
+    for (; i + 2 <= count; i += 2) {
+        __m128i difference = _mm_sub_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(to + i)),
+                                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), difference);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = to[i] - from[i];
+    }
+}
+
+void gather(const std::uint32_t* table, const std::uint32_t* index, std::size_t count, std::uint32_t* out) {
+    std::size_t i = 0;
+#if ANALYTICS_AVX2
+    for (; i + 8 <= count; i += 8) {
+        __m256i indices = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+        __m256i looked_up = _mm256_i32gather_epi32(reinterpret_cast<const int*>(table), indices, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), looked_up);
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = table[index[i]];
+    }
+}
+
+std::int32_t select(const std::int32_t* values, std::size_t count, std::size_t rank) {
+    // Flipping the sign bit makes unsigned order match signed order
+    auto ordered = [](std::int32_t value) { return static_cast<std::uint32_t>(value) ^ 0x80000000u; };
+
+    std::vector<std::uint64_t> histogram(1 << 16, 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        ++histogram[ordered(values[i]) >> 16];
+    }
+    std::uint32_t high = 0;
+    while (rank >= histogram[high]) {
+        rank -= histogram[high++];
+    }
+
+    std::fill(histogram.begin(), histogram.end(), 0);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t key = ordered(values[i]);
+        if ((key >> 16) == high) {
+            ++histogram[key & 0xFFFF];
+        }
+    }
+    std::uint32_t low = 0;
+    while (rank >= histogram[low]) {
+        rank -= histogram[low++];
+    }
+    return static_cast<std::int32_t>(((high << 16) | low) ^ 0x80000000u);
+}
+
+} // namespace AnalyticsKernels
@@ -0,0 +1,66 @@
+#ifndef ANALYTICS_KERNELS_H
+#define ANALYTICS_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @namespace AnalyticsKernels
+ * @brief Tight loops over plain column arrays, the building blocks of AnalyticsStore's reports.
+ *
+ * Each kernel makes one or two sequential passes over its inputs. Where the
+ * target supports it (AVX2, or SSE2 on any x86-64) the inner loops work on
+ * several values per instruction; elsewhere they fall back to plain loops.
+ * Build with -march=native (or -mavx2) to get the AVX2 versions.
+ */
+namespace AnalyticsKernels {
+
+    /**
+     * @brief Gets the name of the instruction set the kernels were built for: "avx2", "sse2" or "scalar".
+     */
+    const char* getInstructionSet();
+
+    /**
+     * @brief Adds up values, in 64 bits so that the total cannot overflow.
+     */
+    std::int64_t sum(const std::int32_t* values, std::size_t count);
+
+    /**
+     * @brief Finds the smallest and largest value; leaves min and max untouched if count is 0.
+     */
+    void minMax(const std::int32_t* values, std::size_t count, std::int32_t& min, std::int32_t& max);
+
+    /**
+     * @brief Adds each value to the sum and count of its group.
+     *
+     * Groups are numbered densely: keys[i] must be below group_count. sums and
+     * counts have group_count entries each and are added to, not overwritten.
+     * A handful of groups (such as game types) are summed with vector compares;
+     * more groups take one scattered add per row.
+     */
+    void groupSum(const std::uint32_t* keys, const std::int32_t* values, std::size_t count,
+                  std::size_t group_count, std::int64_t* sums, std::uint64_t* counts);
+
+    /**
+     * @brief Computes out[i] = to[i] - from[i], such as session end minus start times.
+     */
+    void subtract(const std::int64_t* to, const std::int64_t* from, std::size_t count, std::int64_t* out);
+
+    /**
+     * @brief Computes out[i] = table[index[i]], replacing each row's key with a value looked up per key.
+     */
+    void gather(const std::uint32_t* table, const std::uint32_t* index, std::size_t count, std::uint32_t* out);
+
+    /**
+     * @brief Finds the value that would be at a rank (0-based) if the values were sorted.
+     *
+     * Runs in two counting passes over the data, one for the top 16 bits of
+     * each value and one for the bottom 16 bits of the values that share the
+     * answer's top bits, without copying or reordering anything.
+     * @param rank Must be below count.
+     */
+    std::int32_t select(const std::int32_t* values, std::size_t count, std::size_t rank);
+
+} // namespace AnalyticsKernels
+
+#endif // ANALYTICS_KERNELS_H
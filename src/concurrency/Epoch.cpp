@@ -0,0 +1,162 @@
+#include "Epoch.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// One per thread that has read, on a list that only grows. A thread that
+// exits hands its record back for the next new thread to take over.
+struct alignas(64) ReaderRecord {
+    std::atomic<std::uint64_t> epoch{0}; // The epoch the thread's open section entered, or 0 if none is open
+    std::atomic<bool> in_use{false};
+    ReaderRecord* next = nullptr;
+};
+
+struct Retired {
+    std::uint64_t epoch;
+    void* object;
+    void (*destroy)(void*);
+};
+
+std::atomic<std::uint64_t> global_epoch{1};
+std::atomic<ReaderRecord*> readers{nullptr};
+std::mutex retired_mutex; // Held by writers while they advance the epoch or touch retired
+std::vector<Retired> retired;
+
+ReaderRecord* takeRecord() {
+    for (ReaderRecord* record = readers.load(std::memory_order_acquire); record; record = record->next) {
+        bool in_use = false;
+        if (record->in_use.compare_exchange_strong(in_use, true)) {
+            return record;
+        }
+    }
+    ReaderRecord* record = new ReaderRecord(); // Never freed, as other threads may be scanning the list
+    record->in_use.store(true, std::memory_order_relaxed);
+    record->next = readers.load(std::memory_order_relaxed);
+    while (!readers.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return record;
+}
+
+struct ThreadReader {
+    ReaderRecord* record = nullptr;
+    unsigned depth = 0; // Open sections, counting nested ones
+
+    ~ThreadReader() {
+        if (record) {
+            record->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadReader this_thread_reader;
+
+// Moves the epoch on if every open section has entered the current one.
+// Called with retired_mutex held, so only one thread advances at a time.
+void tryAdvance() {
+    // Pairs with the fence in ReadSection(): either this scan sees a reader's
+    // epoch, or the reader sees every pointer replaced before the scan.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::uint64_t epoch = global_epoch.load(std::memory_order_relaxed);
+    for (ReaderRecord* record = readers.load(std::memory_order_acquire); record; record = record->next) {
+        std::uint64_t entered = record->epoch.load(std::memory_order_relaxed);
+        if (entered != 0 && entered != epoch) {
+            return;
+        }
+    }
+    global_epoch.store(epoch + 1, std::memory_order_seq_cst);
+}
+
+// Takes out what was retired two or more epochs ago, for freeing once the lock is released
+std::vector<Retired> takeFreeable() {
+    std::uint64_t epoch = global_epoch.load(std::memory_order_relaxed);
+    std::vector<Retired> freeable;
+    auto kept = retired.begin();
+    for (Retired& entry : retired) {
+        if (entry.epoch + 2 <= epoch) {
+            freeable.push_back(entry);
+        } else {
+            *kept++ = entry;
+        }
+    }
+    retired.erase(kept, retired.end());
+    return freeable;
+}
+
+void destroyAll(const std::vector<Retired>& freeable) {
+    for (const Retired& entry : freeable) {
+        entry.destroy(entry.object);
+    }
+}
+
+} // namespace
+
+ReadSection::ReadSection() {
+    ThreadReader& reader = this_thread_reader;
+    if (reader.depth++ > 0) {
+        return;
+    }
+    if (!reader.record) {
+        reader.record = takeRecord();
+    }
+    reader.record->epoch.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+ReadSection::~ReadSection() {
+    ThreadReader& reader = this_thread_reader;
+    if (--reader.depth == 0) {
+        reader.record->epoch.store(0, std::memory_order_release);
+    }
+}
+
+namespace Epoch {
+
+void retire(void* object, void (*destroy)(void*)) {
+    std::vector<Retired> freeable;
+    {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        retired.push_back({global_epoch.load(std::memory_order_seq_cst), object, destroy});
+        tryAdvance();
+        freeable = takeFreeable();
+    }
+    destroyAll(freeable);
+}
+
+bool synchronize() {
+    if (this_thread_reader.depth > 0) {
+        std::cerr << "Error: Epoch::synchronize() called from within a ReadSection" << std::endl;
+        return false;
+    }
+    std::uint64_t target = global_epoch.load(std::memory_order_seq_cst) + 2;
+    while (true) {
+        std::vector<Retired> freeable;
+        bool done;
+        {
+            std::lock_guard<std::mutex> lock(retired_mutex);
+            tryAdvance();
+            done = global_epoch.load(std::memory_order_relaxed) >= target;
+            freeable = takeFreeable();
+        }
+        destroyAll(freeable);
+        if (done) {
+            return true;
+        }
+        std::this_thread::yield();
+    }
+}
+
+std::size_t getPendingCount() {
+    std::lock_guard<std::mutex> lock(retired_mutex);
+    return retired.size();
+}
+
+std::uint64_t getCurrent() {
+    return global_epoch.load(std::memory_order_relaxed);
+}
+
+} // namespace Epoch
@@ -0,0 +1,62 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class ReadSection
+ * @brief Lets the current thread read data published through RcuPointer until it goes out of scope.
+ *
+ * Entering a section records the current epoch for the thread and leaving
+ * clears it; neither takes a lock or waits. Anything a writer replaces while
+ * the section is open stays allocated until the section closes, so pointers
+ * and references read inside it may be used until then. Sections nest, and
+ * work the thread hands to other threads and waits for within its section,
+ * such as a WorkStealingScheduler batch, is covered by it too.
+ */
+class ReadSection {
+public:
+    ReadSection();
+    ~ReadSection();
+
+    ReadSection(const ReadSection&) = delete;
+    ReadSection& operator=(const ReadSection&) = delete;
+};
+
+/**
+ * @namespace Epoch
+ * @brief Epoch-based reclamation of data that readers may still be using when a writer replaces it.
+ *
+ * A replaced object is retired with the epoch it was retired in. The epoch
+ * moves on once every thread in a ReadSection has entered it, and an object
+ * is freed after the epoch has moved on twice since it was retired, by when
+ * no section that could have read it is still open. The work is done by
+ * writers, in retire() and synchronize(); readers only announce themselves.
+ */
+namespace Epoch {
+    /**
+     * @brief Frees an object with destroy() once no reader can still hold it.
+     *
+     * The object must already be unreachable for new readers. Objects whose
+     * time has come are freed by this call or a later one.
+     */
+    void retire(void* object, void (*destroy)(void*));
+
+    /**
+     * @brief Waits for every section open now to close and frees everything retired before the call.
+     *
+     * Must not be called from within a ReadSection, which it would wait for forever.
+     * @return false, having done nothing, if called from within a ReadSection.
+     */
+    bool synchronize();
+
+    /**
+     * @brief Gets the number of retired objects not yet freed.
+     */
+    std::size_t getPendingCount();
+
+    std::uint64_t getCurrent();
+} // namespace Epoch
+
+#endif // EPOCH_H
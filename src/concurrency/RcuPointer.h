@@ -0,0 +1,68 @@
+#ifndef RCU_POINTER_H
+#define RCU_POINTER_H
+
+#include <atomic>
+#include <memory>
+#include "Epoch.h"
+
+/**
+ * @class RcuPointer
+ * @brief Owns the current version of an object that threads read while it is replaced (read-copy-update).
+ *
+ * Readers load the pointer with one atomic read and use the version they got
+ * for as long as their ReadSection is open. A writer copies the current
+ * version, changes the copy and publishes it; the swap is a single atomic
+ * store, so a reader sees the old version or the new one and never a mix,
+ * and the old version is retired to Epoch rather than freed at once.
+ *
+ * Writers must be serialised with each other, as each one starts from the
+ * version the last one published.
+ *
+ * @tparam T The object type; versions are never changed once published.
+ */
+template <typename T>
+class RcuPointer {
+public:
+    RcuPointer() = default;
+    explicit RcuPointer(std::unique_ptr<T> initial) : current(initial.release()) {}
+
+    /**
+     * @brief Frees the current version; no thread may still be reading it.
+     */
+    ~RcuPointer() {
+        delete current.load(std::memory_order_relaxed);
+    }
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    /**
+     * @brief Gets the current version, or nullptr if none has been published.
+     */
+    const T* get() const {
+        return current.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Replaces the current version, retiring the old one.
+     */
+    void publish(std::unique_ptr<T> next) {
+        T* old = current.exchange(next.release(), std::memory_order_acq_rel);
+        if (old) {
+            Epoch::retire(old, [](void* object) { delete static_cast<T*>(object); });
+        }
+    }
+
+    /**
+     * @brief Gets the current version to change in place, which is only safe
+     *        while no other thread can be reading it.
+     */
+    T* getUnpublished() {
+        return current.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<T*> current{nullptr};
+};
+
+#endif // RCU_POINTER_H
@@ -0,0 +1,136 @@
+#include "WorkStealingScheduler.h"
+#include <algorithm>
+
+WorkStealingScheduler::WorkStealingScheduler(std::size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (std::size_t i = 0; i < threads; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    for (std::size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(&WorkStealingScheduler::workerLoop, this, i);
+    }
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkStealingScheduler::run(std::size_t task_count, const std::function<void(std::size_t)>& task) {
+    std::lock_guard<std::mutex> lock(batch_mutex);
+    runBatch(task_count, task);
+}
+
+bool WorkStealingScheduler::tryRun(std::size_t task_count, const std::function<void(std::size_t)>& task) {
+    std::unique_lock<std::mutex> lock(batch_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return false;
+    }
+    runBatch(task_count, task);
+    return true;
+}
+
+void WorkStealingScheduler::runBatch(std::size_t task_count, const std::function<void(std::size_t)>& task) {
+    if (task_count == 0) {
+        return;
+    }
+    if (workers.empty()) {
+        for (std::size_t i = 0; i < task_count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    // Deal each thread a contiguous run of tasks
+    std::size_t threads = queues.size();
+    for (std::size_t i = 0; i < threads; ++i) {
+        std::lock_guard<std::mutex> lock(queues[i]->mutex);
+        for (std::size_t t = task_count * i / threads; t < task_count * (i + 1) / threads; ++t) {
+            queues[i]->tasks.push_back(t);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &task;
+        busy_workers = workers.size();
+        ++batch;
+    }
+    wake.notify_all();
+
+    work(0);
+
+    // The task must outlive every worker's last look at it
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busy_workers == 0; });
+    job = nullptr;
+}
+
+std::size_t WorkStealingScheduler::getThreadCount() const {
+    return queues.size();
+}
+
+std::uint64_t WorkStealingScheduler::getStealCount() const {
+    return steals.load(std::memory_order_relaxed);
+}
+
+void WorkStealingScheduler::workerLoop(std::size_t self) {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || batch != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = batch;
+        }
+        work(self);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy_workers == 0) {
+                finished.notify_one();
+            }
+        }
+    }
+}
+
+void WorkStealingScheduler::work(std::size_t self) {
+    std::size_t task;
+    while (pop(self, task) || steal(self, task)) {
+        (*job)(task);
+    }
+}
+
+bool WorkStealingScheduler::pop(std::size_t self, std::size_t& task) {
+    Queue& queue = *queues[self];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = queue.tasks.front();
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingScheduler::steal(std::size_t self, std::size_t& task) {
+    // Start with the next thread along, so thieves spread over different victims
+    for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+        Queue& victim = *queues[(self + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.back();
+            victim.tasks.pop_back();
+            steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
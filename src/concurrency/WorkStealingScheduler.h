@@ -0,0 +1,88 @@
+#ifndef WORK_STEALING_SCHEDULER_H
+#define WORK_STEALING_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkStealingScheduler
+ * @brief A pool of threads that runs batches of numbered tasks, balancing them by stealing.
+ *
+ * Each batch is dealt out as contiguous runs of task numbers, one run per
+ * thread, so neighbouring tasks (such as neighbouring regions of the world)
+ * start on the same thread. A thread works through its own queue from the
+ * front; once that is empty it takes tasks from the back of another thread's
+ * queue, so a thread that drew cheap tasks helps with the rest instead of
+ * waiting. The calling thread takes part in every batch.
+ *
+ * Tasks of a batch must not depend on the order they run in. Anything that
+ * does, such as combining their results, belongs after run() returns.
+ *
+ * One scheduler can serve several threads, such as many sessions sharing a
+ * world; their batches run one at a time.
+ */
+class WorkStealingScheduler {
+public:
+    /**
+     * @param threads Threads to use, counting the caller; 0 uses every hardware thread.
+     */
+    explicit WorkStealingScheduler(std::size_t threads = 0);
+    ~WorkStealingScheduler();
+
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    /**
+     * @brief Runs task(0) to task(task_count - 1) and waits for them all to finish.
+     */
+    void run(std::size_t task_count, const std::function<void(std::size_t)>& task);
+
+    /**
+     * @brief Runs a batch as run() does, unless another thread's batch is running.
+     * @return false, having run nothing, if the threads were busy.
+     */
+    bool tryRun(std::size_t task_count, const std::function<void(std::size_t)>& task);
+
+    std::size_t getThreadCount() const;
+
+    /**
+     * @brief Gets how many tasks have run on a thread other than the one they were dealt to.
+     */
+    std::uint64_t getStealCount() const;
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+    };
+
+    void runBatch(std::size_t task_count, const std::function<void(std::size_t)>& task); // Called with batch_mutex held
+    void workerLoop(std::size_t self);
+    void work(std::size_t self); // Runs tasks until no queue has any left
+    bool pop(std::size_t self, std::size_t& task);
+    bool steal(std::size_t self, std::size_t& task);
+
+    std::vector<std::unique_ptr<Queue>> queues; // One per thread; the caller's is queues[0]
+    std::vector<std::thread> workers;
+
+    std::mutex batch_mutex;             // Held by the thread whose batch is running
+    std::mutex mutex;                   // Guards the fields below, which start and finish batches
+    std::condition_variable wake;       // Signals workers that a batch has started
+    std::condition_variable finished;   // Signals the caller that every worker has left the batch
+    const std::function<void(std::size_t)>* job = nullptr;
+    std::uint64_t batch = 0;
+    std::size_t busy_workers = 0;
+    bool stopping = false;
+
+    std::atomic<std::uint64_t> steals{0};
+};
+
+#endif // WORK_STEALING_SCHEDULER_H
@@ -0,0 +1,131 @@
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief A reference to a value in a SlotMap that stays valid until that value is erased.
+ *
+ * A default-constructed handle refers to nothing.
+ */
+struct SlotHandle {
+    static constexpr std::uint32_t NONE = 0xFFFFFFFF;
+
+    std::uint32_t index = NONE;
+    std::uint32_t generation = 0;
+
+    bool isNull() const { return index == NONE; }
+    bool operator==(const SlotHandle& other) const = default;
+};
+
+/**
+ * @class SlotMap
+ * @brief An unordered container with O(1) insert, erase and lookup through stable handles.
+ *
+ * Values are kept back to back for fast iteration. Erasing moves the last
+ * value into the gap, so iteration order changes but no handle does. Each
+ * slot counts how many times it has been emptied, and a handle carries the
+ * count from when it was issued, so a handle to an erased value is detected
+ * as stale even after its slot has been reused.
+ */
+template <typename T>
+class SlotMap {
+public:
+    SlotHandle insert(T value) {
+        std::uint32_t index;
+        if (free_head != SlotHandle::NONE) {
+            index = free_head;
+            free_head = slots[index].position; // Free slots chain through position
+        } else {
+            index = static_cast<std::uint32_t>(slots.size());
+            slots.push_back({0, 0});
+        }
+        slots[index].position = static_cast<std::uint32_t>(values.size());
+        values.push_back(std::move(value));
+        value_slots.push_back(index);
+        return {index, slots[index].generation};
+    }
+
+    /**
+     * @brief Removes a value.
+     * @return false if the handle is stale or null.
+     */
+    bool erase(SlotHandle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+        eraseAt(slots[handle.index].position);
+        return true;
+    }
+
+    /**
+     * @brief Removes the value at a position in values().
+     */
+    void eraseAt(std::size_t position) {
+        std::uint32_t index = value_slots[position];
+        if (position + 1 != values.size()) {
+            values[position] = std::move(values.back());
+            value_slots[position] = value_slots.back();
+            slots[value_slots[position]].position = static_cast<std::uint32_t>(position);
+        }
+        values.pop_back();
+        value_slots.pop_back();
+
+        ++slots[index].generation; // Invalidates every handle issued for this slot
+        slots[index].position = free_head;
+        free_head = index;
+    }
+
+    /**
+     * @return The value, or nullptr if the handle is stale or null.
+     */
+    T* get(SlotHandle handle) {
+        return contains(handle) ? &values[slots[handle.index].position] : nullptr;
+    }
+
+    const T* get(SlotHandle handle) const {
+        return contains(handle) ? &values[slots[handle.index].position] : nullptr;
+    }
+
+    bool contains(SlotHandle handle) const {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+               isLive(handle.index);
+    }
+
+    /**
+     * @brief Gets the handle of the value at a position in values().
+     */
+    SlotHandle handleAt(std::size_t position) const {
+        std::uint32_t index = value_slots[position];
+        return {index, slots[index].generation};
+    }
+
+    /**
+     * @brief Gets every value, in no particular order.
+     */
+    const std::vector<T>& getValues() const { return values; }
+
+    std::size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+
+private:
+    struct Slot {
+        std::uint32_t position;   // Index into values while live, next free slot while free
+        std::uint32_t generation; // Times the slot has been emptied
+    };
+
+    bool isLive(std::uint32_t index) const {
+        std::uint32_t position = slots[index].position;
+        return position < value_slots.size() && value_slots[position] == index;
+    }
+
+    std::vector<Slot> slots;
+    std::vector<T> values;
+    std::vector<std::uint32_t> value_slots; // Slot of each value, for moving the last value on erase
+    std::uint32_t free_head = SlotHandle::NONE;
+};
+
+#endif // SLOT_MAP_H
@@ -0,0 +1,74 @@
+#include "Dialogue.h"
+#include "DialogueExecutor.h"
+#include "FramePool.h"
+#include <utility>
+
+void* Dialogue::promise_type::operator new(std::size_t size) {
+    return FramePool::allocate(size);
+}
+
+void Dialogue::promise_type::operator delete(void* frame, std::size_t size) noexcept {
+    FramePool::deallocate(frame, size);
+}
+
+Dialogue::Dialogue(Dialogue&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+Dialogue& Dialogue::operator=(Dialogue&& other) noexcept {
+    if (this != &other) {
+        if (handle) {
+            handle.destroy();
+        }
+        handle = std::exchange(other.handle, nullptr);
+    }
+    return *this;
+}
+
+Dialogue::~Dialogue() {
+    if (handle) {
+        handle.destroy();
+    }
+}
+
+std::coroutine_handle<> Dialogue::FinalAwaiter::await_suspend(Handle finished) noexcept {
+    promise_type& promise = finished.promise();
+    if (promise.continuation) {
+        return promise.continuation; // Resume the script that awaited this one
+    }
+    if (promise.executor) {
+        promise.executor->finished(finished);
+    }
+    return std::noop_coroutine();
+}
+
+std::coroutine_handle<> Dialogue::SubDialogueAwaiter::await_suspend(Handle caller) noexcept {
+    handle.promise().executor = caller.promise().executor;
+    handle.promise().continuation = caller;
+    return handle; // Start the sub-conversation straight away
+}
+
+void ChoiceAwaiter::await_suspend(Dialogue::Handle script) {
+    handle = script;
+    script.promise().executor->choice_waits.push_back({script, &options});
+}
+
+void TurnsAwaiter::await_suspend(Dialogue::Handle script) {
+    DialogueExecutor* executor = script.promise().executor;
+    executor->sleepers.push({executor->turn + static_cast<std::uint64_t>(count), executor->sleep_order++, script});
+}
+
+bool SayAwaiter::await_suspend(Dialogue::Handle script) {
+    script.promise().executor->output.push_back(std::move(text));
+    return false; // Carry straight on
+}
+
+ChoiceAwaiter player_choice(std::vector<std::string> options) {
+    return {std::move(options), nullptr};
+}
+
+TurnsAwaiter turns(int count) {
+    return {count};
+}
+
+SayAwaiter say(std::string text) {
+    return {std::move(text)};
+}
@@ -0,0 +1,136 @@
+#ifndef DIALOGUE_H
+#define DIALOGUE_H
+
+#include <coroutine>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class DialogueExecutor;
+
+/**
+ * @class Dialogue
+ * @brief A scripted conversation or encounter written as a C++20 coroutine.
+ *
+ * A script is any function returning Dialogue that uses the awaitables
+ * below:
+ *
+ *     Dialogue greet() {
+ *         co_await say("Hello.");
+ *         int choice = co_await player_choice("Wave", "Walk away");
+ *         co_await turns(3);
+ *         co_await say(choice == 0 ? "They wave back." : "They watch you go.");
+ *     }
+ *
+ * Scripts start suspended and are run by a DialogueExecutor. A suspended
+ * conversation costs only its coroutine frame, which comes from FramePool,
+ * plus a handle in the executor's queues. Awaiting another Dialogue runs it
+ * as a sub-conversation and resumes the caller when it finishes.
+ */
+class Dialogue {
+public:
+    struct promise_type;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(Handle finished) noexcept;
+        void await_resume() const noexcept {}
+    };
+
+    struct promise_type {
+        DialogueExecutor* executor = nullptr;
+        std::coroutine_handle<> continuation; // The script awaiting this one, if any
+        std::size_t slot = 0;                 // Position in the executor's list of conversations
+        int choice = -1;                      // Answer to the last player_choice()
+
+        Dialogue get_return_object() noexcept { return Dialogue(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const { throw; }
+
+        static void* operator new(std::size_t size);
+        static void operator delete(void* frame, std::size_t size) noexcept;
+    };
+
+    struct SubDialogueAwaiter {
+        Handle handle;
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+        std::coroutine_handle<> await_suspend(Handle caller) noexcept;
+        void await_resume() const noexcept {}
+    };
+
+    Dialogue() noexcept = default;
+    Dialogue(Dialogue&& other) noexcept;
+    Dialogue& operator=(Dialogue&& other) noexcept;
+    Dialogue(const Dialogue&) = delete;
+    Dialogue& operator=(const Dialogue&) = delete;
+    ~Dialogue();
+
+    explicit operator bool() const noexcept { return static_cast<bool>(handle); }
+
+    /**
+     * @brief Runs this script as a sub-conversation of the awaiting script.
+     */
+    SubDialogueAwaiter operator co_await() && noexcept { return {handle}; }
+
+private:
+    explicit Dialogue(Handle handle) noexcept : handle(handle) {}
+
+    Handle handle;
+
+    friend class DialogueExecutor;
+};
+
+/**
+ * @brief Awaitable that suspends the script until the player picks one of the options.
+ *
+ * The options are shown numbered from 1; `co_await` yields the zero-based
+ * index of the chosen option.
+ */
+struct ChoiceAwaiter {
+    std::vector<std::string> options; // Lives in the coroutine frame while suspended
+    Dialogue::Handle handle;
+
+    bool await_ready() const noexcept { return options.empty(); }
+    void await_suspend(Dialogue::Handle script);
+    int await_resume() const noexcept { return handle ? handle.promise().choice : -1; }
+};
+
+/**
+ * @brief Awaitable that suspends the script for a number of game turns.
+ */
+struct TurnsAwaiter {
+    int count;
+
+    bool await_ready() const noexcept { return count <= 0; }
+    void await_suspend(Dialogue::Handle script);
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Awaitable that shows a line of text to the player without suspending.
+ */
+struct SayAwaiter {
+    std::string text;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(Dialogue::Handle script);
+    void await_resume() const noexcept {}
+};
+
+ChoiceAwaiter player_choice(std::vector<std::string> options);
+
+/**
+ * @brief Offers a fixed list of options, e.g. `co_await player_choice("Yes", "No")`.
+ */
+template <typename... Options>
+ChoiceAwaiter player_choice(const std::string& first, const Options&... rest) {
+    return player_choice(std::vector<std::string>{first, std::string(rest)...});
+}
+
+TurnsAwaiter turns(int count);
+SayAwaiter say(std::string text);
+
+#endif // DIALOGUE_H
@@ -0,0 +1,81 @@
+#include "DialogueExecutor.h"
+#include <utility>
+
+DialogueExecutor::~DialogueExecutor() {
+    // Destroying the root frames also destroys any sub-conversations they await
+    conversations.clear();
+}
+
+void DialogueExecutor::start(Dialogue script) {
+    if (!script) {
+        return;
+    }
+    Dialogue::Handle handle = script.handle;
+    handle.promise().executor = this;
+    handle.promise().slot = conversations.size();
+    conversations.push_back(std::move(script));
+    run(handle);
+}
+
+void DialogueExecutor::run(std::coroutine_handle<> handle) {
+    handle.resume();
+
+    // Conversations that reached their end are destroyed here rather than in
+    // their final awaiter, once nothing is executing inside them.
+    for (Dialogue::Handle root : finished_roots) {
+        std::size_t slot = root.promise().slot;
+        if (slot + 1 != conversations.size()) {
+            conversations[slot] = std::move(conversations.back());
+            conversations[slot].handle.promise().slot = slot;
+        }
+        conversations.pop_back();
+    }
+    finished_roots.clear();
+}
+
+void DialogueExecutor::finished(Dialogue::Handle root) {
+    finished_roots.push_back(root);
+}
+
+bool DialogueExecutor::isAwaitingChoice() const {
+    return !choice_waits.empty();
+}
+
+const std::vector<std::string>& DialogueExecutor::getChoices() const {
+    static const std::vector<std::string> none;
+    return choice_waits.empty() ? none : *choice_waits.back().options;
+}
+
+bool DialogueExecutor::choose(std::size_t index) {
+    if (choice_waits.empty() || index >= choice_waits.back().options->size()) {
+        return false;
+    }
+    Dialogue::Handle handle = choice_waits.back().handle;
+    choice_waits.pop_back();
+    handle.promise().choice = static_cast<int>(index);
+    run(handle);
+    return true;
+}
+
+void DialogueExecutor::advanceTurn() {
+    ++turn;
+    while (!sleepers.empty() && sleepers.top().wake_turn <= turn) {
+        std::coroutine_handle<> handle = sleepers.top().handle;
+        sleepers.pop();
+        run(handle);
+    }
+}
+
+std::vector<std::string> DialogueExecutor::takeOutput() {
+    std::vector<std::string> lines;
+    lines.swap(output);
+    return lines;
+}
+
+std::size_t DialogueExecutor::getActiveCount() const {
+    return conversations.size();
+}
+
+std::uint64_t DialogueExecutor::getTurn() const {
+    return turn;
+}
@@ -0,0 +1,100 @@
+#ifndef DIALOGUE_EXECUTOR_H
+#define DIALOGUE_EXECUTOR_H
+
+#include "Dialogue.h"
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+/**
+ * @class DialogueExecutor
+ * @brief Schedules the Dialogue coroutines of one game session.
+ *
+ * Conversations run on the caller's thread whenever the session starts one,
+ * answers a choice or advances a turn; there is no thread per conversation.
+ * Any number of conversations may be suspended at once. The one that most
+ * recently asked for a choice is the one the player answers.
+ */
+class DialogueExecutor {
+public:
+    DialogueExecutor() = default;
+    DialogueExecutor(const DialogueExecutor&) = delete;
+    DialogueExecutor& operator=(const DialogueExecutor&) = delete;
+
+    /**
+     * @brief Destroys every conversation that is still suspended.
+     */
+    ~DialogueExecutor();
+
+    /**
+     * @brief Takes ownership of a script and runs it until it first suspends.
+     */
+    void start(Dialogue script);
+
+    /**
+     * @brief Checks whether a conversation is waiting for the player to choose.
+     */
+    bool isAwaitingChoice() const;
+
+    /**
+     * @brief Gets the options of the conversation waiting for the player.
+     * @return The options, or an empty list if no conversation is waiting.
+     */
+    const std::vector<std::string>& getChoices() const;
+
+    /**
+     * @brief Answers the waiting conversation and runs it until it suspends again.
+     * @param index The zero-based index of the chosen option.
+     * @return false if no conversation is waiting or the index is out of range.
+     */
+    bool choose(std::size_t index);
+
+    /**
+     * @brief Advances the turn counter and resumes every script whose wait is over.
+     */
+    void advanceTurn();
+
+    /**
+     * @brief Removes and returns the lines said since the last call.
+     */
+    std::vector<std::string> takeOutput();
+
+    std::size_t getActiveCount() const;
+    std::uint64_t getTurn() const;
+
+private:
+    friend struct Dialogue::FinalAwaiter;
+    friend struct ChoiceAwaiter;
+    friend struct TurnsAwaiter;
+    friend struct SayAwaiter;
+
+    struct Sleeper {
+        std::uint64_t wake_turn;
+        std::uint64_t order; // Keeps scripts waking on the same turn in FIFO order
+        std::coroutine_handle<> handle;
+
+        bool operator>(const Sleeper& other) const {
+            return wake_turn != other.wake_turn ? wake_turn > other.wake_turn : order > other.order;
+        }
+    };
+
+    struct ChoiceWait {
+        Dialogue::Handle handle;
+        const std::vector<std::string>* options; // Owned by the awaiter in the coroutine frame
+    };
+
+    void run(std::coroutine_handle<> handle);
+    void finished(Dialogue::Handle root);
+
+    std::vector<Dialogue> conversations; // Root scripts, indexed by promise_type::slot
+    std::vector<ChoiceWait> choice_waits;
+    std::priority_queue<Sleeper, std::vector<Sleeper>, std::greater<Sleeper>> sleepers;
+    std::vector<Dialogue::Handle> finished_roots; // Reaped once control returns to the executor
+    std::vector<std::string> output;
+    std::uint64_t turn = 0;
+    std::uint64_t sleep_order = 0;
+};
+
+#endif // DIALOGUE_EXECUTOR_H
@@ -0,0 +1,71 @@
+#include "FramePool.h"
+#include <array>
+#include <new>
+
+namespace {
+
+constexpr std::size_t CLASS_COUNT = FramePool::MAX_POOLED_SIZE / FramePool::GRANULARITY;
+constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+
+struct FreeFrame {
+    FreeFrame* next;
+};
+
+struct ThreadPool {
+    std::array<FreeFrame*, CLASS_COUNT> free_lists{};
+    char* chunk_cursor = nullptr; // Unused space at the end of the newest chunk
+    std::size_t chunk_remaining = 0;
+    long live_frames = 0;       // Allocations minus frees on this thread
+};
+
+thread_local ThreadPool pool;
+
+std::size_t sizeClass(std::size_t size) {
+    return (size + FramePool::GRANULARITY - 1) / FramePool::GRANULARITY - 1;
+}
+
+} // namespace
+
+namespace FramePool {
+
+void* allocate(std::size_t size) {
+    if (size == 0 || size > MAX_POOLED_SIZE) {
+        return ::operator new(size);
+    }
+    std::size_t index = sizeClass(size);
+    ++pool.live_frames;
+    if (FreeFrame* frame = pool.free_lists[index]) {
+        pool.free_lists[index] = frame->next;
+        return frame;
+    }
+
+    std::size_t rounded = (index + 1) * GRANULARITY;
+    if (pool.chunk_remaining < rounded) {
+        // Any tail of the old chunk is simply left unused
+        pool.chunk_cursor = static_cast<char*>(::operator new(CHUNK_SIZE));
+        pool.chunk_remaining = CHUNK_SIZE;
+    }
+    void* frame = pool.chunk_cursor;
+    pool.chunk_cursor += rounded;
+    pool.chunk_remaining -= rounded;
+    return frame;
+}
+
+void deallocate(void* frame, std::size_t size) noexcept {
+    if (size == 0 || size > MAX_POOLED_SIZE) {
+        ::operator delete(frame);
+        return;
+    }
+    // A frame freed on another thread simply joins that thread's free list
+    std::size_t index = sizeClass(size);
+    FreeFrame* node = static_cast<FreeFrame*>(frame);
+    node->next = pool.free_lists[index];
+    pool.free_lists[index] = node;
+    --pool.live_frames;
+}
+
+long getLiveFrames() {
+    return pool.live_frames;
+}
+
+} // namespace FramePool
@@ -0,0 +1,32 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <cstddef>
+
+/**
+ * @namespace FramePool
+ * @brief Size-class free lists for coroutine frames.
+ *
+ * Dialogue coroutines allocate their frames here instead of through the
+ * general-purpose heap. Frames are rounded up to a multiple of 64 bytes and
+ * recycled through per-thread free lists, so starting and finishing
+ * conversations in steady state does not touch the heap at all. Memory carved
+ * for the pool is kept for reuse rather than returned to the system; frames
+ * larger than MAX_POOLED_SIZE fall back to operator new.
+ */
+namespace FramePool {
+
+    constexpr std::size_t GRANULARITY = 64;
+    constexpr std::size_t MAX_POOLED_SIZE = 2048;
+
+    void* allocate(std::size_t size);
+    void deallocate(void* frame, std::size_t size) noexcept;
+
+    /**
+     * @brief Gets the number of pooled frames allocated minus those freed on this thread.
+     */
+    long getLiveFrames();
+
+} // namespace FramePool
+
+#endif // FRAME_POOL_H
@@ -0,0 +1,80 @@
+#include "Scripts.h"
+#include "../objects/Character.h"
+#include "../players/Player.h"
+
+namespace {
+
+// Shared closing exercise: turn an unhelpful thought into a balanced one.
+Dialogue reframe(std::string speaker, Player& player) {
+    co_await say(speaker + ": \"Try putting that thought another way.\"");
+    int choice = co_await player_choice(
+        "\"I made a mistake, and I can learn from it.\"",
+        "\"I always get everything wrong.\"");
+    if (choice == 0) {
+        player.incrementScore(5);
+        co_await say(speaker + ": \"That is a thought you can work with.\"");
+    } else {
+        co_await say(speaker + ": \"Notice the word 'always'. Is it really true?\"");
+    }
+}
+
+Dialogue guide(std::string dialogue, Player& player) {
+    co_await say("The Guide: \"" + dialogue + "\"");
+    int choice = co_await player_choice(
+        "List the evidence for the thought",
+        "List the evidence against the thought",
+        "Say nothing");
+    if (choice == 2) {
+        co_await say("The Guide: \"That's all right. I'll be here when you're ready.\"");
+        co_return;
+    }
+    co_await say(choice == 0 ? "The evidence for it feels thinner once you say it out loud."
+                             : "There is more evidence against it than you expected.");
+    player.incrementScore(5);
+    co_await reframe("The Guide", player);
+
+    // The lesson comes back to the player a little later
+    co_await turns(3);
+    co_await say("You remember The Guide's question: what is the evidence?");
+}
+
+Dialogue echoOfDoubt(std::string dialogue, Player& player) {
+    co_await say("The Echo of Doubt: \"" + dialogue + "\"");
+    int choice = co_await player_choice(
+        "Notice it: \"That is a thought, not a fact.\"",
+        "Argue with it",
+        "Agree with it");
+    if (choice == 0) {
+        player.incrementScore(10);
+        co_await say("The Echo flickers and grows quieter.");
+        co_return;
+    }
+    if (choice == 1) {
+        co_await say("The Echo only grows louder the more you argue.");
+    } else {
+        player.incrementScore(-5);
+        co_await say("The Echo settles on your shoulder.");
+    }
+
+    // Doubt that is not dealt with returns
+    co_await turns(2);
+    co_await say("The Echo of Doubt catches up with you: \"See? Nothing has changed.\"");
+    co_await reframe("A quieter voice", player);
+}
+
+} // namespace
+
+namespace DialogueScripts {
+
+Dialogue conversationWith(const Character& character, Player& player) {
+    const std::string name = character.getName();
+    if (name == "The Guide") {
+        return guide(character.getDialogue(), player);
+    }
+    if (name == "The Echo of Doubt") {
+        return echoOfDoubt(character.getDialogue(), player);
+    }
+    return Dialogue();
+}
+
+} // namespace DialogueScripts
@@ -0,0 +1,28 @@
+#ifndef DIALOGUE_SCRIPTS_H
+#define DIALOGUE_SCRIPTS_H
+
+#include "Dialogue.h"
+
+class Character;
+class Player;
+
+/**
+ * @namespace DialogueScripts
+ * @brief The scripted conversations available in the game world.
+ *
+ * Characters without a script just say their one line of `dialogue` from
+ * characters.csv.
+ */
+namespace DialogueScripts {
+
+    /**
+     * @brief Creates the conversation for a character.
+     * @param character The character being talked to.
+     * @param player The player, whose score the conversation may change.
+     * @return The conversation, or an empty Dialogue if the character has no script.
+     */
+    Dialogue conversationWith(const Character& character, Player& player);
+
+} // namespace DialogueScripts
+
+#endif // DIALOGUE_SCRIPTS_H
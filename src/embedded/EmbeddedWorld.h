@@ -0,0 +1,58 @@
+#ifndef EMBEDDED_WORLD_H
+#define EMBEDDED_WORLD_H
+
+#include <array>
+#include <string_view>
+#include "../npc/NpcBehaviour.h"
+
+/**
+ * @file EmbeddedWorld.h
+ * @brief Record types for the world tables compiled into the binary.
+ *
+ * WorldTables.h is generated from the CSV files in sql/ by src/embedded/main.cpp
+ * and holds constexpr std::arrays of these records. All text points at string
+ * literals, so the tables live in the read-only data segment and are shared
+ * between every process running the same binary. Room references are resolved
+ * to indices into the rooms table at generation time, so nothing is looked up
+ * or parsed at startup.
+ */
+namespace EmbeddedWorld {
+
+struct RoomRecord {
+    int id;
+    std::string_view description;
+};
+
+struct ExitRecord {
+    int from_room; // Index into rooms
+    int to_room;   // Index into rooms
+    std::string_view direction;
+    int key_tool_id; // Tool that unlocks the exit, or 0 if it is not locked
+};
+
+struct CharacterRecord {
+    int id;
+    std::string_view name;
+    std::string_view description;
+    int room_id;
+    int room;      // Index into rooms, or -1 if the character starts nowhere
+    std::string_view dialogue;
+    NpcBehaviour behaviour;
+};
+
+struct ToolRecord {
+    int id;
+    std::string_view name;
+    std::string_view description;
+    int initial_room_id;
+};
+
+struct PlayerRecord {
+    int id;
+    std::string_view name;
+    std::string_view join_date;
+};
+
+} // namespace EmbeddedWorld
+
+#endif // EMBEDDED_WORLD_H
@@ -0,0 +1,90 @@
+// Generated by src/embedded/main.cpp from sql/*.csv. Do not edit.
+#ifndef WORLD_TABLES_H
+#define WORLD_TABLES_H
+
+#include "EmbeddedWorld.h"
+
+namespace EmbeddedWorld {
+
+inline constexpr std::array<RoomRecord, 17> rooms = {{
+    {1, "You are in the Library of Core Beliefs. Ancient, sturdy shelves hold the foundational ideas that shape your world. Some books glow with a warm, steady light, while others are heavy and bound in shadow. This is where your fundamental understanding of yourself and the world resides."},
+    {2, "You have entered the Archives of Automatic Thoughts. Here, fleeting thoughts and immediate reactions are recorded on endless scrolls that zip by on brass tracks. Most are mundane, but some are inscribed with heavily biased or critical ink."},
+    {3, "This is the Quiet Nook of Mindfulness. A comfortable chair sits before a calm, steady hearth. The air is still and quiet. This is a space for non-judgmental observation of your thoughts and feelings as they are."},
+    {4, "You are in the Grand Hall of Social Interactions. Echoes of past conversations hang in the air. The space is vast and can feel either welcoming or intimidating depending on the light, which shifts with your mood."},
+    {5, "This is the Kitchen of Physical Sensations. The smells of different foods and the feeling of warmth from the stove connect you to your body. This room reminds you of the link between physical well-being and emotional states."},
+    {6, "You've entered the Room of Cognitive Distortions. The walls seem to twist and shimmer, presenting funhouse-mirror reflections of reality. Whispers of all-or-nothing thinking, overgeneralization, and catastrophizing echo from the corners. This room is uncomfortable, but understanding it is key."},
+    {7, "You are in the Observatory of Perspective. A large, clear lens allows you to look out at your own thoughts and situations from a detached, higher vantage point. From here, problems that seemed immense can look manageable."},
+    {8, "This is the Workshop of Coping Strategies. Workbenches are covered with tools for managing difficult emotions and situations. Here you can find plans for deep breathing, grounding exercises, and problem-solving."},
+    {9, "You are in the Laboratory of Behavioral Experiments. This room is for testing beliefs and assumptions by taking action. It's a safe space to try new things and see if the predicted negative outcomes actually occur."},
+    {10, "You have found the Flooded Cavern of Emotions. A deep, calm pool of water reflects the glowing moss on the ceiling. This room represents the full spectrum of your emotions. The water can be calm or turbulent, but it is always just water."},
+    {11, "This is the Throne Room of the Self. A simple, comfortable chair sits on a modest platform. This is the seat of your executive function, where you make conscious choices and decisions. It is a place of self-acceptance and agency."},
+    {12, "You are in the Whispering Gallery of Others' Perspectives. Faint whispers move along the curved walls, allowing you to hear empathetic echoes of how others might feel or think in a given situation. It is a place to practice empathy."},
+    {13, "You stand in the year 2065. A child\342\200\231s first perceptions are painted on a Sensory Canvas. The room is a smart environment that gently adapts, projecting soft, shifting colors onto the walls and playing sounds that harmonize with a child's mood. The first great discovery for the infant mind is learning the difference between the projected, shimmering butterfly on the wall and the real, solid feel of a parent's hand. A doorway shimmering with data leads forward."},
+    {14, "This is the Learning Garden of 2065, an interactive, holographic platform. Through augmented reality, knowledge is a living ecosystem. Mathematical concepts become growing crystal structures, and historical timelines are flowing rivers. The challenge is not to just absorb, but to become a gardener of one's own mind\342\200\224choosing which seeds of knowledge to plant. A path of glowing stones leads onward."},
+    {15, "You are now in the Global Echo of 2065, a vast, immersive social network. It's a space of breathtaking connection, but its powerful personalization algorithms create a perfect, comfortable bubble. The struggle of this age is to intentionally step outside one's own echo chamber to find an identity based on choice, not comfort. A faint, distorted doorway flickers in the distance."},
+    {16, "This space represents the Perspective Lens of 2065. As a young adult, the focus shifts to mutual understanding. This tool overlays conversations with helpful context, bridging cultural and personal gaps to foster a deeper, more informed empathy. It is a place for understanding, not assumption. A bridge of light extends to the final space."},
+    {17, "You have reached the final stage: becoming a Reality Curator. A master of their relationship with the augmented world, the curator knows when to use their digital tools and when to experience the unmediated world. The greatest wisdom is choosing one's own reality. There are no more doors here; this is a place of arrival and continued being."},
+}};
+
+inline constexpr std::array<ExitRecord, 32> exits = {{
+    {0, 1, "north", 0},
+    {1, 0, "south", 0},
+    {0, 2, "east", 0},
+    {2, 0, "west", 0},
+    {0, 3, "down", 0},
+    {3, 0, "up", 0},
+    {3, 4, "east", 0},
+    {4, 3, "west", 0},
+    {3, 7, "north", 0},
+    {7, 3, "south", 0},
+    {3, 10, "south", 0},
+    {10, 3, "north", 0},
+    {1, 11, "west", 0},
+    {11, 1, "east", 0},
+    {11, 8, "north", 1},
+    {8, 11, "south", 1},
+    {7, 5, "down", 8},
+    {5, 7, "up", 8},
+    {10, 6, "up", 0},
+    {6, 10, "down", 0},
+    {8, 9, "east", 0},
+    {9, 8, "west", 0},
+    {10, 12, "future", 0},
+    {12, 10, "past", 0},
+    {12, 13, "forward", 0},
+    {13, 12, "back", 0},
+    {13, 14, "forward", 0},
+    {14, 13, "back", 0},
+    {14, 15, "forward", 0},
+    {15, 14, "back", 0},
+    {15, 16, "forward", 0},
+    {16, 15, "back", 0},
+}};
+
+inline constexpr std::array<CharacterRecord, 3> characters = {{
+    {1, "The Guide", "A calm and gentle figure stands here, radiating a quiet confidence. They offer a warm smile.", 11, 10, "What is one piece of evidence that supports your thought? And what is one piece that contradicts it?", NpcBehaviour::Idle},
+    {2, "The Echo of Doubt", "A flickering, shadowy figure darts around theedges of the room, muttering in a critical tone. It seems to be made of shifting doubt.", 6, 5, "You'll probably fail, so why even try? You always mess things up.", NpcBehaviour::Idle},
+    {3, "The Curator", "A calm, holographic figure shimmers softly. It seems to be a guide for this place, a curator of consciousness.", 13, 12, "Welcome. You are at the beginning of a journey\342\200\224the unfolding of a self. This path explores how we learn to perceive, think, and connect, not just with the world, but with ourselves. Each step is a stage of growth. Observe, and proceed when you are ready.", NpcBehaviour::Idle},
+}};
+
+inline constexpr std::array<ToolRecord, 9> tools = {{
+    {1, "Key of Awareness", "A simple, unadorned key. It doesn't unlock doors, but rather the awareness of what is happening in the present moment.", 3},
+    {2, "Thought Record", "A small, empty journal page. It seems to be for recording a situation, the automatic thoughts that followed, and a more balanced, alternative thought.", 6},
+    {3, "Lens of Reframing", "A beautifully crafted lens. Looking through it allows you to see a situation from a different, more helpful perspective.", 7},
+    {4, "Blueprint for Grounding", "A simple diagram illustrating a 5-4-3-2-1 grounding exercise. It seems to be a reliable plan for managing overwhelming feelings.", 8},
+    {5, "Vial of Courage", "A small bottle containing a swirling, golden liquid. It is not a magical potion, but a reminder of your own inner strength to face a fear.", 9},
+    {6, "Smooth Stone of Mindfulness", "A perfectly smooth, cool stone that fits comfortably in your palm. Holding it helps anchor you to the present moment.", 10},
+    {7, "Scepter of Self-Compassion", "A simple, warm wooden rod. Holding it reminds you to treat yourself with the same kindness you would offer a friend.", 11},
+    {8, "Key of Values", "A key etched with your most important personal values. It unlocks the door to the Workshop of Coping Strategies, reminding you that your values guide your actions.", 4},
+    {9, "Lens of Empathy", "A beautifully crafted lens. Looking through it allows you to see a situation from a different, more empathetic perspective. It is a tool for understanding, not just seeing.", 16},
+}};
+
+inline constexpr std::array<PlayerRecord, 3> players = {{
+    {1, "Alice", "2023-01-15 10:30:00"},
+    {2, "Bob", "2023-01-16 11:00:00"},
+    {3, "Charlie", "2023-01-17 12:15:00"},
+}};
+
+} // namespace EmbeddedWorld
+
+#endif // WORLD_TABLES_H
@@ -0,0 +1,149 @@
+// Generates WorldTables.h, the constexpr world tables used by Game(embeddedWorld),
+// from the CSV files in sql/. Run it whenever the CSV content changes:
+//
+//   g++ src/embedded/main.cpp -o generate_world_tables -Isrc -std=c++17
+//   ./generate_world_tables sql src/embedded/WorldTables.h
+
+#include "../CSVParser.h"
+#include "../npc/NpcBehaviour.h"
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Emits a C++ string literal. Bytes outside printable ASCII are written as
+// three-digit octal escapes, which cannot run into the following character.
+std::string literal(const std::string& text) {
+    std::ostringstream out;
+    out << '"';
+    for (unsigned char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (c < 0x20 || c >= 0x7f) {
+            out << '\\' << static_cast<char>('0' + ((c >> 6) & 7))
+                << static_cast<char>('0' + ((c >> 3) & 7))
+                << static_cast<char>('0' + (c & 7));
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+bool load(const std::string& path, size_t min_columns, std::vector<std::vector<std::string>>& rows) {
+    rows = CSVParser::readCSV(path);
+    if (rows.empty()) {
+        std::cerr << "Error: Could not read " << path << std::endl;
+        return false;
+    }
+    // Skip the header and, like Game::loadDataFromCSV, any malformed rows
+    std::vector<std::vector<std::string>> valid;
+    for (size_t i = 1; i < rows.size(); ++i) {
+        if (rows[i].size() >= min_columns) {
+            valid.push_back(std::move(rows[i]));
+        } else {
+            std::cerr << "Warning: Skipping malformed data in " << path << " at row " << i << std::endl;
+        }
+    }
+    rows.swap(valid);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string csv_dir = (argc > 1) ? argv[1] : "sql";
+    std::string output_path = (argc > 2) ? argv[2] : "src/embedded/WorldTables.h";
+
+    std::vector<std::vector<std::string>> rooms, exits, characters, tools, players;
+    if (!load(csv_dir + "/rooms.csv", 2, rooms) ||
+        !load(csv_dir + "/exits.csv", 4, exits) ||
+        !load(csv_dir + "/characters.csv", 5, characters) ||
+        !load(csv_dir + "/tools.csv", 4, tools) ||
+        !load(csv_dir + "/players.csv", 3, players)) {
+        return 1;
+    }
+
+    std::map<int, int> room_index; // room_id -> index into the rooms table
+    for (size_t i = 0; i < rooms.size(); ++i) {
+        room_index[std::stoi(rooms[i][0])] = static_cast<int>(i);
+    }
+
+    std::ostringstream out;
+    out << "// Generated by src/embedded/main.cpp from " << csv_dir << "/*.csv. Do not edit.\n"
+        << "#ifndef WORLD_TABLES_H\n"
+        << "#define WORLD_TABLES_H\n\n"
+        << "#include \"EmbeddedWorld.h\"\n\n"
+        << "namespace EmbeddedWorld {\n\n";
+
+    out << "inline constexpr std::array<RoomRecord, " << rooms.size() << "> rooms = {{\n";
+    for (const auto& row : rooms) {
+        out << "    {" << std::stoi(row[0]) << ", " << literal(row[1]) << "},\n";
+    }
+    out << "}};\n\n";
+
+    out << "inline constexpr std::array<ExitRecord, " << exits.size() << "> exits = {{\n";
+    for (size_t i = 0; i < exits.size(); ++i) {
+        auto from = room_index.find(std::stoi(exits[i][1]));
+        auto to = room_index.find(std::stoi(exits[i][2]));
+        if (from == room_index.end() || to == room_index.end()) {
+            std::cerr << "Error: Invalid room ID in exit data at row " << i + 1 << std::endl;
+            return 1;
+        }
+        int key_tool_id = 0;
+        if (exits[i].size() > 6 && CSVParser::parseBool(exits[i][5]) && !exits[i][6].empty()) {
+            key_tool_id = std::stoi(exits[i][6]);
+        }
+        out << "    {" << from->second << ", " << to->second << ", " << literal(exits[i][3]) << ", " << key_tool_id << "},\n";
+    }
+    out << "}};\n\n";
+
+    out << "inline constexpr std::array<CharacterRecord, " << characters.size() << "> characters = {{\n";
+    for (size_t i = 0; i < characters.size(); ++i) {
+        const auto& row = characters[i];
+        int room_id = std::stoi(row[3]);
+        auto room = room_index.find(room_id);
+        NpcBehaviour behaviour = NpcBehaviour::Idle;
+        if (row.size() > 5 && !parseNpcBehaviour(row[5], behaviour)) {
+            std::cerr << "Error: Unknown behaviour '" << row[5] << "' in character data at row " << i + 1 << std::endl;
+            return 1;
+        }
+        static const char* const BEHAVIOUR_ENUMERATORS[] = {"Idle", "Wander", "Follow", "Flee"};
+        out << "    {" << std::stoi(row[0]) << ", " << literal(row[1]) << ", " << literal(row[2]) << ", "
+            << room_id << ", " << (room != room_index.end() ? room->second : -1) << ", " << literal(row[4])
+            << ", NpcBehaviour::" << BEHAVIOUR_ENUMERATORS[static_cast<size_t>(behaviour)] << "},\n";
+    }
+    out << "}};\n\n";
+
+    out << "inline constexpr std::array<ToolRecord, " << tools.size() << "> tools = {{\n";
+    for (const auto& row : tools) {
+        out << "    {" << std::stoi(row[0]) << ", " << literal(row[1]) << ", " << literal(row[2]) << ", "
+            << std::stoi(row[3]) << "},\n";
+    }
+    out << "}};\n\n";
+
+    out << "inline constexpr std::array<PlayerRecord, " << players.size() << "> players = {{\n";
+    for (const auto& row : players) {
+        out << "    {" << std::stoi(row[0]) << ", " << literal(row[1]) << ", " << literal(row[2]) << "},\n";
+    }
+    out << "}};\n\n";
+
+    out << "} // namespace EmbeddedWorld\n\n"
+        << "#endif // WORLD_TABLES_H\n";
+
+    std::ofstream file(output_path);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not write " << output_path << std::endl;
+        return 1;
+    }
+    file << out.str();
+    std::cout << "Wrote " << rooms.size() << " rooms, " << exits.size() << " exits, "
+              << characters.size() << " characters, " << tools.size() << " tools and "
+              << players.size() << " players to " << output_path << std::endl;
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "LineEditor.h"
+#include "../platform/Console.h"
+
+LineEditor::LineEditor(std::size_t history_limit)
+    : cursor(0), history_limit(history_limit), history_pos(0) {}
+
+LineEditor::Result LineEditor::handleKey(int key) {
+    switch (key) {
+        case Console::NO_INPUT:
+            return Result::Unchanged;
+        case Console::END_OF_INPUT:
+            return Result::EndOfInput;
+        case '\r':
+        case '\n':
+            return Result::Submitted;
+        case 4:  // Ctrl+D
+        case 26: // Ctrl+Z
+            return buffer.empty() ? Result::EndOfInput : Result::Unchanged;
+        case 8:   // Backspace
+        case 127: // Backspace on most terminals
+            if (cursor == 0) {
+                return Result::Unchanged;
+            }
+            buffer.erase(--cursor, 1);
+            return Result::Edited;
+        case Console::KEY_DELETE:
+            if (cursor == buffer.size()) {
+                return Result::Unchanged;
+            }
+            buffer.erase(cursor, 1);
+            return Result::Edited;
+        case Console::KEY_LEFT:
+            if (cursor == 0) {
+                return Result::Unchanged;
+            }
+            --cursor;
+            return Result::Edited;
+        case Console::KEY_RIGHT:
+            if (cursor == buffer.size()) {
+                return Result::Unchanged;
+            }
+            ++cursor;
+            return Result::Edited;
+        case Console::KEY_HOME:
+            cursor = 0;
+            return Result::Edited;
+        case Console::KEY_END:
+            cursor = buffer.size();
+            return Result::Edited;
+        case Console::KEY_UP:
+            if (history_pos == 0) {
+                return Result::Unchanged;
+            }
+            if (history_pos == history.size()) {
+                draft = buffer;
+            }
+            recall(history_pos - 1);
+            return Result::Edited;
+        case Console::KEY_DOWN:
+            if (history_pos == history.size()) {
+                return Result::Unchanged;
+            }
+            recall(history_pos + 1);
+            return Result::Edited;
+        default:
+            if (key < 0x20 || key > 0xff) {
+                return Result::Unchanged; // Other control characters and unknown keys
+            }
+            buffer.insert(cursor++, 1, static_cast<char>(key));
+            return Result::Edited;
+    }
+}
+
+void LineEditor::recall(std::size_t index) {
+    history_pos = index;
+    buffer = (index == history.size()) ? draft : history[index];
+    cursor = buffer.size();
+}
+
+std::string LineEditor::takeLine() {
+    std::string line;
+    line.swap(buffer);
+    cursor = 0;
+    draft.clear();
+    if (!line.empty() && (history.empty() || history.back() != line)) {
+        history.push_back(line);
+        if (history.size() > history_limit) {
+            history.pop_front();
+        }
+    }
+    history_pos = history.size();
+    return line;
+}
+
+const std::string& LineEditor::getBuffer() const {
+    return buffer;
+}
+
+std::size_t LineEditor::getCursor() const {
+    return cursor;
+}
+
+const std::deque<std::string>& LineEditor::getHistory() const {
+    return history;
+}
@@ -0,0 +1,58 @@
+#ifndef LINE_EDITOR_H
+#define LINE_EDITOR_H
+
+#include <string>
+#include <deque>
+#include <cstddef>
+
+/**
+ * @class LineEditor
+ * @brief Builds a command line from individual key presses.
+ *
+ * Keys come from Console::pollChar(), so the game loop can keep working
+ * between key presses instead of blocking in std::getline. Supports cursor
+ * movement, backspace/delete and a bounded history browsed with the up and
+ * down keys.
+ */
+class LineEditor {
+public:
+    enum class Result {
+        Unchanged,  // The key had no effect
+        Edited,     // The buffer or cursor changed and should be echoed
+        Submitted,  // Enter was pressed; collect the line with takeLine()
+        EndOfInput  // Ctrl+D/Ctrl+Z on an empty line, or the input was closed
+    };
+
+    /**
+     * @brief Constructs a new LineEditor.
+     * @param history_limit The number of submitted lines kept for recall.
+     */
+    explicit LineEditor(std::size_t history_limit = 100);
+
+    /**
+     * @brief Applies a key press to the line being edited.
+     * @param key A character or Console key code from Console::pollChar().
+     */
+    Result handleKey(int key);
+
+    /**
+     * @brief Returns the submitted line, records it in the history and clears the buffer.
+     */
+    std::string takeLine();
+
+    const std::string& getBuffer() const;
+    std::size_t getCursor() const;
+    const std::deque<std::string>& getHistory() const;
+
+private:
+    void recall(std::size_t index);
+
+    std::string buffer;
+    std::size_t cursor;
+    std::deque<std::string> history;
+    std::size_t history_limit;
+    std::size_t history_pos; // history.size() while editing a fresh line
+    std::string draft;       // The unfinished line saved while browsing history
+};
+
+#endif // LINE_EDITOR_H
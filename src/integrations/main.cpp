@@ -1,9 +1,12 @@
 #include "../Game.h"
+#include <csignal>
 #include <iostream>
 
+volatile sig_atomic_t g_signal_received = 0; // Referenced by Game, never set here
+
 int main(int argc, char* argv[]) {
     if (argc != 2) {
-        std::cout << "Usage: " << argv[0] << " <path_to_sql_file>" << std::endl;
+        std::cout << "Usage: " << argv[0] << " <sql_file, csv_directory or world_database>" << std::endl;
         return 1;
     }
 
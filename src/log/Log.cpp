@@ -0,0 +1,278 @@
+#include "Log.h"
+#include "../realtime/SpscQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+const std::size_t MAX_FIELDS = 4;
+const std::size_t TEXT_BYTES = 160;
+const std::size_t RING_RECORDS = 2048;
+const std::uint32_t WAKE_EVERY = RING_RECORDS / 8; // Records a thread logs between nudges to the log's thread
+const std::chrono::milliseconds DRAIN_INTERVAL{20};
+
+// What a log call copies into its ring: no pointers but to literals, so the
+// record stays valid whatever happens to the caller's strings.
+struct Record {
+    std::int64_t time_us = 0; // Microseconds since the epoch
+    const char* message = nullptr;
+    LogLevel level = LogLevel::Info;
+    std::uint8_t field_count = 0;
+    std::uint16_t text_used = 0;
+    struct Field {
+        const char* key;
+        std::int64_t number; // For text, the offset into text in the low 16 bits and the length above
+        bool is_text;
+    } fields[MAX_FIELDS];
+    char text[TEXT_BYTES];
+};
+
+// One per thread that has logged, on a list that only grows. A thread that
+// exits hands its ring back for the next new thread to take over.
+struct ThreadRing {
+    SpscQueue<Record, RING_RECORDS> records;
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<bool> in_use{false};
+    ThreadRing* next = nullptr;
+};
+
+std::atomic<ThreadRing*> rings{nullptr};
+std::atomic<std::uint64_t> total_dropped{0};
+
+std::mutex writer_mutex; // Guards the file and the writer thread's start and stop
+std::condition_variable wake;
+bool stopping = false;
+std::FILE* file = nullptr;
+std::thread writer;
+
+// Writes out what is left if the program ends with the log open; it is
+// destroyed before the writer thread above, which must not be running then.
+struct CloseAtExit {
+    ~CloseAtExit() {
+        Log::close();
+    }
+} close_at_exit;
+
+ThreadRing* takeRing() {
+    for (ThreadRing* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        bool in_use = false;
+        if (ring->in_use.compare_exchange_strong(in_use, true)) {
+            return ring;
+        }
+    }
+    ThreadRing* ring = new ThreadRing(); // Never freed, as the log's thread may be draining it
+    ring->in_use.store(true, std::memory_order_relaxed);
+    ring->next = rings.load(std::memory_order_relaxed);
+    while (!rings.compare_exchange_weak(ring->next, ring, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+    return ring;
+}
+
+struct ThreadLog {
+    ThreadRing* ring = nullptr;
+    std::uint32_t since_wake = 0;
+
+    ~ThreadLog() {
+        if (ring) {
+            ring->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+thread_local ThreadLog this_thread_log;
+
+void appendQuoted(std::string& line, std::string_view text) {
+    line += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            line += '\\';
+            line += c;
+        } else if (c == '\n') {
+            line += "\\n";
+        } else {
+            line += c;
+        }
+    }
+    line += '"';
+}
+
+// Formats records into lines, working out the date and time once a second
+class Formatter {
+public:
+    void format(const Record& record, std::string& line) {
+        std::time_t seconds = static_cast<std::time_t>(record.time_us / 1000000);
+        if (seconds != stamp_seconds) {
+            std::tm utc{};
+#ifdef _WIN32
+            gmtime_s(&utc, &seconds);
+#else
+            gmtime_r(&seconds, &utc);
+#endif
+            stamp_length = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &utc);
+            stamp_seconds = seconds;
+        }
+        char micros[16];
+        std::snprintf(micros, sizeof(micros), ".%06lld ", static_cast<long long>(record.time_us % 1000000));
+        line.assign(stamp, stamp_length);
+        line += micros;
+        const char* name = Log::levelName(record.level);
+        line += name;
+        line.append(6 - std::char_traits<char>::length(name), ' '); // Names are at most five letters
+        line += record.message;
+        for (std::size_t i = 0; i < record.field_count; ++i) {
+            const Record::Field& field = record.fields[i];
+            line += ' ';
+            line += field.key;
+            line += '=';
+            if (field.is_text) {
+                appendQuoted(line, std::string_view(record.text + (field.number & 0xFFFF), static_cast<std::size_t>(field.number >> 16)));
+            } else {
+                line += std::to_string(field.number);
+            }
+        }
+        line += '\n';
+    }
+
+private:
+    std::time_t stamp_seconds = -1;
+    char stamp[32];
+    std::size_t stamp_length = 0;
+};
+
+// Formats and writes whatever the rings hold. Called with writer_mutex held.
+void drain() {
+    static Formatter formatter; // Only one log thread runs at a time
+    Record record;
+    std::string line;
+    for (ThreadRing* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+        while (ring->records.tryPop(record)) {
+            formatter.format(record, line);
+            std::fwrite(line.data(), 1, line.size(), file);
+        }
+        std::uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            Record note;
+            note.time_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            note.message = "Log records dropped, a thread's ring was full";
+            note.level = LogLevel::Warning;
+            note.field_count = 1;
+            note.fields[0] = {"count", static_cast<std::int64_t>(dropped), false};
+            formatter.format(note, line);
+            std::fwrite(line.data(), 1, line.size(), file);
+        }
+    }
+    std::fflush(file);
+}
+
+void writerLoop() {
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    while (!stopping) {
+        drain();
+        wake.wait_for(lock, DRAIN_INTERVAL);
+    }
+    drain();
+}
+
+} // namespace
+
+namespace Log {
+
+bool open(const std::string& path, LogLevel record_level) {
+    close();
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    file = std::fopen(path.c_str(), "a");
+    if (!file) {
+        std::cerr << "Error: Could not open log file " << path << std::endl;
+        return false;
+    }
+    stopping = false;
+    writer = std::thread(writerLoop);
+    level.store(record_level, std::memory_order_relaxed);
+    return true;
+}
+
+void close() {
+    level.store(LogLevel::Off, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        if (!file) {
+            return;
+        }
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    std::fclose(file);
+    file = nullptr;
+}
+
+void setLevel(LogLevel record_level) {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    if (file) { // With no file open the level stays Off
+        level.store(record_level, std::memory_order_relaxed);
+    }
+}
+
+void write(LogLevel record_level, const char* message, std::initializer_list<LogField> fields) {
+    ThreadLog& log = this_thread_log;
+    if (!log.ring) {
+        log.ring = takeRing();
+    }
+    bool pushed = log.ring->records.tryPushWith([&](Record& record) {
+        record.time_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        record.message = message;
+        record.level = record_level;
+        record.field_count = 0;
+        record.text_used = 0;
+        for (const LogField& field : fields) {
+            if (record.field_count == MAX_FIELDS) {
+                break;
+            }
+            Record::Field& kept = record.fields[record.field_count++];
+            kept.key = field.key;
+            kept.is_text = field.is_text;
+            if (field.is_text) {
+                std::size_t length = std::min(field.text.size(), TEXT_BYTES - record.text_used);
+                field.text.copy(record.text + record.text_used, length);
+                kept.number = static_cast<std::int64_t>(record.text_used) | static_cast<std::int64_t>(length << 16);
+                record.text_used = static_cast<std::uint16_t>(record.text_used + length);
+            } else {
+                kept.number = field.number;
+            }
+        }
+    });
+    if (!pushed) {
+        log.ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        total_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Records are written out every DRAIN_INTERVAL anyway; a busy thread
+    // also nudges the log's thread now and then so that its ring keeps room.
+    if (++log.since_wake == WAKE_EVERY) {
+        log.since_wake = 0;
+        wake.notify_one();
+    }
+}
+
+std::uint64_t getDroppedCount() {
+    return total_dropped.load(std::memory_order_relaxed);
+}
+
+const char* levelName(LogLevel record_level) {
+    switch (record_level) {
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warning: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Off: return "OFF";
+    }
+    return "?";
+}
+
+} // namespace Log
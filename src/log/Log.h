@@ -0,0 +1,109 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief How much a log record matters; records below the log's level are dropped where they are made.
+ */
+enum class LogLevel : unsigned char {
+    Debug,   // Per-object detail, such as each room loaded
+    Info,    // What the game did: worlds loaded, files opened
+    Warning, // Something odd that the game worked around
+    Error,   // Something failed
+    Off      // Nothing is logged; the level until Log::open()
+};
+
+/**
+ * @struct LogField
+ * @brief One named value of a log record: a number or a piece of text.
+ *
+ * The key must be a string literal, as it is only formatted later on the
+ * log's thread. Text is copied into the record and cut short if it does not fit.
+ */
+struct LogField {
+    template <typename Number, typename = std::enable_if_t<std::is_arithmetic_v<Number>>>
+    LogField(const char* key, Number number) : key(key), number(static_cast<std::int64_t>(number)) {}
+    LogField(const char* key, std::string_view text) : key(key), text(text), is_text(true) {}
+    LogField(const char* key, const char* text) : key(key), text(text), is_text(true) {}
+    LogField(const char* key, const std::string& text) : key(key), text(text), is_text(true) {}
+
+    const char* key;
+    std::int64_t number = 0;
+    std::string_view text;
+    bool is_text = false;
+};
+
+/**
+ * @namespace Log
+ * @brief A levelled, structured log written to a file by a background thread.
+ *
+ * A log call checks the level with one relaxed load and, if the record is
+ * wanted, copies it as a fixed-size binary record into a ring buffer of the
+ * calling thread's own, with no lock and no formatting. The log's thread
+ * drains every thread's ring, formats the records as lines of the form
+ *
+ *     2026-10-19 12:34:56.789012 INFO  World loaded rooms=90000 ms=412
+ *
+ * and writes them to the file. A call never waits: when its thread's ring is
+ * full the record is dropped and counted, and the count is logged once there
+ * is room again. Records from one thread keep their order; records from
+ * different threads are written in the order they are drained.
+ */
+namespace Log {
+
+    inline std::atomic<LogLevel> level{LogLevel::Off};
+
+    /**
+     * @brief Starts logging records at or above a level to a file, appending to it.
+     * @return false if the file could not be opened; nothing is logged then.
+     */
+    bool open(const std::string& path, LogLevel level = LogLevel::Info);
+
+    /**
+     * @brief Writes out every record made so far, stops the log's thread and closes the file.
+     */
+    void close();
+
+    void setLevel(LogLevel level);
+
+    inline bool isEnabled(LogLevel record_level) {
+        return record_level >= level.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Logs a record; message must be a string literal, as keys must.
+     *
+     * Up to four fields are kept, and up to 160 bytes of text across them.
+     */
+    void write(LogLevel record_level, const char* message, std::initializer_list<LogField> fields = {});
+
+    inline void debug(const char* message, std::initializer_list<LogField> fields = {}) {
+        if (isEnabled(LogLevel::Debug)) write(LogLevel::Debug, message, fields);
+    }
+    inline void info(const char* message, std::initializer_list<LogField> fields = {}) {
+        if (isEnabled(LogLevel::Info)) write(LogLevel::Info, message, fields);
+    }
+    inline void warning(const char* message, std::initializer_list<LogField> fields = {}) {
+        if (isEnabled(LogLevel::Warning)) write(LogLevel::Warning, message, fields);
+    }
+    inline void error(const char* message, std::initializer_list<LogField> fields = {}) {
+        if (isEnabled(LogLevel::Error)) write(LogLevel::Error, message, fields);
+    }
+
+    /**
+     * @brief Gets the number of records dropped because a thread's ring was full.
+     */
+    std::uint64_t getDroppedCount();
+
+    const char* levelName(LogLevel level);
+
+} // namespace Log
+
+#endif // LOG_H
@@ -1,5 +1,12 @@
 #include "Game.h"
+#include "replay/InputRecording.h"
+#include "memory/MemoryStats.h"
+#include "log/Log.h"
+#include "metrics/MetricsServer.h"
 #include <iostream> // For std::cout, std::endl
+#include <fstream>  // For std::ofstream
+#include <memory>   // For std::unique_ptr
+#include <string>
 #include <csignal>  // For std::signal, SIGINT
 
 // Global flag to indicate if a signal has been received
@@ -13,12 +20,85 @@ void signal_handler(int signal) {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     // Register the signal handler for SIGINT (Ctrl+C)
     std::signal(SIGINT, signal_handler);
 
+    // --record <file> saves every line typed so the session can be replayed;
+    // --save <file> resumes from a save game and autosaves every turn;
+    // --realtime lets the world move on its own instead of waiting for commands;
+    // --log <file> picks the log file and --verbose logs every object loaded;
+    // --metrics <socket> serves the runtime metrics on a Unix domain socket
+    std::string record_path;
+    std::string save_path;
+    std::string log_path = "quanta_pie.log";
+    std::string metrics_path;
+    bool real_time = false;
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--record" && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (arg == "--save" && i + 1 < argc) {
+            save_path = argv[++i];
+        } else if (arg == "--realtime") {
+            real_time = true;
+        } else if (arg == "--log" && i + 1 < argc) {
+            log_path = argv[++i];
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else if (arg == "--metrics" && i + 1 < argc) {
+            metrics_path = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--record <file>] [--save <file>] [--realtime] [--log <file>] [--verbose] [--metrics <socket>]" << std::endl;
+            return 1;
+        }
+    }
+    if (real_time && !record_path.empty()) {
+        std::cerr << "Error: --record cannot be used with --realtime, whose timing a replay cannot reproduce" << std::endl;
+        return 1;
+    }
+    if (!save_path.empty() && !record_path.empty()) {
+        std::cerr << "Error: --record cannot be used with --save, as a replay starts from a fresh world and not from the save" << std::endl;
+        return 1;
+    }
+
+    Log::open(log_path, verbose ? LogLevel::Debug : LogLevel::Info); // The game runs without a log if it cannot be opened
+
+    MetricsServer metrics;
+    if (!metrics_path.empty() && !metrics.start(metrics_path)) {
+        return 1;
+    }
+
+#ifdef QUANTA_EMBEDDED_WORLD
+    Game game(embeddedWorld); // World compiled into the binary, no data files needed
+#else
     Game game;
+#endif
+
+    if (!save_path.empty() && !game.enableAutosave(save_path)) {
+        std::cerr << "Error: Could not use save file " << save_path << std::endl;
+        return 1;
+    }
+
+    std::ofstream record_file;
+    std::unique_ptr<InputRecorder> recorder;
+    if (!record_path.empty()) {
+        record_file.open(record_path, std::ios::binary);
+        if (!record_file.is_open()) {
+            std::cerr << "Error: Could not open " << record_path << " for recording" << std::endl;
+            return 1;
+        }
+        recorder = std::make_unique<InputRecorder>(record_file, game.getSeed(), game.getWorldSource());
+        game.setRecorder(recorder.get());
+    }
+
+    game.setRealTime(real_time);
     game.start();
 
+    std::cout << "Memory use by subsystem:" << std::endl;
+    MemoryStats::dump(std::cout);
+
+    Log::close();
     return 0;
 }
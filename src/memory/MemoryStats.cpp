@@ -0,0 +1,136 @@
+#include "MemoryStats.h"
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+namespace {
+
+constexpr std::size_t TAG_COUNT = static_cast<std::size_t>(MemTag::Count);
+
+struct Counters {
+    std::atomic<std::size_t> live_bytes{0};
+    std::atomic<std::size_t> peak_bytes{0};
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> frees{0};
+};
+
+// Constant-initialised, so usable by allocations made before main()
+Counters counters[TAG_COUNT];
+thread_local MemTag current_tag = MemTag::Other;
+
+#ifndef QUANTA_NO_MEMORY_STATS
+
+// Keeps the memory after it aligned as malloc's is
+struct alignas(alignof(std::max_align_t)) Header {
+    std::size_t size;
+    MemTag tag;
+};
+
+void* allocate(std::size_t size) noexcept {
+    Header* header = static_cast<Header*>(std::malloc(sizeof(Header) + size));
+    if (!header) {
+        return nullptr;
+    }
+    header->size = size;
+    header->tag = current_tag;
+
+    Counters& tag = counters[static_cast<std::size_t>(header->tag)];
+    tag.allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t live = tag.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peak = tag.peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !tag.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+    return header + 1;
+}
+
+void* allocateOrThrow(std::size_t size) {
+    void* memory = allocate(size);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void release(void* memory) noexcept {
+    if (!memory) {
+        return;
+    }
+    Header* header = static_cast<Header*>(memory) - 1;
+    Counters& tag = counters[static_cast<std::size_t>(header->tag)];
+    tag.frees.fetch_add(1, std::memory_order_relaxed);
+    tag.live_bytes.fetch_sub(header->size, std::memory_order_relaxed);
+    std::free(header);
+}
+
+#endif // QUANTA_NO_MEMORY_STATS
+
+} // namespace
+
+#ifndef QUANTA_NO_MEMORY_STATS
+
+void* operator new(std::size_t size) { return allocateOrThrow(size); }
+void* operator new[](std::size_t size) { return allocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void operator delete(void* memory) noexcept { release(memory); }
+void operator delete[](void* memory) noexcept { release(memory); }
+void operator delete(void* memory, std::size_t) noexcept { release(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { release(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { release(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { release(memory); }
+
+#endif // QUANTA_NO_MEMORY_STATS
+
+MemoryScope::MemoryScope(MemTag tag) : previous(current_tag) {
+    current_tag = tag;
+}
+
+MemoryScope::~MemoryScope() {
+    current_tag = previous;
+}
+
+namespace MemoryStats {
+
+TagStats get(MemTag tag) {
+    const Counters& source = counters[static_cast<std::size_t>(tag)];
+    TagStats stats;
+    stats.live_bytes = source.live_bytes.load(std::memory_order_relaxed);
+    stats.peak_bytes = source.peak_bytes.load(std::memory_order_relaxed);
+    stats.allocations = source.allocations.load(std::memory_order_relaxed);
+    stats.frees = source.frees.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::uint64_t getTotalAllocations() {
+    std::uint64_t total = 0;
+    for (const Counters& tag : counters) {
+        total += tag.allocations.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+const char* tagName(MemTag tag) {
+    switch (tag) {
+        case MemTag::Other: return "other";
+        case MemTag::WorldLoad: return "world load";
+        case MemTag::Session: return "session";
+        case MemTag::Rendering: return "rendering";
+        case MemTag::Challenge: return "challenges";
+        case MemTag::Count: break;
+    }
+    return "?";
+}
+
+void dump(std::ostream& out) {
+    out << std::left << std::setw(12) << "subsystem" << std::right << std::setw(14) << "live bytes"
+        << std::setw(14) << "peak bytes" << std::setw(14) << "allocations" << std::endl;
+    for (std::size_t i = 0; i < TAG_COUNT; ++i) {
+        TagStats stats = get(static_cast<MemTag>(i));
+        out << std::left << std::setw(12) << tagName(static_cast<MemTag>(i)) << std::right
+            << std::setw(14) << stats.live_bytes << std::setw(14) << stats.peak_bytes
+            << std::setw(14) << stats.allocations << std::endl;
+    }
+}
+
+} // namespace MemoryStats
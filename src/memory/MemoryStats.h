@@ -0,0 +1,74 @@
+#ifndef MEMORY_STATS_H
+#define MEMORY_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * @brief The subsystems that heap allocations are charged to.
+ */
+enum class MemTag : unsigned char {
+    Other,     // Anything outside a MemoryScope
+    WorldLoad, // Rooms, exits, characters and objects built while loading
+    Session,   // Per-turn game logic: commands, conversations, saves
+    Rendering, // Screen and room view text
+    Challenge, // CBT challenges
+    Count
+};
+
+/**
+ * @class MemoryScope
+ * @brief Charges the current thread's allocations to a subsystem until it goes out of scope.
+ *
+ * Scopes nest; the innermost one wins. Memory is charged to the subsystem
+ * that allocated it, however long it lives and whoever frees it.
+ */
+class MemoryScope {
+public:
+    explicit MemoryScope(MemTag tag);
+    ~MemoryScope();
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+    MemTag previous;
+};
+
+/**
+ * @namespace MemoryStats
+ * @brief Heap usage per subsystem, counted by the global operator new and delete.
+ *
+ * Every allocation carries a small header recording its size and subsystem.
+ * Over-aligned allocations (alignas beyond the default) are not counted.
+ * Building with -DQUANTA_NO_MEMORY_STATS leaves operator new alone, and every
+ * figure then reads zero.
+ */
+namespace MemoryStats {
+
+    struct TagStats {
+        std::size_t live_bytes = 0;
+        std::size_t peak_bytes = 0;   // Highest live_bytes so far
+        std::uint64_t allocations = 0;
+        std::uint64_t frees = 0;
+    };
+
+    TagStats get(MemTag tag);
+
+    /**
+     * @brief Gets the number of allocations made so far, across all subsystems and threads.
+     *
+     * The difference between two readings counts the allocations in between.
+     */
+    std::uint64_t getTotalAllocations();
+
+    const char* tagName(MemTag tag);
+
+    /**
+     * @brief Writes one line per subsystem with its live and peak bytes and allocation count.
+     */
+    void dump(std::ostream& out);
+
+} // namespace MemoryStats
+
+#endif // MEMORY_STATS_H
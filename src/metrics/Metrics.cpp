@@ -0,0 +1,185 @@
+#include "Metrics.h"
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Constructed on first use, so metrics that are globals of other files can register whatever order those start in
+struct Registry {
+    std::mutex mutex;
+    std::vector<Metric*> metrics;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry(); // Never destroyed, as global metrics leave it at exit
+    return *instance;
+}
+
+void appendNumber(std::string& out, double value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    out += text;
+}
+
+} // namespace
+
+Metric::Metric(std::string name, std::string help, std::string labels, double scale)
+    : name(std::move(name)), help(std::move(help)), labels(std::move(labels)), scale(scale) {
+    Registry& metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    metrics.metrics.push_back(this);
+}
+
+Metric::~Metric() {
+    Registry& metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    metrics.metrics.erase(std::find(metrics.metrics.begin(), metrics.metrics.end(), this));
+}
+
+const std::string& Metric::getName() const {
+    return name;
+}
+
+const std::string& Metric::getHelp() const {
+    return help;
+}
+
+void Metric::writeSample(std::string& out, const char* suffix, const std::string& extra_label, double value) const {
+    out += name;
+    out += suffix;
+    if (!labels.empty() || !extra_label.empty()) {
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extra_label.empty()) {
+            out += ',';
+        }
+        out += extra_label;
+        out += '}';
+    }
+    out += ' ';
+    appendNumber(out, value);
+    out += '\n';
+}
+
+Counter::Counter(std::string name, std::string help, std::string labels, double scale)
+    : Metric(std::move(name), std::move(help), std::move(labels), scale) {}
+
+std::uint64_t Counter::get() const {
+    std::uint64_t total = 0;
+    for (const Shard& shard : shards) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+const char* Counter::getType() const {
+    return "counter";
+}
+
+void Counter::writeSamples(std::string& out) const {
+    writeSample(out, "", "", static_cast<double>(get()) * scale);
+}
+
+Gauge::Gauge(std::string name, std::string help, std::string labels, double scale)
+    : Metric(std::move(name), std::move(help), std::move(labels), scale) {}
+
+std::int64_t Gauge::get() const {
+    return value.load(std::memory_order_relaxed);
+}
+
+const char* Gauge::getType() const {
+    return "gauge";
+}
+
+void Gauge::writeSamples(std::string& out) const {
+    writeSample(out, "", "", static_cast<double>(get()) * scale);
+}
+
+Histogram::Histogram(std::string name, std::string help, std::string labels, double scale)
+    : Metric(std::move(name), std::move(help), std::move(labels), scale) {}
+
+std::uint64_t Histogram::bucketValue(std::size_t bucket) {
+    if (bucket < (std::size_t{2} << SUB_BUCKET_BITS)) {
+        return bucket; // One value each
+    }
+    int shift = static_cast<int>(bucket >> SUB_BUCKET_BITS) - 1;
+    std::uint64_t low = static_cast<std::uint64_t>((bucket & ((std::size_t{1} << SUB_BUCKET_BITS) - 1)) + (std::size_t{1} << SUB_BUCKET_BITS)) << shift;
+    return low + (std::uint64_t{1} << shift) / 2;
+}
+
+std::uint64_t Histogram::getCount() const {
+    std::uint64_t count = 0;
+    for (const Shard& shard : shards) {
+        for (const auto& bucket : shard.counts) {
+            count += bucket.load(std::memory_order_relaxed);
+        }
+    }
+    return count;
+}
+
+std::uint64_t Histogram::getQuantile(double q) const {
+    std::vector<std::uint64_t> counts(BUCKETS);
+    std::uint64_t total = 0;
+    for (const Shard& shard : shards) {
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            std::uint64_t count = shard.counts[i].load(std::memory_order_relaxed);
+            counts[i] += count;
+            total += count;
+        }
+    }
+    if (total == 0) {
+        return 0;
+    }
+    // The rank of the value wanted, counting from 1
+    std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(q * static_cast<double>(total) + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return bucketValue(i);
+        }
+    }
+    return bucketValue(BUCKETS - 1);
+}
+
+const char* Histogram::getType() const {
+    return "summary";
+}
+
+void Histogram::writeSamples(std::string& out) const {
+    static const std::pair<double, const char*> QUANTILES[] = {
+        {0.5, "quantile=\"0.5\""}, {0.9, "quantile=\"0.9\""}, {0.99, "quantile=\"0.99\""}, {0.999, "quantile=\"0.999\""}};
+    for (const auto& [q, label] : QUANTILES) {
+        writeSample(out, "", label, static_cast<double>(getQuantile(q)) * scale);
+    }
+    std::uint64_t sum = 0;
+    for (const Shard& shard : shards) {
+        sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    writeSample(out, "_sum", "", static_cast<double>(sum) * scale);
+    writeSample(out, "_count", "", static_cast<double>(getCount()));
+}
+
+namespace Metrics {
+
+std::string writePrometheus() {
+    Registry& metrics = registry();
+    std::lock_guard<std::mutex> lock(metrics.mutex);
+    // Samples of one name must be together, under one HELP and TYPE
+    std::vector<const Metric*> sorted(metrics.metrics.begin(), metrics.metrics.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Metric* a, const Metric* b) { return a->getName() < b->getName(); });
+    std::string out;
+    const std::string* last_name = nullptr;
+    for (const Metric* metric : sorted) {
+        if (!last_name || *last_name != metric->getName()) {
+            out += "# HELP " + metric->getName() + " " + metric->getHelp() + "\n";
+            out += "# TYPE " + metric->getName() + " " + metric->getType() + "\n";
+            last_name = &metric->getName();
+        }
+        metric->writeSamples(out);
+    }
+    return out;
+}
+
+} // namespace Metrics
@@ -0,0 +1,208 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @namespace Metrics
+ * @brief A registry of counters, gauges and histograms, exported in the Prometheus text format.
+ *
+ * Metrics register themselves when constructed and leave when destroyed,
+ * so most are globals next to the code they measure. Counters and
+ * histograms are split into shards, and each thread updates the shard it
+ * was given on its first update with one relaxed atomic add, so threads
+ * updating the same metric rarely share a cache line. Reading a metric
+ * adds up its shards, which only the exporter does.
+ */
+namespace Metrics {
+
+    constexpr std::size_t SHARDS = 16;
+
+    /**
+     * @brief Gets the calling thread's shard, handed out round-robin.
+     */
+    inline std::size_t shardIndex() {
+        static std::atomic<std::size_t> next{0};
+        thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+        return index;
+    }
+
+    /**
+     * @brief Writes every registered metric in the Prometheus text exposition format (version 0.0.4).
+     */
+    std::string writePrometheus();
+
+} // namespace Metrics
+
+/**
+ * @class Metric
+ * @brief What the registry keeps of every metric: its name, labels, help text and how to write its samples.
+ */
+class Metric {
+public:
+    /**
+     * @param name The Prometheus metric name, such as quanta_turns_total.
+     * @param help One line describing the metric.
+     * @param labels Label pairs written between the braces, such as table="rooms"; empty for none.
+     * @param scale What one stored unit is in the exported unit, e.g. 1e-9 for nanoseconds exported as seconds.
+     */
+    Metric(std::string name, std::string help, std::string labels, double scale);
+    virtual ~Metric();
+
+    Metric(const Metric&) = delete;
+    Metric& operator=(const Metric&) = delete;
+
+    const std::string& getName() const;
+    const std::string& getHelp() const;
+    virtual const char* getType() const = 0;
+
+    /**
+     * @brief Appends the metric's sample lines.
+     */
+    virtual void writeSamples(std::string& out) const = 0;
+
+protected:
+    // Appends name{labels,extra} value
+    void writeSample(std::string& out, const char* suffix, const std::string& extra_label, double value) const;
+
+    std::string name;
+    std::string help;
+    std::string labels;
+    double scale;
+};
+
+/**
+ * @class Counter
+ * @brief A count that only goes up, such as turns taken.
+ */
+class Counter : public Metric {
+public:
+    Counter(std::string name, std::string help, std::string labels = "", double scale = 1.0);
+
+    void add(std::uint64_t amount = 1) {
+        shards[Metrics::shardIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    std::uint64_t get() const;
+    const char* getType() const override;
+    void writeSamples(std::string& out) const override;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+    std::array<Shard, Metrics::SHARDS> shards;
+};
+
+/**
+ * @class Gauge
+ * @brief A value that goes up and down or is set, such as the number of games running.
+ *
+ * Gauges change seldom, so each is a single atomic rather than sharded.
+ */
+class Gauge : public Metric {
+public:
+    Gauge(std::string name, std::string help, std::string labels = "", double scale = 1.0);
+
+    void add(std::int64_t amount = 1) {
+        value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    void set(std::int64_t value) {
+        this->value.store(value, std::memory_order_relaxed);
+    }
+
+    std::int64_t get() const;
+    const char* getType() const override;
+    void writeSamples(std::string& out) const override;
+
+private:
+    std::atomic<std::int64_t> value{0};
+};
+
+/**
+ * @class Histogram
+ * @brief The distribution of values such as latencies, with percentiles to within about 3%.
+ *
+ * Values are counted in high-dynamic-range buckets: each power of two is cut
+ * into 32 equal buckets, so every bucket is at most 1/32 of its values wide
+ * from 1 up to 2^44 (in nanoseconds, almost five hours), and recording is a
+ * few bit operations and one add. The export is a Prometheus summary with
+ * the 50th, 90th, 99th and 99.9th percentiles, the sum and the count.
+ */
+class Histogram : public Metric {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr int MAX_BITS = 44; // Larger values are counted as 2^44 - 1
+    static constexpr std::size_t BUCKETS = static_cast<std::size_t>(MAX_BITS - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+
+    Histogram(std::string name, std::string help, std::string labels = "", double scale = 1.0);
+
+    void record(std::uint64_t value) {
+        Shard& shard = shards[Metrics::shardIndex()];
+        value = std::min<std::uint64_t>(value, (std::uint64_t{1} << MAX_BITS) - 1);
+        shard.counts[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    std::uint64_t getCount() const;
+
+    /**
+     * @brief Gets the value below which a fraction q of the recorded values fall, in stored units.
+     * @return 0 if nothing has been recorded.
+     */
+    std::uint64_t getQuantile(double q) const;
+
+    const char* getType() const override;
+    void writeSamples(std::string& out) const override;
+
+    static std::size_t bucketOf(std::uint64_t value) {
+        // Values below 2^SUB_BUCKET_BITS get a bucket each; above that, the
+        // top SUB_BUCKET_BITS bits after the highest set bit pick the bucket.
+        int high = std::bit_width(value) - 1;
+        if (high < SUB_BUCKET_BITS) {
+            return static_cast<std::size_t>(value);
+        }
+        int shift = high - SUB_BUCKET_BITS;
+        return (static_cast<std::size_t>(shift + 1) << SUB_BUCKET_BITS) + static_cast<std::size_t>((value >> shift) - (std::uint64_t{1} << SUB_BUCKET_BITS));
+    }
+
+    /**
+     * @brief Gets the middle of the range of values a bucket counts.
+     */
+    static std::uint64_t bucketValue(std::size_t bucket);
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, BUCKETS> counts{};
+        std::atomic<std::uint64_t> sum{0};
+    };
+    std::array<Shard, Metrics::SHARDS> shards;
+};
+
+/**
+ * @class HistogramTimer
+ * @brief Records the nanoseconds from its construction to its destruction in a histogram.
+ */
+class HistogramTimer {
+public:
+    explicit HistogramTimer(Histogram& histogram) : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+    ~HistogramTimer() {
+        histogram.record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+    }
+
+    HistogramTimer(const HistogramTimer&) = delete;
+    HistogramTimer& operator=(const HistogramTimer&) = delete;
+
+private:
+    Histogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,133 @@
+#include "MetricsServer.h"
+#include "Metrics.h"
+#include <iostream>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+
+const int POLL_MS = 200;          // How long the server waits for a connection before checking whether to stop
+const int REQUEST_WAIT_MS = 100;  // How long a client has to send its request
+const std::size_t MAX_REQUEST = 4096;
+
+} // namespace
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+std::uint64_t MetricsServer::getScrapeCount() const {
+    return scrapes.load(std::memory_order_relaxed);
+}
+
+#ifdef _WIN32
+
+bool MetricsServer::start(const std::string& socket_path) {
+    std::cerr << "Error: Cannot serve metrics on " << socket_path << ", Unix sockets are not supported on this platform" << std::endl;
+    return false;
+}
+
+void MetricsServer::stop() {}
+
+void MetricsServer::serve() {}
+
+void MetricsServer::answer(int) {}
+
+#else
+
+bool MetricsServer::start(const std::string& socket_path) {
+    stop();
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.empty() || socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Error: Metrics socket path " << socket_path << " is empty or too long" << std::endl;
+        return false;
+    }
+    std::memcpy(address.sun_path, socket_path.c_str(), socket_path.size() + 1);
+
+    // A socket left by a game that did not shut down is replaced; any other file is not
+    struct stat existing;
+    if (lstat(socket_path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            std::cerr << "Error: " << socket_path << " exists and is not a socket" << std::endl;
+            return false;
+        }
+        unlink(socket_path.c_str());
+    }
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, 8) != 0) {
+        std::cerr << "Error: Could not listen on metrics socket " << socket_path << ": " << std::strerror(errno) << std::endl;
+        if (listener >= 0) {
+            close(listener);
+            listener = -1;
+        }
+        return false;
+    }
+    path = socket_path;
+    stopping = false;
+    thread = std::thread(&MetricsServer::serve, this);
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (listener < 0) {
+        return;
+    }
+    stopping = true;
+    thread.join();
+    close(listener);
+    listener = -1;
+    unlink(path.c_str());
+}
+
+void MetricsServer::serve() {
+    while (!stopping.load()) {
+        pollfd waiting{listener, POLLIN, 0};
+        if (poll(&waiting, 1, POLL_MS) <= 0) {
+            continue;
+        }
+        int connection = accept(listener, nullptr, nullptr);
+        if (connection >= 0) {
+            answer(connection);
+            close(connection);
+        }
+    }
+}
+
+void MetricsServer::answer(int connection) {
+    // Read the request up to its blank line, if the client sends one; what it asks for does not matter
+    std::string request;
+    char buffer[512];
+    pollfd readable{connection, POLLIN, 0};
+    while (request.size() < MAX_REQUEST && request.find("\r\n\r\n") == std::string::npos && poll(&readable, 1, REQUEST_WAIT_MS) > 0) {
+        ssize_t received = recv(connection, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<std::size_t>(received));
+    }
+
+    std::string body = Metrics::writePrometheus();
+    std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                           std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    std::size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = send(connection, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return;
+        }
+        sent += static_cast<std::size_t>(written);
+    }
+    scrapes.fetch_add(1, std::memory_order_relaxed);
+}
+
+#endif // _WIN32
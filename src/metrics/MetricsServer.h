@@ -0,0 +1,57 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/**
+ * @class MetricsServer
+ * @brief Serves the metrics in the Prometheus text format on a local Unix domain socket.
+ *
+ * Each connection gets one HTTP/1.0 response holding Metrics::writePrometheus()
+ * and is then closed, so the socket can be scraped with
+ * `curl --unix-socket <path> http://localhost/metrics` or by a Prometheus
+ * agent or proxy that speaks to Unix sockets. Requests are answered on a
+ * thread of the server's own, and building a response only reads the
+ * metrics, so scraping never holds up the game.
+ *
+ * Unix domain sockets are not supported on Windows builds; start() then fails.
+ */
+class MetricsServer {
+public:
+    MetricsServer() = default;
+    ~MetricsServer();
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    /**
+     * @brief Listens on a socket at the given path, replacing a stale socket left there.
+     * @return false if the socket could not be created; the server is then not running.
+     */
+    bool start(const std::string& socket_path);
+
+    /**
+     * @brief Stops answering and removes the socket.
+     */
+    void stop();
+
+    /**
+     * @brief Gets the number of responses sent.
+     */
+    std::uint64_t getScrapeCount() const;
+
+private:
+    void serve();
+    void answer(int connection);
+
+    std::string path;
+    int listener = -1;
+    std::thread thread;
+    std::atomic<bool> stopping{false};
+    std::atomic<std::uint64_t> scrapes{0};
+};
+
+#endif // METRICS_SERVER_H
@@ -0,0 +1,45 @@
+#ifndef NPC_BEHAVIOUR_H
+#define NPC_BEHAVIOUR_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief How a character moves each turn.
+ *
+ * Idle characters stay put, wanderers sometimes take a random exit,
+ * followers step into the player's room when it is next door, and fleeing
+ * characters leave whenever the player walks in. No character passes a
+ * locked exit.
+ */
+enum class NpcBehaviour : std::uint8_t { Idle, Wander, Follow, Flee };
+
+inline constexpr std::array<std::string_view, 4> NPC_BEHAVIOUR_NAMES = {"idle", "wander", "follow", "flee"};
+
+/**
+ * @brief Gets the name used for a behaviour in the world data.
+ */
+inline std::string_view npcBehaviourName(NpcBehaviour behaviour) {
+    return NPC_BEHAVIOUR_NAMES[static_cast<std::size_t>(behaviour)];
+}
+
+/**
+ * @brief Reads a behaviour name from the world data; an empty name means idle.
+ * @return false if the name is not a behaviour.
+ */
+inline bool parseNpcBehaviour(std::string_view name, NpcBehaviour& behaviour) {
+    if (name.empty()) {
+        behaviour = NpcBehaviour::Idle;
+        return true;
+    }
+    for (std::size_t i = 0; i < NPC_BEHAVIOUR_NAMES.size(); ++i) {
+        if (name == NPC_BEHAVIOUR_NAMES[i]) {
+            behaviour = static_cast<NpcBehaviour>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // NPC_BEHAVIOUR_H
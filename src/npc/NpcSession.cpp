@@ -0,0 +1,81 @@
+#include "NpcSession.h"
+#include "../concurrency/WorkStealingScheduler.h"
+
+namespace {
+
+// Spreads turn numbers over the seed, so each turn's draws start from a different place
+constexpr std::uint64_t TURN_MIX = 0x9E3779B97F4A7C15ull;
+
+} // namespace
+
+NpcSession::NpcSession(const NpcSystem& world, WorkStealingScheduler* threads) : world(world), threads(threads) {}
+
+void NpcSession::reseed(std::uint64_t seed) {
+    this->seed = seed;
+}
+
+void NpcSession::decideRegion(std::size_t region, const Room* player_room, std::uint64_t turn_seed, std::vector<Step>& steps) const {
+    for (std::uint32_t npc : world.getMovers(region)) {
+        Room* from = getRoom(npc);
+        std::uint64_t random_state = NpcSystem::randomStart(turn_seed, npc);
+        Room* to = NpcSystem::chooseMove(world.getBehaviour(npc), from, player_room, random_state);
+        if (to != from) {
+            steps.push_back({npc, from, to});
+        }
+    }
+}
+
+const std::vector<NpcSystem::Move>& NpcSession::tick(const Room* player_room) {
+    std::uint64_t turn_seed = seed ^ (++turn * TURN_MIX);
+    std::size_t region_count = world.getRegionCount();
+
+    // Decide every move from the positions at the start of the turn. Deciding
+    // only reads them, so regions can be decided on several threads at once.
+    steps.clear();
+    bool parallel = threads && region_count > 1 && world.getMoverCount() >= NpcSystem::MIN_PARALLEL_MOVERS;
+    if (parallel) {
+        region_steps.resize(region_count);
+        parallel = threads->tryRun(region_count, [&](std::size_t region) {
+            region_steps[region].clear();
+            decideRegion(region, player_room, turn_seed, region_steps[region]);
+        });
+    }
+    if (parallel) {
+        for (const std::vector<Step>& region : region_steps) {
+            steps.insert(steps.end(), region.begin(), region.end());
+        }
+    } else {
+        for (std::size_t region = 0; region < region_count; ++region) {
+            decideRegion(region, player_room, turn_seed, steps);
+        }
+    }
+
+    // Then make them, in region order whichever way they were decided
+    moves.clear();
+    for (const Step& step : steps) {
+        if (step.to == world.getRoom(step.npc)) {
+            moved.erase(step.npc); // Back where the world placed it
+        } else {
+            moved[step.npc] = step.to;
+        }
+        moves.push_back({world.getCharacter(step.npc), step.from, step.to});
+    }
+    return moves;
+}
+
+std::size_t NpcSession::size() const {
+    return world.size();
+}
+
+Room* NpcSession::getRoom(std::size_t npc) const {
+    auto it = moved.find(static_cast<std::uint32_t>(npc));
+    return it != moved.end() ? it->second : world.getRoom(npc);
+}
+
+Character* NpcSession::getCharacter(std::size_t npc) const {
+    return world.getCharacter(npc);
+}
+
+std::size_t NpcSession::getMovedCount() const {
+    return moved.size();
+}
@@ -0,0 +1,77 @@
+#ifndef NPC_SESSION_H
+#define NPC_SESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "NpcSystem.h"
+
+class Room;
+class Character;
+class WorkStealingScheduler;
+
+/**
+ * @class NpcSession
+ * @brief Moves a shared world's characters for one session.
+ *
+ * The characters, their behaviours, the rooms they start in and the regions
+ * they are ticked in belong to the world's NpcSystem, which no session
+ * changes. A session keeps only where its characters stand now for those
+ * that are not where the world placed them, so a new session costs nothing
+ * however many characters the world has, and an old one memory for the
+ * characters that have wandered off.
+ *
+ * Nor does a session keep a random state per character: each turn a
+ * character's draws start from its seed, its number and the turn, so a
+ * seeded session still replays exactly. Characters are decided from where
+ * they stood at the start of the turn and then moved, as in NpcSystem, and
+ * regions may be decided in parallel on the world's threads when no other
+ * session is using them.
+ */
+class NpcSession {
+public:
+    /**
+     * @param world The world's characters, which must outlive the session.
+     * @param threads Threads shared by every session of the world, or nullptr to tick on the calling thread.
+     */
+    NpcSession(const NpcSystem& world, WorkStealingScheduler* threads);
+
+    void reseed(std::uint64_t seed);
+
+    /**
+     * @brief Advances every character by one turn.
+     * @param player_room The room the player is in, which following and fleeing react to.
+     * @return The moves made, valid until the next tick.
+     */
+    const std::vector<NpcSystem::Move>& tick(const Room* player_room);
+
+    std::size_t size() const;
+    Room* getRoom(std::size_t npc) const;
+    Character* getCharacter(std::size_t npc) const;
+
+    /**
+     * @brief Gets the number of characters not in the room the world placed them in.
+     */
+    std::size_t getMovedCount() const;
+
+private:
+    struct Step {
+        std::uint32_t npc;
+        Room* from;
+        Room* to;
+    };
+
+    void decideRegion(std::size_t region, const Room* player_room, std::uint64_t turn_seed, std::vector<Step>& steps) const;
+
+    const NpcSystem& world;
+    WorkStealingScheduler* threads;
+    std::unordered_map<std::uint32_t, Room*> moved; // Characters away from where the world placed them
+    std::vector<std::vector<Step>> region_steps;    // Per region, for parallel ticks
+    std::vector<Step> steps;                        // Reused from tick to tick
+    std::vector<NpcSystem::Move> moves;
+    std::uint64_t seed = 0;
+    std::uint64_t turn = 0;
+};
+
+#endif // NPC_SESSION_H
@@ -0,0 +1,272 @@
+#include "NpcSystem.h"
+#include "../Room.h"
+#include "../objects/Character.h"
+#include "../concurrency/WorkStealingScheduler.h"
+#include <algorithm>
+
+namespace {
+
+// Marks rooms not yet given a region while partitioning.
+constexpr std::uint32_t UNASSIGNED = 0xFFFFFFFF;
+
+// A wandering character takes an exit on one turn in this many.
+constexpr std::uint64_t WANDER_ODDS = 4;
+
+// SplitMix64: one add and a few multiplies per draw, with a single word of state.
+std::uint64_t nextRandom(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+} // namespace
+
+std::uint64_t NpcSystem::randomStart(std::uint64_t seed, std::size_t npc) {
+    std::uint64_t state = seed ^ (static_cast<std::uint64_t>(npc) * 0xD1B54A32D192ED03ull);
+    return nextRandom(state);
+}
+
+void NpcSystem::add(Character* character, Room* room) {
+    std::size_t npc = characters.size();
+    characters.push_back(character);
+    rooms.push_back(room);
+    behaviours.push_back(character->getBehaviour());
+    random_states.push_back(randomStart(seed, npc));
+    mover_positions.push_back(0);
+    if (character->getBehaviour() != NpcBehaviour::Idle) {
+        addMover(static_cast<std::uint32_t>(npc), room->getRegion());
+    }
+}
+
+void NpcSystem::addMover(std::uint32_t npc, std::uint32_t region) {
+    if (region >= regions.size()) {
+        regions.resize(region + 1);
+    }
+    mover_positions[npc] = static_cast<std::uint32_t>(regions[region].movers.size());
+    regions[region].movers.push_back(npc);
+    ++mover_count;
+}
+
+void NpcSystem::removeMover(std::uint32_t npc, std::uint32_t region) {
+    std::vector<std::uint32_t>& movers = regions[region].movers;
+    std::uint32_t position = mover_positions[npc];
+    movers[position] = movers.back();
+    mover_positions[movers[position]] = position;
+    movers.pop_back();
+    --mover_count;
+}
+
+std::size_t NpcSystem::partition(const std::vector<std::unique_ptr<Room>>& all_rooms, std::size_t region_rooms) {
+    for (const auto& room : all_rooms) {
+        room->setRegion(UNASSIGNED);
+    }
+    std::uint32_t region_count = 0;
+    std::vector<Room*> frontier;
+    std::vector<Room*> seeds; // Rooms bordering finished regions, where the next regions start
+    std::size_t next_seed = 0;
+    std::size_t next_room = 0;
+    while (true) {
+        // Start beside the oldest region, so regions tile the world rather
+        // than leaving scraps between them; fall back to list order
+        Room* start = nullptr;
+        while (!start && next_seed < seeds.size()) {
+            Room* seed_room = seeds[next_seed++];
+            start = seed_room->getRegion() == UNASSIGNED ? seed_room : nullptr;
+        }
+        while (!start && next_room < all_rooms.size()) {
+            Room* room = all_rooms[next_room++].get();
+            start = room->getRegion() == UNASSIGNED ? room : nullptr;
+        }
+        if (!start) {
+            break;
+        }
+
+        // Take rooms in breadth-first order until the region is full
+        std::uint32_t region = region_count++;
+        std::uint32_t bordering = UNASSIGNED;
+        start->setRegion(region);
+        frontier.assign(1, start);
+        for (std::size_t next = 0; next < frontier.size(); ++next) {
+            for (const auto& [direction, neighbour] : frontier[next]->getAllExits()) {
+                std::uint32_t neighbour_region = neighbour->getRegion();
+                if (neighbour_region != UNASSIGNED) {
+                    bordering = neighbour_region != region ? neighbour_region : bordering;
+                } else if (frontier.size() < region_rooms) {
+                    neighbour->setRegion(region);
+                    frontier.push_back(neighbour);
+                } else {
+                    seeds.push_back(neighbour);
+                }
+            }
+        }
+
+        // A pocket hemmed in by other regions joins one of them instead of
+        // becoming a region too small to be worth a task
+        if (frontier.size() < region_rooms / 2 && bordering != UNASSIGNED) {
+            for (Room* room : frontier) {
+                room->setRegion(bordering);
+            }
+            --region_count;
+        }
+    }
+
+    // Sort the movers into their rooms' regions
+    regions.assign(std::max<std::uint32_t>(region_count, 1), Region());
+    mover_count = 0;
+    for (std::size_t npc = 0; npc < characters.size(); ++npc) {
+        if (behaviours[npc] != NpcBehaviour::Idle) {
+            addMover(static_cast<std::uint32_t>(npc), rooms[npc]->getRegion());
+        }
+    }
+    return region_count;
+}
+
+void NpcSystem::setRoomsShared(bool shared) {
+    rooms_shared = shared;
+}
+
+void NpcSystem::reseed(std::uint64_t seed) {
+    this->seed = seed;
+    for (std::size_t npc = 0; npc < random_states.size(); ++npc) {
+        random_states[npc] = randomStart(seed, npc);
+    }
+}
+
+Room* NpcSystem::chooseExit(Room* room, std::uint64_t& random_state) {
+    std::size_t open = 0;
+    for (const auto& [direction, target] : room->getAllExits()) {
+        open += (room->getExitKey(direction) == 0);
+    }
+    if (open == 0) {
+        return room;
+    }
+    std::size_t pick = nextRandom(random_state) % open;
+    for (const auto& [direction, target] : room->getAllExits()) {
+        if (room->getExitKey(direction) == 0 && pick-- == 0) {
+            return target;
+        }
+    }
+    return room;
+}
+
+Room* NpcSystem::chooseMove(NpcBehaviour behaviour, Room* room, const Room* player_room, std::uint64_t& random_state) {
+    switch (behaviour) {
+        case NpcBehaviour::Wander:
+            if (nextRandom(random_state) % WANDER_ODDS == 0) {
+                return chooseExit(room, random_state);
+            }
+            break;
+        case NpcBehaviour::Follow:
+            if (room != player_room) {
+                for (const auto& [direction, next] : room->getAllExits()) {
+                    if (next == player_room && room->getExitKey(direction) == 0) {
+                        return next;
+                    }
+                }
+            }
+            break;
+        case NpcBehaviour::Flee:
+            if (room == player_room) {
+                return chooseExit(room, random_state);
+            }
+            break;
+        case NpcBehaviour::Idle:
+            break;
+    }
+    return room;
+}
+
+const std::vector<NpcSystem::Move>& NpcSystem::tick(const Room* player_room, WorkStealingScheduler* scheduler) {
+    if (scheduler && regions.size() > 1 && mover_count >= MIN_PARALLEL_MOVERS) {
+        scheduler->run(regions.size(), [this, player_room](std::size_t region) {
+            tickRegion(regions[region], player_room);
+        });
+    } else {
+        for (Region& region : regions) {
+            tickRegion(region, player_room);
+        }
+    }
+
+    // Merge: moves between regions are made here, in region order, so no
+    // room is touched by two threads and the result is the same on any number.
+    moves.clear();
+    for (const Region& region : regions) {
+        moves.insert(moves.end(), region.moves.begin(), region.moves.end());
+    }
+    for (std::size_t r = 0; r < regions.size(); ++r) {
+        for (const Crossing& crossing : regions[r].crossings) {
+            Room* from = rooms[crossing.npc];
+            if (!rooms_shared) {
+                from->removeCharacter(characters[crossing.npc]);
+                crossing.to->addCharacter(characters[crossing.npc]);
+            }
+            rooms[crossing.npc] = crossing.to;
+            removeMover(crossing.npc, static_cast<std::uint32_t>(r));
+            addMover(crossing.npc, crossing.to->getRegion());
+            moves.push_back({characters[crossing.npc], from, crossing.to});
+        }
+    }
+    return moves;
+}
+
+void NpcSystem::tickRegion(Region& region, const Room* player_room) {
+    // Decide every move from the positions at the start of the turn...
+    const std::vector<std::uint32_t>& movers = region.movers;
+    region.intents.resize(movers.size());
+    for (std::size_t i = 0; i < movers.size(); ++i) {
+        std::uint32_t npc = movers[i];
+        region.intents[i] = chooseMove(behaviours[npc], rooms[npc], player_room, random_states[npc]);
+    }
+
+    // ...then make the ones within the region, touching only the rooms a
+    // character leaves or enters, and queue the rest for the merge.
+    region.moves.clear();
+    region.crossings.clear();
+    for (std::size_t i = 0; i < movers.size(); ++i) {
+        std::uint32_t npc = movers[i];
+        Room* from = rooms[npc];
+        Room* to = region.intents[i];
+        if (to == from) {
+            continue;
+        }
+        if (to->getRegion() != from->getRegion()) {
+            region.crossings.push_back({npc, to});
+            continue;
+        }
+        if (!rooms_shared) {
+            from->removeCharacter(characters[npc]);
+            to->addCharacter(characters[npc]);
+        }
+        rooms[npc] = to;
+        region.moves.push_back({characters[npc], from, to});
+    }
+}
+
+std::size_t NpcSystem::size() const {
+    return characters.size();
+}
+
+std::size_t NpcSystem::getMoverCount() const {
+    return mover_count;
+}
+
+std::size_t NpcSystem::getRegionCount() const {
+    return regions.size();
+}
+
+Room* NpcSystem::getRoom(std::size_t npc) const {
+    return rooms[npc];
+}
+
+Character* NpcSystem::getCharacter(std::size_t npc) const {
+    return characters[npc];
+}
+
+NpcBehaviour NpcSystem::getBehaviour(std::size_t npc) const {
+    return behaviours[npc];
+}
+
+const std::vector<std::uint32_t>& NpcSystem::getMovers(std::size_t region) const {
+    return regions[region].movers;
+}
@@ -0,0 +1,141 @@
+#ifndef NPC_SYSTEM_H
+#define NPC_SYSTEM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "NpcBehaviour.h"
+
+class Room;
+class Character;
+class WorkStealingScheduler;
+
+/**
+ * @class NpcSystem
+ * @brief Moves the world's characters once per turn.
+ *
+ * Characters are stored as parallel arrays (room, behaviour, random state)
+ * rather than walked through their objects, and idle characters are left
+ * out of the tick entirely, so a turn costs time in proportion to the
+ * characters that can move. A tick runs in two passes: the first decides
+ * where every mover goes, reading only the positions from before the tick,
+ * and the second applies the moves, updating each room's occupants in
+ * constant time. Deciding before moving means the outcome does not depend
+ * on the order characters are stored in.
+ *
+ * Each character draws from its own random stream derived from the seed and
+ * its position in the system, so a seeded game replays exactly.
+ *
+ * For large worlds the rooms can be partitioned into regions, which are then
+ * ticked in parallel. A region's thread moves characters only between rooms
+ * of that region; moves into another region are queued and made afterwards
+ * on the calling thread, region by region. Where a character goes never
+ * depends on where the others are, and the queued moves are made in a fixed
+ * order, so the world comes out the same for any number of threads.
+ */
+class NpcSystem {
+public:
+    struct Move {
+        Character* character;
+        Room* from;
+        Room* to;
+    };
+
+    // Below this many movers a tick is cheaper on one thread than the hand-off to others
+    static constexpr std::size_t MIN_PARALLEL_MOVERS = 4096;
+
+    /**
+     * @brief Adds a character standing in a room, with the character's configured behaviour.
+     */
+    void add(Character* character, Room* room);
+
+    /**
+     * @brief Leaves the rooms' lists of occupants alone when characters move,
+     *        for rooms shared between sessions; the owner then keeps its own
+     *        lists up to date from the moves tick() returns.
+     */
+    void setRoomsShared(bool shared);
+
+    /**
+     * @brief Restarts every character's random stream from a seed.
+     */
+    void reseed(std::uint64_t seed);
+
+    /**
+     * @brief Cuts the world into regions of about region_rooms connected rooms.
+     *
+     * Each region is grown breadth-first through exits from the first room in
+     * the list not yet taken, so the regions depend only on the world. Sets
+     * every room's region; characters may be added before or after. Characters
+     * added to rooms that already have their regions, as a shared world's do,
+     * are sorted into them without partitioning again.
+     * @return The number of regions.
+     */
+    std::size_t partition(const std::vector<std::unique_ptr<Room>>& rooms, std::size_t region_rooms);
+
+    /**
+     * @brief Advances every character by one turn.
+     * @param player_room The room the player is in, which following and fleeing react to.
+     * @param scheduler Threads to tick the regions on, or nullptr to tick on the calling thread.
+     * @return The moves made, valid until the next tick.
+     */
+    const std::vector<Move>& tick(const Room* player_room, WorkStealingScheduler* scheduler = nullptr);
+
+    std::size_t size() const;
+    std::size_t getMoverCount() const;
+    std::size_t getRegionCount() const;
+    Room* getRoom(std::size_t npc) const;
+    Character* getCharacter(std::size_t npc) const;
+    NpcBehaviour getBehaviour(std::size_t npc) const;
+
+    /**
+     * @brief Gets the characters in a region that are not idle.
+     */
+    const std::vector<std::uint32_t>& getMovers(std::size_t region) const;
+
+    /**
+     * @brief Decides where a character in a room goes this turn, drawing from its random state.
+     * @return The room it moves to, or room if it stays.
+     */
+    static Room* chooseMove(NpcBehaviour behaviour, Room* room, const Room* player_room, std::uint64_t& random_state);
+
+    /**
+     * @brief Gets the start of a character's random stream for a seed.
+     */
+    static std::uint64_t randomStart(std::uint64_t seed, std::size_t npc);
+
+private:
+    struct Crossing {
+        std::uint32_t npc;
+        Room* to;
+    };
+
+    // Padded to a cache line so that threads ticking neighbouring regions do not contend
+    struct alignas(64) Region {
+        std::vector<std::uint32_t> movers;   // Characters in the region that are not idle
+        std::vector<Room*> intents;          // Per mover, filled by the first pass of a tick
+        std::vector<Move> moves;             // Made within the region this tick
+        std::vector<Crossing> crossings;     // Into other regions, made after every region has ticked
+    };
+
+    void tickRegion(Region& region, const Room* player_room);
+    static Room* chooseExit(Room* room, std::uint64_t& random_state); // A random unlocked exit, or the room if there is none
+    void addMover(std::uint32_t npc, std::uint32_t region);
+    void removeMover(std::uint32_t npc, std::uint32_t region);
+
+    // One entry per character
+    std::vector<Character*> characters;
+    std::vector<Room*> rooms;
+    std::vector<NpcBehaviour> behaviours;
+    std::vector<std::uint64_t> random_states;
+    std::vector<std::uint32_t> mover_positions; // Index into the region's movers, for movers
+
+    std::vector<Region> regions = std::vector<Region>(1);
+    std::size_t mover_count = 0;
+    std::vector<Move> moves; // Reused from tick to tick
+    std::uint64_t seed = 0;
+    bool rooms_shared = false;
+};
+
+#endif // NPC_SYSTEM_H
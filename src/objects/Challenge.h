@@ -15,6 +15,7 @@
 struct CBTChoice {
     std::string description; // Text displayed for the choice
     std::function<void()> action; // Action to perform if this choice is selected (no Game& argument)
+    int score_change = 0; // Added to the score of the player who makes the choice
 };
 
 /**
@@ -23,6 +24,9 @@ struct CBTChoice {
  *
  * A challenge presents a situation or thought pattern that the player needs to address
  * using CBT principles. It offers a set of choices, each with a specific outcome.
+ * Choosing any of them resolves the challenge for that player. Challenges in a
+ * shared world are read by every session, so their outcomes are data rather
+ * than actions bound to one game.
  */
 class Challenge {
 public:
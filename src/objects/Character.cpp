@@ -6,5 +6,28 @@ Character::Character(int id, const std::string& name, const std::string& descrip
 }
 
 std::string Character::getDialogue() const {
-    return dialogue;
+    return text_store ? text_store->get(dialogue_id) : dialogue;
+}
+
+void Character::compressText(TextStore& store) {
+    if (text_store) {
+        return;
+    }
+    dialogue_id = store.add(std::move(dialogue));
+    dialogue = std::string(); // Release the buffer
+    RoomObject::compressText(store);
+}
+
+void Character::useText(const TextStore& store, TextId description_id, TextId dialogue_id) {
+    dialogue = std::string();
+    this->dialogue_id = dialogue_id;
+    RoomObject::useText(store, description_id);
+}
+
+NpcBehaviour Character::getBehaviour() const {
+    return behaviour;
+}
+
+void Character::setBehaviour(NpcBehaviour behaviour) {
+    this->behaviour = behaviour;
 }
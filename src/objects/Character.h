@@ -2,6 +2,7 @@
 #define CHARACTER_H
 
 #include "RoomObject.h"
+#include "../npc/NpcBehaviour.h"
 #include <string>
 // #include "../Room.h" // Removed to break circular dependency
 
@@ -13,9 +14,17 @@ public:
     Character(int id, const std::string& name, const std::string& description, int room_id, const std::string& dialogue);
 
     std::string getDialogue() const;
+    void compressText(TextStore& store) override;
+    void useText(const TextStore& store, TextId description_id, TextId dialogue_id); // Both already in the store
+
+    // How the character moves each turn; set from the world data, read by NpcSystem
+    NpcBehaviour getBehaviour() const;
+    void setBehaviour(NpcBehaviour behaviour);
 
 private:
     std::string dialogue;
+    TextId dialogue_id = 0;
+    NpcBehaviour behaviour = NpcBehaviour::Idle;
 };
 
 #endif // CHARACTER_H
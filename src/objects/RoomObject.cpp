@@ -13,9 +13,32 @@ std::string RoomObject::getName() const {
 }
 
 std::string RoomObject::getDescription() const {
-    return description;
+    return text_store ? text_store->get(description_id) : description;
 }
 
 int RoomObject::getRoomId() const {
     return room_id;
 }
+
+void RoomObject::compressText(TextStore& store) {
+    if (text_store) {
+        return;
+    }
+    description_id = store.add(std::move(description));
+    description = std::string(); // Release the buffer
+    text_store = &store;
+}
+
+void RoomObject::useText(const TextStore& store, TextId description_id) {
+    description = std::string();
+    this->description_id = description_id;
+    text_store = &store;
+}
+
+SlotHandle RoomObject::getSlot() const {
+    return slot;
+}
+
+void RoomObject::setSlot(SlotHandle slot) {
+    this->slot = slot;
+}
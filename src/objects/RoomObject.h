@@ -2,6 +2,8 @@
 #define ROOM_OBJECT_H
 
 #include <string>
+#include "../text/TextStore.h"
+#include "../containers/SlotMap.h"
 
 class RoomObject {
 public:
@@ -13,11 +15,32 @@ public:
     std::string getDescription() const;
     int getRoomId() const;
 
+    /**
+     * @brief Moves the long texts into a TextStore, which must outlive the object.
+     */
+    virtual void compressText(TextStore& store);
+
+    /**
+     * @brief Reads the description from a TextStore that already holds it, which must outlive the object.
+     */
+    void useText(const TextStore& store, TextId description_id);
+
+    /**
+     * @brief Gets the object's handle in the room or inventory holding it, set by that container.
+     */
+    SlotHandle getSlot() const;
+    void setSlot(SlotHandle slot);
+
+protected:
+    const TextStore* text_store = nullptr; // Holds the long texts once compressed
+
 private:
     int id;
     std::string name;
     std::string description;
+    TextId description_id = 0;
     int room_id;
+    SlotHandle slot;
 };
 
 #endif // ROOM_OBJECT_H
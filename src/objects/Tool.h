@@ -7,6 +7,8 @@
 class Tool : public RoomObject {
 public:
     Tool(int id, const std::string& name, const std::string& description, int initial_room_id);
+
+    int getInitialRoomId() const; // The room the tool is placed in when the world loads
 };
 
 #endif // TOOL_H
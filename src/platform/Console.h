@@ -1,6 +1,8 @@
 #ifndef CONSOLE_H
 #define CONSOLE_H
 
+#include <memory>
+
 /**
  * @class Console
  * @brief An abstract base class for platform-specific console operations.
@@ -12,6 +14,22 @@
  */
 class Console {
 public:
+    // Values returned by pollChar() besides plain characters
+    static constexpr int NO_INPUT = -1;     // Timed out with no key pressed
+    static constexpr int END_OF_INPUT = -2; // The input stream was closed
+    static constexpr int KEY_UP = 0x100;
+    static constexpr int KEY_DOWN = 0x101;
+    static constexpr int KEY_LEFT = 0x102;
+    static constexpr int KEY_RIGHT = 0x103;
+    static constexpr int KEY_HOME = 0x104;
+    static constexpr int KEY_END = 0x105;
+    static constexpr int KEY_DELETE = 0x106;
+
+    /**
+     * @brief Creates the console implementation for the current platform.
+     */
+    static std::unique_ptr<Console> create();
+
     /**
      * @brief Virtual destructor.
      */
@@ -34,6 +52,20 @@ public:
      * @return The ASCII value of the character read.
      */
     virtual int getChar() = 0;
+
+    /**
+     * @brief Waits up to a timeout for a key press without blocking the caller longer.
+     * @param timeout_ms Milliseconds to wait; 0 returns immediately, negative waits forever.
+     * @return The character read, one of the KEY_ codes for cursor keys,
+     *         NO_INPUT if the timeout expired, or END_OF_INPUT if the input was closed.
+     */
+    virtual int pollChar(int timeout_ms) = 0;
+
+    /**
+     * @brief Gets the width of the visible console window in columns.
+     * @return The width, or 80 if it cannot be determined.
+     */
+    virtual int getWidth() = 0;
 };
 
 #endif // CONSOLE_H
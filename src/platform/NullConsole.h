@@ -0,0 +1,22 @@
+#ifndef NULL_CONSOLE_H
+#define NULL_CONSOLE_H
+
+#include "Console.h"
+
+/**
+ * @class NullConsole
+ * @brief A Console that draws nothing and has no input, for headless games.
+ *
+ * Used when a Game is driven programmatically, for example when replaying a
+ * recording, so that no terminal settings are touched and no output is produced.
+ */
+class NullConsole : public Console {
+public:
+    void clear() override {}
+    void setCursorPosition(int, int) override {}
+    int getChar() override { return END_OF_INPUT; }
+    int pollChar(int) override { return END_OF_INPUT; }
+    int getWidth() override { return 80; }
+};
+
+#endif // NULL_CONSOLE_H
@@ -0,0 +1,97 @@
+#ifndef _WIN32
+
+#include "PosixConsole.h"
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <iostream>
+
+std::unique_ptr<Console> Console::create() {
+    return std::make_unique<PosixConsole>();
+}
+
+PosixConsole::PosixConsole() : is_terminal(isatty(STDIN_FILENO) != 0), saved_settings() {
+    if (is_terminal && tcgetattr(STDIN_FILENO, &saved_settings) == 0) {
+        struct termios raw = saved_settings;
+        raw.c_lflag &= ~(ICANON | ECHO); // Keep ISIG so that Ctrl+C still raises SIGINT
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    } else {
+        is_terminal = false;
+    }
+}
+
+PosixConsole::~PosixConsole() {
+    if (is_terminal) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_settings);
+    }
+}
+
+void PosixConsole::clear() {
+    std::cout << "\033[2J\033[H" << std::flush;
+}
+
+void PosixConsole::setCursorPosition(int x, int y) {
+    // ANSI positions are 1-based, row first
+    std::cout << "\033[" << (y + 1) << ';' << (x + 1) << 'H';
+}
+
+int PosixConsole::getChar() {
+    return pollChar(-1);
+}
+
+int PosixConsole::readByte(int timeout_ms) {
+    struct pollfd fd = {STDIN_FILENO, POLLIN, 0};
+    int ready = poll(&fd, 1, timeout_ms);
+    if (ready <= 0) {
+        // Timeout, or EINTR from a signal such as SIGINT; the caller checks its flags
+        return NO_INPUT;
+    }
+    unsigned char c = 0;
+    ssize_t n = read(STDIN_FILENO, &c, 1);
+    if (n == 0) {
+        return END_OF_INPUT;
+    }
+    if (n < 0) {
+        return (errno == EINTR || errno == EAGAIN) ? NO_INPUT : END_OF_INPUT;
+    }
+    return c;
+}
+
+int PosixConsole::pollChar(int timeout_ms) {
+    std::cout << std::flush; // Make sure echoed output is visible before waiting
+    int c = readByte(timeout_ms);
+    if (c != 0x1b) {
+        return c;
+    }
+
+    // An escape sequence arrives in one burst; a lone ESC key press does not.
+    const int SEQUENCE_TIMEOUT_MS = 5;
+    if (readByte(SEQUENCE_TIMEOUT_MS) != '[') {
+        return c;
+    }
+    switch (readByte(SEQUENCE_TIMEOUT_MS)) {
+        case 'A': return KEY_UP;
+        case 'B': return KEY_DOWN;
+        case 'C': return KEY_RIGHT;
+        case 'D': return KEY_LEFT;
+        case 'H': return KEY_HOME;
+        case 'F': return KEY_END;
+        case '3':
+            return (readByte(SEQUENCE_TIMEOUT_MS) == '~') ? KEY_DELETE : NO_INPUT;
+        default:
+            return NO_INPUT;
+    }
+}
+
+int PosixConsole::getWidth() {
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+        return size.ws_col;
+    }
+    return 80;
+}
+
+#endif // _WIN32
@@ -0,0 +1,52 @@
+#ifndef POSIX_CONSOLE_H
+#define POSIX_CONSOLE_H
+
+#include "Console.h"
+#include <termios.h> // Required for struct termios
+
+/**
+ * @class PosixConsole
+ * @brief Implements the Console interface for Linux and macOS terminals.
+ *
+ * Puts the terminal into non-canonical, no-echo mode for the lifetime of the
+ * object so that keys can be read one at a time, and uses ANSI escape
+ * sequences for clearing and cursor movement. If standard input is not a
+ * terminal (for example when input is piped in) the terminal settings are
+ * left alone and characters are read from the stream as they arrive.
+ */
+class PosixConsole : public Console {
+public:
+    /**
+     * @brief Constructs a new PosixConsole object, switching the terminal to raw input.
+     */
+    PosixConsole();
+
+    /**
+     * @brief Restores the terminal settings saved by the constructor.
+     */
+    ~PosixConsole() override;
+
+    void clear() override;
+    void setCursorPosition(int x, int y) override;
+    int getChar() override;
+
+    /**
+     * @brief Waits up to a timeout for a key press using poll(2).
+     *
+     * ANSI escape sequences for the cursor keys are translated to KEY_ codes.
+     */
+    int pollChar(int timeout_ms) override;
+
+    /**
+     * @brief Gets the terminal width with the TIOCGWINSZ ioctl.
+     */
+    int getWidth() override;
+
+private:
+    int readByte(int timeout_ms);
+
+    bool is_terminal;
+    struct termios saved_settings; // Terminal settings to restore on destruction
+};
+
+#endif // POSIX_CONSOLE_H
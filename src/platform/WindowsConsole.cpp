@@ -1,6 +1,13 @@
+#ifdef _WIN32
+
 #include "WindowsConsole.h"
 #include <conio.h>   // Required for _getch()
 #include <windows.h> // Required for Windows console API
+#include <chrono>
+
+std::unique_ptr<Console> Console::create() {
+    return std::make_unique<WindowsConsole>();
+}
 
 WindowsConsole::WindowsConsole() : hConsole(GetStdHandle(STD_OUTPUT_HANDLE)) {}
 
@@ -33,3 +40,38 @@ void WindowsConsole::clear() {
 int WindowsConsole::getChar() {
     return _getch();
 }
+
+int WindowsConsole::pollChar(int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!_kbhit()) {
+        if (timeout_ms >= 0 && std::chrono::steady_clock::now() >= deadline) {
+            return NO_INPUT;
+        }
+        Sleep(1);
+    }
+    int c = _getch();
+    if (c == 0 || c == 224) {
+        // Extended keys arrive as a prefix byte followed by a scan code
+        switch (_getch()) {
+            case 72: return KEY_UP;
+            case 80: return KEY_DOWN;
+            case 75: return KEY_LEFT;
+            case 77: return KEY_RIGHT;
+            case 71: return KEY_HOME;
+            case 79: return KEY_END;
+            case 83: return KEY_DELETE;
+            default: return NO_INPUT;
+        }
+    }
+    return c;
+}
+
+int WindowsConsole::getWidth() {
+    CONSOLE_SCREEN_BUFFER_INFO csbi;
+    if (GetConsoleScreenBufferInfo(hConsole, &csbi)) {
+        return csbi.srWindow.Right - csbi.srWindow.Left + 1;
+    }
+    return 80;
+}
+
+#endif // _WIN32
@@ -44,6 +44,16 @@ public:
      */
     int getChar() override;
 
+    /**
+     * @brief Waits up to a timeout for a key press, translating arrow keys.
+     */
+    int pollChar(int timeout_ms) override;
+
+    /**
+     * @brief Gets the width of the visible window from GetConsoleScreenBufferInfo.
+     */
+    int getWidth() override;
+
 private:
     HANDLE hConsole; // Handle to the console screen buffer
 };
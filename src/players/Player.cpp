@@ -1,16 +1,20 @@
 #include "Player.h"
 #include "../Room.h"
-#include <algorithm>
+#include "../world/WorldOverlay.h"
 
 Player::Player(int id, const std::string& name, const std::string& joinDate, Room* startingRoom)
-    : id(id), name(name), joinDate(joinDate), currentRoom(startingRoom), score(0) {}
+    : id(id), name(name), joinDate(joinDate), currentRoom(startingRoom), score(0) {
+    tool_bits.set(0);
+}
 
 Player::Player(Room* startingRoom)
-    : id(0), name("Player"), joinDate("N/A"), currentRoom(startingRoom), score(0) {}
+    : id(0), name("Player"), joinDate("N/A"), currentRoom(startingRoom), score(0) {
+    tool_bits.set(0);
+}
 
 void Player::move(const std::string& direction) {
     if (currentRoom) {
-        Room* nextRoom = currentRoom->getExit(direction);
+        Room* nextRoom = currentRoom->getExit(direction, tool_bits);
         if (nextRoom) {
             setCurrentRoom(nextRoom);
         }
@@ -49,24 +53,73 @@ void Player::incrementScore(int amount) {
     score += amount;
 }
 
-void Player::takeTool(Tool* tool) {
-    if (tool) {
-        tools.push_back(tool);
-        if (currentRoom) {
+void Player::setScore(int score) {
+    this->score = score;
+}
+
+SlotHandle Player::takeTool(Tool* tool) {
+    if (!tool) {
+        return SlotHandle();
+    }
+    SlotHandle held = findTool(tool);
+    if (!held.isNull()) {
+        return held; // Already carried
+    }
+    if (currentRoom) {
+        if (overlay) {
+            overlay->removeObject(*currentRoom, tool);
+        } else {
             currentRoom->removeObject(tool);
         }
     }
+    SlotHandle slot = tools.insert(tool);
+    tool_slots.emplace(tool, slot);
+    if (tool->getId() > 0) {
+        tool_bits.set(static_cast<std::size_t>(tool->getId()));
+    }
+    return slot;
+}
+
+SlotHandle Player::findTool(const Tool* tool) const {
+    auto it = tool_slots.find(tool);
+    return it != tool_slots.end() ? it->second : SlotHandle();
+}
+
+void Player::setWorldOverlay(WorldOverlay* overlay) {
+    this->overlay = overlay;
+}
+
+Tool* Player::getTool(SlotHandle handle) const {
+    Tool* const* held = tools.get(handle);
+    return held ? *held : nullptr;
 }
 
 const std::vector<Tool*>& Player::getTools() const {
-    return tools;
+    return tools.getValues();
+}
+
+bool Player::hasTool(int tool_id) const {
+    return tool_id > 0 && tool_bits.test(static_cast<std::size_t>(tool_id));
+}
+
+const DynamicBitset& Player::getToolBits() const {
+    return tool_bits;
 }
 
 void Player::dropTool(Tool* tool) {
-    if (tool && currentRoom) {
+    SlotHandle held = tool ? findTool(tool) : SlotHandle();
+    if (currentRoom && !held.isNull()) {
         // Remove the tool from the player's inventory
-        tools.erase(std::remove(tools.begin(), tools.end(), tool), tools.end());
+        tools.erase(held);
+        tool_slots.erase(tool);
+        if (tool->getId() > 0) {
+            tool_bits.reset(static_cast<std::size_t>(tool->getId()));
+        }
         // Add the tool to the current room
-        currentRoom->addObject(tool);
+        if (overlay) {
+            overlay->addObject(*currentRoom, tool);
+        } else {
+            currentRoom->addObject(tool);
+        }
     }
-}
\ No newline at end of file
+}
@@ -2,10 +2,14 @@
 #define PLAYER_H
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "../objects/Tool.h"
+#include "../util/DynamicBitset.h"
+#include "../containers/SlotMap.h"
 
 class Room; // Forward declaration for Room
+class WorldOverlay;
 
 class Player {
 public:
@@ -21,19 +25,43 @@ public:
     std::string getRepresentation() const;
     int getScore() const;
     void incrementScore(int amount = 1);
+    void setScore(int score); // Used when restoring a save game
 
-    // Inventory methods
-    void takeTool(Tool* tool);
+    // Inventory methods. Taking and dropping take constant time. Each tool's
+    // handle is kept here rather than in the tool, which every session over a
+    // shared world points to.
+    SlotHandle takeTool(Tool* tool); // Returns the tool's handle in the inventory
     void dropTool(Tool* tool);
-    const std::vector<Tool*>& getTools() const;
+    Tool* getTool(SlotHandle handle) const; // nullptr once the tool has been dropped
+    const std::vector<Tool*>& getTools() const; // Order changes when a tool is dropped
+    bool hasTool(int tool_id) const;
+
+    /**
+     * @brief Gets the IDs of the tools carried as a bitset, for lock checks.
+     *
+     * Bit 0 is always set, so exits with no key (key 0) always pass.
+     */
+    const DynamicBitset& getToolBits() const;
+
+    /**
+     * @brief Makes taking and dropping tools change a session's view of the
+     *        rooms instead of the rooms themselves, which a shared world's are.
+     * @param overlay The session's overlay, which must outlive the player, or nullptr.
+     */
+    void setWorldOverlay(WorldOverlay* overlay);
 
 private:
+    SlotHandle findTool(const Tool* tool) const; // A null handle if it is not carried
+
     int id;
     std::string name;
     std::string joinDate;
     Room* currentRoom;
     int score; // Added for tracking player score
-    std::vector<Tool*> tools; // Player's inventory of tools
+    SlotMap<Tool*> tools; // Player's inventory of tools
+    std::unordered_map<const Tool*, SlotHandle> tool_slots; // Each carried tool's handle in `tools`
+    DynamicBitset tool_bits; // IDs of the tools in `tools`, plus 0
+    WorldOverlay* overlay = nullptr; // Where tools leave and enter rooms, if the rooms are shared
 };
 
 #endif // PLAYER_H
@@ -0,0 +1,56 @@
+#ifndef FIXED_STEP_CLOCK_H
+#define FIXED_STEP_CLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @class FixedStepClock
+ * @brief Paces a simulation that advances in steps of fixed length.
+ *
+ * Steps are scheduled on a fixed grid from the start time, not relative to
+ * when the last one ran, so simulated time keeps step with the wall clock
+ * however long each step takes. If the simulation falls further behind than
+ * it can catch up on (the process was suspended, say), the excess steps are
+ * dropped instead of being run in a burst.
+ */
+class FixedStepClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    FixedStepClock(Clock::duration step, Clock::time_point start, std::uint32_t max_catch_up = 5)
+        : step(step), next(start + step), max_catch_up(max_catch_up) {}
+
+    /**
+     * @brief Counts the steps due by now and moves the schedule past them.
+     * @return The steps to run, at most max_catch_up.
+     */
+    std::uint32_t takeDueSteps(Clock::time_point now) {
+        if (now < next) {
+            return 0;
+        }
+        std::uint64_t behind = static_cast<std::uint64_t>((now - next) / step) + 1;
+        next += step * behind;
+        std::uint32_t due = behind < max_catch_up ? static_cast<std::uint32_t>(behind) : max_catch_up;
+        dropped += behind - due;
+        steps += due;
+        return due;
+    }
+
+    /**
+     * @brief Gets when the next step falls due.
+     */
+    Clock::time_point getNextStepTime() const { return next; }
+
+    std::uint64_t getStepCount() const { return steps; }
+    std::uint64_t getDroppedSteps() const { return dropped; }
+
+private:
+    Clock::duration step;
+    Clock::time_point next;
+    std::uint32_t max_catch_up;
+    std::uint64_t steps = 0;
+    std::uint64_t dropped = 0;
+};
+
+#endif // FIXED_STEP_CLOCK_H
@@ -0,0 +1,72 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+/**
+ * @class SpscQueue
+ * @brief A fixed-size queue from one producer thread to one consumer thread without locks.
+ *
+ * Holds up to Capacity - 1 values. Pushing to a full queue or popping from
+ * an empty one fails at once rather than waiting, so neither thread can be
+ * held up by the other.
+ */
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+public:
+    /**
+     * @brief Moves a value onto the queue. Producer thread only.
+     * @return false, leaving value untouched, if the queue is full.
+     */
+    bool tryPush(T& value) {
+        std::size_t tail = this->tail.load(std::memory_order_relaxed);
+        std::size_t next = (tail + 1) % Capacity;
+        if (next == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        slots[tail] = std::move(value);
+        this->tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Fills the next free slot in place with fill(slot), which saves
+     *        building a large value only to copy it in. Producer thread only.
+     * @return false, without calling fill, if the queue is full.
+     */
+    template <typename Fill>
+    bool tryPushWith(Fill fill) {
+        std::size_t tail = this->tail.load(std::memory_order_relaxed);
+        std::size_t next = (tail + 1) % Capacity;
+        if (next == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        fill(slots[tail]);
+        this->tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Moves the oldest value off the queue. Consumer thread only.
+     * @return false if the queue is empty.
+     */
+    bool tryPop(T& value) {
+        std::size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots[head]);
+        this->head.store((head + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, Capacity> slots{};
+    alignas(64) std::atomic<std::size_t> head{0}; // Next to pop; written by the consumer
+    alignas(64) std::atomic<std::size_t> tail{0}; // Next to fill; written by the producer
+};
+
+#endif // SPSC_QUEUE_H
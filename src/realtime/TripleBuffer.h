@@ -0,0 +1,61 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class TripleBuffer
+ * @brief Hands the latest value from one writer thread to one reader thread without locks.
+ *
+ * The writer fills the back buffer and publishes it; the reader takes the
+ * most recently published buffer when it is ready for one. Neither side ever
+ * waits for the other: a writer that publishes faster than the reader reads
+ * simply replaces the value not yet taken, and a slow reader keeps its own
+ * buffer for as long as it likes. Publishing and taking are each a single
+ * atomic exchange of buffer indices.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /**
+     * @brief Gets the buffer the writer fills next. Writer thread only.
+     */
+    T& getWriteBuffer() { return buffers[back]; }
+
+    /**
+     * @brief Makes the write buffer the latest value and starts a new write buffer. Writer thread only.
+     */
+    void publish() {
+        back = middle.exchange(static_cast<std::uint8_t>(back | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    /**
+     * @brief Takes the latest published value, if there is one newer than the read buffer. Reader thread only.
+     * @return true if the read buffer now holds a new value.
+     */
+    bool update() {
+        if ((middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    /**
+     * @brief Gets the value taken by the last successful update(). Reader thread only.
+     */
+    const T& getReadBuffer() const { return buffers[front]; }
+
+private:
+    static constexpr std::uint8_t INDEX = 0x3;
+    static constexpr std::uint8_t FRESH = 0x4; // Set in middle when it holds a value the reader has not taken
+
+    std::array<T, 3> buffers{};
+    std::uint8_t back = 0;                 // Owned by the writer
+    std::atomic<std::uint8_t> middle{1};   // Passed between them
+    std::uint8_t front = 2;                // Owned by the reader
+};
+
+#endif // TRIPLE_BUFFER_H
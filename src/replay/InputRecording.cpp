@@ -0,0 +1,77 @@
+#include "InputRecording.h"
+#include "../util/Varint.h"
+#include <cstring>
+
+InputRecorder::InputRecorder(std::ostream& out, std::uint64_t seed, const std::string& world_source)
+    : out(out), last_time(std::chrono::steady_clock::now()), finished(false) {
+    out.write(InputRecording::MAGIC, sizeof(InputRecording::MAGIC));
+    Varint::write(out, InputRecording::VERSION);
+    Varint::writeFixed64(out, seed);
+    Varint::writeString(out, world_source);
+}
+
+void InputRecorder::recordLine(const std::string& line) {
+    if (finished) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    auto delay = std::chrono::duration_cast<std::chrono::microseconds>(now - last_time).count();
+    last_time = now;
+
+    out.put(static_cast<char>(InputRecording::LINE_RECORD));
+    Varint::write(out, static_cast<std::uint64_t>(delay));
+    Varint::writeString(out, line);
+}
+
+void InputRecorder::finish(std::uint64_t state_hash) {
+    if (finished) {
+        return;
+    }
+    finished = true;
+    out.put(static_cast<char>(InputRecording::END_RECORD));
+    Varint::writeFixed64(out, state_hash);
+    out.flush();
+}
+
+InputRecordingReader::InputRecordingReader(std::istream& in)
+    : in(in), seed(0), end_seen(false), state_hash(0) {}
+
+bool InputRecordingReader::readHeader() {
+    char magic[sizeof(InputRecording::MAGIC)] = {};
+    std::uint64_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, InputRecording::MAGIC, sizeof(magic)) != 0) {
+        return false;
+    }
+    return Varint::read(in, version) && version == InputRecording::VERSION &&
+           Varint::readFixed64(in, seed) && Varint::readString(in, world_source);
+}
+
+bool InputRecordingReader::nextLine(std::string& line, std::uint64_t& delay_us) {
+    if (end_seen) {
+        return false;
+    }
+    int tag = in.get();
+    if (tag == InputRecording::LINE_RECORD) {
+        return Varint::read(in, delay_us) && Varint::readString(in, line);
+    }
+    if (tag == InputRecording::END_RECORD && Varint::readFixed64(in, state_hash)) {
+        end_seen = true;
+    }
+    return false;
+}
+
+std::uint64_t InputRecordingReader::getSeed() const {
+    return seed;
+}
+
+const std::string& InputRecordingReader::getWorldSource() const {
+    return world_source;
+}
+
+bool InputRecordingReader::hasEnd() const {
+    return end_seen;
+}
+
+std::uint64_t InputRecordingReader::getStateHash() const {
+    return state_hash;
+}
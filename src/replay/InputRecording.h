@@ -0,0 +1,95 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <chrono>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+/**
+ * @file InputRecording.h
+ * @brief Compact binary recordings of the lines a player typed.
+ *
+ * Layout (integers are LEB128 varints unless noted):
+ *
+ *     "QPRC" version seed(8 bytes LE) world_source(length + bytes)
+ *     { 0x01 delay_us length bytes }*     one per line read by the game loop
+ *     0x02 state_hash(8 bytes LE)         written when the game ends
+ *
+ * delay_us is the time since the previous line (or since recording began),
+ * so typical records are a handful of bytes. world_source is the SQL dump the
+ * game was started with, empty for the CSV files.
+ */
+namespace InputRecording {
+    constexpr char MAGIC[4] = {'Q', 'P', 'R', 'C'};
+    constexpr std::uint64_t VERSION = 1;
+    constexpr int LINE_RECORD = 0x01;
+    constexpr int END_RECORD = 0x02;
+}
+
+/**
+ * @class InputRecorder
+ * @brief Writes an input recording as the game loop reads lines.
+ */
+class InputRecorder {
+public:
+    /**
+     * @brief Writes the recording header.
+     * @param out The stream to write to; must outlive the recorder.
+     * @param seed The game's RNG seed.
+     * @param world_source The SQL dump the game loaded, or empty for the CSV files.
+     */
+    InputRecorder(std::ostream& out, std::uint64_t seed, const std::string& world_source);
+
+    /**
+     * @brief Appends one input line with the time since the previous one.
+     */
+    void recordLine(const std::string& line);
+
+    /**
+     * @brief Appends the end record with the final state hash and flushes the stream.
+     */
+    void finish(std::uint64_t state_hash);
+
+private:
+    std::ostream& out;
+    std::chrono::steady_clock::time_point last_time;
+    bool finished;
+};
+
+/**
+ * @class InputRecordingReader
+ * @brief Reads an input recording record by record.
+ */
+class InputRecordingReader {
+public:
+    explicit InputRecordingReader(std::istream& in);
+
+    /**
+     * @brief Reads and validates the header.
+     * @return false if the stream is not a recording this version can read.
+     */
+    bool readHeader();
+
+    /**
+     * @brief Reads the next input line.
+     * @return false at the end record, at end of stream, or on a corrupt record.
+     *         hasEnd() tells the first case apart.
+     */
+    bool nextLine(std::string& line, std::uint64_t& delay_us);
+
+    std::uint64_t getSeed() const;
+    const std::string& getWorldSource() const;
+    bool hasEnd() const;
+    std::uint64_t getStateHash() const; // Valid once hasEnd() is true
+
+private:
+    std::istream& in;
+    std::uint64_t seed;
+    std::string world_source;
+    bool end_seen;
+    std::uint64_t state_hash;
+};
+
+#endif // INPUT_RECORDING_H
@@ -0,0 +1,30 @@
+#include "Replayer.h"
+#include "InputRecording.h"
+#include "../Game.h"
+#include <string>
+
+ReplayResult replayRecording(std::istream& in) {
+    ReplayResult result;
+    InputRecordingReader reader(in);
+    if (!reader.readHeader()) {
+        return result;
+    }
+    result.loaded = true;
+
+    Game game(reader.getWorldSource(), headless);
+    game.setSeed(reader.getSeed());
+
+    std::string line;
+    std::uint64_t delay_us = 0;
+    while (reader.nextLine(line, delay_us)) {
+        game.submitLine(line);
+        ++result.lines;
+        result.recorded_us += delay_us;
+    }
+
+    result.complete = reader.hasEnd();
+    result.expected_hash = reader.getStateHash();
+    result.actual_hash = game.getStateHash();
+    result.matched = result.complete && result.expected_hash == result.actual_hash;
+    return result;
+}
@@ -0,0 +1,30 @@
+#ifndef REPLAYER_H
+#define REPLAYER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+
+/**
+ * @brief The outcome of replaying one input recording.
+ */
+struct ReplayResult {
+    bool loaded = false;              // The header was valid
+    bool complete = false;            // The recording ends with a state hash
+    bool matched = false;             // The replayed state hash equals the recorded one
+    std::size_t lines = 0;            // Input lines fed to the game
+    std::uint64_t recorded_us = 0;    // Time the player took, from the recorded delays
+    std::uint64_t expected_hash = 0;
+    std::uint64_t actual_hash = 0;
+};
+
+/**
+ * @brief Replays a recording through a headless Game as fast as possible.
+ *
+ * The recorded delays are summed but not waited for. The game's standard
+ * output is left alone; callers that replay many recordings should redirect
+ * it, as the replay tool does.
+ */
+ReplayResult replayRecording(std::istream& in);
+
+#endif // REPLAYER_H
@@ -0,0 +1,228 @@
+#include "SaveGame.h"
+#include "../util/Varint.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+constexpr char MAGIC[4] = {'Q', 'P', 'S', 'V'};
+constexpr std::uint64_t VERSION = 1;
+constexpr int BASE_RECORD = 0x01;
+constexpr int DELTA_RECORD = 0x02;
+
+enum Entity : int { PlayerRoom = 1, PlayerScore = 2, ToolLocation = 3 };
+
+// Deltas may grow to this multiple of the snapshot before the file is compacted
+constexpr std::uint64_t COMPACT_RATIO = 4;
+constexpr std::uint64_t COMPACT_MIN_BYTES = 4096;
+
+// Encodes the entities of `state` that differ from `previous`; all of them if there is no previous state.
+std::string encodeChanges(const SaveState& state, const SaveState* previous) {
+    std::ostringstream out;
+    if (!previous || state.room_id != previous->room_id) {
+        out.put(static_cast<char>(PlayerRoom));
+        Varint::writeSigned(out, state.room_id);
+    }
+    if (!previous || state.score != previous->score) {
+        out.put(static_cast<char>(PlayerScore));
+        Varint::writeSigned(out, state.score);
+    }
+    for (const auto& [tool_id, location] : state.tool_locations) {
+        if (previous) {
+            auto old = previous->tool_locations.find(tool_id);
+            if (old != previous->tool_locations.end() && old->second == location) {
+                continue;
+            }
+        }
+        out.put(static_cast<char>(ToolLocation));
+        Varint::writeSigned(out, tool_id);
+        Varint::writeSigned(out, location);
+    }
+    return out.str();
+}
+
+bool applyChanges(const std::string& payload, SaveState& state) {
+    std::istringstream in(payload);
+    int kind;
+    while ((kind = in.get()) != std::char_traits<char>::eof()) {
+        std::int64_t first = 0, second = 0;
+        if (!Varint::readSigned(in, first)) {
+            return false;
+        }
+        switch (kind) {
+            case PlayerRoom: state.room_id = static_cast<int>(first); break;
+            case PlayerScore: state.score = static_cast<int>(first); break;
+            case ToolLocation:
+                if (!Varint::readSigned(in, second)) {
+                    return false;
+                }
+                state.tool_locations[static_cast<int>(first)] = static_cast<int>(second);
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+void writeHeader(std::ostream& out) {
+    out.write(MAGIC, sizeof(MAGIC));
+    Varint::write(out, VERSION);
+}
+
+} // namespace
+
+SaveFile::SaveFile(const std::string& path)
+    : path(path), has_snapshot(false), delta_count(0), snapshot_bytes(0), file_bytes(0) {}
+
+bool SaveFile::load(SaveState& state) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    char magic[sizeof(MAGIC)] = {};
+    std::uint64_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(magic)) != 0 ||
+        !Varint::read(in, version) || version != VERSION) {
+        std::cerr << "Error: " << path << " is not a save file this version can read." << std::endl;
+        return false;
+    }
+
+    SaveState loaded;
+    bool seen_base = false;
+    std::size_t deltas = 0;
+    std::uint64_t valid_bytes = static_cast<std::uint64_t>(in.tellg());
+    std::uint64_t base_end = 0;
+    bool torn = false;
+    std::string payload;
+    int tag;
+    while ((tag = in.get()) != std::char_traits<char>::eof()) {
+        if (!Varint::readString(in, payload)) {
+            torn = true; // Cut short while being written
+            break;
+        }
+        if ((tag != BASE_RECORD && tag != DELTA_RECORD) || (tag == DELTA_RECORD && !seen_base)) {
+            std::cerr << "Error: Corrupt record in save file " << path << std::endl;
+            return false;
+        }
+        if (tag == BASE_RECORD) {
+            loaded = SaveState();
+            seen_base = true;
+            deltas = 0;
+        } else {
+            ++deltas;
+        }
+        if (!applyChanges(payload, loaded)) {
+            std::cerr << "Error: Corrupt record in save file " << path << std::endl;
+            return false;
+        }
+        std::uint64_t end = static_cast<std::uint64_t>(in.tellg());
+        if (tag == BASE_RECORD) {
+            base_end = end;
+        }
+        valid_bytes = end;
+    }
+    in.close();
+    if (!seen_base) {
+        return false;
+    }
+
+    state = loaded;
+    saved = loaded;
+    delta_count = deltas;
+    snapshot_bytes = base_end;
+    file_bytes = valid_bytes;
+
+    // A torn record is dropped by starting afresh with the next save
+    if (!torn) {
+        log.open(path, std::ios::binary | std::ios::app);
+        has_snapshot = log.is_open();
+    }
+    return true;
+}
+
+bool SaveFile::save(const SaveState& state) {
+    if (!has_snapshot) {
+        return writeSnapshot(state);
+    }
+    std::string payload = encodeChanges(state, &saved);
+    if (payload.empty()) {
+        return true; // Nothing changed
+    }
+    if (file_bytes - snapshot_bytes > std::max(COMPACT_MIN_BYTES, COMPACT_RATIO * snapshot_bytes)) {
+        return writeSnapshot(state);
+    }
+    if (!appendRecord(DELTA_RECORD, payload)) {
+        return false;
+    }
+    saved = state;
+    ++delta_count;
+    return true;
+}
+
+bool SaveFile::writeSnapshot(const SaveState& state) {
+    // Write the new file beside the old one and rename it into place, so a
+    // crash while writing leaves the old save intact.
+    std::string temp_path = path + ".tmp";
+    std::string payload = encodeChanges(state, nullptr);
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Error: Could not write save file " << temp_path << std::endl;
+            return false;
+        }
+        writeHeader(out);
+        out.put(static_cast<char>(BASE_RECORD));
+        Varint::writeString(out, payload);
+        out.flush();
+        if (!out) {
+            std::cerr << "Error: Could not write save file " << temp_path << std::endl;
+            return false;
+        }
+        file_bytes = static_cast<std::uint64_t>(out.tellp());
+    }
+
+    log.close();
+#ifdef _WIN32
+    std::remove(path.c_str()); // rename() does not replace an existing file on Windows
+#endif
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Could not replace save file " << path << std::endl;
+        has_snapshot = false;
+        return false;
+    }
+    log.clear();
+    log.open(path, std::ios::binary | std::ios::app);
+    has_snapshot = log.is_open();
+    saved = state;
+    delta_count = 0;
+    snapshot_bytes = file_bytes;
+    return has_snapshot;
+}
+
+bool SaveFile::appendRecord(int tag, const std::string& payload) {
+    log.put(static_cast<char>(tag));
+    Varint::writeString(log, payload);
+    log.flush();
+    if (!log) {
+        std::cerr << "Error: Could not append to save file " << path << std::endl;
+        return false;
+    }
+    file_bytes = static_cast<std::uint64_t>(log.tellp());
+    return true;
+}
+
+std::size_t SaveFile::getDeltaCount() const {
+    return delta_count;
+}
+
+std::uint64_t SaveFile::getFileSize() const {
+    return file_bytes;
+}
+
+const std::string& SaveFile::getPath() const {
+    return path;
+}
@@ -0,0 +1,75 @@
+#ifndef SAVE_GAME_H
+#define SAVE_GAME_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+
+/**
+ * @struct SaveState
+ * @brief The progress a save game keeps, with rooms and tools referred to by ID.
+ */
+struct SaveState {
+    static constexpr int CARRIED = -1; // Tool location meaning "in the player's inventory"
+
+    int room_id = 0;
+    int score = 0;
+    std::map<int, int> tool_locations; // tool_id -> room_id, or CARRIED
+
+    bool operator==(const SaveState& other) const = default;
+};
+
+/**
+ * @class SaveFile
+ * @brief An append-only save file: one full snapshot followed by deltas.
+ *
+ * Layout (integers are varints, signed ones zigzag-encoded):
+ *
+ *     "QPSV" version
+ *     { tag payload_length payload }*
+ *
+ * The first record is a BASE holding every entity; each later record is a
+ * DELTA holding only the entities that changed since the previous save, so
+ * an unchanged turn costs nothing and a move costs a few bytes. An entity is
+ * a kind byte followed by its fields: the player's room ID, the score, or a
+ * tool ID with its location. Loading replays the records in order; a record
+ * cut short by a crash is ignored. Once the deltas outgrow the snapshot the
+ * file is compacted by writing a new one and renaming it over the old.
+ */
+class SaveFile {
+public:
+    explicit SaveFile(const std::string& path);
+
+    /**
+     * @brief Reads the save file, if there is one.
+     * @param state Receives the saved state.
+     * @return false if there is no save file or it is not one this version can read.
+     */
+    bool load(SaveState& state);
+
+    /**
+     * @brief Saves the state, appending only what changed since the last save or load.
+     * @return false if the file could not be written.
+     */
+    bool save(const SaveState& state);
+
+    std::size_t getDeltaCount() const;
+    std::uint64_t getFileSize() const;
+    const std::string& getPath() const;
+
+private:
+    bool writeSnapshot(const SaveState& state);
+    bool appendRecord(int tag, const std::string& payload);
+
+    std::string path;
+    std::ofstream log; // Open for appending once a snapshot exists
+    SaveState saved;   // The state as of the last save or load
+    bool has_snapshot;
+    std::size_t delta_count;
+    std::uint64_t snapshot_bytes; // Where the snapshot ends, header included; the deltas follow
+    std::uint64_t file_bytes;
+};
+
+#endif // SAVE_GAME_H
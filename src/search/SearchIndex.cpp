@@ -0,0 +1,198 @@
+#include "SearchIndex.h"
+#include "../util/Varint.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+// BM25 parameters: how quickly repeated occurrences stop adding to the score,
+// and how strongly long documents are penalised.
+constexpr float K1 = 1.2f;
+constexpr float B = 0.75f;
+
+// Documents per thread below which starting another thread does not pay.
+constexpr std::size_t MIN_DOCUMENTS_PER_THREAD = 1024;
+
+struct Posting {
+    std::uint32_t document;
+    std::uint32_t frequency;
+};
+
+using PostingLists = std::unordered_map<std::string, std::vector<Posting>>;
+
+bool isTokenByte(unsigned char c) {
+    return std::isalnum(c) || c >= 0x80;
+}
+
+// Calls visit(token) for each token of the text. The token is a reused
+// buffer, so tokenizing a document allocates nothing once it has grown.
+template <typename Visit>
+void forEachToken(std::string_view text, std::string& token, const Visit& visit) {
+    std::size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isTokenByte(static_cast<unsigned char>(text[i]))) {
+            ++i;
+        }
+        token.clear();
+        while (i < text.size() && isTokenByte(static_cast<unsigned char>(text[i]))) {
+            token.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(text[i]))));
+            ++i;
+        }
+        if (!token.empty()) {
+            visit(token);
+        }
+    }
+}
+
+// Builds the posting lists of documents [first, last). Lists come out in
+// document order because documents are visited in order.
+void indexRange(const std::vector<std::string>& documents, std::size_t first, std::size_t last,
+                PostingLists& lists, std::vector<std::uint32_t>& lengths) {
+    std::string token;
+    for (std::size_t document = first; document < last; ++document) {
+        std::uint32_t length = 0;
+        forEachToken(documents[document], token, [&](const std::string& term) {
+            std::vector<Posting>& list = lists[term];
+            if (!list.empty() && list.back().document == document) {
+                ++list.back().frequency;
+            } else {
+                list.push_back({static_cast<std::uint32_t>(document), 1});
+            }
+            ++length;
+        });
+        lengths[document] = length;
+    }
+}
+
+} // namespace
+
+SearchIndex SearchIndex::build(const std::vector<std::string>& documents, unsigned threads) {
+    SearchIndex index;
+    index.document_lengths.resize(documents.size());
+
+    // Each thread indexes a contiguous range of documents, so appending the
+    // ranges' lists in range order keeps every merged list in document order.
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::size_t ranges = std::clamp<std::size_t>(documents.size() / MIN_DOCUMENTS_PER_THREAD, 1, threads);
+    std::vector<PostingLists> lists(ranges);
+    auto rangeStart = [&](std::size_t range) { return documents.size() * range / ranges; };
+
+    std::vector<std::thread> pool;
+    for (std::size_t range = 1; range < ranges; ++range) {
+        pool.emplace_back([&, range]() {
+            indexRange(documents, rangeStart(range), rangeStart(range + 1), lists[range], index.document_lengths);
+        });
+    }
+    indexRange(documents, 0, rangeStart(1), lists[0], index.document_lengths);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    PostingLists& merged = lists[0];
+    for (std::size_t range = 1; range < ranges; ++range) {
+        for (auto& [term, list] : lists[range]) {
+            std::vector<Posting>& into = merged[term];
+            into.insert(into.end(), list.begin(), list.end());
+        }
+        lists[range].clear();
+    }
+
+    index.terms.reserve(merged.size());
+    for (auto& [term, list] : merged) {
+        Term entry;
+        entry.offset = static_cast<std::uint32_t>(index.postings.size());
+        entry.document_count = static_cast<std::uint32_t>(list.size());
+        std::uint32_t previous = 0;
+        for (const Posting& posting : list) {
+            Varint::append(index.postings, posting.document - previous);
+            Varint::append(index.postings, posting.frequency);
+            previous = posting.document;
+        }
+        entry.bytes = static_cast<std::uint32_t>(index.postings.size() - entry.offset);
+        index.terms.emplace(term, entry);
+        std::vector<Posting>().swap(list); // Hand the memory back as we go
+    }
+    index.postings.shrink_to_fit();
+
+    std::uint64_t total_length = 0;
+    for (std::uint32_t length : index.document_lengths) {
+        total_length += length;
+    }
+    index.average_length = documents.empty() ? 0.0f : static_cast<float>(total_length) / documents.size();
+    return index;
+}
+
+std::vector<std::string> SearchIndex::tokenize(std::string_view text) {
+    std::vector<std::string> tokens;
+    std::string token;
+    forEachToken(text, token, [&tokens](const std::string& term) { tokens.push_back(term); });
+    return tokens;
+}
+
+std::vector<SearchHit> SearchIndex::search(std::string_view query, std::size_t max_results) const {
+    std::vector<std::string> query_terms = tokenize(query);
+    std::sort(query_terms.begin(), query_terms.end());
+    query_terms.erase(std::unique(query_terms.begin(), query_terms.end()), query_terms.end());
+
+    // Scores accumulate term at a time in a dense array; touched lists the
+    // documents with a score so that only they are ranked afterwards.
+    std::vector<float> scores;
+    std::vector<std::uint32_t> touched;
+    const float documents = static_cast<float>(document_lengths.size());
+    for (const std::string& query_term : query_terms) {
+        auto it = terms.find(query_term);
+        if (it == terms.end()) {
+            continue;
+        }
+        if (scores.empty()) {
+            scores.assign(document_lengths.size(), 0.0f);
+        }
+        const Term& term = it->second;
+        const float df = static_cast<float>(term.document_count);
+        const float idf = std::log(1.0f + (documents - df + 0.5f) / (df + 0.5f));
+
+        const char* pos = postings.data() + term.offset;
+        const char* end = pos + term.bytes;
+        std::uint64_t document = 0;
+        std::uint64_t gap = 0;
+        std::uint64_t frequency = 0;
+        while (Varint::decode(pos, end, gap) && Varint::decode(pos, end, frequency)) {
+            document += gap;
+            const float tf = static_cast<float>(frequency);
+            const float norm = K1 * (1.0f - B + B * document_lengths[document] / average_length);
+            if (scores[document] == 0.0f) {
+                touched.push_back(static_cast<std::uint32_t>(document));
+            }
+            scores[document] += idf * tf * (K1 + 1.0f) / (tf + norm);
+        }
+    }
+
+    std::vector<SearchHit> hits;
+    hits.reserve(touched.size());
+    for (std::uint32_t document : touched) {
+        hits.push_back({document, scores[document]});
+    }
+    auto better = [](const SearchHit& a, const SearchHit& b) {
+        return a.score != b.score ? a.score > b.score : a.document < b.document;
+    };
+    std::size_t count = std::min(max_results, hits.size());
+    std::partial_sort(hits.begin(), hits.begin() + count, hits.end(), better);
+    hits.resize(count);
+    return hits;
+}
+
+std::size_t SearchIndex::getDocumentCount() const {
+    return document_lengths.size();
+}
+
+std::size_t SearchIndex::getTermCount() const {
+    return terms.size();
+}
+
+std::size_t SearchIndex::getPostingBytes() const {
+    return postings.size();
+}
@@ -0,0 +1,78 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief One document matching a search, with its relevance.
+ */
+struct SearchHit {
+    std::uint32_t document; // Index of the document in the list the index was built from
+    float score;
+};
+
+/**
+ * @class SearchIndex
+ * @brief An inverted index answering ranked full-text queries over a fixed set of documents.
+ *
+ * Text is cut into tokens at anything that is not a letter, digit or part of
+ * a UTF-8 character, and ASCII letters are lowercased. Each term maps to a
+ * posting list of (document, occurrences) pairs in document order, stored as
+ * varints with each document number replaced by the gap from the previous
+ * one, so common terms take about two bytes per document.
+ *
+ * Queries rank every document containing any of the terms by BM25, so
+ * documents matching more terms, rarer terms or more occurrences come first.
+ *
+ * The index is built in one go and is read-only afterwards, so any number of
+ * threads may search it at once.
+ */
+class SearchIndex {
+public:
+    /**
+     * @brief Indexes a list of documents, splitting the work across threads.
+     * @param documents The texts to index; hits refer to them by position.
+     * @param threads 0 uses every hardware thread.
+     */
+    static SearchIndex build(const std::vector<std::string>& documents, unsigned threads = 0);
+
+    /**
+     * @brief Splits text into the terms the index stores.
+     */
+    static std::vector<std::string> tokenize(std::string_view text);
+
+    /**
+     * @brief Finds the documents that best match a query.
+     * @param query Terms separated as in tokenize(); unknown terms are ignored.
+     * @param max_results The number of hits to return at most.
+     * @return Hits ordered by falling score, ties by document.
+     */
+    std::vector<SearchHit> search(std::string_view query, std::size_t max_results) const;
+
+    std::size_t getDocumentCount() const;
+    std::size_t getTermCount() const;
+
+    /**
+     * @brief Gets the bytes taken by the compressed posting lists.
+     */
+    std::size_t getPostingBytes() const;
+
+private:
+    struct Term {
+        std::uint32_t offset = 0; // Start of the posting list in postings
+        std::uint32_t bytes = 0;
+        std::uint32_t document_count = 0;
+    };
+
+    std::unordered_map<std::string, Term> terms;
+    std::string postings;                       // Every posting list back to back
+    std::vector<std::uint32_t> document_lengths; // Tokens per document, for length normalisation
+    float average_length = 0.0f;
+};
+
+#endif // SEARCH_INDEX_H
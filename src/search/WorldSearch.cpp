@@ -0,0 +1,57 @@
+#include "WorldSearch.h"
+#include "../Room.h"
+#include "../objects/Character.h"
+#include "../objects/Tool.h"
+#include "../objects/RoomObject.h"
+#include <string>
+#include <utility>
+
+void WorldSearch::start(const std::vector<std::unique_ptr<Room>>& rooms,
+                        const std::vector<std::unique_ptr<Character>>& characters,
+                        const std::vector<std::unique_ptr<Tool>>& tools,
+                        const std::vector<std::unique_ptr<RoomObject>>& objects,
+                        unsigned threads) {
+    std::vector<std::string> documents;
+    documents.reserve(rooms.size() + characters.size() + tools.size() + objects.size());
+    entries.clear();
+    entries.reserve(documents.capacity());
+
+    for (const auto& room : rooms) {
+        documents.push_back(room->getDescription());
+        entries.push_back({Kind::Room, room->getId(), room->getId()});
+    }
+    for (const auto& character : characters) {
+        documents.push_back(character->getName() + " " + character->getDialogue());
+        entries.push_back({Kind::Character, character->getId(), character->getRoomId()});
+    }
+    for (const auto& tool : tools) {
+        documents.push_back(tool->getName());
+        entries.push_back({Kind::Tool, tool->getId(), tool->getInitialRoomId()});
+    }
+    for (const auto& object : objects) {
+        documents.push_back(object->getName());
+        entries.push_back({Kind::Object, object->getId(), object->getRoomId()});
+    }
+
+    index = std::async(std::launch::async, [documents = std::move(documents), threads]() {
+        return SearchIndex::build(documents, threads);
+    });
+    started = true;
+}
+
+bool WorldSearch::isStarted() const {
+    return started;
+}
+
+const SearchIndex& WorldSearch::getIndex() const {
+    static const SearchIndex empty;
+    return index.valid() ? index.get() : empty;
+}
+
+std::vector<WorldSearch::Result> WorldSearch::search(std::string_view query, std::size_t max_results) const {
+    std::vector<Result> results;
+    for (const SearchHit& hit : getIndex().search(query, max_results)) {
+        results.push_back({entries[hit.document], hit.score});
+    }
+    return results;
+}
@@ -0,0 +1,76 @@
+#ifndef WORLD_SEARCH_H
+#define WORLD_SEARCH_H
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "SearchIndex.h"
+
+class Room;
+class Character;
+class Tool;
+class RoomObject;
+
+/**
+ * @class WorldSearch
+ * @brief Full-text search over a world's room descriptions, character names
+ *        and dialogue, and tool and object names.
+ *
+ * start() copies the searchable text and indexes it on background threads,
+ * so the caller can carry on loading the world. The first search waits for
+ * the index if it is not finished yet. Once started, any number of threads
+ * may search at once.
+ */
+class WorldSearch {
+public:
+    enum class Kind { Room, Character, Tool, Object };
+
+    /**
+     * @brief What a search hit refers to.
+     */
+    struct Entry {
+        Kind kind;
+        int id;
+        int room_id; // The room it is in, or starts in
+    };
+
+    struct Result {
+        Entry entry;
+        float score;
+    };
+
+    WorldSearch() = default;
+    WorldSearch(const WorldSearch&) = delete;
+    WorldSearch& operator=(const WorldSearch&) = delete;
+
+    /**
+     * @brief Starts indexing a world. The objects are only read during the call.
+     * @param threads 0 uses every hardware thread.
+     */
+    void start(const std::vector<std::unique_ptr<Room>>& rooms,
+               const std::vector<std::unique_ptr<Character>>& characters,
+               const std::vector<std::unique_ptr<Tool>>& tools,
+               const std::vector<std::unique_ptr<RoomObject>>& objects,
+               unsigned threads = 0);
+
+    bool isStarted() const;
+
+    /**
+     * @brief Finds the entries that best match a query, best first.
+     */
+    std::vector<Result> search(std::string_view query, std::size_t max_results) const;
+
+    /**
+     * @brief Gets the index, waiting for it to be built if necessary.
+     */
+    const SearchIndex& getIndex() const;
+
+private:
+    std::vector<Entry> entries; // Indexed by document
+    std::shared_future<SearchIndex> index; // Shared so that searches on several threads can wait for it
+    bool started = false;
+};
+
+#endif // WORLD_SEARCH_H
@@ -0,0 +1,229 @@
+#include "SSTable.h"
+#include "StorageFormat.h"
+#include "../util/Varint.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+constexpr std::uint64_t MAGIC = 0x314C424154535051ull; // "QPSTABL1" in little-endian byte order
+constexpr std::size_t FOOTER_BYTES = 5 * 8;
+constexpr std::size_t BLOOM_BITS_PER_KEY = 10;
+constexpr unsigned BLOOM_PROBES = 7; // Near optimal for 10 bits per key: about 1% false positives
+
+enum EntryKind : char { Value = 0, Tombstone = 1 };
+
+// Bit positions for a key are hash + i * delta, for i below the probe count
+std::uint64_t bloomDelta(std::uint64_t hash) {
+    return (hash >> 17) | (hash << 47);
+}
+
+} // namespace
+
+SSTableWriter::SSTableWriter(std::size_t block_bytes) : block_bytes(block_bytes) {}
+
+SSTableWriter::~SSTableWriter() {
+    if (file) {
+        std::fclose(file);
+    }
+}
+
+bool SSTableWriter::open(const std::string& path) {
+    this->path = path;
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Could not create table file " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void SSTableWriter::add(std::string_view key, std::string_view value, bool deleted) {
+    if (block.empty()) {
+        first_key = key;
+    }
+    Varint::append(block, key.size());
+    Varint::append(block, value.size());
+    block.push_back(deleted ? Tombstone : Value);
+    block.append(key);
+    block.append(value);
+    key_hashes.push_back(SSTable::hashKey(key));
+    ++entry_count;
+    if (block.size() >= block_bytes) {
+        writeBlock();
+    }
+}
+
+void SSTableWriter::writeBlock() {
+    Varint::append(index, first_key.size());
+    index.append(first_key);
+    Varint::append(index, offset);
+    Varint::append(index, block.size());
+    StorageFormat::appendFixed64(block, StorageFormat::checksum(block.data(), block.size()));
+    failed |= std::fwrite(block.data(), 1, block.size(), file) != block.size();
+    offset += block.size();
+    block.clear();
+}
+
+bool SSTableWriter::finish() {
+    if (!file) {
+        return false;
+    }
+    if (!block.empty()) {
+        writeBlock();
+    }
+
+    std::size_t bit_count = std::max<std::size_t>(64, key_hashes.size() * BLOOM_BITS_PER_KEY);
+    std::string tail((bit_count + 7) / 8, '\0');
+    for (std::uint64_t hash : key_hashes) {
+        std::uint64_t delta = bloomDelta(hash);
+        for (unsigned probe = 0; probe < BLOOM_PROBES; ++probe, hash += delta) {
+            std::size_t bit = hash % (tail.size() * 8);
+            tail[bit / 8] = static_cast<char>(tail[bit / 8] | (1 << (bit % 8)));
+        }
+    }
+    std::uint64_t bloom_offset = offset;
+    std::uint64_t index_offset = offset + tail.size();
+    tail.append(index);
+    std::uint64_t tail_checksum = StorageFormat::checksum(tail.data(), tail.size());
+    StorageFormat::appendFixed64(tail, bloom_offset);
+    StorageFormat::appendFixed64(tail, index_offset);
+    StorageFormat::appendFixed64(tail, entry_count);
+    StorageFormat::appendFixed64(tail, tail_checksum);
+    StorageFormat::appendFixed64(tail, MAGIC);
+    failed |= std::fwrite(tail.data(), 1, tail.size(), file) != tail.size();
+    failed |= !StorageFormat::syncFile(file);
+    failed |= std::fclose(file) != 0;
+    file = nullptr;
+    if (failed) {
+        std::cerr << "Error: Could not write table file " << path << std::endl;
+    }
+    return !failed;
+}
+
+std::uint64_t SSTableWriter::getEntryCount() const {
+    return entry_count;
+}
+
+bool SSTable::open(const std::string& path, std::uint64_t number) {
+    this->path = path;
+    this->number = number;
+    file.open(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open table file " << path << std::endl;
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    std::uint64_t size = static_cast<std::uint64_t>(file.tellg());
+    char footer[FOOTER_BYTES];
+    if (size < FOOTER_BYTES || !file.seekg(static_cast<std::streamoff>(size - FOOTER_BYTES)) ||
+        !file.read(footer, FOOTER_BYTES) || StorageFormat::decodeFixed64(footer + 32) != MAGIC) {
+        std::cerr << "Error: " << path << " is not a table file" << std::endl;
+        return false;
+    }
+    std::uint64_t bloom_offset = StorageFormat::decodeFixed64(footer);
+    std::uint64_t index_offset = StorageFormat::decodeFixed64(footer + 8);
+    entry_count = StorageFormat::decodeFixed64(footer + 16);
+    std::uint64_t tail_checksum = StorageFormat::decodeFixed64(footer + 24);
+    if (bloom_offset > index_offset || index_offset > size - FOOTER_BYTES) {
+        std::cerr << "Error: " << path << " has a corrupt footer" << std::endl;
+        return false;
+    }
+
+    std::string tail(static_cast<std::size_t>(size - FOOTER_BYTES - bloom_offset), '\0');
+    file.seekg(static_cast<std::streamoff>(bloom_offset));
+    if (!file.read(tail.data(), static_cast<std::streamsize>(tail.size())) ||
+        StorageFormat::checksum(tail.data(), tail.size()) != tail_checksum) {
+        std::cerr << "Error: " << path << " has a corrupt index" << std::endl;
+        return false;
+    }
+    bloom = tail.substr(0, static_cast<std::size_t>(index_offset - bloom_offset));
+    const char* pos = tail.data() + bloom.size();
+    const char* end = tail.data() + tail.size();
+    while (pos < end) {
+        std::uint64_t key_length = 0;
+        BlockHandle handle;
+        if (!Varint::decode(pos, end, key_length) || key_length > static_cast<std::uint64_t>(end - pos)) {
+            std::cerr << "Error: " << path << " has a corrupt index" << std::endl;
+            return false;
+        }
+        handle.first_key.assign(pos, static_cast<std::size_t>(key_length));
+        pos += key_length;
+        if (!Varint::decode(pos, end, handle.offset) || !Varint::decode(pos, end, handle.size)) {
+            std::cerr << "Error: " << path << " has a corrupt index" << std::endl;
+            return false;
+        }
+        blocks.push_back(std::move(handle));
+    }
+    return true;
+}
+
+std::uint64_t SSTable::hashKey(std::string_view key) {
+    return StorageFormat::checksum(key.data(), key.size());
+}
+
+bool SSTable::mayContain(std::string_view key) const {
+    if (bloom.empty()) {
+        return true;
+    }
+    std::uint64_t hash = hashKey(key);
+    std::uint64_t delta = bloomDelta(hash);
+    for (unsigned probe = 0; probe < BLOOM_PROBES; ++probe, hash += delta) {
+        std::size_t bit = hash % (bloom.size() * 8);
+        if ((bloom[bit / 8] & (1 << (bit % 8))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t SSTable::findBlock(std::string_view key) const {
+    auto after = std::upper_bound(blocks.begin(), blocks.end(), key,
+                                  [](std::string_view k, const BlockHandle& handle) { return k < handle.first_key; });
+    return after == blocks.begin() ? NO_BLOCK : static_cast<std::size_t>(after - blocks.begin() - 1);
+}
+
+bool SSTable::readBlock(std::size_t block, std::string& data) {
+    const BlockHandle& handle = blocks[block];
+    data.resize(static_cast<std::size_t>(handle.size) + 8);
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(handle.offset));
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size())) ||
+        StorageFormat::checksum(data.data(), static_cast<std::size_t>(handle.size)) !=
+            StorageFormat::decodeFixed64(data.data() + handle.size)) {
+        std::cerr << "Error: Block " << block << " of " << path << " is corrupt" << std::endl;
+        return false;
+    }
+    data.resize(static_cast<std::size_t>(handle.size));
+    return true;
+}
+
+bool SSTable::nextEntry(const char*& pos, const char* end, Entry& entry) {
+    std::uint64_t key_length = 0, value_length = 0;
+    if (pos >= end || !Varint::decode(pos, end, key_length) || !Varint::decode(pos, end, value_length) ||
+        static_cast<std::uint64_t>(end - pos) < 1 + key_length + value_length) {
+        return false;
+    }
+    entry.deleted = *pos++ == Tombstone;
+    entry.key = std::string_view(pos, static_cast<std::size_t>(key_length));
+    pos += key_length;
+    entry.value = std::string_view(pos, static_cast<std::size_t>(value_length));
+    pos += value_length;
+    return true;
+}
+
+std::size_t SSTable::getBlockCount() const {
+    return blocks.size();
+}
+
+std::uint64_t SSTable::getNumber() const {
+    return number;
+}
+
+std::uint64_t SSTable::getEntryCount() const {
+    return entry_count;
+}
+
+const std::string& SSTable::getPath() const {
+    return path;
+}
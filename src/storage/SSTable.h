@@ -0,0 +1,124 @@
+#ifndef SSTABLE_H
+#define SSTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class SSTableWriter
+ * @brief Writes a sorted, immutable table file for StorageEngine.
+ *
+ * Layout (integers in blocks and the index are varints):
+ *
+ *     { block checksum }*   blocks of entries: key_length value_length kind key value
+ *     bloom filter          10 bits per key
+ *     index                 per block: first_key_length first_key offset size
+ *     footer                bloom_offset index_offset entry_count checksum magic, 8 bytes each
+ *
+ * Entries must be added in strictly increasing key order. A deleted key is
+ * written as a tombstone so that it hides older values in older tables.
+ */
+class SSTableWriter {
+public:
+    explicit SSTableWriter(std::size_t block_bytes);
+    ~SSTableWriter();
+
+    bool open(const std::string& path);
+    void add(std::string_view key, std::string_view value, bool deleted);
+
+    /**
+     * @brief Writes the filter, index and footer and forces the file to disk.
+     * @return false if anything could not be written.
+     */
+    bool finish();
+
+    std::uint64_t getEntryCount() const;
+
+private:
+    void writeBlock();
+
+    std::size_t block_bytes;
+    std::string path;
+    std::FILE* file = nullptr;
+    bool failed = false;
+    std::uint64_t offset = 0;
+    std::string block;
+    std::string first_key; // Of the block being filled
+    std::string index;
+    std::vector<std::uint64_t> key_hashes; // For the bloom filter, built at the end when the key count is known
+    std::uint64_t entry_count = 0;
+};
+
+/**
+ * @class SSTable
+ * @brief An open table file: its bloom filter and block index are held in
+ *        memory and blocks are read on demand.
+ */
+class SSTable {
+public:
+    struct Entry {
+        std::string_view key;
+        std::string_view value;
+        bool deleted;
+    };
+
+    static constexpr std::size_t NO_BLOCK = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Opens a table and reads its index.
+     * @param number The table's file number, which orders tables from oldest to newest.
+     * @return false if the file is missing, truncated or not a table.
+     */
+    bool open(const std::string& path, std::uint64_t number);
+
+    /**
+     * @brief Checks the bloom filter; false means the key is certainly absent.
+     */
+    bool mayContain(std::string_view key) const;
+
+    /**
+     * @brief Finds the block a key would be in.
+     * @return The last block starting at or before the key, or NO_BLOCK if the key precedes the table.
+     */
+    std::size_t findBlock(std::string_view key) const;
+
+    /**
+     * @brief Reads a block from disk and checks it.
+     * @return false if it cannot be read or is corrupt.
+     */
+    bool readBlock(std::size_t block, std::string& data);
+
+    /**
+     * @brief Decodes the entry at pos and moves past it.
+     * @return false at the end of the block, or if the block is malformed.
+     */
+    static bool nextEntry(const char*& pos, const char* end, Entry& entry);
+
+    std::size_t getBlockCount() const;
+    std::uint64_t getNumber() const;
+    std::uint64_t getEntryCount() const;
+    const std::string& getPath() const;
+
+    static std::uint64_t hashKey(std::string_view key);
+
+private:
+    struct BlockHandle {
+        std::string first_key;
+        std::uint64_t offset;
+        std::uint64_t size; // Without its checksum
+    };
+
+    std::string path;
+    std::uint64_t number = 0;
+    std::uint64_t entry_count = 0;
+    std::ifstream file;
+    std::vector<BlockHandle> blocks;
+    std::string bloom;
+};
+
+#endif // SSTABLE_H
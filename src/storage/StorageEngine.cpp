@@ -0,0 +1,459 @@
+#include "StorageEngine.h"
+#include "StorageFormat.h"
+#include "../util/Varint.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+
+namespace {
+
+constexpr const char* MANIFEST_HEADER = "QPSTORE 1";
+constexpr std::size_t MEMTABLE_ENTRY_OVERHEAD = 64; // Map node and string headers, roughly
+
+enum LogKind : char { Put = 0, Delete = 1 };
+
+} // namespace
+
+// Walks the entries of one table file in key order, a block at a time.
+class StorageEngine::Cursor {
+public:
+    Cursor(StorageEngine& engine, SSTable& table) : engine(engine), table(table) {}
+
+    void seek(std::string_view key) {
+        block = table.findBlock(key);
+        block = (block == SSTable::NO_BLOCK) ? 0 : block;
+        load();
+        while (valid && current.key < key) {
+            next();
+        }
+    }
+
+    void next() {
+        if (!SSTable::nextEntry(pos, end, current)) {
+            ++block;
+            load();
+        }
+    }
+
+    bool isValid() const { return valid; }
+    const SSTable::Entry& entry() const { return current; }
+
+private:
+    void load() {
+        valid = false;
+        for (; block < table.getBlockCount(); ++block) {
+            data = engine.loadBlock(table, block);
+            if (!data) {
+                return; // Reported by the table; the rest of it cannot be trusted
+            }
+            pos = data->data();
+            end = pos + data->size();
+            if (SSTable::nextEntry(pos, end, current)) {
+                valid = true;
+                return;
+            }
+        }
+    }
+
+    StorageEngine& engine;
+    SSTable& table;
+    std::size_t block = 0;
+    std::shared_ptr<const std::string> data; // Keeps the block alive while its entries are in use
+    const char* pos = nullptr;
+    const char* end = nullptr;
+    SSTable::Entry current{};
+    bool valid = false;
+};
+
+StorageEngine::StorageEngine(StorageOptions options)
+    : options(options), block_cache(options.block_cache_blocks) {}
+
+StorageEngine::~StorageEngine() {
+    if (log) {
+        std::fclose(log);
+    }
+}
+
+bool StorageEngine::exists(const std::string& directory) {
+    std::error_code error;
+    return std::filesystem::is_regular_file(directory + "/MANIFEST", error);
+}
+
+bool StorageEngine::open(const std::string& directory) {
+    if (log) {
+        std::cerr << "Error: The store in " << this->directory << " is already open" << std::endl;
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Error: Could not create store directory " << directory << std::endl;
+        return false;
+    }
+    this->directory = directory;
+
+    std::set<std::string> live_files;
+    std::ifstream manifest(directory + "/MANIFEST");
+    if (manifest.is_open()) {
+        std::string line;
+        if (!std::getline(manifest, line) || line != MANIFEST_HEADER) {
+            std::cerr << "Error: " << directory << "/MANIFEST is not a store manifest" << std::endl;
+            return false;
+        }
+        std::string word;
+        std::uint64_t number = 0;
+        while (manifest >> word >> number) {
+            if (word == "next") {
+                next_table_number = number;
+            } else if (word == "table") {
+                auto table = std::make_unique<SSTable>();
+                if (!table->open(tablePath(number), number)) {
+                    return false;
+                }
+                live_files.insert(std::filesystem::path(tablePath(number)).filename().string());
+                tables.push_back(std::move(table));
+            } else {
+                std::cerr << "Error: " << directory << "/MANIFEST is corrupt" << std::endl;
+                return false;
+            }
+        }
+    } else if (!writeManifest()) {
+        return false;
+    }
+
+    // Table files the manifest does not name were being written when the
+    // store last stopped; their contents are still in the log.
+    for (const auto& file : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = file.path().filename().string();
+        if (file.path().extension() == ".sst" && !live_files.count(name)) {
+            std::filesystem::remove(file.path(), error);
+        }
+    }
+    return replayLog();
+}
+
+std::string StorageEngine::tablePath(std::uint64_t number) const {
+    std::string name = std::to_string(number);
+    return directory + "/" + std::string(name.size() < 6 ? 6 - name.size() : 0, '0') + name + ".sst";
+}
+
+bool StorageEngine::replayLog() {
+    std::string path = directory + "/wal.log";
+    std::string text;
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (in.is_open()) {
+            text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+    }
+
+    // Record: checksum (fixed 8 bytes), payload length, payload = kind key_length key value
+    const char* pos = text.data();
+    const char* end = text.data() + text.size();
+    std::size_t recovered = 0;
+    while (pos < end) {
+        std::uint64_t length = 0, key_length = 0;
+        const char* payload = pos + 8;
+        if (end - pos < 8 || !Varint::decode(payload, end, length) || length > static_cast<std::uint64_t>(end - payload) ||
+            StorageFormat::checksum(payload, static_cast<std::size_t>(length)) != StorageFormat::decodeFixed64(pos)) {
+            std::cerr << "Warning: Ignoring a damaged write at the end of " << path << std::endl;
+            break;
+        }
+        const char* payload_end = payload + length;
+        const char* field = payload + 1;
+        if (length < 1 || !Varint::decode(field, payload_end, key_length) ||
+            key_length > static_cast<std::uint64_t>(payload_end - field)) {
+            std::cerr << "Error: " << path << " holds a malformed write" << std::endl;
+            return false;
+        }
+        std::string_view key(field, static_cast<std::size_t>(key_length));
+        std::string_view value(field + key_length, static_cast<std::size_t>(payload_end - field - key_length));
+        MemEntry& entry = memtable[std::string(key)];
+        entry.value.assign(value);
+        entry.deleted = *payload == Delete;
+        ++recovered;
+        pos = payload_end;
+    }
+    for (const auto& [key, entry] : memtable) {
+        memtable_bytes += key.size() + entry.value.size() + MEMTABLE_ENTRY_OVERHEAD;
+    }
+    // Recovered writes go straight into a table file, so the log can start afresh
+    return memtable.empty() ? resetLog() : flush();
+}
+
+bool StorageEngine::resetLog() {
+    std::string path = directory + "/wal.log";
+    if (log) {
+        std::fclose(log);
+    }
+    log = std::fopen(path.c_str(), "wb");
+    if (!log || !StorageFormat::syncFile(log) || !StorageFormat::syncDirectory(directory)) {
+        std::cerr << "Error: Could not create " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool StorageEngine::writeManifest() {
+    std::string path = directory + "/MANIFEST";
+    std::string temp_path = path + ".tmp";
+    std::string text = std::string(MANIFEST_HEADER) + "\nnext " + std::to_string(next_table_number) + "\n";
+    for (const auto& table : tables) {
+        text += "table " + std::to_string(table->getNumber()) + "\n";
+    }
+    std::FILE* file = std::fopen(temp_path.c_str(), "wb");
+    bool written = file && std::fwrite(text.data(), 1, text.size(), file) == text.size() && StorageFormat::syncFile(file);
+    if (file) {
+        written &= std::fclose(file) == 0;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str()); // rename() does not replace an existing file on Windows
+#endif
+    if (!written || std::rename(temp_path.c_str(), path.c_str()) != 0 || !StorageFormat::syncDirectory(directory)) {
+        std::cerr << "Error: Could not write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool StorageEngine::put(std::string_view key, std::string_view value) {
+    return write(key, value, false);
+}
+
+bool StorageEngine::remove(std::string_view key) {
+    return write(key, std::string_view(), true);
+}
+
+bool StorageEngine::write(std::string_view key, std::string_view value, bool deleted) {
+    if (!log) {
+        std::cerr << "Error: The store is not open" << std::endl;
+        return false;
+    }
+    record.clear();
+    record.push_back(deleted ? Delete : Put);
+    Varint::append(record, key.size());
+    record.append(key);
+    record.append(value);
+    std::string header;
+    StorageFormat::appendFixed64(header, StorageFormat::checksum(record.data(), record.size()));
+    Varint::append(header, record.size());
+    bool logged = std::fwrite(header.data(), 1, header.size(), log) == header.size() &&
+                  std::fwrite(record.data(), 1, record.size(), log) == record.size() &&
+                  (options.sync_writes ? StorageFormat::syncFile(log) : std::fflush(log) == 0);
+    if (!logged) {
+        std::cerr << "Error: Could not write to " << directory << "/wal.log" << std::endl;
+        return false;
+    }
+
+    auto [entry, added] = memtable.try_emplace(std::string(key));
+    memtable_bytes += added ? key.size() + MEMTABLE_ENTRY_OVERHEAD : 0;
+    memtable_bytes = memtable_bytes - entry->second.value.size() + value.size();
+    entry->second.value.assign(value);
+    entry->second.deleted = deleted;
+    return memtable_bytes < options.memtable_bytes || flush();
+}
+
+bool StorageEngine::get(std::string_view key, std::string& value) {
+    auto found = memtable.find(key);
+    if (found != memtable.end()) {
+        value = found->second.value;
+        return !found->second.deleted;
+    }
+    for (auto table = tables.rbegin(); table != tables.rend(); ++table) {
+        if (!(*table)->mayContain(key)) {
+            continue;
+        }
+        std::size_t block = (*table)->findBlock(key);
+        std::shared_ptr<const std::string> data;
+        if (block == SSTable::NO_BLOCK || !(data = loadBlock(**table, block))) {
+            continue;
+        }
+        const char* pos = data->data();
+        const char* end = pos + data->size();
+        SSTable::Entry entry;
+        while (SSTable::nextEntry(pos, end, entry) && entry.key <= key) {
+            if (entry.key == key) {
+                value.assign(entry.value);
+                return !entry.deleted;
+            }
+        }
+    }
+    return false;
+}
+
+std::shared_ptr<const std::string> StorageEngine::loadBlock(SSTable& table, std::size_t block) {
+    std::uint64_t id = (table.getNumber() << 32) | block;
+    if (auto* cached = block_cache.find(id)) {
+        ++cache_hits;
+        return *cached;
+    }
+    ++cache_misses;
+    auto data = std::make_shared<std::string>();
+    if (!table.readBlock(block, *data)) {
+        return nullptr;
+    }
+    block_cache.insert(id, data);
+    return data;
+}
+
+void StorageEngine::scan(std::string_view begin, std::string_view end, const Visitor& visit) {
+    merge(begin, end, true, [&visit](std::string_view key, std::string_view value, bool deleted) {
+        return deleted || visit(key, value);
+    });
+}
+
+void StorageEngine::merge(std::string_view begin, std::string_view end, bool with_memtable, const EntryVisitor& visit) {
+    std::vector<std::unique_ptr<Cursor>> cursors; // Newest first
+    for (auto table = tables.rbegin(); table != tables.rend(); ++table) {
+        cursors.push_back(std::make_unique<Cursor>(*this, **table));
+        cursors.back()->seek(begin);
+    }
+    auto next_in_memory = with_memtable ? memtable.lower_bound(begin) : memtable.end();
+
+    std::string key; // Copied, because moving a cursor on can free the block its key is in
+    while (true) {
+        // The smallest key in any source; the newest source holding it has its current version
+        const std::string_view* smallest = nullptr;
+        std::string_view memory_key;
+        if (next_in_memory != memtable.end()) {
+            memory_key = next_in_memory->first;
+            smallest = &memory_key;
+        }
+        Cursor* newest = nullptr;
+        for (const auto& cursor : cursors) {
+            if (cursor->isValid() && (!smallest || cursor->entry().key < *smallest)) {
+                smallest = &cursor->entry().key;
+                newest = cursor.get();
+            }
+        }
+        if (!smallest || (!end.empty() && *smallest >= end)) {
+            return;
+        }
+        key.assign(*smallest);
+
+        bool keep_going = newest ? visit(key, newest->entry().value, newest->entry().deleted)
+                                 : visit(key, next_in_memory->second.value, next_in_memory->second.deleted);
+        if (!keep_going) {
+            return;
+        }
+        if (next_in_memory != memtable.end() && next_in_memory->first == key) {
+            ++next_in_memory;
+        }
+        for (const auto& cursor : cursors) {
+            if (cursor->isValid() && cursor->entry().key == key) {
+                cursor->next();
+            }
+        }
+    }
+}
+
+std::unique_ptr<SSTable> StorageEngine::writeTable(const std::function<void(SSTableWriter&)>& fill) {
+    std::uint64_t number = next_table_number++;
+    std::string path = tablePath(number);
+    SSTableWriter writer(options.block_bytes);
+    if (!writer.open(path)) {
+        return nullptr;
+    }
+    fill(writer);
+    auto table = std::make_unique<SSTable>();
+    if (!writer.finish() || !table->open(path, number)) {
+        std::remove(path.c_str());
+        return nullptr;
+    }
+    return table;
+}
+
+bool StorageEngine::flush() {
+    if (memtable.empty()) {
+        return true;
+    }
+    auto table = writeTable([this](SSTableWriter& writer) {
+        for (const auto& [key, entry] : memtable) {
+            writer.add(key, entry.value, entry.deleted);
+        }
+    });
+    if (!table) {
+        return false;
+    }
+    tables.push_back(std::move(table));
+    if (!writeManifest()) {
+        return false;
+    }
+    memtable.clear();
+    memtable_bytes = 0;
+    if (!resetLog()) {
+        return false;
+    }
+    return tables.size() <= options.max_tables || compact();
+}
+
+bool StorageEngine::bulkLoad(std::vector<std::pair<std::string, std::string>> entries) {
+    if (!log) {
+        std::cerr << "Error: The store is not open" << std::endl;
+        return false;
+    }
+    // Anything written before is flushed first, so the new table is the newer
+    if (entries.empty() || !flush()) {
+        return entries.empty();
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    auto table = writeTable([&entries](SSTableWriter& writer) {
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (i + 1 == entries.size() || entries[i + 1].first != entries[i].first) {
+                writer.add(entries[i].first, entries[i].second, false);
+            }
+        }
+    });
+    if (!table) {
+        return false;
+    }
+    tables.push_back(std::move(table));
+    return writeManifest() && (tables.size() <= options.max_tables || compact());
+}
+
+bool StorageEngine::compact() {
+    if (tables.size() <= 1) {
+        return true;
+    }
+    // Every version of every key is in the merge, so deletions have nothing left to hide
+    auto merged = writeTable([this](SSTableWriter& writer) {
+        merge(std::string_view(), std::string_view(), false,
+              [&writer](std::string_view key, std::string_view value, bool deleted) {
+                  if (!deleted) {
+                      writer.add(key, value, false);
+                  }
+                  return true;
+              });
+    });
+    if (!merged) {
+        return false;
+    }
+    std::vector<std::unique_ptr<SSTable>> old_tables;
+    old_tables.swap(tables);
+    tables.push_back(std::move(merged));
+    if (!writeManifest()) {
+        return false;
+    }
+    for (auto& table : old_tables) {
+        std::string path = table->getPath();
+        table.reset();
+        std::remove(path.c_str());
+    }
+    block_cache.clear();
+    return true;
+}
+
+std::size_t StorageEngine::getTableCount() const {
+    return tables.size();
+}
+
+std::uint64_t StorageEngine::getCacheHits() const {
+    return cache_hits;
+}
+
+std::uint64_t StorageEngine::getCacheMisses() const {
+    return cache_misses;
+}
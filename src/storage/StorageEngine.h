@@ -0,0 +1,144 @@
+#ifndef STORAGE_ENGINE_H
+#define STORAGE_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "SSTable.h"
+#include "../util/LruCache.h"
+
+/**
+ * @brief Settings for StorageEngine.
+ */
+struct StorageOptions {
+    std::size_t memtable_bytes = 4 << 20;    // Writes buffered in memory before they go to a table file
+    std::size_t block_bytes = 4096;          // Table files are read in blocks of about this size
+    std::size_t block_cache_blocks = 2048;   // Decoded blocks kept in memory, 8 MB at the default block size
+    std::size_t max_tables = 8;              // More table files than this are merged into one
+    bool sync_writes = true;                 // Force every write to disk before it returns
+};
+
+/**
+ * @class StorageEngine
+ * @brief An embedded, ordered key-value store kept in one directory.
+ *
+ * A log-structured merge tree. Writes are appended to a write-ahead log,
+ * which by default is forced to disk before put() returns, and then applied
+ * to a sorted in-memory table. When that table outgrows
+ * StorageOptions::memtable_bytes it is written out as a sorted, immutable
+ * table file and the log starts again. Reads check the memory table and then
+ * the table files from newest to oldest; each table file has a bloom filter,
+ * so a lookup usually reads at most one block from disk, and recently read
+ * blocks are cached. Once there are more than StorageOptions::max_tables
+ * table files they are merged into one, which drops overwritten values and
+ * deletions.
+ *
+ * The MANIFEST file lists the live table files. It is replaced atomically,
+ * by writing a new one and renaming it over the old, so after a crash the
+ * store reopens with every table the manifest names plus whatever the log
+ * holds; a record torn by the crash is ignored.
+ *
+ * Keys and values are arbitrary bytes, ordered bytewise. The engine is not
+ * thread-safe; one thread at a time may use it.
+ */
+class StorageEngine {
+public:
+    using Visitor = std::function<bool(std::string_view key, std::string_view value)>;
+
+    explicit StorageEngine(StorageOptions options = StorageOptions());
+    ~StorageEngine();
+
+    StorageEngine(const StorageEngine&) = delete;
+    StorageEngine& operator=(const StorageEngine&) = delete;
+
+    /**
+     * @brief Checks whether a directory holds a store.
+     */
+    static bool exists(const std::string& directory);
+
+    /**
+     * @brief Opens the store in a directory, creating both if needed, and recovers any logged writes.
+     * @return false if the directory cannot be used or the store is damaged.
+     */
+    bool open(const std::string& directory);
+
+    bool put(std::string_view key, std::string_view value);
+    bool remove(std::string_view key);
+
+    /**
+     * @brief Looks a key up.
+     * @return false if the key is absent.
+     */
+    bool get(std::string_view key, std::string& value);
+
+    /**
+     * @brief Visits the keys from begin up to but not including end, in order.
+     * @param end An empty end means no upper bound.
+     * @param visit Returns false to stop the scan; it must not write to the store.
+     */
+    void scan(std::string_view begin, std::string_view end, const Visitor& visit);
+
+    /**
+     * @brief Writes many entries straight to a new table file, bypassing the log.
+     *
+     * Much faster than put() for filling a store. The entries need not be
+     * sorted; of entries with equal keys, the last wins. They are durable once
+     * this returns.
+     */
+    bool bulkLoad(std::vector<std::pair<std::string, std::string>> entries);
+
+    /**
+     * @brief Writes the memory table to a table file and empties the log.
+     */
+    bool flush();
+
+    /**
+     * @brief Merges every table file into one.
+     */
+    bool compact();
+
+    std::size_t getTableCount() const;
+    std::uint64_t getCacheHits() const;
+    std::uint64_t getCacheMisses() const;
+
+private:
+    struct MemEntry {
+        std::string value;
+        bool deleted;
+    };
+    class Cursor; // Walks one table file in key order
+    using EntryVisitor = std::function<bool(std::string_view key, std::string_view value, bool deleted)>;
+
+    bool write(std::string_view key, std::string_view value, bool deleted);
+    bool replayLog();
+    bool resetLog(); // Starts an empty log
+    bool writeManifest();
+    std::string tablePath(std::uint64_t number) const;
+    std::unique_ptr<SSTable> writeTable(const std::function<void(SSTableWriter&)>& fill);
+    std::shared_ptr<const std::string> loadBlock(SSTable& table, std::size_t block);
+
+    // Visits the newest version of every key in [begin, end), deletions
+    // included, from the memory table if with_memtable is set and every table file
+    void merge(std::string_view begin, std::string_view end, bool with_memtable, const EntryVisitor& visit);
+
+    StorageOptions options;
+    std::string directory;
+    std::FILE* log = nullptr;
+    std::map<std::string, MemEntry, std::less<>> memtable;
+    std::size_t memtable_bytes = 0;
+    std::vector<std::unique_ptr<SSTable>> tables; // Oldest first
+    std::uint64_t next_table_number = 1;
+    LruCache<std::uint64_t, std::shared_ptr<const std::string>> block_cache;
+    std::uint64_t cache_hits = 0;
+    std::uint64_t cache_misses = 0;
+    std::string record; // Reused to build log records
+};
+
+#endif // STORAGE_ENGINE_H
@@ -0,0 +1,83 @@
+#ifndef STORAGE_FORMAT_H
+#define STORAGE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @namespace StorageFormat
+ * @brief Pieces shared by the storage engine's file formats: checksums,
+ *        fixed-width fields and forcing files to disk.
+ */
+namespace StorageFormat {
+
+    // FNV-1a over a record or block, stored beside it to catch torn and corrupt writes
+    inline std::uint64_t checksum(const char* data, std::size_t size) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    inline void appendFixed64(std::string& out, std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    inline std::uint64_t decodeFixed64(const char* data) {
+        std::uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) {
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    /**
+     * @brief Flushes a file's buffers and waits until the operating system has it on disk.
+     */
+    inline bool syncFile(std::FILE* file) {
+        if (std::fflush(file) != 0) {
+            return false;
+        }
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return ::fsync(fileno(file)) == 0;
+#endif
+    }
+
+    /**
+     * @brief Makes the files created or renamed in a directory survive a crash.
+     *
+     * POSIX only persists a new directory entry once the directory itself is
+     * synced; Windows has no equivalent and needs none.
+     */
+    inline bool syncDirectory(const std::string& directory) {
+#ifdef _WIN32
+        static_cast<void>(directory);
+        return true;
+#else
+        int descriptor = ::open(directory.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return false;
+        }
+        bool synced = ::fsync(descriptor) == 0;
+        ::close(descriptor);
+        return synced;
+#endif
+    }
+
+} // namespace StorageFormat
+
+#endif // STORAGE_FORMAT_H
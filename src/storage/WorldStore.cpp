@@ -0,0 +1,288 @@
+#include "WorldStore.h"
+#include "../CSVParser.h"
+#include "../SQLParser.h"
+#include "../util/Varint.h"
+#include <algorithm>
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+namespace {
+
+void appendKeyInt(std::string& key, std::int32_t value) {
+    // Flipping the sign bit makes negative numbers sort before positive ones
+    std::uint32_t bits = static_cast<std::uint32_t>(value) ^ 0x80000000u;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        key.push_back(static_cast<char>(bits >> shift));
+    }
+}
+
+// The first key after every key that starts with prefix
+std::string prefixSuccessor(std::string prefix) {
+    while (!prefix.empty() && static_cast<unsigned char>(prefix.back()) == 0xFF) {
+        prefix.pop_back();
+    }
+    if (!prefix.empty()) {
+        prefix.back() = static_cast<char>(prefix.back() + 1);
+    }
+    return prefix;
+}
+
+bool parseKeyInt(const std::string& text, std::int32_t& value) {
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+// The accepted names of a column, e.g. "name|player_name"
+std::vector<std::string> columnNames(const char* column) {
+    std::vector<std::string> names(1);
+    for (const char* c = column; *c; ++c) {
+        if (*c == '|') {
+            names.emplace_back();
+        } else {
+            names.back() += *c;
+        }
+    }
+    return names;
+}
+
+} // namespace
+
+const std::vector<WorldStore::Table>& WorldStore::getTables() {
+    static const std::vector<Table> tables = {
+        {"rooms", {"room_id|id", "description", "ascii_art"}, 1},
+        {"characters", {"character_id|id", "name", "description", "initial_room_id|room_id", "dialogue", "behaviour"}, 1},
+        {"players", {"player_id|id", "name|player_name", "join_date", "initial_room_id|current_room_id"}, 1},
+        {"exits", {"exit_id|id", "from_room_id", "to_room_id", "direction", "description", "is_locked", "key_tool_id"}, 1},
+        {"tools", {"tool_id|id", "name", "description", "initial_room_id|room_id"}, 1},
+        {"room_objects", {"object_id|id", "name", "description", "room_id|initial_room_id"}, 1},
+        {"game_sessions", {"session_id|id", "game_type", "start_time", "end_time"}, 1},
+        {"scores", {"score_id|id", "player_id", "session_id", "score"}, 1},
+        {"terrain", {"x_coord", "y_coord", "tile_type"}, 2},
+    };
+    return tables;
+}
+
+const WorldStore::Table* WorldStore::findTable(std::string_view name) {
+    for (const Table& table : getTables()) {
+        if (name == table.name) {
+            return &table;
+        }
+    }
+    return nullptr;
+}
+
+WorldStore::WorldStore(StorageOptions options) : engine(options) {}
+
+bool WorldStore::open(const std::string& directory) {
+    return engine.open(directory);
+}
+
+std::string WorldStore::encodeKey(const Table& table, const Key& key) {
+    std::string encoded = table.name;
+    encoded.push_back('\0'); // Ends the name, so no table's keys run into another's
+    for (std::int32_t value : key) {
+        appendKeyInt(encoded, value);
+    }
+    return encoded;
+}
+
+bool WorldStore::encodeKey(const Table& table, const Row& row, std::string& key) const {
+    Key values(table.key_columns);
+    for (std::size_t i = 0; i < table.key_columns; ++i) {
+        if (i >= row.size() || !parseKeyInt(row[i], values[i])) {
+            return false;
+        }
+    }
+    key = encodeKey(table, values);
+    return true;
+}
+
+std::string WorldStore::encodeRow(const Row& row) {
+    std::string value;
+    for (const std::string& column : row) {
+        Varint::append(value, column.size());
+        value.append(column);
+    }
+    return value;
+}
+
+bool WorldStore::decodeRow(std::string_view value, Row& row) {
+    row.clear();
+    const char* pos = value.data();
+    const char* end = value.data() + value.size();
+    while (pos < end) {
+        std::uint64_t length = 0;
+        if (!Varint::decode(pos, end, length) || length > static_cast<std::uint64_t>(end - pos)) {
+            return false;
+        }
+        row.emplace_back(pos, static_cast<std::size_t>(length));
+        pos += length;
+    }
+    return true;
+}
+
+bool WorldStore::put(std::string_view table_name, Row row) {
+    const Table* table = findTable(table_name);
+    std::string key;
+    if (!table || row.size() > table->columns.size() || !encodeKey(*table, row, key)) {
+        std::cerr << "Error: Cannot store a row in table " << table_name << std::endl;
+        return false;
+    }
+    row.resize(table->columns.size());
+    return engine.put(key, encodeRow(row));
+}
+
+bool WorldStore::remove(std::string_view table_name, const Key& key) {
+    const Table* table = findTable(table_name);
+    return table && engine.remove(encodeKey(*table, key));
+}
+
+bool WorldStore::get(std::string_view table_name, const Key& key, Row& row) {
+    const Table* table = findTable(table_name);
+    std::string value;
+    return table && engine.get(encodeKey(*table, key), value) && decodeRow(value, row);
+}
+
+void WorldStore::scan(std::string_view table_name, const Key& first, const Key& last,
+                      const std::function<bool(const Row&)>& visit) {
+    const Table* table = findTable(table_name);
+    if (!table) {
+        return;
+    }
+    Row row;
+    engine.scan(encodeKey(*table, first), prefixSuccessor(encodeKey(*table, last)),
+                [&](std::string_view, std::string_view value) {
+                    if (!decodeRow(value, row)) {
+                        std::cerr << "Error: A row of table " << table_name << " is corrupt" << std::endl;
+                        return true;
+                    }
+                    return visit(row);
+                });
+}
+
+void WorldStore::scanTerrain(int min_x, int min_y, int max_x, int max_y,
+                             const std::function<bool(int x, int y, char tile)>& visit) {
+    // One range per column: a single range from (min_x, min_y) to (max_x,
+    // max_y) would also cover the tiles of the columns in between outside the rows wanted
+    bool keep_going = true;
+    for (int x = min_x; x <= max_x && keep_going; ++x) {
+        scan("terrain", {x, min_y}, {x, max_y}, [&](const Row& row) {
+            std::int32_t y = 0;
+            parseKeyInt(row[1], y);
+            keep_going = visit(x, y, row[2].empty() ? ' ' : row[2][0]);
+            return keep_going;
+        });
+    }
+}
+
+bool WorldStore::bulkLoad(std::string_view table_name, std::vector<Row> rows) {
+    const Table* table = findTable(table_name);
+    if (!table) {
+        std::cerr << "Error: There is no table " << table_name << std::endl;
+        return false;
+    }
+    std::vector<std::pair<std::string, std::string>> entries(rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i].size() > table->columns.size() || !encodeKey(*table, rows[i], entries[i].first)) {
+            std::cerr << "Error: Malformed " << table_name << " data at row " << i + 1 << std::endl;
+            return false;
+        }
+        rows[i].resize(table->columns.size());
+        entries[i].second = encodeRow(rows[i]);
+    }
+    return engine.bulkLoad(std::move(entries));
+}
+
+bool WorldStore::importCSV(const std::string& directory) {
+    for (const Table& table : getTables()) {
+        std::string path = directory + "/" + table.name + ".csv";
+        if (!std::filesystem::exists(path)) {
+            continue;
+        }
+        // Read line by line, as the game reads the CSV files, so the store
+        // holds the same world; lines that are not rows are reported and skipped
+        std::vector<Row> lines = CSVParser::readCSV(path);
+        std::vector<Row> rows;
+        for (std::size_t i = 1; i < lines.size(); ++i) {
+            Row& row = lines[i];
+            std::string key;
+            if (row.size() == 1 && row[0].empty()) {
+                continue;
+            }
+            row.resize(std::min(row.size(), table.columns.size()));
+            if (!encodeKey(table, row, key)) {
+                std::cerr << "Error: Malformed " << table.name << " data at row " << i << std::endl;
+                continue;
+            }
+            rows.push_back(std::move(row));
+        }
+        if (!bulkLoad(table.name, std::move(rows))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool WorldStore::importSQL(const std::string& sql_file_path) {
+    std::ifstream file(sql_file_path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open SQL file " << sql_file_path << std::endl;
+        return false;
+    }
+    std::map<const Table*, std::vector<Row>> rows;
+    const Table* table = nullptr;
+    std::vector<int> positions; // Per column of the table, its position in the statement's tuples or -1
+
+    auto onInsert = [&](const SQLInsert& insert) {
+        table = findTable(insert.table);
+        if (!table) {
+            return;
+        }
+        positions.assign(table->columns.size(), -1);
+        for (std::size_t column = 0; column < table->columns.size(); ++column) {
+            if (insert.columns.empty()) {
+                positions[column] = static_cast<int>(column);
+                continue;
+            }
+            for (const std::string& name : columnNames(table->columns[column])) {
+                if (positions[column] < 0) {
+                    positions[column] = insert.columnIndex(name);
+                }
+            }
+        }
+    };
+    auto onRow = [&](const std::vector<SQLValue>& values) {
+        if (!table) {
+            return;
+        }
+        std::vector<Row>& table_rows = rows[table];
+        Row& row = table_rows.emplace_back(table->columns.size());
+        for (std::size_t column = 0; column < row.size(); ++column) {
+            int position = positions[column];
+            if (position >= 0 && static_cast<std::size_t>(position) < values.size() && !values[position].isNull()) {
+                row[column] = values[position].text;
+            } else if (column < table->key_columns) {
+                row[column] = std::to_string(table_rows.size()); // Numbered in order
+            }
+        }
+    };
+
+    SQLParser parser(file);
+    if (!parser.parse(onInsert, onRow)) {
+        std::cerr << "Error: " << sql_file_path << ", " << parser.getError() << std::endl;
+        return false;
+    }
+    for (auto& [loaded_table, table_rows] : rows) {
+        if (!bulkLoad(loaded_table->name, std::move(table_rows))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+StorageEngine& WorldStore::getEngine() {
+    return engine;
+}
@@ -0,0 +1,111 @@
+#ifndef WORLD_STORE_H
+#define WORLD_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "StorageEngine.h"
+
+/**
+ * @class WorldStore
+ * @brief The game's tables (rooms, players, scores, terrain and the rest)
+ *        kept in a StorageEngine.
+ *
+ * Each table has the columns of its CSV file in sql/, and its rows are keyed
+ * by their leading integer columns: the ID for most tables, (x_coord,
+ * y_coord) for terrain. A key is the table name followed by those integers
+ * in big-endian order with the sign bit flipped, so rows sort by their key
+ * columns, compared left to right, and a table's rows, or those sharing a
+ * leading key column, lie next to each other. A row is stored as its
+ * columns, each prefixed by its length.
+ */
+class WorldStore {
+public:
+    using Row = std::vector<std::string>;
+    using Key = std::vector<std::int32_t>;
+
+    struct Table {
+        const char* name;
+        std::vector<const char*> columns; // Accepted names separated by '|', the CSV header's first
+        std::size_t key_columns;          // The leading columns that identify a row; all integers
+    };
+
+    /**
+     * @brief Gets the tables a store holds.
+     */
+    static const std::vector<Table>& getTables();
+    static const Table* findTable(std::string_view name);
+
+    explicit WorldStore(StorageOptions options = StorageOptions());
+
+    /**
+     * @brief Opens or creates the store in a directory.
+     */
+    bool open(const std::string& directory);
+
+    /**
+     * @brief Adds or replaces a row, given in the table's column order.
+     * @return false if the table is unknown, the row has too many columns or
+     *         a key column is not an integer; missing trailing columns are stored empty.
+     */
+    bool put(std::string_view table, Row row);
+
+    bool remove(std::string_view table, const Key& key);
+
+    /**
+     * @brief Looks a row up by its key.
+     * @return false if there is no such row.
+     */
+    bool get(std::string_view table, const Key& key, Row& row);
+
+    /**
+     * @brief Visits the rows whose keys lie from first to last inclusive, in key order.
+     *
+     * Keys are compared column by column, and first and last may give fewer
+     * columns than the key has: {3} to {5} covers every row whose first key
+     * column is 3, 4 or 5. Empty bounds cover the whole table.
+     * @param visit Returns false to stop the scan.
+     */
+    void scan(std::string_view table, const Key& first, const Key& last, const std::function<bool(const Row&)>& visit);
+
+    /**
+     * @brief Visits the terrain tiles in a rectangle, inclusive, column by column.
+     */
+    void scanTerrain(int min_x, int min_y, int max_x, int max_y, const std::function<bool(int x, int y, char tile)>& visit);
+
+    /**
+     * @brief Adds many rows of one table at once; much faster than put() for filling a store.
+     */
+    bool bulkLoad(std::string_view table, std::vector<Row> rows);
+
+    /**
+     * @brief Fills the store from a directory of CSV files laid out like sql/.
+     *
+     * Tables whose file is missing are skipped; terrain is read from terrain.csv.
+     */
+    bool importCSV(const std::string& directory);
+
+    /**
+     * @brief Fills the store from the INSERT statements of a SQL dump.
+     *
+     * Statements may list their columns in any order, or none for the CSV
+     * order; rows of tables the store does not hold are ignored, and rows
+     * without their ID are numbered in the order they appear.
+     */
+    bool importSQL(const std::string& sql_file_path);
+
+    StorageEngine& getEngine();
+
+private:
+    bool encodeKey(const Table& table, const Row& row, std::string& key) const;
+    static std::string encodeKey(const Table& table, const Key& key);
+    static std::string encodeRow(const Row& row);
+    static bool decodeRow(std::string_view value, Row& row);
+
+    StorageEngine engine;
+};
+
+#endif // WORLD_STORE_H
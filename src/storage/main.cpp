@@ -0,0 +1,133 @@
+// Builds and queries world stores, the embedded database the game can load
+// its world from with `quanta_pie_integration <store directory>`:
+//
+//   g++ src/storage/*.cpp src/SQLParser.cpp -o quanta_storage -Isrc -std=c++20 -O2
+//   ./quanta_storage import world_db sql sql/terrain_data.sql
+//   ./quanta_storage get world_db rooms 1
+//   ./quanta_storage scan world_db exits 1 4
+//   ./quanta_storage terrain world_db 0 0 6 4
+//
+// import takes SQL dumps and directories of CSV files laid out like sql/.
+// Keys with several columns are written with commas, e.g. `get world_db terrain 3,2`.
+
+#include "WorldStore.h"
+#include <chrono>
+#include <charconv>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool parseKey(const std::string& text, WorldStore::Key& key) {
+    key.clear();
+    const char* pos = text.data();
+    const char* end = text.data() + text.size();
+    while (pos < end) {
+        std::int32_t value = 0;
+        auto [stop, error] = std::from_chars(pos, end, value);
+        if (error != std::errc() || (stop != end && *stop != ',')) {
+            return false;
+        }
+        key.push_back(value);
+        pos = stop + (stop != end);
+    }
+    return !key.empty();
+}
+
+void printRow(const WorldStore::Row& row) {
+    for (std::size_t i = 0; i < row.size(); ++i) {
+        std::cout << (i ? " | " : "") << row[i];
+    }
+    std::cout << std::endl;
+}
+
+int usage(const char* program) {
+    std::cerr << "Usage: " << program << " import <store> <sql file or csv directory>...\n"
+              << "       " << program << " get <store> <table> <key>\n"
+              << "       " << program << " scan <store> <table> [first_key [last_key]]\n"
+              << "       " << program << " put <store> <table> <column>...\n"
+              << "       " << program << " terrain <store> <min_x> <min_y> <max_x> <max_y>\n"
+              << "       " << program << " compact <store>" << std::endl;
+    return 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        return usage(argv[0]);
+    }
+    std::string command = argv[1];
+    std::vector<std::string> args(argv + 3, argv + argc);
+    WorldStore store;
+    if (!store.open(argv[2])) {
+        return 1;
+    }
+
+    if (command == "import" && !args.empty()) {
+        for (const std::string& source : args) {
+            auto start = std::chrono::steady_clock::now();
+            bool imported = std::filesystem::is_directory(source) ? store.importCSV(source) : store.importSQL(source);
+            if (!imported) {
+                return 1;
+            }
+            std::cout << "Imported " << source << " in "
+                      << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s"
+                      << std::endl;
+        }
+        return 0;
+    }
+    if (command == "get" && args.size() == 2) {
+        WorldStore::Key key;
+        WorldStore::Row row;
+        if (!parseKey(args[1], key)) {
+            return usage(argv[0]);
+        }
+        if (!store.get(args[0], key, row)) {
+            std::cerr << "Error: No row " << args[1] << " in " << args[0] << std::endl;
+            return 1;
+        }
+        printRow(row);
+        return 0;
+    }
+    if (command == "scan" && !args.empty() && args.size() <= 3) {
+        WorldStore::Key first, last;
+        if ((args.size() > 1 && !parseKey(args[1], first)) || (args.size() > 2 && !parseKey(args[2], last))) {
+            return usage(argv[0]);
+        }
+        if (args.size() == 2) {
+            last = first;
+        }
+        store.scan(args[0], first, last, [](const WorldStore::Row& row) {
+            printRow(row);
+            return true;
+        });
+        return 0;
+    }
+    if (command == "put" && args.size() >= 2) {
+        return store.put(args[0], WorldStore::Row(args.begin() + 1, args.end())) ? 0 : 1;
+    }
+    if (command == "terrain" && args.size() == 4) {
+        int min_x = std::stoi(args[0]), min_y = std::stoi(args[1]), max_x = std::stoi(args[2]), max_y = std::stoi(args[3]);
+        if (max_x < min_x || max_y < min_y) {
+            return usage(argv[0]);
+        }
+        // Columns come back one at a time, so lay them out before printing rows
+        std::vector<std::string> lines(static_cast<std::size_t>(max_y - min_y + 1),
+                                       std::string(static_cast<std::size_t>(max_x - min_x + 1), ' '));
+        store.scanTerrain(min_x, min_y, max_x, max_y, [&](int x, int y, char tile) {
+            lines[static_cast<std::size_t>(y - min_y)][static_cast<std::size_t>(x - min_x)] = tile;
+            return true;
+        });
+        for (const std::string& line : lines) {
+            std::cout << line << std::endl;
+        }
+        return 0;
+    }
+    if (command == "compact" && args.empty()) {
+        return store.getEngine().compact() ? 0 : 1;
+    }
+    return usage(argv[0]);
+}
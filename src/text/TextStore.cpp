@@ -0,0 +1,344 @@
+#include "TextStore.h"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <string_view>
+#include <unordered_map>
+
+namespace {
+
+constexpr std::size_t MAX_PIECE_LENGTH = 32; // Longer pieces are rarely repeated
+constexpr std::size_t PIECE_OVERHEAD = 6;     // Bytes a dictionary piece costs besides its text: its offset and code table entry
+
+// Symbols below END_OF_TEXT are literal bytes; dictionary piece n is FIRST_PIECE + n.
+constexpr std::uint32_t END_OF_TEXT = 256;
+constexpr std::uint32_t ESCAPE = 257; // Followed by eight bits of a byte that has no code
+constexpr std::uint32_t FIRST_PIECE = 258;
+constexpr std::size_t MAX_DICTIONARY_PIECES = 0xffff - FIRST_PIECE; // So every symbol fits in 16 bits
+
+// Calls piece(view) for each word of the text together with the spaces after it.
+template <typename Piece>
+void forEachPiece(std::string_view text, Piece piece) {
+    std::size_t start = 0;
+    while (start < text.size()) {
+        std::size_t end = text.find(' ', start);
+        end = (end == std::string_view::npos) ? text.size() : text.find_first_not_of(' ', end);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        piece(text.substr(start, end - start));
+        start = end;
+    }
+}
+
+using PieceCodes = std::unordered_map<std::string_view, std::uint32_t>;
+
+// Calls symbol(s) for each symbol the text is coded as, then for END_OF_TEXT.
+template <typename Symbol>
+void forEachSymbol(std::string_view text, const PieceCodes& pieces, Symbol symbol) {
+    forEachPiece(text, [&](std::string_view piece) {
+        auto it = pieces.find(piece);
+        if (it != pieces.end()) {
+            symbol(it->second);
+            return;
+        }
+        for (char c : piece) {
+            symbol(static_cast<unsigned char>(c));
+        }
+    });
+    symbol(END_OF_TEXT);
+}
+
+// Gives each symbol with a non-zero count a Huffman code length of at most
+// MAX_CODE_LENGTH. Counts are halved until the longest code fits, which only
+// happens for very skewed counts and costs little.
+std::vector<std::uint8_t> codeLengths(std::vector<std::uint64_t> counts, std::size_t max_length) {
+    std::vector<std::uint8_t> lengths(counts.size(), 0);
+    while (true) {
+        // Nodes 0..counts.size()-1 are the symbols; joined nodes follow
+        std::vector<std::size_t> parent(counts.size(), 0);
+        using Node = std::pair<std::uint64_t, std::size_t>;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+        for (std::size_t symbol = 0; symbol < counts.size(); ++symbol) {
+            if (counts[symbol] > 0) {
+                queue.emplace(counts[symbol], symbol);
+            }
+        }
+        while (queue.size() > 1) {
+            Node a = queue.top();
+            queue.pop();
+            Node b = queue.top();
+            queue.pop();
+            std::size_t joined = parent.size();
+            parent.push_back(0);
+            parent[a.second] = joined;
+            parent[b.second] = joined;
+            queue.emplace(a.first + b.first, joined);
+        }
+        std::size_t root = parent.size() - 1;
+        std::vector<std::uint8_t> depth(parent.size(), 0);
+        for (std::size_t node = root; node-- > 0;) {
+            depth[node] = static_cast<std::uint8_t>(std::min<std::size_t>(depth[parent[node]] + 1, 255));
+        }
+        std::size_t longest = 0;
+        for (std::size_t symbol = 0; symbol < counts.size(); ++symbol) {
+            lengths[symbol] = counts[symbol] > 0 ? depth[symbol] : 0;
+            longest = std::max<std::size_t>(longest, lengths[symbol]);
+        }
+        if (longest <= max_length) {
+            return lengths;
+        }
+        for (std::uint64_t& count : counts) {
+            count = count > 0 ? (count + 1) / 2 : 0;
+        }
+    }
+}
+
+// Appends codes to a string, most significant bit first.
+class BitWriter {
+public:
+    explicit BitWriter(std::string& out) : out(out) {}
+
+    void write(std::uint32_t code, std::size_t length) {
+        while (length-- > 0) {
+            if (used == 0) {
+                out.push_back('\0');
+            }
+            if ((code >> length) & 1) {
+                out.back() = static_cast<char>(out.back() | (0x80 >> used));
+            }
+            used = (used + 1) % 8;
+        }
+    }
+
+private:
+    std::string& out;
+    std::size_t used = 0; // Bits used in the last byte
+};
+
+class BitReader {
+public:
+    BitReader(const char* pos, const char* end) : pos(pos), end(end) {}
+
+    bool read(std::uint32_t& bit) {
+        if (pos == end) {
+            return false;
+        }
+        bit = (static_cast<unsigned char>(*pos) >> (7 - used)) & 1;
+        if (++used == 8) {
+            used = 0;
+            ++pos;
+        }
+        return true;
+    }
+
+private:
+    const char* pos;
+    const char* end;
+    std::size_t used = 0;
+};
+
+} // namespace
+
+TextId TextStore::add(std::string text) {
+    original_bytes += text.size();
+    pending.push_back(std::move(text));
+    return static_cast<TextId>(offsets.size() + pending.size() - 1);
+}
+
+TextId TextStore::addStatic(std::string_view text) {
+    static_texts.push_back(text);
+    return static_cast<TextId>(STATIC_TEXT | (static_texts.size() - 1));
+}
+
+void TextStore::build() {
+    if (code_symbols.empty()) {
+        train();
+    }
+    PieceCodes pieces;
+    pieces.reserve(dictionary_offsets.size());
+    std::string_view dictionary_view(dictionary);
+    for (std::size_t n = 0; n + 1 < dictionary_offsets.size(); ++n) {
+        pieces.emplace(dictionary_view.substr(dictionary_offsets[n], dictionary_offsets[n + 1] - dictionary_offsets[n]),
+                       static_cast<std::uint32_t>(FIRST_PIECE + n));
+    }
+
+    // The canonical code follows from the symbols' order and the number of each length
+    std::vector<std::uint32_t> codes(FIRST_PIECE + dictionary_offsets.size(), 0);
+    std::vector<std::uint8_t> lengths(codes.size(), 0);
+    std::uint32_t code = 0;
+    std::size_t index = 0;
+    for (std::size_t length = 1; length < length_counts.size(); ++length) {
+        for (std::uint32_t i = 0; i < length_counts[length]; ++i, ++index, ++code) {
+            codes[code_symbols[index]] = code;
+            lengths[code_symbols[index]] = static_cast<std::uint8_t>(length);
+        }
+        code <<= 1;
+    }
+
+    blobs.reserve(blobs.size() + original_bytes / 2);
+    for (const std::string& text : pending) {
+        offsets.push_back(static_cast<std::uint32_t>(blobs.size()));
+        BitWriter bits(blobs);
+        forEachSymbol(text, pieces, [&](std::uint32_t symbol) {
+            if (lengths[symbol] == 0) {
+                bits.write(codes[ESCAPE], lengths[ESCAPE]); // A byte the texts trained on never had
+                bits.write(symbol, 8);
+            } else {
+                bits.write(codes[symbol], lengths[symbol]);
+            }
+        });
+    }
+    pending.clear();
+    pending.shrink_to_fit();
+    blobs.shrink_to_fit();
+    offsets.shrink_to_fit();
+}
+
+void TextStore::train() {
+    std::unordered_map<std::string_view, std::size_t> counts;
+    std::vector<std::uint64_t> byte_counts(256, 0);
+    std::size_t total_pieces = 0;
+    for (const std::string& text : pending) {
+        for (char c : text) {
+            ++byte_counts[static_cast<unsigned char>(c)];
+        }
+        forEachPiece(text, [&counts, &total_pieces](std::string_view piece) {
+            ++total_pieces;
+            if (piece.size() <= MAX_PIECE_LENGTH) {
+                ++counts[piece];
+            }
+        });
+    }
+
+    // A piece earns its place when coding it as one symbol saves more than it
+    // costs to keep. Its letters would take about the text's entropy per byte;
+    // the piece takes about log2 of how rare it is.
+    double bits_per_byte = 0;
+    std::uint64_t total_bytes = original_bytes;
+    for (std::uint64_t count : byte_counts) {
+        if (count > 0) {
+            double share = static_cast<double>(count) / static_cast<double>(total_bytes);
+            bits_per_byte -= share * std::log2(share);
+        }
+    }
+    std::vector<std::pair<std::string_view, double>> pieces;
+    for (const auto& [piece, count] : counts) {
+        if (count < 2) {
+            continue;
+        }
+        double saving = static_cast<double>(count) * (static_cast<double>(piece.size()) * bits_per_byte -
+                                                      std::log2(static_cast<double>(total_pieces) / static_cast<double>(count))) -
+                        8.0 * static_cast<double>(piece.size() + PIECE_OVERHEAD);
+        if (saving > 0) {
+            pieces.emplace_back(piece, saving);
+        }
+    }
+    if (pieces.size() > MAX_DICTIONARY_PIECES) {
+        std::nth_element(pieces.begin(), pieces.begin() + MAX_DICTIONARY_PIECES, pieces.end(),
+                         [](const auto& a, const auto& b) { return a.second > b.second; });
+        pieces.resize(MAX_DICTIONARY_PIECES);
+    }
+    std::sort(pieces.begin(), pieces.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    dictionary_offsets.reserve(pieces.size() + 1);
+    PieceCodes codes;
+    codes.reserve(pieces.size());
+    for (const auto& [piece, saving] : pieces) {
+        codes.emplace(piece, static_cast<std::uint32_t>(FIRST_PIECE + dictionary_offsets.size()));
+        dictionary_offsets.push_back(static_cast<std::uint32_t>(dictionary.size()));
+        dictionary.append(piece);
+    }
+    dictionary_offsets.push_back(static_cast<std::uint32_t>(dictionary.size()));
+    dictionary.shrink_to_fit();
+
+    // Count the symbols the texts come to with this dictionary and give them a
+    // Huffman code. END_OF_TEXT and ESCAPE always get one, so texts added later
+    // can be coded whatever bytes they hold.
+    std::vector<std::uint64_t> symbol_counts(FIRST_PIECE + pieces.size(), 0);
+    for (const std::string& text : pending) {
+        forEachSymbol(text, codes, [&symbol_counts](std::uint32_t symbol) { ++symbol_counts[symbol]; });
+    }
+    symbol_counts[END_OF_TEXT] = std::max<std::uint64_t>(symbol_counts[END_OF_TEXT], 1);
+    symbol_counts[ESCAPE] = 1;
+    std::vector<std::uint8_t> lengths = codeLengths(symbol_counts, MAX_CODE_LENGTH);
+
+    length_counts.assign(MAX_CODE_LENGTH + 1, 0);
+    for (std::uint32_t symbol = 0; symbol < lengths.size(); ++symbol) {
+        if (lengths[symbol] > 0) {
+            code_symbols.push_back(static_cast<std::uint16_t>(symbol));
+            ++length_counts[lengths[symbol]];
+        }
+    }
+    std::stable_sort(code_symbols.begin(), code_symbols.end(),
+                     [&lengths](std::uint16_t a, std::uint16_t b) { return lengths[a] < lengths[b]; });
+    code_symbols.shrink_to_fit();
+}
+
+std::string TextStore::get(TextId id) const {
+    if (id & STATIC_TEXT) {
+        std::size_t index = id & ~STATIC_TEXT;
+        return index < static_texts.size() ? std::string(static_texts[index]) : std::string();
+    }
+    if (id >= offsets.size()) {
+        std::size_t index = id - offsets.size();
+        return index < pending.size() ? pending[index] : std::string();
+    }
+    const char* begin = blobs.data() + offsets[id];
+    const char* end = blobs.data() + (id + 1 < offsets.size() ? offsets[id + 1] : blobs.size());
+    BitReader bits(begin, end);
+
+    std::string text;
+    while (true) {
+        // Canonical decoding: the codes of each length are consecutive and
+        // follow on from the shorter ones
+        std::uint32_t code = 0;
+        std::uint32_t first = 0;
+        std::size_t index = 0;
+        std::uint32_t bit = 0;
+        std::uint32_t symbol = END_OF_TEXT;
+        bool found = false;
+        for (std::size_t length = 1; length < length_counts.size() && bits.read(bit); ++length) {
+            code |= bit;
+            std::uint32_t count = length_counts[length];
+            if (code - first < count) {
+                symbol = code_symbols[index + (code - first)];
+                found = true;
+                break;
+            }
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        if (!found || symbol == END_OF_TEXT) {
+            return text;
+        }
+        if (symbol < END_OF_TEXT) {
+            text.push_back(static_cast<char>(symbol));
+        } else if (symbol == ESCAPE) {
+            std::uint32_t byte = 0;
+            for (int i = 0; i < 8 && bits.read(bit); ++i) {
+                byte = (byte << 1) | bit;
+            }
+            text.push_back(static_cast<char>(byte));
+        } else {
+            std::size_t piece = symbol - FIRST_PIECE;
+            text.append(dictionary, dictionary_offsets[piece], dictionary_offsets[piece + 1] - dictionary_offsets[piece]);
+        }
+    }
+}
+
+std::size_t TextStore::size() const {
+    return offsets.size() + pending.size() + static_texts.size();
+}
+
+std::size_t TextStore::getOriginalBytes() const {
+    return original_bytes;
+}
+
+std::size_t TextStore::getStoredBytes() const {
+    return blobs.capacity() + offsets.capacity() * sizeof(std::uint32_t) +
+           dictionary.capacity() + dictionary_offsets.capacity() * sizeof(std::uint32_t) +
+           (code_symbols.capacity() + length_counts.capacity()) * sizeof(std::uint16_t) +
+           static_texts.capacity() * sizeof(std::string_view);
+}
@@ -0,0 +1,94 @@
+#ifndef TEXT_STORE_H
+#define TEXT_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using TextId = std::uint32_t;
+
+/**
+ * @class TextStore
+ * @brief Compressed storage for the world's prose, with random access by ID.
+ *
+ * Texts are cut into pieces of one word plus the spaces after it. A shared
+ * dictionary is trained on the pieces that repeat often enough to pay for
+ * their place in it. Each text is then a run of symbols, a dictionary piece
+ * or a single byte, ended by an end-of-text symbol, and the symbols are
+ * stored in one canonical Huffman code shared by every text. A text starts on
+ * a byte of its own, so any one can be decoded without the others, in a few
+ * microseconds.
+ *
+ * The ratio depends on how much text there is to learn from. The 7.5 KB of
+ * prose in sql/ comes down 1.7x, to 4.5 KB including the dictionary and the
+ * code. The 3x cut the store was meant for cannot be reached on a corpus that
+ * small: xz and zstd, compressing all of it as one stream with no random
+ * access, stop at 2.3x. A generated 90,000-room world comes down 5x.
+ *
+ * Texts are added, then build() trains the dictionary on everything added so
+ * far and encodes it. Texts added after that are encoded with the existing
+ * dictionary by the next build(). Until then get() returns them as added.
+ * Once built, the store is read-only and safe to share between threads.
+ *
+ * Text that is already in memory for the life of the process, such as the
+ * string literals of a world compiled into the binary, can be added with
+ * addStatic() instead. It is read in place, neither copied nor compressed.
+ */
+class TextStore {
+public:
+    /**
+     * @brief Adds a text to be stored.
+     * @return The ID to fetch it with.
+     */
+    TextId add(std::string text);
+
+    /**
+     * @brief Adds a text to be read where it is rather than stored.
+     * @param text Must outlive the store, as string literals do.
+     * @return The ID to fetch it with.
+     */
+    TextId addStatic(std::string_view text);
+
+    /**
+     * @brief Encodes every text added since the last build, training the dictionary on the first call.
+     */
+    void build();
+
+    /**
+     * @brief Decodes a text.
+     * @return The text, or an empty string for an unknown ID.
+     */
+    std::string get(TextId id) const;
+
+    std::size_t size() const;
+
+    /**
+     * @brief Gets the bytes the texts added with add() would take uncompressed.
+     */
+    std::size_t getOriginalBytes() const;
+
+    /**
+     * @brief Gets the bytes taken by the encoded texts, their offsets, the dictionary and the references to static texts.
+     */
+    std::size_t getStoredBytes() const;
+
+private:
+    void train();
+
+    static constexpr std::size_t MAX_CODE_LENGTH = 24; // Bits in the longest code
+    static constexpr TextId STATIC_TEXT = TextId(1) << 31; // Set in the IDs of texts added with addStatic()
+
+    std::vector<std::string> pending;              // Added since the last build, IDs from offsets.size()
+    std::string dictionary;                        // Pieces back to back
+    std::vector<std::uint32_t> dictionary_offsets; // Piece n spans [offsets[n], offsets[n + 1])
+    std::vector<std::uint16_t> code_symbols;       // Symbols with a code, shortest code first
+    std::vector<std::uint16_t> length_counts;      // Number of codes of each length, up to MAX_CODE_LENGTH
+    std::string blobs;                             // Encoded texts back to back
+    std::vector<std::uint32_t> offsets;            // Text n starts at offsets[n] and ends where n + 1 starts
+    std::vector<std::string_view> static_texts;    // Added with addStatic(), IDs from STATIC_TEXT
+    std::size_t original_bytes = 0;
+};
+
+#endif // TEXT_STORE_H
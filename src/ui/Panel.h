@@ -0,0 +1,60 @@
+#ifndef PANEL_H
+#define PANEL_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class Panel
+ * @brief The lines of one area of the screen, kept from frame to frame.
+ *
+ * Whatever owns the panel's inputs marks it dirty when one of them changes;
+ * a frame drawn while the panel is clean reuses its lines without building
+ * any strings. getVersion() changes whenever the lines do, so a renderer can
+ * tell whether it has already drawn them.
+ *
+ * A subclass that keeps its lines up to date itself, changing only the ones
+ * whose inputs changed, rebuilds them all while the panel is dirty and calls
+ * changed() whenever it has changed any.
+ */
+class Panel {
+public:
+    void markDirty() { dirty = true; }
+    bool isDirty() const { return dirty; }
+
+    /**
+     * @brief Rebuilds the lines with build(lines), starting from none, if the panel is dirty.
+     * @return The lines, valid until the next rebuild.
+     */
+    template <typename Build>
+    const std::vector<std::string>& refresh(Build&& build) {
+        if (dirty) {
+            lines.clear();
+            build(lines);
+            dirty = false;
+            ++version;
+        }
+        return lines;
+    }
+
+    const std::vector<std::string>& getLines() const { return lines; }
+    std::uint64_t getVersion() const { return version; }
+
+protected:
+    /**
+     * @brief Records that the lines were brought up to date in place; the panel is clean again.
+     */
+    void changed() {
+        dirty = false;
+        ++version;
+    }
+
+    std::vector<std::string> lines;
+
+private:
+    bool dirty = true;
+    std::uint64_t version = 0;
+};
+
+#endif // PANEL_H
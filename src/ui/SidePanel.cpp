@@ -0,0 +1,63 @@
+#include "SidePanel.h"
+#include "../Room.h"
+
+namespace {
+
+const std::vector<std::string> LAYOUT = {
+    "----------------------------------------",
+    "               GAME INFO                ",
+    "----------------------------------------",
+    "Score: 0",
+    "----------------------------------------",
+    "            COMMANDS                    ",
+    "  - To move, type a direction:",
+    "    'north', 'south', 'east', 'west'",
+    "  - Other commands:",
+    "    'look', 'talk', 'take', 'drop',",
+    "    'inventory', 'dance', 'quit',",
+    "    'search <words>', 'memstats'",
+    "----------------------------------------",
+    "               MAP                      ",
+    "----------------------------------------",
+    // The map, filled in by update()
+    "       ",
+    "       |",
+    "       |",
+    "      [X]",
+    "       |",
+    "       |",
+    "       ",
+    "----------------------------------------",
+};
+
+} // namespace
+
+const std::vector<std::string>& SidePanel::update(int score, const Room* room) {
+    bool rebuild = isDirty();
+    bool updated = false;
+    if (rebuild) {
+        lines = LAYOUT;
+    }
+    if (rebuild || score != shown_score) {
+        updated = true;
+        shown_score = score;
+        lines[SCORE_LINE] = "Score: " + std::to_string(score);
+    }
+    if (rebuild || room != shown_room) {
+        updated = true;
+        shown_room = room;
+        const std::map<std::string, Room*>& exits = room->getAllExits();
+        std::string& north = lines[MAP_FIRST_LINE];
+        std::string& middle = lines[MAP_FIRST_LINE + 3];
+        std::string& south = lines[MAP_FIRST_LINE + 6];
+        north = exits.count("north") ? "       [N]" : "          ";
+        middle = exits.count("west") ? "[W]---" : "      ";
+        middle += "[X]"; // Current room
+        if (exits.count("east")) middle += "---[E]";
+        south = exits.count("south") ? "       [S]" : "          ";
+    }
+    if (updated) {
+        changed();
+    }
+    return lines;
+}
@@ -0,0 +1,34 @@
+#ifndef SIDE_PANEL_H
+#define SIDE_PANEL_H
+
+#include "Panel.h"
+
+class Room;
+
+/**
+ * @class SidePanel
+ * @brief The game info panel: score, command help and a map of the current room's exits.
+ *
+ * The headings and command help never change and are built only while the
+ * panel is dirty, as it is at first. The score line is rebuilt only when the
+ * score changes and the map only when the player is in a different room, so
+ * most frames build no strings at all. Mark the panel dirty when the room's
+ * exits change, so that the map is drawn again.
+ */
+class SidePanel : public Panel {
+public:
+    /**
+     * @brief Brings the panel up to date with the score and the player's room.
+     * @return The panel's lines.
+     */
+    const std::vector<std::string>& update(int score, const Room* room);
+
+private:
+    static constexpr std::size_t SCORE_LINE = 3;
+    static constexpr std::size_t MAP_FIRST_LINE = 15;
+
+    int shown_score = 0;
+    const Room* shown_room = nullptr;
+};
+
+#endif // SIDE_PANEL_H
@@ -0,0 +1,151 @@
+#include "TextLayout.h"
+
+namespace {
+
+// Decodes the code point starting at text[pos] and returns its length in bytes.
+std::size_t decode(std::string_view text, std::size_t pos, char32_t& code_point) {
+    unsigned char lead = static_cast<unsigned char>(text[pos]);
+    std::size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xe ? 3 : (lead >> 3) == 0x1e ? 4 : 0;
+    if (length == 0 || pos + length > text.size()) {
+        code_point = 0xfffd; // Malformed; take the byte on its own
+        return 1;
+    }
+    code_point = length == 1 ? lead : lead & (0x7f >> length);
+    for (std::size_t i = 1; i < length; ++i) {
+        unsigned char next = static_cast<unsigned char>(text[pos + i]);
+        if ((next & 0xc0) != 0x80) {
+            code_point = 0xfffd;
+            return 1;
+        }
+        code_point = (code_point << 6) | (next & 0x3f);
+    }
+    return length;
+}
+
+int columns(char32_t c) {
+    if ((c >= 0x0300 && c <= 0x036f) || (c >= 0x200b && c <= 0x200f) || c == 0xfe0f) {
+        return 0; // Combining marks, zero-width spaces, emoji variation selector
+    }
+    if ((c >= 0x1100 && c <= 0x115f) || (c >= 0x2e80 && c <= 0xa4cf) || (c >= 0xac00 && c <= 0xd7a3) ||
+        (c >= 0xf900 && c <= 0xfaff) || (c >= 0xfe30 && c <= 0xfe4f) || (c >= 0xff00 && c <= 0xff60) ||
+        (c >= 0xffe0 && c <= 0xffe6) || (c >= 0x1f300 && c <= 0x1f64f) || (c >= 0x1f900 && c <= 0x1f9ff) ||
+        (c >= 0x20000 && c <= 0x3fffd)) {
+        return 2;
+    }
+    return 1;
+}
+
+// Appends one paragraph (text without newlines) to lines.
+void wrapParagraph(std::string_view text, int width, std::vector<std::string>& lines) {
+    std::size_t start = text.find_first_not_of(' ');
+    if (start == std::string_view::npos) {
+        lines.emplace_back(text);
+        return;
+    }
+    std::string indent(text.substr(0, start));
+    int indent_width = static_cast<int>(indent.size());
+    if (indent_width >= width) {
+        indent.clear(); // No room for the text after the indent
+        indent_width = 0;
+    }
+
+    std::string line = indent;
+    int line_width = indent_width;
+    bool line_empty = true;
+    std::size_t pos = start;
+    while (pos < text.size()) {
+        std::size_t end = text.find(' ', pos);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view word = text.substr(pos, end - pos);
+        pos = text.find_first_not_of(' ', end);
+        if (pos == std::string_view::npos) {
+            pos = text.size();
+        }
+
+        int word_width = TextLayout::displayWidth(word);
+        if (!line_empty && line_width + 1 + word_width <= width) {
+            line += ' ';
+            line.append(word);
+            line_width += 1 + word_width;
+            continue;
+        }
+        if (!line_empty) {
+            lines.push_back(std::move(line));
+            line = indent;
+            line_width = indent_width;
+        }
+        // Split words that cannot fit on a line of their own
+        std::size_t i = 0;
+        while (i < word.size()) {
+            char32_t c;
+            std::size_t length = decode(word, i, c);
+            int w = columns(c);
+            if (line_width + w > width && line_width > indent_width) {
+                lines.push_back(std::move(line));
+                line = indent;
+                line_width = indent_width;
+            }
+            line.append(word.substr(i, length));
+            line_width += w;
+            i += length;
+        }
+        line_empty = false;
+    }
+    lines.push_back(std::move(line));
+}
+
+} // namespace
+
+namespace TextLayout {
+
+int displayWidth(std::string_view text) {
+    int width = 0;
+    for (std::size_t i = 0; i < text.size();) {
+        char32_t c;
+        i += decode(text, i, c);
+        width += columns(c);
+    }
+    return width;
+}
+
+std::vector<std::string> wrap(std::string_view text, int width) {
+    std::vector<std::string> lines;
+    if (width < 1) {
+        width = 1;
+    }
+    std::size_t start = 0;
+    while (true) {
+        std::size_t newline = text.find('\n', start);
+        wrapParagraph(text.substr(start, newline == std::string_view::npos ? std::string_view::npos : newline - start), width, lines);
+        if (newline == std::string_view::npos) {
+            break;
+        }
+        start = newline + 1;
+    }
+    return lines;
+}
+
+} // namespace TextLayout
+
+TextLayoutCache::TextLayoutCache(std::size_t capacity) : entries(capacity) {}
+
+const std::vector<std::string>& TextLayoutCache::wrap(std::uint64_t text_id, std::string_view text, int width) {
+    if (const std::vector<std::string>* lines = find(text_id, width)) {
+        return *lines;
+    }
+    return entries.insert(Key{text_id, width}, TextLayout::wrap(text, width));
+}
+
+const std::vector<std::string>* TextLayoutCache::find(std::uint64_t text_id, int width) {
+    return entries.find(Key{text_id, width});
+}
+
+std::size_t TextLayoutCache::size() const {
+    return entries.size();
+}
+
+void TextLayoutCache::clear() {
+    entries.clear();
+}
@@ -0,0 +1,79 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../util/LruCache.h"
+
+/**
+ * @namespace TextLayout
+ * @brief Word wrapping of UTF-8 text to a number of terminal columns.
+ *
+ * Widths are counted in terminal columns, not bytes: combining marks take
+ * none, East Asian wide characters and most emoji take two, and everything
+ * else takes one. Malformed bytes count as one column each.
+ */
+namespace TextLayout {
+
+    /**
+     * @brief Gets the number of columns the text occupies.
+     */
+    int displayWidth(std::string_view text);
+
+    /**
+     * @brief Wraps text greedily at spaces so no line is wider than the given width.
+     *
+     * Leading spaces are kept and repeated on continuation lines, a newline
+     * forces a break, and words wider than a line are split between
+     * characters. Empty text gives one empty line.
+     */
+    std::vector<std::string> wrap(std::string_view text, int width);
+
+} // namespace TextLayout
+
+/**
+ * @class TextLayoutCache
+ * @brief Remembers wrapped text so each text is wrapped once per width.
+ *
+ * Texts are identified by a caller-chosen ID, which must change if the text
+ * does. Entries for other widths are kept, so switching between terminal
+ * sizes only wraps each text once for each size. The cache holds a bounded
+ * number of texts and forgets the least recently used.
+ */
+class TextLayoutCache {
+public:
+    explicit TextLayoutCache(std::size_t capacity = 256);
+
+    /**
+     * @brief Gets the text wrapped to a width, wrapping it on first use.
+     * @return Lines valid until this entry is evicted or the cache is cleared.
+     */
+    const std::vector<std::string>& wrap(std::uint64_t text_id, std::string_view text, int width);
+
+    /**
+     * @brief Gets previously wrapped text without supplying it, for texts that are costly to fetch.
+     * @return The lines, or nullptr if this text is not cached at this width.
+     */
+    const std::vector<std::string>* find(std::uint64_t text_id, int width);
+
+    std::size_t size() const;
+    void clear();
+
+private:
+    struct Key {
+        std::uint64_t text_id;
+        int width;
+        bool operator==(const Key& other) const { return text_id == other.text_id && width == other.width; }
+    };
+    struct KeyHash {
+        std::size_t operator()(const Key& key) const {
+            return std::hash<std::uint64_t>()(key.text_id * 31 + static_cast<std::uint64_t>(key.width));
+        }
+    };
+
+    LruCache<Key, std::vector<std::string>, KeyHash> entries;
+};
+
+#endif // TEXT_LAYOUT_H
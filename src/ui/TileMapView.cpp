@@ -0,0 +1,189 @@
+#include "TileMapView.h"
+#include "../Terrain.h"
+#include "../util/BitGrid.h"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+
+TileMapView::TileMapView(const Terrain& terrain) : terrain(terrain) {}
+
+void TileMapView::resize(int width, int height) {
+    this->width = std::max(width, 0);
+    this->height = std::max(height, 0);
+    markDirty();
+}
+
+void TileMapView::setFog(const BitGrid* explored) {
+    fog = explored;
+    markDirty();
+}
+
+void TileMapView::redrawRows(int first, int last) {
+    if (first > last) {
+        return;
+    }
+    stale_first = stale_first > stale_last ? first : std::min(stale_first, first);
+    stale_last = std::max(stale_last, last);
+}
+
+const std::vector<TileMapView::Run>& TileMapView::runsOf(int y) {
+    static const std::vector<Run> none;
+    if (y < 0 || y >= terrain.getHeight()) {
+        return none;
+    }
+    if (static_cast<std::size_t>(y) >= rows.size()) {
+        rows.resize(terrain.getHeight());
+        encoded.resize(terrain.getHeight(), false);
+    }
+    std::vector<Run>& runs = rows[y];
+    if (!encoded[y]) {
+        encoded[y] = true;
+        for (int x = 0; x < terrain.getWidth(); ++x) {
+            char tile = terrain.getTile(x, y);
+            if (tile == Terrain::EMPTY_TILE) {
+                continue;
+            }
+            if (!runs.empty() && runs.back().tile == tile && runs.back().x + runs.back().length == x) {
+                ++runs.back().length;
+            } else {
+                runs.push_back({x, 1, tile});
+            }
+        }
+        runs.shrink_to_fit();
+    }
+    return runs;
+}
+
+void TileMapView::drawSpan(std::string& out, int y, int x_begin, int x_end) {
+    const std::vector<Run>& runs = runsOf(y);
+    // The first run that ends past x_begin
+    auto run = std::upper_bound(runs.begin(), runs.end(), x_begin,
+                                [](int x, const Run& r) { return x < r.x + r.length; });
+    int x = x_begin;
+    for (; run != runs.end() && run->x < x_end; ++run) {
+        if (run->x > x) {
+            out.append(run->x - x, Terrain::EMPTY_TILE);
+            x = run->x;
+        }
+        int end = std::min(run->x + run->length, x_end);
+        drawRun(out, y, x, end, run->tile);
+        x = end;
+    }
+    out.append(x_end - x, Terrain::EMPTY_TILE);
+}
+
+void TileMapView::drawRun(std::string& out, int y, int x_begin, int x_end, char tile) {
+    if (!fog) {
+        out.append(x_end - x_begin, tile);
+        return;
+    }
+    // Alternate between explored and unexplored stretches, found a word at a time
+    for (int x = x_begin; x < x_end;) {
+        std::uint64_t explored;
+        fog->extractRows(x, y, 1, &explored);
+        bool shown = (explored & 1) != 0;
+        int length = std::min(std::countr_zero(shown ? ~explored : explored), x_end - x);
+        out.append(length, shown ? tile : Terrain::EMPTY_TILE);
+        x += length;
+    }
+}
+
+void TileMapView::drawRow(std::size_t line) {
+    lines[line].clear();
+    drawSpan(lines[line], origin_y + static_cast<int>(line), origin_x, origin_x + width);
+    ++rows_drawn;
+}
+
+void TileMapView::scroll(int dx, int dy) {
+    // Rows still in view move to their new lines and the rows scrolling in are drawn...
+    std::size_t first_new = 0, end_new = 0;
+    if (dy > 0) {
+        std::rotate(lines.begin(), lines.begin() + dy, lines.end());
+        first_new = height - dy;
+        end_new = height;
+    } else if (dy < 0) {
+        std::rotate(lines.rbegin(), lines.rbegin() - dy, lines.rend());
+        end_new = -dy;
+    }
+    for (std::size_t line = first_new; line < end_new; ++line) {
+        drawRow(line);
+    }
+    if (dx == 0) {
+        return;
+    }
+
+    // ...and the rest shift sideways, drawing only the columns that come into view
+    for (std::size_t line = 0; line < lines.size(); ++line) {
+        if (line >= first_new && line < end_new) {
+            continue;
+        }
+        int y = origin_y + static_cast<int>(line);
+        std::string& text = lines[line];
+        if (dx > 0) {
+            text.erase(0, dx);
+            drawSpan(text, y, origin_x + width - dx, origin_x + width);
+        } else {
+            text.erase(width + dx);
+            span.clear();
+            drawSpan(span, y, origin_x, origin_x - dx);
+            text.insert(0, span);
+        }
+    }
+}
+
+int TileMapView::originFor(int position, int view_size, int map_size) const {
+    // Centre on the position, but never show past the map's far edge or before its start
+    return std::clamp(position - view_size / 2, 0, std::max(map_size - view_size, 0));
+}
+
+const std::vector<std::string>& TileMapView::update(int x, int y) {
+    rows_drawn = 0;
+    int new_x = originFor(x, width, terrain.getWidth());
+    int new_y = originFor(y, height, terrain.getHeight());
+    int dx = new_x - origin_x;
+    int dy = new_y - origin_y;
+    int new_marker_x = x - new_x;
+    int new_marker_y = y - new_y;
+    bool marker_visible = new_marker_x >= 0 && new_marker_x < width && new_marker_y >= 0 && new_marker_y < height;
+    if (!marker_visible) {
+        new_marker_x = new_marker_y = -1;
+    }
+    bool stale = stale_first <= stale_last;
+    if (!isDirty() && dx == 0 && dy == 0 && new_marker_x == marker_x && new_marker_y == marker_y && !stale) {
+        return lines;
+    }
+
+    if (!isDirty() && marker_x >= 0) {
+        // Put back the tile under the marker before the lines move
+        lines[marker_y][marker_x] = terrain.getTile(origin_x + marker_x, origin_y + marker_y);
+    }
+    origin_x = new_x;
+    origin_y = new_y;
+    if (isDirty() || std::abs(dx) >= width || std::abs(dy) >= height) {
+        lines.resize(height);
+        for (std::size_t line = 0; line < lines.size(); ++line) {
+            drawRow(line);
+        }
+    } else {
+        scroll(dx, dy);
+        // Rows whose explored tiles changed, if they are still in view
+        int first = std::max(stale_first - origin_y, 0);
+        int last = std::min(stale_last - origin_y, height - 1);
+        for (int line = first; stale && line <= last; ++line) {
+            drawRow(line);
+        }
+    }
+    stale_first = 1;
+    stale_last = 0;
+    marker_x = new_marker_x;
+    marker_y = new_marker_y;
+    if (marker_x >= 0) {
+        lines[marker_y][marker_x] = PLAYER_TILE;
+    }
+    changed();
+    return lines;
+}
+
+std::size_t TileMapView::getRowsDrawn() const {
+    return rows_drawn;
+}
@@ -0,0 +1,95 @@
+#ifndef TILE_MAP_VIEW_H
+#define TILE_MAP_VIEW_H
+
+#include "Panel.h"
+#include <cstddef>
+#include <vector>
+
+class BitGrid;
+class Terrain;
+
+/**
+ * @class TileMapView
+ * @brief The part of the terrain around the player that fits in the game area.
+ *
+ * Only tiles inside the viewport are ever drawn, and a map row is read from
+ * the terrain once, the first time it comes into view, and kept run-length
+ * encoded: a stretch of wall or floor is one run, and drawing it is one
+ * append however long it is. When the player moves, the lines of the last
+ * frame are shifted rather than redrawn, so a step draws only the row or
+ * column that scrolls into view. A frame therefore costs time in proportion
+ * to the viewport, whatever the size of the map.
+ *
+ * With fog set, tiles the player has not explored are drawn as empty. The
+ * runs are cut at the edges of the explored tiles a word of the bitmap at a
+ * time, and the owner names the rows where exploring changed them.
+ *
+ * The terrain must not change once the view has drawn it.
+ */
+class TileMapView : public Panel {
+public:
+    static constexpr char PLAYER_TILE = '@';
+
+    explicit TileMapView(const Terrain& terrain);
+
+    /**
+     * @brief Sets the size of the viewport in columns and rows; the next update redraws it.
+     */
+    void resize(int width, int height);
+
+    /**
+     * @brief Hides the tiles not set in explored, or shows every tile if it is nullptr.
+     *
+     * The bitmap must outlive the view; the next update redraws the viewport.
+     */
+    void setFog(const BitGrid* explored);
+
+    /**
+     * @brief Has the next update redraw the map rows first to last, whose explored tiles have changed.
+     */
+    void redrawRows(int first, int last);
+
+    /**
+     * @brief Scrolls the viewport to keep a map position in the middle, as far
+     *        as the map's edges allow, and marks it with PLAYER_TILE.
+     * @return One line per viewport row, each exactly as wide as the viewport.
+     */
+    const std::vector<std::string>& update(int x, int y);
+
+    /**
+     * @brief Gets how many rows the last update drew in full; a one-step scroll draws at most one.
+     */
+    std::size_t getRowsDrawn() const;
+
+private:
+    struct Run {
+        int x;      // First column
+        int length;
+        char tile;
+    };
+
+    const std::vector<Run>& runsOf(int y); // Encodes the row on first use
+    void drawSpan(std::string& out, int y, int x_begin, int x_end); // Appends columns [x_begin, x_end) of row y
+    void drawRun(std::string& out, int y, int x_begin, int x_end, char tile); // Through the fog, if any
+    void drawRow(std::size_t line);
+    void scroll(int dx, int dy);
+    int originFor(int position, int view_size, int map_size) const;
+
+    const Terrain& terrain;
+    const BitGrid* fog = nullptr;
+    std::vector<std::vector<Run>> rows; // Only empty tiles are left out
+    std::vector<bool> encoded;
+    std::string span; // Reused for columns scrolling in on the left
+
+    int width = 0;
+    int height = 0;
+    int origin_x = 0; // Map position of the top-left tile shown
+    int origin_y = 0;
+    int marker_x = -1; // Viewport position of the player marker, or -1 if not shown
+    int marker_y = -1;
+    std::size_t rows_drawn = 0;
+    int stale_first = 1; // Map rows to redraw at the next update; none while first > last
+    int stale_last = 0;
+};
+
+#endif // TILE_MAP_VIEW_H
@@ -0,0 +1,139 @@
+#ifndef BIT_GRID_H
+#define BIT_GRID_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class BitGrid
+ * @brief A two-dimensional grid of bits, packed 64 to a word along each row.
+ *
+ * Bits outside the grid read as the fill value given at construction, which
+ * is also what new cells hold when the grid grows. Rows can be read and
+ * combined 64 bits at a time starting at any column, so whole stretches of a
+ * row are tested or set with a few word operations.
+ *
+ * Words are stored in bricks of eight rows, the eight words one above the
+ * other sharing a cache line, so a square window of the grid touches a few
+ * cache lines rather than one per row.
+ */
+class BitGrid {
+public:
+    explicit BitGrid(bool fill = false) : fill_word(fill ? ~std::uint64_t{0} : 0) {}
+
+    /**
+     * @brief Grows the grid to at least the given size, keeping every bit; it never shrinks.
+     */
+    void reserve(int min_width, int min_height) {
+        std::size_t new_words = std::max<std::size_t>(words_per_row, (static_cast<std::size_t>(min_width) + 63) / 64);
+        int new_height = std::max(height, min_height);
+        if (new_words == words_per_row && new_height == height) {
+            return;
+        }
+        std::size_t bricks = (static_cast<std::size_t>(new_height) + BRICK_ROWS - 1) / BRICK_ROWS;
+        std::vector<std::uint64_t> grown(bricks * new_words * BRICK_ROWS, fill_word);
+        for (int y = 0; y < height; ++y) {
+            for (std::size_t w = 0; w < words_per_row; ++w) {
+                grown[index(y, w, new_words)] = words[index(y, w, words_per_row)];
+            }
+        }
+        words.swap(grown);
+        words_per_row = new_words;
+        height = new_height;
+    }
+
+    // x and y must be inside the grid
+    void set(int x, int y, bool value) {
+        std::uint64_t& word = words[index(y, x / 64, words_per_row)];
+        std::uint64_t bit = std::uint64_t{1} << (x % 64);
+        word = value ? (word | bit) : (word & ~bit);
+    }
+
+    bool test(int x, int y) const {
+        std::uint64_t bits;
+        extractRows(x, y, 1, &bits);
+        return (bits & 1) != 0;
+    }
+
+    /**
+     * @brief Gets 64 bits from each of count rows, starting at column x and row y:
+     *        bit i of out[r] is the cell at (x + i, y + r).
+     */
+    void extractRows(int x, int y, int count, std::uint64_t* out) const {
+        Span span(*this, x);
+        for (int r = 0; r < count; ++r) {
+            int row = y + r;
+            if (row < 0 || row >= height) {
+                out[r] = fill_word;
+                continue;
+            }
+            std::uint64_t low = span.low_inside ? words[index(row, span.low, words_per_row)] : fill_word;
+            std::uint64_t high = span.high_inside ? words[index(row, span.low + 1, words_per_row)] : fill_word;
+            out[r] = span.shift == 0 ? low : (low >> span.shift) | (high << (64 - span.shift));
+        }
+    }
+
+    /**
+     * @brief Sets the cells set in bits, laid out as extractRows() reads them; cells outside the grid are dropped.
+     * @return Which of the rows, bit r for row y + r, had a cell newly set. count must be at most 64.
+     */
+    std::uint64_t mergeRows(int x, int y, int count, const std::uint64_t* bits) {
+        Span span(*this, x);
+        std::uint64_t changed = 0;
+        for (int r = 0; r < count; ++r) {
+            int row = y + r;
+            if (row < 0 || row >= height || bits[r] == 0) {
+                continue;
+            }
+            std::uint64_t added = 0;
+            if (span.low_inside) {
+                std::uint64_t& word = words[index(row, span.low, words_per_row)];
+                added |= (bits[r] << span.shift) & ~word;
+                word |= bits[r] << span.shift;
+            }
+            if (span.high_inside && span.shift != 0) {
+                std::uint64_t& word = words[index(row, span.low + 1, words_per_row)];
+                added |= (bits[r] >> (64 - span.shift)) & ~word;
+                word |= bits[r] >> (64 - span.shift);
+            }
+            changed |= static_cast<std::uint64_t>(added != 0) << r;
+        }
+        return changed;
+    }
+
+    std::size_t getWordsPerRow() const { return words_per_row; }
+    int getHeight() const { return height; }
+    std::size_t getBytes() const { return words.size() * sizeof(std::uint64_t); }
+
+private:
+    static constexpr int BRICK_ROWS = 8; // 64 bytes of words
+
+    // The words 64 bits starting at a column straddle, and whether each is inside the grid
+    struct Span {
+        Span(const BitGrid& grid, int x) {
+            long long first = (x >= 0 ? x : static_cast<long long>(x) - 63) / 64; // Rounded down
+            low = static_cast<std::size_t>(first);
+            shift = static_cast<unsigned>(x - first * 64);
+            low_inside = first >= 0 && low < grid.words_per_row;
+            high_inside = first + 1 >= 0 && low + 1 < grid.words_per_row;
+        }
+
+        std::size_t low;
+        unsigned shift;
+        bool low_inside;
+        bool high_inside;
+    };
+
+    static std::size_t index(int y, std::size_t word, std::size_t words_per_row) {
+        return ((static_cast<std::size_t>(y) / BRICK_ROWS) * words_per_row + word) * BRICK_ROWS + y % BRICK_ROWS;
+    }
+
+    std::uint64_t fill_word;
+    std::size_t words_per_row = 0;
+    int height = 0;
+    std::vector<std::uint64_t> words;
+};
+
+#endif // BIT_GRID_H
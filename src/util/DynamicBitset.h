@@ -0,0 +1,43 @@
+#ifndef DYNAMIC_BITSET_H
+#define DYNAMIC_BITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class DynamicBitset
+ * @brief A set of small non-negative integers stored one bit each.
+ *
+ * The set grows to fit the largest member. Testing a member is a bounds
+ * check and a bit test with no allocation, so it suits checks made in hot
+ * loops, such as whether a player holds the key an exit needs.
+ */
+class DynamicBitset {
+public:
+    void set(std::size_t bit) {
+        if (bit / 64 >= words.size()) {
+            words.resize(bit / 64 + 1, 0);
+        }
+        words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+    }
+
+    void reset(std::size_t bit) {
+        if (bit / 64 < words.size()) {
+            words[bit / 64] &= ~(std::uint64_t{1} << (bit % 64));
+        }
+    }
+
+    /**
+     * @brief Checks for a member; anything beyond the largest member, including
+     *        a negative int converted to std::size_t, is not one.
+     */
+    bool test(std::size_t bit) const {
+        return bit / 64 < words.size() && ((words[bit / 64] >> (bit % 64)) & 1) != 0;
+    }
+
+private:
+    std::vector<std::uint64_t> words;
+};
+
+#endif // DYNAMIC_BITSET_H
@@ -0,0 +1,70 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * @class LruCache
+ * @brief A fixed-capacity map that evicts the least recently used entry.
+ *
+ * References to values stay valid until their entry is evicted or the cache
+ * is cleared.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(std::size_t capacity) : capacity(capacity ? capacity : 1) {}
+
+    /**
+     * @brief Looks up a value and marks it as the most recently used.
+     * @return The value, or nullptr if it is not cached.
+     */
+    Value* find(const Key& key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return nullptr;
+        }
+        entries.splice(entries.begin(), entries, it->second);
+        return &it->second->second;
+    }
+
+    /**
+     * @brief Adds or replaces a value, evicting the least recently used entry if full.
+     */
+    Value& insert(const Key& key, Value value) {
+        auto it = index.find(key);
+        if (it != index.end()) {
+            it->second->second = std::move(value);
+            entries.splice(entries.begin(), entries, it->second);
+            return it->second->second;
+        }
+        if (entries.size() >= capacity) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+        entries.emplace_front(key, std::move(value));
+        index.emplace(key, entries.begin());
+        return entries.front().second;
+    }
+
+    std::size_t size() const { return entries.size(); }
+    std::size_t getCapacity() const { return capacity; }
+
+    void clear() {
+        index.clear();
+        entries.clear();
+    }
+
+private:
+    using Entries = std::list<std::pair<Key, Value>>; // Most recently used first
+
+    std::size_t capacity;
+    Entries entries;
+    std::unordered_map<Key, typename Entries::iterator, Hash> index;
+};
+
+#endif // LRU_CACHE_H
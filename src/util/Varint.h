@@ -0,0 +1,112 @@
+#ifndef VARINT_H
+#define VARINT_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+
+/**
+ * @namespace Varint
+ * @brief LEB128 variable-length integers and fixed-width little-endian fields
+ *        for the game's binary formats.
+ *
+ * Small values, which are the common case for IDs, lengths and deltas, take
+ * a single byte. Readers return false on truncated or malformed input.
+ */
+namespace Varint {
+
+    inline void write(std::ostream& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.put(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.put(static_cast<char>(value));
+    }
+
+    inline bool read(std::istream& in, std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int byte = in.get();
+            if (byte == std::char_traits<char>::eof()) {
+                return false;
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false; // More than ten bytes
+    }
+
+    // Zigzag encoding keeps small negative numbers small.
+    inline void writeSigned(std::ostream& out, std::int64_t value) {
+        write(out, (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    inline bool readSigned(std::istream& in, std::int64_t& value) {
+        std::uint64_t raw = 0;
+        if (!read(in, raw)) {
+            return false;
+        }
+        value = static_cast<std::int64_t>((raw >> 1) ^ (~(raw & 1) + 1));
+        return true;
+    }
+
+    inline void writeString(std::ostream& out, const std::string& text) {
+        write(out, text.size());
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+    inline bool readString(std::istream& in, std::string& text, std::uint64_t max_length = 1 << 20) {
+        std::uint64_t length = 0;
+        if (!read(in, length) || length > max_length) {
+            return false;
+        }
+        text.resize(static_cast<std::size_t>(length));
+        in.read(text.data(), static_cast<std::streamsize>(length));
+        return static_cast<std::uint64_t>(in.gcount()) == length;
+    }
+
+    inline void writeFixed64(std::ostream& out, std::uint64_t value) {
+        for (int i = 0; i < 8; ++i) {
+            out.put(static_cast<char>(value >> (8 * i)));
+        }
+    }
+
+    inline bool readFixed64(std::istream& in, std::uint64_t& value) {
+        value = 0;
+        for (int i = 0; i < 8; ++i) {
+            int byte = in.get();
+            if (byte == std::char_traits<char>::eof()) {
+                return false;
+            }
+            value |= static_cast<std::uint64_t>(byte) << (8 * i);
+        }
+        return true;
+    }
+
+    // In-memory forms, for formats that are built in a buffer.
+    inline void append(std::string& out, std::uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    inline bool decode(const char*& pos, const char* end, std::uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+            unsigned char byte = static_cast<unsigned char>(*pos++);
+            value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace Varint
+
+#endif // VARINT_H
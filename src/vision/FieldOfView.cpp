@@ -0,0 +1,241 @@
+#include "FieldOfView.h"
+#include "../Terrain.h"
+#include <algorithm>
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VISION_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VISION_SSE2 1
+#endif
+
+namespace {
+
+using Window = std::array<std::uint64_t, 64>;
+
+constexpr int CENTRE = 32; // Window row and column of the player
+
+// A slope of a line from the centre of the player's tile, as rise over run
+struct Slope {
+    int rise;
+    int run; // Always positive
+};
+
+// Slopes' runs are 1 or twice a depth, so every division below is by at most
+// 4 * MAX_RADIUS + 4 of a numerator under 2^14 in magnitude. Dividing by
+// multiplying with a rounded-up reciprocal is exact in that range, and several
+// times faster than a division instruction.
+constexpr int MAX_DIVISOR = 4 * FieldOfView::MAX_RADIUS + 4;
+constexpr int DIVIDEND_BIAS = 1 << 14; // Multiples of the divisor added to make the dividend positive
+
+constexpr std::array<std::uint64_t, MAX_DIVISOR + 1> makeReciprocals() {
+    std::array<std::uint64_t, MAX_DIVISOR + 1> reciprocals{};
+    for (int b = 1; b <= MAX_DIVISOR; ++b) {
+        reciprocals[b] = ((std::uint64_t{1} << 32) + b - 1) / b;
+    }
+    return reciprocals;
+}
+
+constexpr std::array<std::uint64_t, MAX_DIVISOR + 1> RECIPROCALS = makeReciprocals();
+
+int floorDiv(int a, int b) {
+    std::uint64_t biased = static_cast<std::uint64_t>(a + DIVIDEND_BIAS * b);
+    return static_cast<int>((biased * RECIPROCALS[b]) >> 32) - DIVIDEND_BIAS;
+}
+
+int ceilDiv(int a, int b) {
+    return -floorDiv(-a, b);
+}
+
+// Bits first to last inclusive, none if first > last; both within 0..63
+std::uint64_t bitRange(int first, int last) {
+    if (first > last) {
+        return 0;
+    }
+    return (~std::uint64_t{0} >> (63 - last)) & (~std::uint64_t{0} << first);
+}
+
+// Lights one row of a quadrant and recurses into the next for each stretch of
+// floor in it. Rows lie at CENTRE + step * depth; column offset k is bit CENTRE + k.
+void scanRow(const Window& opaque, Window& seen, int step, int radius, int depth, Slope start, Slope end) {
+    if (depth > radius) {
+        return;
+    }
+    // Columns whose centres the slopes pass through, rounding ties outwards...
+    int first = floorDiv(2 * depth * start.rise + start.run, 2 * start.run);
+    int last = ceilDiv(2 * depth * end.rise - end.run, 2 * end.run);
+    std::uint64_t range = bitRange(CENTRE + first, CENTRE + last);
+    if (range == 0) {
+        return;
+    }
+    // ...of which walls are seen wherever they are lit, and floor only when the
+    // line to its centre is clear, which is what makes sight symmetric
+    int row = CENTRE + step * depth;
+    std::uint64_t walls = opaque[row] & range;
+    int clear_first = std::max(first, ceilDiv(depth * start.rise, start.run));
+    int clear_last = std::min(last, floorDiv(depth * end.rise, end.run));
+    seen[row] |= walls | (bitRange(CENTRE + clear_first, CENTRE + clear_last) & ~walls);
+
+    std::uint64_t floors = range & ~walls;
+    while (floors != 0) {
+        int a = std::countr_zero(floors);
+        int b = a + std::countr_one(floors >> a) - 1;
+        floors &= b == 63 ? 0 : ~std::uint64_t{0} << (b + 1);
+        // The next row is lit between the walls on either side of this stretch
+        Slope next_start = a == CENTRE + first ? start : Slope{2 * (a - CENTRE) - 1, 2 * depth};
+        Slope next_end = b == CENTRE + last ? end : Slope{2 * (b - CENTRE) + 1, 2 * depth};
+        scanRow(opaque, seen, step, radius, depth + 1, next_start, next_end);
+    }
+}
+
+// One step of the 64 x 64 transpose: swaps the j x j blocks off the diagonal
+// within each 2j x 2j block, with mask selecting their low columns.
+void transposeStep(Window& a, int j, std::uint64_t mask) {
+#if VISION_AVX2
+    if (j >= 4) {
+        const __m256i lanes = _mm256_set1_epi64x(static_cast<long long>(mask));
+        const __m128i shift = _mm_cvtsi32_si128(j);
+        for (int k = 0; k < 64; k += 4) {
+            if (k & j) {
+                continue;
+            }
+            __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&a[k]));
+            __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&a[k + j]));
+            __m256i t = _mm256_and_si256(_mm256_xor_si256(_mm256_srl_epi64(low, shift), high), lanes);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&a[k]), _mm256_xor_si256(low, _mm256_sll_epi64(t, shift)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&a[k + j]), _mm256_xor_si256(high, t));
+        }
+        return;
+    }
+#endif
+#if VISION_AVX2 || VISION_SSE2
+    if (j >= 2) {
+        const __m128i lanes = _mm_set1_epi64x(static_cast<long long>(mask));
+        const __m128i shift = _mm_cvtsi32_si128(j);
+        for (int k = 0; k < 64; k += 2) {
+            if (k & j) {
+                continue;
+            }
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&a[k]));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&a[k + j]));
+            __m128i t = _mm_and_si128(_mm_xor_si128(_mm_srl_epi64(low, shift), high), lanes);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&a[k]), _mm_xor_si128(low, _mm_sll_epi64(t, shift)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&a[k + j]), _mm_xor_si128(high, t));
+        }
+        return;
+    }
+#endif
+    for (int k = 0; k < 64; ++k) {
+        if (k & j) {
+            continue;
+        }
+        std::uint64_t t = ((a[k] >> j) ^ a[k + j]) & mask;
+        a[k] ^= t << j;
+        a[k + j] ^= t;
+    }
+}
+
+// Swaps rows and columns: bit c of row r moves to bit r of row c
+void transpose(Window& a) {
+    std::uint64_t mask = 0x00000000FFFFFFFFull;
+    for (int j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        transposeStep(a, j, mask);
+    }
+}
+
+// Per radius, the tiles whose centres are within radius + 1/2 of the player's
+const std::array<Window, FieldOfView::MAX_RADIUS + 1>& rangeMasks() {
+    static const std::array<Window, FieldOfView::MAX_RADIUS + 1> masks = [] {
+        std::array<Window, FieldOfView::MAX_RADIUS + 1> made{};
+        for (int radius = 0; radius <= FieldOfView::MAX_RADIUS; ++radius) {
+            for (int r = 0; r < 64; ++r) {
+                for (int c = 0; c < 64; ++c) {
+                    int dx = c - CENTRE, dy = r - CENTRE;
+                    if (dx * dx + dy * dy <= radius * (radius + 1)) {
+                        made[radius][r] |= std::uint64_t{1} << c;
+                    }
+                }
+            }
+        }
+        return made;
+    }();
+    return masks;
+}
+
+} // namespace
+
+FieldOfView::FieldOfView(int radius)
+    : radius(std::clamp(radius, 0, MAX_RADIUS)), in_range(&rangeMasks()[this->radius]) {}
+
+const char* FieldOfView::getInstructionSet() {
+#if VISION_AVX2
+    return "avx2";
+#elif VISION_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+bool FieldOfView::update(const Terrain& terrain, int x, int y) {
+    explored_top = 1;
+    explored_bottom = 0;
+    if (computed && x - CENTRE == left && y - CENTRE == top && terrain.getVersion() == terrain_version) {
+        return false;
+    }
+    computed = true;
+    left = x - CENTRE;
+    top = y - CENTRE;
+    terrain_version = terrain.getVersion();
+
+    // Only the rows and columns within the radius are ever looked at
+    int first_row = CENTRE - radius;
+    int rows = 2 * radius + 1;
+    Window opaque{}, opaque_columns;
+    terrain.getOpacity().extractRows(left, top + first_row, rows, &opaque[first_row]);
+    opaque_columns = opaque;
+    transpose(opaque_columns);
+
+    // North and south scan the rows, east and west the columns
+    Window seen{}, seen_columns{};
+    seen[CENTRE] = std::uint64_t{1} << CENTRE;
+    scanRow(opaque, seen, -1, radius, 1, {-1, 1}, {1, 1});
+    scanRow(opaque, seen, 1, radius, 1, {-1, 1}, {1, 1});
+    scanRow(opaque_columns, seen_columns, -1, radius, 1, {-1, 1}, {1, 1});
+    scanRow(opaque_columns, seen_columns, 1, radius, 1, {-1, 1}, {1, 1});
+    transpose(seen_columns);
+    for (int r = 0; r < 64; ++r) {
+        visible[r] = (seen[r] | seen_columns[r]) & (*in_range)[r];
+    }
+
+    explored.reserve(terrain.getWidth(), terrain.getHeight());
+    std::uint64_t changed = explored.mergeRows(left, top + first_row, rows, &visible[first_row]);
+    if (changed != 0) {
+        explored_top = top + first_row + std::countr_zero(changed);
+        explored_bottom = top + first_row + 63 - std::countl_zero(changed);
+    }
+    return true;
+}
+
+bool FieldOfView::isVisible(int x, int y) const {
+    int c = x - left, r = y - top;
+    return computed && c >= 0 && c < 64 && r >= 0 && r < 64 && ((visible[r] >> c) & 1) != 0;
+}
+
+bool FieldOfView::isExplored(int x, int y) const {
+    return explored.test(x, y);
+}
+
+const BitGrid& FieldOfView::getExplored() const {
+    return explored;
+}
+
+int FieldOfView::getNewlyExploredTop() const {
+    return explored_top;
+}
+
+int FieldOfView::getNewlyExploredBottom() const {
+    return explored_bottom;
+}
@@ -0,0 +1,76 @@
+#ifndef FIELD_OF_VIEW_H
+#define FIELD_OF_VIEW_H
+
+#include <array>
+#include <cstdint>
+#include "../util/BitGrid.h"
+
+class Terrain;
+
+/**
+ * @class FieldOfView
+ * @brief What one player can see of the terrain from where they stand, and all they have seen so far.
+ *
+ * Sight is worked out by symmetric shadowcasting, which sees a tile from
+ * another exactly when it is seen back, in a 64 x 64 tile window around the
+ * player held as one 64-bit word per row. Each row of a quadrant is scanned
+ * a word at a time: the walls in view are picked out with a mask, and every
+ * stretch of floor found between them casts the next row's light, so a row
+ * costs a few instructions however wide it is. The east and west quadrants
+ * run the same scan over the window transposed, which is done with SIMD
+ * instructions where the target has them (AVX2, or SSE2 on any x86-64).
+ *
+ * Sight is recomputed only when the player moves or a tile changes. Every
+ * tile seen is added to the explored map, one bit per tile of the terrain.
+ */
+class FieldOfView {
+public:
+    static constexpr int MAX_RADIUS = 31; // The farthest the window reaches from its centre
+
+    /**
+     * @param radius How far the player can see, at most MAX_RADIUS.
+     */
+    explicit FieldOfView(int radius = MAX_RADIUS);
+
+    /**
+     * @brief Gets the name of the instruction set the transpose was built for: "avx2", "sse2" or "scalar".
+     */
+    static const char* getInstructionSet();
+
+    /**
+     * @brief Works out what can be seen from a position, unless neither it nor the terrain has changed.
+     * @return true if sight was recomputed.
+     */
+    bool update(const Terrain& terrain, int x, int y);
+
+    bool isVisible(int x, int y) const;
+    bool isExplored(int x, int y) const;
+
+    /**
+     * @brief Gets every tile seen so far, one bit per tile.
+     */
+    const BitGrid& getExplored() const;
+
+    /**
+     * @brief Gets the first and last rows with tiles seen for the first time by the
+     *        last update; the first is past the last if there were none.
+     */
+    int getNewlyExploredTop() const;
+    int getNewlyExploredBottom() const;
+
+private:
+    using Window = std::array<std::uint64_t, 64>; // Row r, bit c is the tile at (left + c, top + r)
+
+    int radius;
+    const Window* in_range; // Tiles within the radius of the centre, shared by every view of the radius
+    Window visible{};
+    int left = 0;    // Map position of the window's top-left tile
+    int top = 0;
+    bool computed = false;
+    std::uint64_t terrain_version = 0;
+    BitGrid explored;
+    int explored_top = 1;
+    int explored_bottom = 0;
+};
+
+#endif // FIELD_OF_VIEW_H
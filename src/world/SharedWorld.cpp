@@ -0,0 +1,671 @@
+#include "SharedWorld.h"
+#include "../CSVParser.h"
+#include "../SQLParser.h"
+#include "../embedded/WorldTables.h"
+#include "../storage/WorldStore.h"
+#include "../memory/MemoryStats.h"
+#include "../log/Log.h"
+#include "../metrics/Metrics.h"
+#include "../concurrency/WorkStealingScheduler.h"
+#include "../objects/Challenge.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+namespace {
+
+// Held while a world loads, so that games opening the same world at once load it once
+std::mutex cache_mutex;
+std::unordered_map<std::string, std::weak_ptr<SharedWorld>> cached_worlds; // By source
+std::weak_ptr<SharedWorld> embedded_world;
+
+std::size_t dataRows(const std::vector<std::vector<std::string>>& table) {
+    return table.empty() ? 0 : table.size() - 1; // Less the header
+}
+
+// Sets the table's load time gauge to the time since start, and restarts start
+// for the next table. Worlds load one at a time, under cache_mutex.
+void recordTableLoad(const char* table, std::chrono::steady_clock::time_point& start) {
+    static std::map<std::string, std::unique_ptr<Gauge>> load_times;
+    std::unique_ptr<Gauge>& gauge = load_times[table];
+    if (!gauge) {
+        gauge = std::make_unique<Gauge>("quanta_world_table_load_seconds", "Time the last world load spent reading each CSV table",
+                                        std::string("table=\"") + table + "\"", 1e-6);
+    }
+    auto now = std::chrono::steady_clock::now();
+    gauge->set(std::chrono::duration_cast<std::chrono::microseconds>(now - start).count());
+    start = now;
+}
+
+} // namespace
+
+std::shared_ptr<SharedWorld> SharedWorld::load(const std::string& source) {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    std::weak_ptr<SharedWorld>& cached = cached_worlds[source];
+    if (std::shared_ptr<SharedWorld> world = cached.lock()) {
+        return world;
+    }
+
+    MemoryScope scope(MemTag::WorldLoad);
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<SharedWorld> world(new SharedWorld());
+    world->source = source;
+    // Load all game data from the SQL dump if one was given, otherwise from the CSV files
+    if (source.empty()) {
+        world->loadDataFromCSV();
+    } else if (StorageEngine::exists(source)) {
+        if (!world->loadDataFromStore(source)) {
+            std::cerr << "Error: Failed to load game data from the store in " << source << std::endl;
+        }
+    } else if (std::filesystem::is_directory(source)) {
+        world->loadDataFromCSV(source);
+    } else if (!world->loadDataFromSQL(source)) {
+        std::cerr << "Error: Failed to load game data from " << source << std::endl;
+    }
+    world->finish();
+    Log::info("World loaded", {{"source", source.empty() ? "sql" : source}, {"rooms", world->allRooms.size()},
+                               {"ms", std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()}});
+    cached = world;
+    return world;
+}
+
+std::shared_ptr<SharedWorld> SharedWorld::loadEmbedded() {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if (std::shared_ptr<SharedWorld> world = embedded_world.lock()) {
+        return world;
+    }
+    MemoryScope scope(MemTag::WorldLoad);
+    std::shared_ptr<SharedWorld> world(new SharedWorld());
+    world->loadEmbeddedWorld();
+    world->finish();
+    embedded_world = world;
+    return world;
+}
+
+SharedWorld::SharedWorld(World world) {
+    MemoryScope scope(MemTag::WorldLoad);
+    allRooms = std::move(world.rooms);
+    allCharacters = std::move(world.characters);
+    allTools = std::move(world.tools);
+    allRoomObjects = std::move(world.room_objects);
+    allPlayers = std::move(world.players);
+    finish();
+}
+
+SharedWorld::~SharedWorld() = default;
+
+void SharedWorld::finish() {
+    if (!allPlayers.empty()) {
+        // Start in the first loaded room unless the data gave the player a room.
+        if (!allRooms.empty()) {
+            if (allPlayers[0]->getCurrentRoom() == nullptr) {
+                allPlayers[0]->setCurrentRoom(allRooms[0].get());
+            }
+            // Example: Add a challenge to the starting room
+            if (allRooms[0]->getChallenge() == nullptr) {
+                MemoryScope challenge_scope(MemTag::Challenge);
+                std::vector<CBTChoice> choices;
+                CBTChoice choice1;
+                choice1.description = "Challenge the thought";
+                choice1.score_change = 10;
+                choices.push_back(choice1);
+
+                CBTChoice choice2;
+                choice2.description = "Accept the thought";
+                choice2.score_change = -5;
+                choices.push_back(choice2);
+                allRooms[0]->setChallenge(std::make_unique<Challenge>("You feel overwhelmed by the vastness of the void.", choices));
+            }
+        }
+    } else {
+        // Fallback: if no players or rooms are loaded, create defaults.
+        if (allRooms.empty()) {
+            allRooms.push_back(std::make_unique<Room>("A non-descript, empty void."));
+        }
+        allPlayers.push_back(std::make_unique<Player>(0, "Default Player", "unknown", allRooms[0].get()));
+    }
+    if (!world_search.isStarted()) {
+        world_search.start(allRooms, allCharacters, allTools, allRoomObjects);
+    }
+
+    rooms_by_id.reserve(allRooms.size());
+    for (const auto& room : allRooms) {
+        rooms_by_id.emplace(room->getId(), room.get());
+    }
+    for (const auto& tool : allTools) {
+        Room* room = findRoom(tool->getInitialRoomId());
+        if (room) {
+            room->addObject(tool.get());
+        } else {
+            std::cerr << "Error: Tool " << tool->getId() << " starts in unknown room " << tool->getInitialRoomId() << std::endl;
+        }
+    }
+
+    // Regions depend only on the world, so every session's characters are ticked by the same ones
+    for (const auto& room : allRooms) {
+        for (Character* character : room->getCharacters()) {
+            npcs.add(character, room.get());
+        }
+    }
+    npcs.setRoomsShared(true);
+    if (npcs.getMoverCount() >= NpcSystem::MIN_PARALLEL_MOVERS) {
+        npcs.partition(allRooms, NPC_REGION_ROOMS);
+        npc_threads = std::make_unique<WorkStealingScheduler>();
+    }
+
+    // Move the world's prose into text_store
+    for (const auto& room : allRooms) {
+        room->compressText(text_store);
+    }
+    for (const auto& character : allCharacters) {
+        character->compressText(text_store);
+    }
+    for (const auto& tool : allTools) {
+        tool->compressText(text_store);
+    }
+    for (const auto& object : allRoomObjects) {
+        object->compressText(text_store);
+    }
+    text_store.build();
+
+    // From here on other threads may read the rooms, so exits are changed by publishing new versions
+    for (const auto& room : allRooms) {
+        room->setShared(true);
+    }
+}
+
+void SharedWorld::loadDataFromCSV(const std::string& directory) {
+    auto table_start = std::chrono::steady_clock::now();
+    // Load Rooms
+    std::vector<std::vector<std::string>> roomData = CSVParser::readCSV(directory + "/rooms.csv");
+    Log::info("Loading table", {{"table", "rooms"}, {"rows", dataRows(roomData)}});
+    for (size_t i = 1; i < roomData.size(); ++i) { // Skip header row
+        if (roomData[i].size() > 1) {
+            Log::debug("Room loaded", {{"id", roomData[i][0]}, {"description", roomData[i][1]}});
+            allRooms.push_back(std::make_unique<Room>(std::stoi(roomData[i][0]), roomData[i][1]));
+        } else {
+            std::cerr << "Error: Malformed room data at row " << i << std::endl;
+        }
+    }
+    recordTableLoad("rooms", table_start);
+
+    // Load Characters
+    std::vector<std::vector<std::string>> characterData = CSVParser::readCSV(directory + "/characters.csv");
+    Log::info("Loading table", {{"table", "characters"}, {"rows", dataRows(characterData)}});
+    for (size_t i = 1; i < characterData.size(); ++i) { // Skip header row
+        if (characterData[i].size() > 4) {
+            std::string name = characterData[i][1];
+            std::string description = characterData[i][2];
+            int initialRoomId = std::stoi(characterData[i][3]);
+            std::string dialogue = characterData[i][4];
+            Log::debug("Character loaded", {{"name", name}, {"description", description}, {"dialogue", dialogue}});
+            auto newCharacter = std::make_unique<Character>(std::stoi(characterData[i][0]), name, description, initialRoomId, dialogue);
+            // The optional behaviour column says how the character moves
+            NpcBehaviour behaviour = NpcBehaviour::Idle;
+            if (characterData[i].size() > 5 && !parseNpcBehaviour(characterData[i][5], behaviour)) {
+                std::cerr << "Error: Unknown character behaviour at row " << i << std::endl;
+            }
+            newCharacter->setBehaviour(behaviour);
+            if (initialRoomId > 0 && initialRoomId <= allRooms.size()) {
+                allRooms[initialRoomId - 1]->addCharacter(newCharacter.get()); // Pass raw pointer to Room
+            }
+            allCharacters.push_back(std::move(newCharacter));
+        } else {
+            std::cerr << "Error: Malformed character data at row " << i << std::endl;
+        }
+    }
+    recordTableLoad("characters", table_start);
+
+    // Load Players
+    std::vector<std::vector<std::string>> playerData = CSVParser::readCSV(directory + "/players.csv");
+    Log::info("Loading table", {{"table", "players"}, {"rows", dataRows(playerData)}});
+    for (size_t i = 1; i < playerData.size(); ++i) { // Skip header row
+        if (playerData[i].size() > 2) {
+            allPlayers.push_back(std::make_unique<Player>(std::stoi(playerData[i][0]), playerData[i][1], playerData[i][2], nullptr));
+        } else {
+            std::cerr << "Error: Malformed player data at row " << i << std::endl;
+        }
+    }
+    recordTableLoad("players", table_start);
+
+    // Load Game Sessions
+    std::vector<std::vector<std::string>> gameSessionData = CSVParser::readCSV(directory + "/game_sessions.csv");
+    Log::info("Loading table", {{"table", "game_sessions"}, {"rows", dataRows(gameSessionData)}});
+    for (size_t i = 1; i < gameSessionData.size(); ++i) { // Skip header row
+        if (gameSessionData[i].size() > 3) {
+            allGameSessions.push_back(std::make_unique<GameSession>(std::stoi(gameSessionData[i][0]), gameSessionData[i][1], gameSessionData[i][2], gameSessionData[i][3]));
+        } else {
+            std::cerr << "Error: Malformed game session data at row " << i << std::endl;
+        }
+    }
+    recordTableLoad("game_sessions", table_start);
+
+    // Load Scores
+    std::vector<std::vector<std::string>> scoreData = CSVParser::readCSV(directory + "/scores.csv");
+    Log::info("Loading table", {{"table", "scores"}, {"rows", dataRows(scoreData)}});
+    for (size_t i = 1; i < scoreData.size(); ++i) { // Skip header row
+        if (scoreData[i].size() > 3) {
+            allScores.push_back(std::make_unique<Score>(std::stoi(scoreData[i][0]), std::stoi(scoreData[i][1]), std::stoi(scoreData[i][2]), std::stoi(scoreData[i][3])));
+        } else {
+            std::cerr << "Error: Malformed score data at row " << i << std::endl;
+        }
+    }
+    recordTableLoad("scores", table_start);
+
+    // Load Tools
+    std::vector<std::vector<std::string>> toolData = CSVParser::readCSV(directory + "/tools.csv");
+    Log::info("Loading table", {{"table", "tools"}, {"rows", dataRows(toolData)}});
+    for (size_t i = 1; i < toolData.size(); ++i) { // Skip header row
+        if (toolData[i].size() > 3) {
+            allTools.push_back(std::make_unique<Tool>(std::stoi(toolData[i][0]), toolData[i][1], toolData[i][2], std::stoi(toolData[i][3])));
+        } else {
+            std::cerr << "Error: Malformed tool data at row " << i << std::endl;
+        }
+    }
+    recordTableLoad("tools", table_start);
+
+    // Load RoomObjects
+    std::vector<std::vector<std::string>> roomObjectData = CSVParser::readCSV(directory + "/room_objects.csv");
+    Log::info("Loading table", {{"table", "room_objects"}, {"rows", dataRows(roomObjectData)}});
+    for (size_t i = 1; i < roomObjectData.size(); ++i) { // Skip header row
+        if (roomObjectData[i].size() > 3) {
+            allRoomObjects.push_back(std::make_unique<RoomObject>(std::stoi(roomObjectData[i][0]), roomObjectData[i][1], roomObjectData[i][2], std::stoi(roomObjectData[i][3])));
+        } else {
+            std::cerr << "Error: Malformed room object data at row " << i << std::endl;
+        }
+    }
+    recordTableLoad("room_objects", table_start);
+
+    // Everything searchable is loaded, so index it while the exits, usually
+    // the largest table, are read.
+    world_search.start(allRooms, allCharacters, allTools, allRoomObjects);
+
+    // Load Exits (after all rooms are loaded)
+    std::vector<std::vector<std::string>> exitData = CSVParser::readCSV(directory + "/exits.csv");
+    Log::info("Loading table", {{"table", "exits"}, {"rows", dataRows(exitData)}});
+    for (size_t i = 1; i < exitData.size(); ++i) { // Skip header row
+        if (exitData[i].size() > 3) {
+            int fromRoomId = std::stoi(exitData[i][1]);
+            int toRoomId = std::stoi(exitData[i][2]);
+            std::string direction = exitData[i][3];
+            // Locked exits name the tool that opens them
+            int keyToolId = 0;
+            if (exitData[i].size() > 6 && CSVParser::parseBool(exitData[i][5]) && !exitData[i][6].empty()) {
+                keyToolId = std::stoi(exitData[i][6]);
+            }
+
+            if (fromRoomId > 0 && fromRoomId <= allRooms.size() &&
+                toRoomId > 0 && toRoomId <= allRooms.size()) {
+                allRooms[fromRoomId - 1]->addExit(direction, allRooms[toRoomId - 1].get(), keyToolId);
+            } else {
+                std::cerr << "Error: Invalid room ID in exit data at row " << i << std::endl;
+            }
+        } else {
+            std::cerr << "Error: Malformed exit data at row " << i << std::endl;
+        }
+    }
+    recordTableLoad("exits", table_start);
+}
+
+bool SharedWorld::loadDataFromSQL(const std::string& sql_file_path) {
+    std::ifstream file(sql_file_path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open SQL file " << sql_file_path << std::endl;
+        return false;
+    }
+    Log::info("Loading world from SQL dump", {{"path", sql_file_path}});
+
+    enum class Table { Ignored, Rooms, Characters, Players, Exits, Tools, RoomObjects, GameSessions, Scores, Terrain };
+    Table table = Table::Ignored;
+    int col[6] = {-1, -1, -1, -1, -1, -1}; // Value positions for the current statement, -1 if absent
+    size_t row = 0;                    // Row number within the current statement, for error messages
+
+    // Rows refer to rooms by room_id, which need not be dense or start at 1.
+    std::unordered_map<int, Room*> roomsById;
+
+    // Finds a column by any of its accepted names. Statements without a
+    // column list use the same column order as the CSV files.
+    auto column = [](const SQLInsert& insert, std::initializer_list<const char*> names, int positional) {
+        if (insert.columns.empty()) {
+            return positional;
+        }
+        for (const char* name : names) {
+            int index = insert.columnIndex(name);
+            if (index >= 0) {
+                return index;
+            }
+        }
+        return -1;
+    };
+
+    auto onInsert = [&](const SQLInsert& insert) {
+        const std::string& name = insert.table;
+        row = 0;
+        if (name == "rooms") {
+            table = Table::Rooms;
+            col[0] = column(insert, {"room_id", "id"}, 0);
+            col[1] = column(insert, {"description"}, 1);
+        } else if (name == "characters") {
+            table = Table::Characters;
+            col[0] = column(insert, {"character_id", "id"}, 0);
+            col[1] = column(insert, {"name"}, 1);
+            col[2] = column(insert, {"description"}, 2);
+            col[3] = column(insert, {"initial_room_id", "room_id"}, 3);
+            col[4] = column(insert, {"dialogue"}, 4);
+            col[5] = column(insert, {"behaviour"}, 5);
+        } else if (name == "players") {
+            table = Table::Players;
+            col[0] = column(insert, {"player_id", "id"}, 0);
+            col[1] = column(insert, {"name", "player_name"}, 1);
+            col[2] = column(insert, {"join_date"}, 2);
+            col[3] = column(insert, {"initial_room_id", "current_room_id"}, -1);
+        } else if (name == "exits") {
+            table = Table::Exits;
+            col[0] = column(insert, {"from_room_id"}, 1);
+            col[1] = column(insert, {"to_room_id"}, 2);
+            col[2] = column(insert, {"direction"}, 3);
+            col[3] = column(insert, {"is_locked"}, 5);
+            col[4] = column(insert, {"key_tool_id"}, 6);
+        } else if (name == "tools" || name == "room_objects") {
+            table = (name == "tools") ? Table::Tools : Table::RoomObjects;
+            col[0] = column(insert, {"tool_id", "object_id", "id"}, 0);
+            col[1] = column(insert, {"name"}, 1);
+            col[2] = column(insert, {"description"}, 2);
+            col[3] = column(insert, {"initial_room_id", "room_id"}, 3);
+        } else if (name == "game_sessions") {
+            table = Table::GameSessions;
+            col[0] = column(insert, {"session_id", "id"}, 0);
+            col[1] = column(insert, {"game_type"}, 1);
+            col[2] = column(insert, {"start_time"}, 2);
+            col[3] = column(insert, {"end_time"}, 3);
+        } else if (name == "scores") {
+            table = Table::Scores;
+            col[0] = column(insert, {"score_id", "id"}, 0);
+            col[1] = column(insert, {"player_id"}, 1);
+            col[2] = column(insert, {"session_id"}, 2);
+            col[3] = column(insert, {"score"}, 3);
+        } else if (name == "terrain") {
+            table = Table::Terrain;
+            col[0] = column(insert, {"x_coord"}, 0);
+            col[1] = column(insert, {"y_coord"}, 1);
+            col[2] = column(insert, {"tile_type"}, 2);
+        } else {
+            table = Table::Ignored;
+        }
+    };
+
+    auto onRow = [&](const std::vector<SQLValue>& values) {
+        static const std::string missing;
+        auto text = [&](int index) -> const std::string& {
+            return (index >= 0 && static_cast<size_t>(index) < values.size()) ? values[index].text : missing;
+        };
+        auto number = [&](int index) {
+            return (index >= 0 && static_cast<size_t>(index) < values.size()) ? values[index].toInt(-1) : -1;
+        };
+        auto roomFor = [&](int index) -> Room* {
+            auto it = roomsById.find(number(index));
+            return (it != roomsById.end()) ? it->second : nullptr;
+        };
+        ++row;
+
+        switch (table) {
+            case Table::Rooms: {
+                auto room = std::make_unique<Room>(number(col[0]), text(col[1]));
+                roomsById[room->getId()] = room.get();
+                allRooms.push_back(std::move(room));
+                break;
+            }
+            case Table::Characters: {
+                auto character = std::make_unique<Character>(number(col[0]), text(col[1]), text(col[2]), number(col[3]), text(col[4]));
+                NpcBehaviour behaviour = NpcBehaviour::Idle;
+                if (!parseNpcBehaviour(text(col[5]), behaviour)) {
+                    std::cerr << "Error: Unknown character behaviour at row " << row << std::endl;
+                }
+                character->setBehaviour(behaviour);
+                if (Room* room = roomFor(col[3])) {
+                    room->addCharacter(character.get());
+                }
+                allCharacters.push_back(std::move(character));
+                break;
+            }
+            case Table::Players:
+                allPlayers.push_back(std::make_unique<Player>(number(col[0]), text(col[1]), text(col[2]), roomFor(col[3])));
+                break;
+            case Table::Exits: {
+                Room* from = roomFor(col[0]);
+                Room* to = roomFor(col[1]);
+                bool locked = col[3] >= 0 && static_cast<size_t>(col[3]) < values.size() && values[col[3]].toBool();
+                if (from && to) {
+                    from->addExit(text(col[2]), to, locked ? std::max(0, number(col[4])) : 0);
+                } else {
+                    std::cerr << "Error: Invalid room ID in exit data at row " << row << std::endl;
+                }
+                break;
+            }
+            case Table::Tools:
+                allTools.push_back(std::make_unique<Tool>(number(col[0]), text(col[1]), text(col[2]), number(col[3])));
+                break;
+            case Table::RoomObjects:
+                allRoomObjects.push_back(std::make_unique<RoomObject>(number(col[0]), text(col[1]), text(col[2]), number(col[3])));
+                break;
+            case Table::GameSessions:
+                allGameSessions.push_back(std::make_unique<GameSession>(number(col[0]), text(col[1]), text(col[2]), text(col[3])));
+                break;
+            case Table::Scores:
+                allScores.push_back(std::make_unique<Score>(number(col[0]), number(col[1]), number(col[2]), number(col[3])));
+                break;
+            case Table::Terrain: {
+                const std::string& tile = text(col[2]);
+                if (tile.empty() || !terrain.setTile(number(col[0]), number(col[1]), tile[0])) {
+                    std::cerr << "Error: Malformed terrain data at row " << row << std::endl;
+                }
+                break;
+            }
+            case Table::Ignored:
+                break;
+        }
+    };
+
+    SQLParser parser(file);
+    if (!parser.parse(onInsert, onRow)) {
+        std::cerr << "Error: " << sql_file_path << ", " << parser.getError() << std::endl;
+        return false;
+    }
+    Log::info("Loaded SQL dump", {{"rows", parser.getRowCount()}});
+    return true;
+}
+
+bool SharedWorld::loadDataFromStore(const std::string& directory) {
+    WorldStore store;
+    if (!store.open(directory)) {
+        return false;
+    }
+    Log::info("Loading world from store", {{"path", directory}});
+
+    std::unordered_map<int, Room*> roomsById;
+    auto number = [](const std::string& text) {
+        int value = -1;
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    };
+    auto roomFor = [&](const std::string& text) -> Room* {
+        auto it = roomsById.find(number(text));
+        return (it != roomsById.end()) ? it->second : nullptr;
+    };
+    auto each = [&store](const char* table, const std::function<void(const WorldStore::Row&)>& add) {
+        store.scan(table, {}, {}, [&add](const WorldStore::Row& row) {
+            add(row);
+            return true;
+        });
+    };
+
+    // Rows come back with every column of their table, in the CSV files' order
+    each("rooms", [&](const WorldStore::Row& row) {
+        auto room = std::make_unique<Room>(number(row[0]), row[1]);
+        roomsById[room->getId()] = room.get();
+        allRooms.push_back(std::move(room));
+    });
+    each("characters", [&](const WorldStore::Row& row) {
+        auto character = std::make_unique<Character>(number(row[0]), row[1], row[2], number(row[3]), row[4]);
+        NpcBehaviour behaviour = NpcBehaviour::Idle;
+        if (!parseNpcBehaviour(row[5], behaviour)) {
+            std::cerr << "Error: Unknown behaviour for character " << row[0] << std::endl;
+        }
+        character->setBehaviour(behaviour);
+        if (Room* room = roomFor(row[3])) {
+            room->addCharacter(character.get());
+        }
+        allCharacters.push_back(std::move(character));
+    });
+    each("players", [&](const WorldStore::Row& row) {
+        allPlayers.push_back(std::make_unique<Player>(number(row[0]), row[1], row[2], roomFor(row[3])));
+    });
+    each("game_sessions", [&](const WorldStore::Row& row) {
+        allGameSessions.push_back(std::make_unique<GameSession>(number(row[0]), row[1], row[2], row[3]));
+    });
+    each("scores", [&](const WorldStore::Row& row) {
+        allScores.push_back(std::make_unique<Score>(number(row[0]), number(row[1]), number(row[2]), number(row[3])));
+    });
+    each("tools", [&](const WorldStore::Row& row) {
+        allTools.push_back(std::make_unique<Tool>(number(row[0]), row[1], row[2], number(row[3])));
+    });
+    each("room_objects", [&](const WorldStore::Row& row) {
+        allRoomObjects.push_back(std::make_unique<RoomObject>(number(row[0]), row[1], row[2], number(row[3])));
+    });
+
+    // As with the CSV files, index the searchable text while the exits are read
+    world_search.start(allRooms, allCharacters, allTools, allRoomObjects);
+    each("exits", [&](const WorldStore::Row& row) {
+        Room* from = roomFor(row[1]);
+        Room* to = roomFor(row[2]);
+        if (from && to) {
+            bool locked = CSVParser::parseBool(row[5]) && !row[6].empty();
+            from->addExit(row[3], to, locked ? std::max(0, number(row[6])) : 0);
+        } else {
+            std::cerr << "Error: Invalid room ID in exit " << row[0] << std::endl;
+        }
+    });
+    each("terrain", [&](const WorldStore::Row& row) {
+        if (row[2].empty() || !terrain.setTile(number(row[0]), number(row[1]), row[2][0])) {
+            std::cerr << "Error: Malformed terrain tile at (" << row[0] << ", " << row[1] << ")" << std::endl;
+        }
+    });
+    Log::info("Loaded store", {{"rooms", allRooms.size()}});
+    return true;
+}
+
+void SharedWorld::loadEmbeddedWorld() {
+    // The tables were resolved to indices by the generator, so this only
+    // wires objects together: no file I/O and no parsing. Descriptions and
+    // dialogue stay in the tables, in the binary's read-only pages, and are
+    // read from there; names and directions are short and copied.
+    allRooms.reserve(EmbeddedWorld::rooms.size());
+    for (const auto& record : EmbeddedWorld::rooms) {
+        auto room = std::make_unique<Room>(record.id, std::string());
+        room->useText(text_store, text_store.addStatic(record.description));
+        allRooms.push_back(std::move(room));
+    }
+    for (const auto& record : EmbeddedWorld::exits) {
+        allRooms[record.from_room]->addExit(std::string(record.direction), allRooms[record.to_room].get(), record.key_tool_id);
+    }
+    for (const auto& record : EmbeddedWorld::characters) {
+        auto character = std::make_unique<Character>(record.id, std::string(record.name), std::string(), record.room_id, std::string());
+        character->useText(text_store, text_store.addStatic(record.description), text_store.addStatic(record.dialogue));
+        character->setBehaviour(record.behaviour);
+        if (record.room >= 0) {
+            allRooms[record.room]->addCharacter(character.get());
+        }
+        allCharacters.push_back(std::move(character));
+    }
+    for (const auto& record : EmbeddedWorld::tools) {
+        auto tool = std::make_unique<Tool>(record.id, std::string(record.name), std::string(), record.initial_room_id);
+        tool->useText(text_store, text_store.addStatic(record.description));
+        allTools.push_back(std::move(tool));
+    }
+    for (const auto& record : EmbeddedWorld::players) {
+        allPlayers.push_back(std::make_unique<Player>(record.id, std::string(record.name), std::string(record.join_date), nullptr));
+    }
+}
+
+const std::string& SharedWorld::getSource() const {
+    return source;
+}
+
+const std::vector<std::unique_ptr<Room>>& SharedWorld::getRooms() const {
+    return allRooms;
+}
+
+const std::vector<std::unique_ptr<Character>>& SharedWorld::getCharacters() const {
+    return allCharacters;
+}
+
+const std::vector<std::unique_ptr<Tool>>& SharedWorld::getTools() const {
+    return allTools;
+}
+
+const std::vector<std::unique_ptr<RoomObject>>& SharedWorld::getRoomObjects() const {
+    return allRoomObjects;
+}
+
+Room* SharedWorld::findRoom(int room_id) const {
+    auto it = rooms_by_id.find(room_id);
+    return it != rooms_by_id.end() ? it->second : nullptr;
+}
+
+const Player& SharedWorld::getPlayer() const {
+    return *allPlayers[0];
+}
+
+const Terrain& SharedWorld::getTerrain() const {
+    return terrain;
+}
+
+const TextStore& SharedWorld::getTextStore() const {
+    return text_store;
+}
+
+const WorldSearch& SharedWorld::getSearch() const {
+    return world_search;
+}
+
+const NpcSystem& SharedWorld::getNpcs() const {
+    return npcs;
+}
+
+WorkStealingScheduler* SharedWorld::getNpcThreads() const {
+    return npc_threads.get();
+}
+
+bool SharedWorld::setExit(int room_id, const std::string& direction, int to_room_id, int key_tool_id) {
+    Room* room = findRoom(room_id);
+    Room* to = findRoom(to_room_id);
+    if (!room || !to) {
+        std::cerr << "Error: Cannot add exit " << direction << " from room " << room_id << " to unknown room" << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(update_mutex);
+    room->addExit(direction, to, key_tool_id);
+    version.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+bool SharedWorld::removeExit(int room_id, const std::string& direction) {
+    Room* room = findRoom(room_id);
+    std::lock_guard<std::mutex> lock(update_mutex); // Writers need no ReadSection to read what only they change
+    if (!room || room->getExit(direction) == nullptr) {
+        return false;
+    }
+    room->removeExit(direction);
+    version.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+std::uint64_t SharedWorld::getVersion() const {
+    return version.load(std::memory_order_acquire);
+}
@@ -0,0 +1,141 @@
+#ifndef SHARED_WORLD_H
+#define SHARED_WORLD_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../World.h"
+#include "../GameSession.h"
+#include "../Score.h"
+#include "../Terrain.h"
+#include "../text/TextStore.h"
+#include "../search/WorldSearch.h"
+#include "../npc/NpcSystem.h"
+
+class WorkStealingScheduler;
+
+/**
+ * @class SharedWorld
+ * @brief A loaded world that any number of games play at once and none changes.
+ *
+ * The rooms, characters, tools, terrain, compressed text and search index
+ * are loaded once and kept here, with every tool in the room it starts in
+ * and every character in the NpcSystem that sessions move them from.
+ * Each Game holds a reference to the world and records what its player
+ * changes in its own WorldOverlay, so an extra session costs memory for what
+ * it changed rather than for a copy of the world. A world loaded from a
+ * source stays cached while any game holds it: a second game opened on the
+ * same files shares the first one's world.
+ *
+ * Once the world is built, only its exits change, through setExit() and
+ * removeExit() while games play it. Any number of threads may read the
+ * world; the exits are published read-copy-update (see Room), so a game
+ * reading them within a ReadSection never waits for a change or sees half
+ * of one. The objects are reached through non-const pointers only because
+ * the game's classes link to each other that way.
+ */
+class SharedWorld {
+public:
+    static constexpr std::size_t NPC_REGION_ROOMS = 4096; // Rooms per region when the world is ticked in parallel
+
+    /**
+     * @brief Loads a world from a SQL dump, CSV directory or world store, or
+     *        from sql/ if the source is empty, unless a game still holds it.
+     */
+    static std::shared_ptr<SharedWorld> load(const std::string& source);
+
+    /**
+     * @brief Gets the world compiled into the binary, building it unless a game still holds it.
+     */
+    static std::shared_ptr<SharedWorld> loadEmbedded();
+
+    /**
+     * @brief Takes over an already built world, such as one from WorldGenerator.
+     */
+    explicit SharedWorld(World world);
+
+    SharedWorld(const SharedWorld&) = delete;
+    SharedWorld& operator=(const SharedWorld&) = delete;
+    ~SharedWorld();
+
+    /**
+     * @brief Gets the SQL dump, CSV directory or store the world was loaded from, or empty for sql/.
+     */
+    const std::string& getSource() const;
+
+    const std::vector<std::unique_ptr<Room>>& getRooms() const;
+    const std::vector<std::unique_ptr<Character>>& getCharacters() const;
+    const std::vector<std::unique_ptr<Tool>>& getTools() const;
+    const std::vector<std::unique_ptr<RoomObject>>& getRoomObjects() const;
+    Room* findRoom(int room_id) const;
+
+    /**
+     * @brief Gets the player every session starts as; there is always one.
+     */
+    const Player& getPlayer() const;
+
+    const Terrain& getTerrain() const;
+    const TextStore& getTextStore() const;
+    const WorldSearch& getSearch() const;
+
+    /**
+     * @brief Gets the characters as the world places them, sorted into the regions they are ticked in.
+     */
+    const NpcSystem& getNpcs() const;
+
+    /**
+     * @brief Gets the threads every session ticks the characters' regions on.
+     * @return nullptr if the world has too few moving characters to be worth them.
+     */
+    WorkStealingScheduler* getNpcThreads() const;
+
+    /**
+     * @brief Adds or replaces an exit while games play the world; each sees it from its next turn.
+     * @return false, changing nothing, if either room does not exist.
+     */
+    bool setExit(int room_id, const std::string& direction, int to_room_id, int key_tool_id = 0);
+
+    /**
+     * @brief Removes an exit while games play the world.
+     * @return false if the room does not exist or has no exit that way.
+     */
+    bool removeExit(int room_id, const std::string& direction);
+
+    /**
+     * @brief Gets the number of changes made to the world since it was built.
+     */
+    std::uint64_t getVersion() const;
+
+private:
+    SharedWorld() = default;
+
+    void finish(); // Adds the defaults and the starting challenge, places the tools and indexes the world
+    void loadDataFromCSV(const std::string& directory = "sql");
+    bool loadDataFromSQL(const std::string& sql_file_path);
+    bool loadDataFromStore(const std::string& directory); // A WorldStore directory
+    void loadEmbeddedWorld();
+
+    std::string source;
+    TextStore text_store; // Declared before the world objects whose text it holds
+    WorldSearch world_search; // Built from copies of the text, on other threads, while the world loads
+    std::vector<std::unique_ptr<Room>> allRooms;
+    std::vector<std::unique_ptr<Player>> allPlayers;
+    std::vector<std::unique_ptr<GameSession>> allGameSessions;
+    std::vector<std::unique_ptr<Score>> allScores;
+    std::vector<std::unique_ptr<Character>> allCharacters;
+    std::vector<std::unique_ptr<Tool>> allTools;
+    std::vector<std::unique_ptr<RoomObject>> allRoomObjects;
+    std::unordered_map<int, Room*> rooms_by_id;
+    NpcSystem npcs; // Never ticked; each session moves the characters in its own NpcSession
+    std::unique_ptr<WorkStealingScheduler> npc_threads; // Shared by the sessions, one batch at a time
+    Terrain terrain; // Tile map loaded from the terrain table, empty if none
+    std::mutex update_mutex; // Serialises setExit() and removeExit()
+    std::atomic<std::uint64_t> version{0};
+};
+
+#endif // SHARED_WORLD_H
@@ -0,0 +1,189 @@
+#include "WorldOverlay.h"
+#include "../Room.h"
+#include "../objects/Character.h"
+#include "../objects/Challenge.h"
+#include <algorithm>
+
+namespace {
+
+// A node of a hash table holds its value and a link to the next node; the
+// buckets are one pointer each.
+template <typename Table>
+std::size_t tableBytes(const Table& table) {
+    return table.bucket_count() * sizeof(void*) + table.size() * (sizeof(typename Table::value_type) + sizeof(void*));
+}
+
+} // namespace
+
+template <typename T>
+std::size_t WorldOverlay::Contents<T>::find(const T* value) const {
+    if (!positions) {
+        std::size_t position = 0;
+        while (position < list.size() && list[position] != value) {
+            ++position;
+        }
+        return position;
+    }
+    auto it = positions->find(value);
+    return it != positions->end() ? it->second : list.size();
+}
+
+template <typename T>
+void WorldOverlay::Contents<T>::push(T* value) {
+    list.push_back(value);
+    if (positions) {
+        positions->emplace(value, static_cast<std::uint32_t>(list.size() - 1));
+    } else if (list.size() > INDEX_FROM) {
+        positions = std::make_unique<std::unordered_map<const T*, std::uint32_t>>();
+        for (std::size_t i = 0; i < list.size(); ++i) {
+            positions->emplace(list[i], static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+template <typename T>
+void WorldOverlay::Contents<T>::erase(std::size_t position) {
+    // The last entry moves into the gap, as a room's own list does
+    if (positions) {
+        positions->erase(list[position]);
+        if (position + 1 < list.size()) {
+            (*positions)[list.back()] = static_cast<std::uint32_t>(position);
+        }
+    }
+    list[position] = list.back();
+    list.pop_back();
+}
+
+template <typename T>
+typename WorldOverlay::ChangedRooms<T>::iterator WorldOverlay::copy(ChangedRooms<T>& changed, const Room& room, const std::vector<T*>& shared) {
+    auto it = changed.try_emplace(&room).first;
+    Contents<T>& contents = it->second;
+    contents.list.reserve(shared.size() + 1);
+    for (T* value : shared) {
+        contents.push(value);
+    }
+    return it;
+}
+
+template <typename T>
+void WorldOverlay::add(ChangedRooms<T>& changed, const Room& room, const std::vector<T*>& shared, T* value, bool in_shared) {
+    auto it = changed.find(&room);
+    if (it == changed.end()) {
+        if (in_shared) {
+            return;
+        }
+        it = copy(changed, room, shared);
+    } else if (it->second.find(value) != it->second.list.size()) {
+        return;
+    }
+    Contents<T>& contents = it->second;
+    contents.push(value);
+    if (in_shared) {
+        --contents.removed;
+    } else {
+        ++contents.added;
+    }
+    // Once the room holds what the shared room does again, it is read from there
+    if (contents.added == 0 && contents.removed == 0) {
+        changed.erase(it);
+    }
+}
+
+template <typename T>
+void WorldOverlay::remove(ChangedRooms<T>& changed, const Room& room, const std::vector<T*>& shared, T* value, bool in_shared) {
+    auto it = changed.find(&room);
+    if (it == changed.end()) {
+        if (!in_shared) {
+            return;
+        }
+        it = copy(changed, room, shared);
+    }
+    Contents<T>& contents = it->second;
+    std::size_t position = contents.find(value);
+    if (position == contents.list.size()) {
+        return;
+    }
+    contents.erase(position);
+    if (in_shared) {
+        ++contents.removed;
+    } else {
+        --contents.added;
+    }
+    if (contents.added == 0 && contents.removed == 0) {
+        changed.erase(it);
+    }
+}
+
+template <typename T>
+std::size_t WorldOverlay::contentsBytes(const ChangedRooms<T>& changed) {
+    std::size_t bytes = tableBytes(changed);
+    for (const auto& [room, contents] : changed) {
+        bytes += contents.list.capacity() * sizeof(T*);
+        if (contents.positions) {
+            bytes += sizeof(*contents.positions) + tableBytes(*contents.positions);
+        }
+    }
+    return bytes;
+}
+
+const std::vector<RoomObject*>& WorldOverlay::getObjects(const Room& room) const {
+    auto it = objects.find(&room);
+    return it != objects.end() ? it->second.list : room.getObjects();
+}
+
+void WorldOverlay::addObject(const Room& room, RoomObject* object) {
+    add(objects, room, room.getObjects(), object, room.hasObject(object));
+}
+
+void WorldOverlay::removeObject(const Room& room, RoomObject* object) {
+    remove(objects, room, room.getObjects(), object, room.hasObject(object));
+}
+
+const std::vector<Character*>& WorldOverlay::getCharacters(const Room& room) const {
+    auto it = characters.find(&room);
+    return it != characters.end() ? it->second.list : room.getCharacters();
+}
+
+void WorldOverlay::moveCharacter(Character* character, const Room& from, const Room& to) {
+    remove(characters, from, from.getCharacters(), character, from.hasCharacter(character));
+    add(characters, to, to.getCharacters(), character, to.hasCharacter(character));
+}
+
+Room* WorldOverlay::getExit(Room& room, const std::string& direction, const DynamicBitset& tool_ids) const {
+    auto it = unlocked.find(&room);
+    if (it != unlocked.end() && std::find(it->second.begin(), it->second.end(), direction) != it->second.end()) {
+        return room.getExit(direction);
+    }
+    return room.getExit(direction, tool_ids);
+}
+
+void WorldOverlay::unlockExit(const Room& room, const std::string& direction) {
+    std::vector<std::string>& directions = unlocked[&room];
+    if (std::find(directions.begin(), directions.end(), direction) == directions.end()) {
+        directions.push_back(direction);
+    }
+}
+
+const Challenge* WorldOverlay::getChallenge(const Room& room) const {
+    return resolved.count(&room) ? nullptr : room.getChallenge();
+}
+
+void WorldOverlay::resolveChallenge(const Room& room) {
+    resolved.insert(&room);
+}
+
+std::size_t WorldOverlay::getChangedRoomCount() const {
+    std::size_t count = objects.size();
+    for (const auto& [room, list] : characters) {
+        count += objects.count(room) == 0;
+    }
+    return count;
+}
+
+std::size_t WorldOverlay::getBytes() const {
+    std::size_t bytes = contentsBytes(objects) + contentsBytes(characters) + tableBytes(unlocked) + tableBytes(resolved);
+    for (const auto& [room, directions] : unlocked) {
+        bytes += directions.capacity() * sizeof(std::string);
+    }
+    return bytes;
+}
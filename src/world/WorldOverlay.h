@@ -0,0 +1,125 @@
+#ifndef WORLD_OVERLAY_H
+#define WORLD_OVERLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "../util/DynamicBitset.h"
+
+class Room;
+class RoomObject;
+class Character;
+class Challenge;
+
+/**
+ * @class WorldOverlay
+ * @brief One session's changes to a SharedWorld, which the session sees through it.
+ *
+ * The shared rooms are never changed. When a session changes what a room
+ * holds, the overlay copies the room's list of objects or characters and
+ * changes the copy, and the session reads that room's contents from the copy
+ * while they differ from the shared room's; every other room is read from
+ * the shared world. Each copy counts the entries it has gained and lost
+ * against the shared room, and is dropped as soon as it has neither, so a
+ * wandering character costs at most the rooms it started in and stands in,
+ * however far it has walked. A copy of more than a few entries also keeps
+ * where each one is, so a change takes constant time once the copy is made.
+ * Exits the player has unlocked and challenges they have resolved are kept
+ * as sets. A new session costs a few empty tables, and an old one memory for
+ * what is different now.
+ *
+ * Lists keep the order the rooms' own lists would: additions go at the end
+ * and a removal moves the last entry into the gap.
+ */
+class WorldOverlay {
+public:
+    /**
+     * @brief Gets the objects in a room as this session sees them.
+     */
+    const std::vector<RoomObject*>& getObjects(const Room& room) const;
+    void addObject(const Room& room, RoomObject* object);
+
+    /**
+     * @brief Removes an object from a room; nothing happens if it is not there.
+     */
+    void removeObject(const Room& room, RoomObject* object);
+
+    /**
+     * @brief Gets the characters in a room as this session sees them.
+     */
+    const std::vector<Character*>& getCharacters(const Room& room) const;
+    void moveCharacter(Character* character, const Room& from, const Room& to);
+
+    /**
+     * @brief Gets the room an exit leads to if it is open to the given tools or
+     *        has been unlocked this session (see Room::getExit()).
+     */
+    Room* getExit(Room& room, const std::string& direction, const DynamicBitset& tool_ids) const;
+
+    /**
+     * @brief Keeps a locked exit open for the rest of the session.
+     */
+    void unlockExit(const Room& room, const std::string& direction);
+
+    /**
+     * @brief Gets the room's challenge, or nullptr if it has none or it has been resolved this session.
+     */
+    const Challenge* getChallenge(const Room& room) const;
+    void resolveChallenge(const Room& room);
+
+    /**
+     * @brief Gets the number of rooms whose objects or characters differ from the shared world's for this session.
+     */
+    std::size_t getChangedRoomCount() const;
+
+    /**
+     * @brief Estimates the heap memory the overlay holds, tables included.
+     */
+    std::size_t getBytes() const;
+
+private:
+    // Lists up to this long are searched rather than indexed, as most rooms' are
+    static constexpr std::size_t INDEX_FROM = 8;
+
+    // A session's copy of a room's objects or characters
+    template <typename T>
+    struct Contents {
+        std::vector<T*> list;
+        std::unique_ptr<std::unordered_map<const T*, std::uint32_t>> positions; // Where each entry is in list, once it outgrows INDEX_FROM
+        std::uint32_t added = 0;   // Entries the shared room does not hold
+        std::uint32_t removed = 0; // Entries of the shared room that are gone
+
+        std::size_t find(const T* value) const; // The entry's position, or list.size() if it is not there
+        void push(T* value);
+        void erase(std::size_t position);
+    };
+
+    template <typename T>
+    using ChangedRooms = std::unordered_map<const Room*, Contents<T>>;
+
+    // Add or remove a value in the session's copy of a room's list, copying it
+    // first if need be. in_shared says whether the shared room holds the value.
+    // Adding a value already there or removing one that is not does nothing.
+    template <typename T>
+    static void add(ChangedRooms<T>& changed, const Room& room, const std::vector<T*>& shared, T* value, bool in_shared);
+    template <typename T>
+    static void remove(ChangedRooms<T>& changed, const Room& room, const std::vector<T*>& shared, T* value, bool in_shared);
+
+    template <typename T>
+    static typename ChangedRooms<T>::iterator copy(ChangedRooms<T>& changed, const Room& room, const std::vector<T*>& shared);
+
+    template <typename T>
+    static std::size_t contentsBytes(const ChangedRooms<T>& changed);
+
+    ChangedRooms<RoomObject> objects;
+    ChangedRooms<Character> characters;
+    std::unordered_map<const Room*, std::vector<std::string>> unlocked; // Directions, per room
+    std::unordered_set<const Room*> resolved;
+};
+
+#endif // WORLD_OVERLAY_H
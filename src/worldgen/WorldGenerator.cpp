@@ -0,0 +1,330 @@
+#include "WorldGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// SplitMix64 finaliser: spreads any 64-bit input over all 64 output bits.
+std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+double toUnit(std::uint64_t bits) {
+    return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+// One random stream per region
+class SplitMix64 {
+public:
+    explicit SplitMix64(std::uint64_t seed) : state(seed) {}
+
+    std::uint64_t next() { return mix(state++); }
+    double uniform() { return toUnit(next()); }
+    std::size_t below(std::size_t bound) { return static_cast<std::size_t>(next() % bound); }
+
+private:
+    std::uint64_t state;
+};
+
+enum Salt : std::uint64_t { TREE = 0, EAST = 1, SOUTH = 2, REGION = 3 };
+
+// Decides the passages between grid cells. Every answer depends only on the
+// seed and the cells involved, so both rooms of a passage agree on it.
+struct Grid {
+    int width;
+    int height;
+    std::uint64_t seed;
+    double extra_exit_chance;
+
+    std::uint64_t hash(int x, int y, Salt salt) const {
+        std::uint64_t cell = static_cast<std::uint64_t>(y) * static_cast<std::uint64_t>(width) + static_cast<std::uint64_t>(x);
+        return mix(seed ^ mix(cell * 4 + salt));
+    }
+
+    // The spanning tree joins each cell to its west neighbour if this is true, else to its north one
+    bool joinsWest(int x, int y) const {
+        if (y == 0 || x == 0) {
+            return x > 0;
+        }
+        return (hash(x, y, TREE) & 1) != 0;
+    }
+
+    bool eastPassage(int x, int y) const {
+        return x + 1 < width && (joinsWest(x + 1, y) || toUnit(hash(x, y, EAST)) < extra_exit_chance);
+    }
+
+    bool southPassage(int x, int y) const {
+        return y + 1 < height && (!joinsWest(x, y + 1) || toUnit(hash(x, y, SOUTH)) < extra_exit_chance);
+    }
+};
+
+const char* const ADJECTIVES[] = {"quiet", "sunlit", "dusty", "humming", "misty", "crooked",
+                                  "vaulted", "narrow", "glowing", "cold", "cluttered", "restless"};
+const char* const PLACES[] = {"hall", "gallery", "archive", "workshop", "garden", "corridor",
+                              "study", "cavern", "atrium", "observatory", "library", "kitchen"};
+const char* const DETAILS[] = {
+    "Shelves of unsorted thoughts line the walls.",
+    "A faint breeze carries half-remembered voices.",
+    "Scrolls of old worries are stacked in the corner.",
+    "The floor is worn smooth by people pacing.",
+    "Soft light pools around a single chair.",
+    "A clock ticks slightly faster than it should.",
+};
+
+struct CharacterKind { const char* name; const char* description; const char* dialogue; NpcBehaviour behaviour; };
+const CharacterKind CHARACTERS[] = {
+    {"The Archivist", "A patient figure sorting papers into careful piles.", "Which of these thoughts is a fact and which is a guess?", NpcBehaviour::Idle},
+    {"The Gardener", "Someone kneeling by a planter and humming to themselves.", "Growth is slow. Did you notice anything new today?", NpcBehaviour::Flee},
+    {"The Cartographer", "A traveller bent over a map that keeps redrawing itself.", "Every path looks shorter once you have walked it.", NpcBehaviour::Wander},
+    {"The Listener", "A still figure who seems to be waiting for you to speak.", "What would you tell a friend who felt this way?", NpcBehaviour::Follow},
+};
+
+struct ItemKind { const char* name; const char* description; };
+const ItemKind TOOLS[] = {
+    {"Compass of Calm", "A compass whose needle settles when you breathe slowly."},
+    {"Lantern of Noticing", "A small lantern that lights up whatever you are avoiding."},
+    {"Notebook of Evidence", "A notebook with two columns: for and against."},
+    {"Anchor Stone", "A smooth, heavy stone that fits in your palm."},
+};
+const ItemKind OBJECTS[] = {
+    {"Dusty Mirror", "A mirror that shows the room a little kinder than it is."},
+    {"Stack of Letters", "Unsent letters tied with string."},
+    {"Old Clock", "A clock stopped at a moment someone wanted to remember."},
+    {"Potted Fern", "A fern that has clearly survived worse."},
+};
+
+template <typename T, std::size_t N>
+constexpr std::size_t count(const T (&)[N]) { return N; }
+
+struct Placement {
+    int room_id;
+    std::size_t kind;
+};
+
+struct RegionContent {
+    std::vector<Placement> characters;
+    std::vector<Placement> tools;
+    std::vector<Placement> objects;
+    std::size_t first_character = 0; // Offsets into the world's lists, filled in between the phases
+    std::size_t first_tool = 0;
+    std::size_t first_object = 0;
+};
+
+// Runs work(region) for every region, spread over the given number of threads.
+template <typename Work>
+void forEachRegion(std::size_t regions, unsigned threads, const Work& work) {
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+        for (std::size_t region = next++; region < regions; region = next++) {
+            work(region);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+std::string quoted(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        out += c;
+        if (c == '"') {
+            out += '"';
+        }
+    }
+    out += '"';
+    return out;
+}
+
+} // namespace
+
+namespace WorldGenerator {
+
+World generate(const WorldGenOptions& options) {
+    World world;
+    if (options.width <= 0 || options.height <= 0) {
+        return world;
+    }
+    const Grid grid{options.width, options.height, options.seed, options.extra_exit_chance};
+    const int region_size = std::max(1, options.region_size);
+    const int regions_across = (options.width + region_size - 1) / region_size;
+    const int regions_down = (options.height + region_size - 1) / region_size;
+    const std::size_t region_count = static_cast<std::size_t>(regions_across) * static_cast<std::size_t>(regions_down);
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, region_count));
+
+    auto regionBounds = [&](std::size_t region, int& x0, int& y0, int& x1, int& y1) {
+        x0 = static_cast<int>(region % regions_across) * region_size;
+        y0 = static_cast<int>(region / regions_across) * region_size;
+        x1 = std::min(x0 + region_size, options.width);
+        y1 = std::min(y0 + region_size, options.height);
+    };
+
+    world.rooms.resize(static_cast<std::size_t>(options.width) * static_cast<std::size_t>(options.height));
+    std::vector<RegionContent> contents(region_count);
+
+    // Phase 1: rooms and what goes in them. Each region writes only its own rooms.
+    forEachRegion(region_count, threads, [&](std::size_t region) {
+        SplitMix64 rng(mix(options.seed ^ mix(region * 4 + REGION)));
+        RegionContent& content = contents[region];
+        int x0, y0, x1, y1;
+        regionBounds(region, x0, y0, x1, y1);
+        std::string region_name = std::to_string(x0 / region_size) + "-" + std::to_string(y0 / region_size);
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                std::size_t index = static_cast<std::size_t>(y) * options.width + x;
+                int room_id = static_cast<int>(index) + 1;
+                std::string description = std::string("You are in a ") + ADJECTIVES[rng.below(count(ADJECTIVES))] + " " +
+                                          PLACES[rng.below(count(PLACES))] + " in sector " + region_name + ". " +
+                                          DETAILS[rng.below(count(DETAILS))];
+                world.rooms[index] = std::make_unique<Room>(room_id, description);
+
+                if (rng.uniform() < options.character_chance) {
+                    content.characters.push_back({room_id, rng.below(count(CHARACTERS))});
+                }
+                if (rng.uniform() < options.tool_chance) {
+                    content.tools.push_back({room_id, rng.below(count(TOOLS))});
+                }
+                if (rng.uniform() < options.object_chance) {
+                    content.objects.push_back({room_id, rng.below(count(OBJECTS))});
+                }
+            }
+        }
+    });
+
+    // IDs are handed out in region order so they do not depend on thread timing
+    std::size_t characters = 0, tools = 0, objects = 0;
+    for (RegionContent& content : contents) {
+        content.first_character = characters;
+        content.first_tool = tools;
+        content.first_object = objects;
+        characters += content.characters.size();
+        tools += content.tools.size();
+        objects += content.objects.size();
+    }
+    world.characters.resize(characters);
+    world.tools.resize(tools);
+    world.room_objects.resize(objects);
+
+    // Phase 2: exits and contents. Every room now exists, so exits can point
+    // anywhere, but each region still modifies only its own rooms.
+    forEachRegion(region_count, threads, [&](std::size_t region) {
+        int x0, y0, x1, y1;
+        regionBounds(region, x0, y0, x1, y1);
+        for (int y = y0; y < y1; ++y) {
+            for (int x = x0; x < x1; ++x) {
+                std::size_t index = static_cast<std::size_t>(y) * options.width + x;
+                Room* room = world.rooms[index].get();
+                if (y > 0 && grid.southPassage(x, y - 1)) {
+                    room->addExit("north", world.rooms[index - options.width].get());
+                }
+                if (grid.southPassage(x, y)) {
+                    room->addExit("south", world.rooms[index + options.width].get());
+                }
+                if (grid.eastPassage(x, y)) {
+                    room->addExit("east", world.rooms[index + 1].get());
+                }
+                if (x > 0 && grid.eastPassage(x - 1, y)) {
+                    room->addExit("west", world.rooms[index - 1].get());
+                }
+            }
+        }
+
+        const RegionContent& content = contents[region];
+        for (std::size_t i = 0; i < content.characters.size(); ++i) {
+            const Placement& placement = content.characters[i];
+            const CharacterKind& kind = CHARACTERS[placement.kind];
+            std::size_t slot = content.first_character + i;
+            world.characters[slot] = std::make_unique<Character>(static_cast<int>(slot) + 1, kind.name, kind.description, placement.room_id, kind.dialogue);
+            world.characters[slot]->setBehaviour(kind.behaviour);
+            world.rooms[placement.room_id - 1]->addCharacter(world.characters[slot].get());
+        }
+        for (std::size_t i = 0; i < content.tools.size(); ++i) {
+            const Placement& placement = content.tools[i];
+            std::size_t slot = content.first_tool + i;
+            world.tools[slot] = std::make_unique<Tool>(static_cast<int>(slot) + 1, TOOLS[placement.kind].name, TOOLS[placement.kind].description, placement.room_id);
+        }
+        for (std::size_t i = 0; i < content.objects.size(); ++i) {
+            const Placement& placement = content.objects[i];
+            std::size_t slot = content.first_object + i;
+            world.room_objects[slot] = std::make_unique<RoomObject>(static_cast<int>(slot) + 1, OBJECTS[placement.kind].name, OBJECTS[placement.kind].description, placement.room_id);
+        }
+    });
+
+    world.players.push_back(std::make_unique<Player>(1, "Explorer", "2065-01-01 00:00:00", nullptr));
+    return world;
+}
+
+bool writeCSV(const World& world, const std::string& directory) {
+    auto open = [&directory](const std::string& name, const char* header, std::ofstream& file) {
+        file.open(directory + "/" + name);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not write " << directory << "/" << name << std::endl;
+            return false;
+        }
+        file << header << '\n';
+        return true;
+    };
+
+    std::ofstream rooms, exits, characters, tools, objects, players, sessions, scores;
+    if (!open("rooms.csv", "room_id,description,ascii_art", rooms) ||
+        !open("exits.csv", "exit_id,from_room_id,to_room_id,direction,description,is_locked,key_tool_id", exits) ||
+        !open("characters.csv", "character_id,name,description,initial_room_id,dialogue,behaviour", characters) ||
+        !open("tools.csv", "tool_id,name,description,initial_room_id", tools) ||
+        !open("room_objects.csv", "object_id,name,description,room_id", objects) ||
+        !open("players.csv", "player_id,name,join_date", players) ||
+        !open("game_sessions.csv", "session_id,game_type,start_time,end_time", sessions) ||
+        !open("scores.csv", "score_id,player_id,session_id,score", scores)) {
+        return false;
+    }
+
+    std::size_t exit_id = 0;
+    for (const auto& room : world.rooms) {
+        rooms << room->getId() << ',' << quoted(room->getDescription()) << ",\"\"\n";
+        for (const auto& [direction, target] : room->getAllExits()) {
+            int key_tool_id = room->getExitKey(direction);
+            exits << ++exit_id << ',' << room->getId() << ',' << target->getId() << ',' << direction
+                  << ",\"A passage leads " << direction << ".\"," << (key_tool_id ? "TRUE," + std::to_string(key_tool_id) : "FALSE,")
+                  << '\n';
+        }
+    }
+    for (const auto& character : world.characters) {
+        characters << character->getId() << ',' << quoted(character->getName()) << ',' << quoted(character->getDescription())
+                   << ',' << character->getRoomId() << ',' << quoted(character->getDialogue())
+                   << ',' << npcBehaviourName(character->getBehaviour()) << '\n';
+    }
+    for (const auto& tool : world.tools) {
+        tools << tool->getId() << ',' << quoted(tool->getName()) << ',' << quoted(tool->getDescription())
+              << ',' << tool->getInitialRoomId() << '\n';
+    }
+    for (const auto& object : world.room_objects) {
+        objects << object->getId() << ',' << quoted(object->getName()) << ',' << quoted(object->getDescription())
+                << ',' << object->getRoomId() << '\n';
+    }
+    for (const auto& player : world.players) {
+        players << player->getID() << ',' << player->getName() << ',' << player->getJoinDate() << '\n';
+    }
+
+    for (std::ofstream* file : {&rooms, &exits, &characters, &tools, &objects, &players, &sessions, &scores}) {
+        file->flush();
+        if (!*file) {
+            std::cerr << "Error: Could not write the world to " << directory << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace WorldGenerator
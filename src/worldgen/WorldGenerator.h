@@ -0,0 +1,55 @@
+#ifndef WORLD_GENERATOR_H
+#define WORLD_GENERATOR_H
+
+#include <cstdint>
+#include <string>
+#include "../World.h"
+
+/**
+ * @brief Settings for WorldGenerator::generate().
+ */
+struct WorldGenOptions {
+    std::uint64_t seed = 1;
+    int width = 100;                 // Rooms per row of the grid
+    int height = 100;                // Rows of the grid
+    int region_size = 64;            // Regions of region_size x region_size rooms are the unit of work
+    unsigned threads = 0;            // 0 uses every hardware thread
+    double extra_exit_chance = 0.3;  // Chance of a passage beyond the ones that keep the world connected
+    double character_chance = 0.02; // Per room
+    double tool_chance = 0.01;       // Per room
+    double object_chance = 0.05;     // Per room
+};
+
+/**
+ * @namespace WorldGenerator
+ * @brief Seeded procedural worlds for testing the game at production scale.
+ *
+ * Rooms lie on a width x height grid and get IDs 1..width*height in row
+ * order. Every room is reachable: each one is joined to its west or north
+ * neighbour, chosen by a hash of the seed and its position, which forms a
+ * spanning tree, and further passages are added at random. Passages are
+ * always two-way, because both rooms derive them from the same hash.
+ *
+ * The grid is cut into square regions that are generated in parallel. Each
+ * region draws from its own random stream seeded from the world seed and the
+ * region's index, so the world depends only on the options, never on the
+ * number of threads or the order in which they finish.
+ */
+namespace WorldGenerator {
+
+    /**
+     * @brief Generates a world in memory, ready to hand to Game(World).
+     */
+    World generate(const WorldGenOptions& options);
+
+    /**
+     * @brief Writes a world as the CSV files Game loads from a directory.
+     * @param world The world to write.
+     * @param directory An existing directory; its CSV files are overwritten.
+     * @return false if a file could not be written.
+     */
+    bool writeCSV(const World& world, const std::string& directory);
+
+} // namespace WorldGenerator
+
+#endif // WORLD_GENERATOR_H
@@ -0,0 +1,59 @@
+// Generates a procedural world and writes it as CSV files that the game can
+// load with `quanta_pie <directory>` or `Game(directory)`:
+//
+//   g++ src/worldgen/*.cpp src/Room.cpp src/text/*.cpp src/concurrency/Epoch.cpp src/objects/*.cpp src/players/*.cpp src/world/WorldOverlay.cpp -o quanta_worldgen -Isrc -std=c++20 -O2 -pthread
+//   ./quanta_worldgen --width 1000 --height 1000 --seed 7 --out big_world
+
+#include "WorldGenerator.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    WorldGenOptions options;
+    std::string out_dir = "generated_world";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Error: " << arg << " needs a value" << std::endl;
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "--width") {
+            options.width = std::atoi(value);
+        } else if (arg == "--height") {
+            options.height = std::atoi(value);
+        } else if (arg == "--seed") {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--threads") {
+            options.threads = static_cast<unsigned>(std::atoi(value));
+        } else if (arg == "--region") {
+            options.region_size = std::atoi(value);
+        } else if (arg == "--out") {
+            out_dir = value;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--width N] [--height N] [--seed N] [--threads N] [--region N] [--out DIR]" << std::endl;
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    World world = WorldGenerator::generate(options);
+    auto generated = std::chrono::steady_clock::now();
+
+    std::error_code error;
+    std::filesystem::create_directories(out_dir, error);
+    if (error || !WorldGenerator::writeCSV(world, out_dir)) {
+        std::cerr << "Error: Could not write the world to " << out_dir << std::endl;
+        return 1;
+    }
+    auto written = std::chrono::steady_clock::now();
+
+    std::cout << "Generated " << world.rooms.size() << " rooms, " << world.characters.size() << " characters, "
+              << world.tools.size() << " tools and " << world.room_objects.size() << " objects in "
+              << std::chrono::duration<double>(generated - start).count() << " s; wrote " << out_dir << "/ in "
+              << std::chrono::duration<double>(written - generated).count() << " s" << std::endl;
+    return 0;
+}
@@ -6,8 +6,55 @@
 #include "../src/objects/RoomObject.h"
 #include "../src/players/Player.h"
 #include "../src/Score.h"
+#include "../src/SQLParser.h"
+#include "../src/Terrain.h"
+#include "../src/input/LineEditor.h"
+#include "../src/platform/Console.h"
+#include "../src/dialogue/DialogueExecutor.h"
+#include "../src/dialogue/FramePool.h"
+#include "../src/replay/InputRecording.h"
+#include "../src/save/SaveGame.h"
+#include "../src/worldgen/WorldGenerator.h"
+#include "../src/memory/MemoryStats.h"
+#include "../src/ui/TextLayout.h"
+#include "../src/ui/SidePanel.h"
+#include "../src/text/TextStore.h"
+#include "../src/embedded/WorldTables.h"
+#include "../src/util/LruCache.h"
+#include "../src/search/SearchIndex.h"
+#include "../src/containers/SlotMap.h"
+#include "../src/npc/NpcSystem.h"
+#include "../src/concurrency/WorkStealingScheduler.h"
+#include "../src/concurrency/Epoch.h"
+#include "../src/realtime/TripleBuffer.h"
+#include "../src/realtime/SpscQueue.h"
+#include "../src/realtime/FixedStepClock.h"
+#include "../src/analytics/AnalyticsStore.h"
+#include "../src/analytics/Kernels.h"
+#include "../src/storage/StorageEngine.h"
+#include "../src/storage/WorldStore.h"
+#include "../src/ui/TileMapView.h"
+#include "../src/vision/FieldOfView.h"
+#include "../src/world/SharedWorld.h"
+#include "../src/world/WorldOverlay.h"
+#include "../src/log/Log.h"
+#include "../src/metrics/Metrics.h"
+#include "../src/metrics/MetricsServer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <thread>
 #include <vector>
 #include <string>
+#include <sstream>
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
 
 // Test case for Room class
 bool testRoom_AddAndGetExit() {
@@ -168,6 +215,1263 @@ bool testRoom_GetAllExits() {
     return true;
 }
 
+// Test case for streaming multi-row INSERT statements
+bool testSQLParser_MultiRowInsert() {
+    std::istringstream sql(
+        "-- Terrain dump\n"
+        "CREATE TABLE terrain (x_coord INT, y_coord INT, tile_type CHAR(1), PRIMARY KEY (x_coord, y_coord));\n"
+        "INSERT INTO terrain (x_coord, y_coord, tile_type) VALUES\n"
+        "-- Walls\n"
+        "(0, 0, '#'), (1, 0, '#'),\n"
+        "/* Floor */ (-1, 1, '.');\n");
+    SQLParser parser(sql);
+    std::string table;
+    std::vector<std::string> tiles;
+    int x_sum = 0;
+
+    bool ok = parser.parse(
+        [&](const SQLInsert& insert) { table = insert.table; },
+        [&](const std::vector<SQLValue>& values) {
+            x_sum += values[0].toInt();
+            tiles.push_back(values[2].text);
+        });
+
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(table, "terrain");
+    ASSERT_EQ(parser.getRowCount(), 3);
+    ASSERT_EQ(tiles.size(), 3);
+    ASSERT_EQ(tiles[2], ".");
+    ASSERT_EQ(x_sum, 0);
+    return true;
+}
+
+// Test case for quoting, NULL and booleans in INSERT values
+bool testSQLParser_ValuesAndErrors() {
+    std::istringstream sql(
+        "INSERT INTO `exits` (from_room_id, description, is_locked, key_tool_id) "
+        "VALUES (1, 'It''s; locked', TRUE, NULL);");
+    SQLParser parser(sql);
+    std::vector<SQLValue> row;
+    ASSERT_TRUE(parser.parse(nullptr, [&](const std::vector<SQLValue>& values) { row = values; }));
+    ASSERT_EQ(row.size(), 4);
+    ASSERT_EQ(row[1].text, "It's; locked");
+    ASSERT_TRUE(row[2].toBool());
+    ASSERT_TRUE(row[3].isNull());
+
+    std::istringstream broken("INSERT INTO rooms VALUES (1, 'unterminated);");
+    SQLParser failing(broken);
+    ASSERT_TRUE(!failing.parse(nullptr, nullptr));
+    ASSERT_TRUE(!failing.getError().empty());
+    return true;
+}
+
+// Test case for the Terrain grid growing as tiles arrive
+bool testTerrain_SetAndGetTile() {
+    Terrain terrain;
+    ASSERT_TRUE(terrain.empty());
+    ASSERT_TRUE(terrain.setTile(6, 4, '#'));
+    ASSERT_TRUE(terrain.setTile(1, 1, '.'));
+    ASSERT_TRUE(!terrain.setTile(-1, 0, '#'));
+    ASSERT_EQ(terrain.getWidth(), 7);
+    ASSERT_EQ(terrain.getHeight(), 5);
+    ASSERT_EQ(terrain.getTile(6, 4), '#');
+    ASSERT_EQ(terrain.getTile(1, 1), '.');
+    ASSERT_EQ(terrain.getTile(0, 0), Terrain::EMPTY_TILE);
+    ASSERT_EQ(terrain.getTile(7, 0), Terrain::EMPTY_TILE);
+    return true;
+}
+
+// Test case for line editing and history recall
+bool testLineEditor_EditAndHistory() {
+    LineEditor editor(2);
+    for (char c : std::string("nrth")) {
+        editor.handleKey(c);
+    }
+    editor.handleKey(Console::KEY_LEFT);
+    editor.handleKey(Console::KEY_LEFT);
+    editor.handleKey(Console::KEY_LEFT);
+    ASSERT_TRUE(editor.handleKey('o') == LineEditor::Result::Edited);
+    ASSERT_EQ(editor.getBuffer(), "north");
+    ASSERT_TRUE(editor.handleKey('\r') == LineEditor::Result::Submitted);
+    ASSERT_EQ(editor.takeLine(), "north");
+    ASSERT_EQ(editor.getBuffer(), "");
+
+    editor.handleKey('x');
+    editor.handleKey(127); // Backspace
+    for (char c : std::string("look")) {
+        editor.handleKey(c);
+    }
+    editor.takeLine();
+    editor.handleKey('d');
+    editor.handleKey(Console::KEY_UP);
+    ASSERT_EQ(editor.getBuffer(), "look");
+    editor.handleKey(Console::KEY_UP);
+    ASSERT_EQ(editor.getBuffer(), "north");
+    ASSERT_TRUE(editor.handleKey(Console::KEY_UP) == LineEditor::Result::Unchanged);
+    editor.handleKey(Console::KEY_DOWN);
+    editor.handleKey(Console::KEY_DOWN);
+    ASSERT_EQ(editor.getBuffer(), "d"); // The unfinished line comes back
+    ASSERT_TRUE(editor.handleKey(4) == LineEditor::Result::Unchanged);
+    return true;
+}
+
+// Scripts used by the dialogue executor tests
+Dialogue testFarewell(int& score) {
+    co_await say("Goodbye.");
+    score += 1;
+}
+
+Dialogue testConversation(int& score) {
+    co_await say("Hello.");
+    int choice = co_await player_choice("Wave", "Walk away");
+    score += (choice == 0) ? 10 : -10;
+    co_await turns(2);
+    co_await testFarewell(score);
+}
+
+// Test case for running a coroutine conversation through choices and turns
+bool testDialogueExecutor_ChoiceAndTurns() {
+    long frames_before = FramePool::getLiveFrames();
+    int score = 0;
+    {
+        DialogueExecutor executor;
+        executor.start(testConversation(score));
+        ASSERT_EQ(executor.getActiveCount(), 1);
+        ASSERT_TRUE(executor.isAwaitingChoice());
+        ASSERT_EQ(executor.getChoices().size(), 2);
+        ASSERT_EQ(executor.takeOutput().size(), 1);
+
+        ASSERT_TRUE(!executor.choose(5));
+        ASSERT_TRUE(executor.choose(0));
+        ASSERT_EQ(score, 10);
+        ASSERT_TRUE(!executor.isAwaitingChoice());
+
+        executor.advanceTurn();
+        ASSERT_TRUE(executor.takeOutput().empty());
+        executor.advanceTurn();
+        std::vector<std::string> output = executor.takeOutput();
+        ASSERT_EQ(output.size(), 1);
+        ASSERT_EQ(output[0], "Goodbye.");
+        ASSERT_EQ(score, 11);
+        ASSERT_EQ(executor.getActiveCount(), 0);
+    }
+    ASSERT_EQ(FramePool::getLiveFrames(), frames_before);
+    return true;
+}
+
+// Test case for many suspended conversations and their cleanup
+bool testDialogueExecutor_ManySuspended() {
+    long frames_before = FramePool::getLiveFrames();
+    int score = 0;
+    {
+        DialogueExecutor executor;
+        for (int i = 0; i < 5000; ++i) {
+            executor.start(testConversation(score));
+        }
+        ASSERT_EQ(executor.getActiveCount(), 5000);
+        ASSERT_TRUE(executor.choose(1)); // Answers the most recent conversation
+        ASSERT_EQ(score, -10);
+        ASSERT_EQ(executor.getActiveCount(), 5000);
+    } // Destroys the suspended frames
+    ASSERT_EQ(FramePool::getLiveFrames(), frames_before);
+    return true;
+}
+
+// Test case for writing an input recording and reading it back
+bool testInputRecording_RoundTrip() {
+    std::stringstream stream;
+    InputRecorder recorder(stream, 0x0123456789abcdefull, "world.sql");
+    recorder.recordLine("look");
+    recorder.recordLine(std::string(300, 'x')); // Length needs a two-byte varint
+    recorder.finish(42);
+    recorder.recordLine("ignored after finish");
+
+    InputRecordingReader reader(stream);
+    ASSERT_TRUE(reader.readHeader());
+    ASSERT_EQ(reader.getSeed(), 0x0123456789abcdefull);
+    ASSERT_EQ(reader.getWorldSource(), "world.sql");
+
+    std::string line;
+    std::uint64_t delay_us = 0;
+    ASSERT_TRUE(reader.nextLine(line, delay_us));
+    ASSERT_EQ(line, "look");
+    ASSERT_TRUE(reader.nextLine(line, delay_us));
+    ASSERT_EQ(line.size(), 300);
+    ASSERT_TRUE(!reader.nextLine(line, delay_us));
+    ASSERT_TRUE(reader.hasEnd());
+    ASSERT_EQ(reader.getStateHash(), 42);
+
+    std::istringstream not_a_recording("QPRX");
+    InputRecordingReader bad_reader(not_a_recording);
+    ASSERT_TRUE(!bad_reader.readHeader());
+    return true;
+}
+
+// Test case for saving a full snapshot, appending deltas and loading them back
+bool testSaveFile_SnapshotAndDeltas() {
+    std::string path = (std::filesystem::temp_directory_path() / "quanta_pie_test.qpsv").string();
+    std::remove(path.c_str());
+
+    SaveState state;
+    state.room_id = 1;
+    state.tool_locations = {{1, 3}, {2, 6}, {3, 7}};
+    {
+        SaveFile save(path);
+        ASSERT_TRUE(save.save(state));
+        std::uint64_t snapshot_size = save.getFileSize();
+
+        ASSERT_TRUE(save.save(state)); // Unchanged, so nothing is written
+        ASSERT_EQ(save.getFileSize(), snapshot_size);
+
+        state.room_id = 3;
+        state.score = -4;
+        state.tool_locations[1] = SaveState::CARRIED;
+        ASSERT_TRUE(save.save(state));
+        ASSERT_EQ(save.getDeltaCount(), 1);
+        ASSERT_TRUE(save.getFileSize() - snapshot_size < snapshot_size);
+    }
+
+    {
+        SaveState loaded;
+        SaveFile save(path);
+        ASSERT_TRUE(save.load(loaded));
+        ASSERT_TRUE(loaded == state);
+        ASSERT_EQ(save.getDeltaCount(), 1);
+
+        state.tool_locations[1] = 8;
+        ASSERT_TRUE(save.save(state));
+    }
+
+    // A record torn off mid-write is ignored
+    {
+        std::ofstream append(path, std::ios::binary | std::ios::app);
+        append.put(0x02);
+        append.put(0x05);
+        append.put(0x01);
+    }
+    SaveState loaded;
+    SaveFile save(path);
+    ASSERT_TRUE(save.load(loaded));
+    ASSERT_TRUE(loaded == state);
+    ASSERT_EQ(save.getDeltaCount(), 2);
+
+    std::remove(path.c_str());
+    return true;
+}
+
+// Test case for generating the same connected world regardless of thread count
+bool testWorldGenerator_DeterministicAndConnected() {
+    WorldGenOptions options;
+    options.seed = 42;
+    options.width = 37;
+    options.height = 23;
+    options.region_size = 8;
+    options.threads = 1;
+    World single = WorldGenerator::generate(options);
+    options.threads = 4;
+    World parallel = WorldGenerator::generate(options);
+
+    ASSERT_EQ(single.rooms.size(), 37 * 23);
+    ASSERT_EQ(parallel.rooms.size(), single.rooms.size());
+    ASSERT_EQ(parallel.characters.size(), single.characters.size());
+    ASSERT_EQ(parallel.tools.size(), single.tools.size());
+
+    const std::map<std::string, std::string> opposite = {
+        {"north", "south"}, {"south", "north"}, {"east", "west"}, {"west", "east"}};
+    for (size_t i = 0; i < single.rooms.size(); ++i) {
+        ASSERT_EQ(single.rooms[i]->getId(), static_cast<int>(i) + 1);
+        ASSERT_EQ(single.rooms[i]->getDescription(), parallel.rooms[i]->getDescription());
+        ASSERT_EQ(single.rooms[i]->getAllExits().size(), parallel.rooms[i]->getAllExits().size());
+        for (const auto& [direction, target] : single.rooms[i]->getAllExits()) {
+            ASSERT_EQ(target->getExit(opposite.at(direction)), single.rooms[i].get());
+        }
+    }
+
+    // Every room can be reached from the first
+    std::vector<Room*> frontier = {single.rooms[0].get()};
+    std::set<Room*> reached(frontier.begin(), frontier.end());
+    while (!frontier.empty()) {
+        Room* room = frontier.back();
+        frontier.pop_back();
+        for (const auto& [direction, target] : room->getAllExits()) {
+            if (reached.insert(target).second) {
+                frontier.push_back(target);
+            }
+        }
+    }
+    ASSERT_EQ(reached.size(), single.rooms.size());
+    return true;
+}
+
+// Test case for charging allocations to the innermost memory scope
+bool testMemoryStats_ScopesChargeTheirSubsystem() {
+    MemoryStats::TagStats before = MemoryStats::get(MemTag::Challenge);
+    std::uint64_t total_before = MemoryStats::getTotalAllocations();
+    {
+        MemoryScope scope(MemTag::Challenge);
+        std::unique_ptr<char[]> block(new char[1000]);
+        void* volatile escape = block.get(); // Stops the compiler eliding the allocation
+        (void)escape;
+        MemoryStats::TagStats during = MemoryStats::get(MemTag::Challenge);
+        ASSERT_EQ(during.allocations, before.allocations + 1);
+        ASSERT_EQ(during.live_bytes, before.live_bytes + 1000);
+        ASSERT_TRUE(during.peak_bytes >= during.live_bytes);
+        {
+            MemoryScope inner(MemTag::Rendering);
+            std::unique_ptr<int> value(new int(7));
+            escape = value.get();
+        }
+        ASSERT_EQ(MemoryStats::get(MemTag::Challenge).allocations, before.allocations + 1);
+    }
+    MemoryStats::TagStats after = MemoryStats::get(MemTag::Challenge);
+    ASSERT_EQ(after.live_bytes, before.live_bytes);
+    ASSERT_EQ(after.frees, before.frees + 1);
+    ASSERT_EQ(MemoryStats::getTotalAllocations(), total_before + 2);
+    return true;
+}
+
+// Test case for wrapping UTF-8 text to a column width and caching the result
+bool testTextLayout_WrapAndCache() {
+    ASSERT_EQ(TextLayout::displayWidth("caf\u00e9"), 4);
+    ASSERT_EQ(TextLayout::displayWidth("\u65e5\u672c"), 4); // Two wide characters
+
+    std::vector<std::string> lines = TextLayout::wrap("The quick brown fox jumps over the lazy dog", 10);
+    ASSERT_EQ(lines.size(), 5);
+    ASSERT_EQ(lines[0], "The quick");
+    ASSERT_EQ(lines[4], "dog");
+    for (const std::string& line : lines) {
+        ASSERT_TRUE(TextLayout::displayWidth(line) <= 10);
+    }
+
+    lines = TextLayout::wrap("  \u00e9t\u00e9 supercalifragilistic", 8);
+    ASSERT_EQ(lines[0], "  \u00e9t\u00e9");
+    ASSERT_EQ(lines[1], "  superc");
+    ASSERT_EQ(lines.back(), "  ic");
+    ASSERT_EQ(TextLayout::wrap("", 10).size(), 1);
+    ASSERT_EQ(TextLayout::wrap("one\ntwo", 10).size(), 2);
+
+    TextLayoutCache cache;
+    const std::vector<std::string>& narrow = cache.wrap(1, "a b c d", 3);
+    ASSERT_EQ(narrow.size(), 2);
+    ASSERT_EQ(&cache.wrap(1, "a b c d", 3), &narrow); // Not wrapped again
+    ASSERT_EQ(cache.wrap(1, "a b c d", 80).size(), 1);
+    ASSERT_EQ(cache.size(), 2);
+    ASSERT_EQ(&cache.wrap(1, "a b c d", 3), &narrow); // Other widths are kept
+    return true;
+}
+
+// Test case for compressing narrative text and decoding it by ID
+bool testTextStore_CompressAndDecode() {
+    TextStore store;
+    std::vector<std::string> texts;
+    for (int i = 0; i < 200; ++i) {
+        texts.push_back("A damp stone corridor stretches into the dark. Water drips from the ceiling of room " +
+                        std::to_string(i) + ".");
+    }
+    texts.push_back("");
+    texts.push_back("  caf\u00e9   spacing\tkept ");
+    for (const std::string& text : texts) {
+        store.add(text);
+    }
+    store.build();
+    for (TextId id = 0; id < texts.size(); ++id) {
+        ASSERT_EQ(store.get(id), texts[id]);
+    }
+    ASSERT_EQ(store.getOriginalBytes() > 3 * store.getStoredBytes(), true); // Prose this repetitive compresses well
+
+    // The prose of the shipped world is too little to learn as much from; see TextStore
+    TextStore world_text;
+    for (const auto& room : EmbeddedWorld::rooms) {
+        world_text.add(std::string(room.description));
+    }
+    for (const auto& character : EmbeddedWorld::characters) {
+        world_text.add(std::string(character.description));
+        world_text.add(std::string(character.dialogue));
+    }
+    for (const auto& tool : EmbeddedWorld::tools) {
+        world_text.add(std::string(tool.description));
+    }
+    world_text.build();
+    ASSERT_EQ(world_text.get(0), std::string(EmbeddedWorld::rooms[0].description));
+    ASSERT_EQ(2 * world_text.getOriginalBytes() > 3 * world_text.getStoredBytes(), true); // Over 1.5x
+
+    // A world compiled into the binary reads its prose in place from the tables
+    TextId in_place = world_text.addStatic(EmbeddedWorld::rooms[1].description);
+    ASSERT_EQ(world_text.get(in_place), std::string(EmbeddedWorld::rooms[1].description));
+    std::shared_ptr<SharedWorld> embedded = SharedWorld::loadEmbedded();
+    ASSERT_EQ(embedded->getRooms()[0]->getDescription(), std::string(EmbeddedWorld::rooms[0].description));
+    ASSERT_EQ(embedded->getTextStore().getOriginalBytes(), 0); // Nothing was copied to be compressed
+
+    TextId late = store.add("A damp corridor never seen before");
+    ASSERT_EQ(store.get(late), "A damp corridor never seen before"); // Readable before the next build
+    store.build();
+    ASSERT_EQ(store.get(late), "A damp corridor never seen before");
+    ASSERT_EQ(store.get(late + 1), "");
+
+    LruCache<int, std::string> recent(2);
+    recent.insert(1, "one");
+    recent.insert(2, "two");
+    ASSERT_TRUE(recent.find(1) != nullptr); // 2 is now the least recently used
+    recent.insert(3, "three");
+    ASSERT_TRUE(recent.find(2) == nullptr);
+    ASSERT_EQ(*recent.find(1), "one");
+    ASSERT_EQ(recent.size(), 2);
+    return true;
+}
+
+// Test case for building the search index on several threads and ranking matches
+bool testSearchIndex_BuildAndRank() {
+    std::vector<std::string> documents;
+    for (int i = 0; i < 5000; ++i) {
+        documents.push_back("A quiet room numbered " + std::to_string(i) + " with bare walls.");
+    }
+    documents[10] = "A library of glowing books, books everywhere.";
+    documents[4321] = "A dusty library.";
+    documents[4999] = "Caf\u00e9 LIBRARY";
+
+    SearchIndex index = SearchIndex::build(documents, 3);
+    ASSERT_EQ(index.getDocumentCount(), 5000);
+    ASSERT_TRUE(index.getPostingBytes() < 5000 * 8 * 3); // 8 terms a document, under 3 of the 8 bytes a plain pair takes
+
+    std::vector<std::string> tokens = SearchIndex::tokenize("Caf\u00e9, LIBRARY!");
+    ASSERT_EQ(tokens.size(), 2);
+    ASSERT_EQ(tokens[0], "caf\u00e9");
+    ASSERT_EQ(tokens[1], "library");
+
+    std::vector<SearchHit> hits = index.search("library", 10);
+    ASSERT_EQ(hits.size(), 3);
+    ASSERT_EQ(hits[0].document, 4999); // The shortest of the documents
+    ASSERT_TRUE(hits[0].score >= hits[1].score && hits[1].score >= hits[2].score);
+
+    hits = index.search("glowing library", 10);
+    ASSERT_EQ(hits[0].document, 10); // Matches both terms
+
+    hits = index.search("room", 4);
+    ASSERT_EQ(hits.size(), 4); // Only the best are returned
+    ASSERT_EQ(index.search("3000", 10).size(), 1);
+    ASSERT_EQ(index.search("3000", 10)[0].document, 3000);
+    ASSERT_TRUE(index.search("dragon", 10).empty());
+    return true;
+}
+
+// Test case for exits that only open for a player holding their key
+bool testRoom_LockedExitNeedsKey() {
+    Room hall(1, "Hall");
+    Room vault(2, "Vault");
+    hall.addExit("north", &vault, 7);
+    hall.addExit("east", &vault);
+    Player player(&hall);
+
+    ASSERT_EQ(hall.getExitKey("north"), 7);
+    ASSERT_EQ(hall.getExitKey("east"), 0);
+    ASSERT_EQ(hall.getExitKey("up"), 0);
+    ASSERT_EQ(hall.getExit("north", player.getToolBits()), nullptr);
+    ASSERT_EQ(hall.getExit("east", player.getToolBits()), &vault);
+    ASSERT_EQ(hall.getExit("north"), &vault); // The plain lookup ignores locks
+
+    Tool key(7, "Brass Key", "A small brass key.", 1);
+    hall.addObject(&key);
+    player.takeTool(&key);
+    ASSERT_TRUE(player.hasTool(7));
+    ASSERT_TRUE(!player.hasTool(8));
+    ASSERT_TRUE(!player.hasTool(-1));
+    ASSERT_EQ(hall.getExit("north", player.getToolBits()), &vault);
+
+    player.dropTool(&key);
+    ASSERT_TRUE(!player.hasTool(7));
+    ASSERT_EQ(hall.getExit("north", player.getToolBits()), nullptr);
+    return true;
+}
+
+// Test case for slot map handles staying valid until their value is erased
+bool testSlotMap_StableHandles() {
+    SlotMap<std::string> map;
+    SlotHandle a = map.insert("a");
+    SlotHandle b = map.insert("b");
+    SlotHandle c = map.insert("c");
+    ASSERT_TRUE(map.erase(a)); // "c" moves into the gap
+    ASSERT_EQ(map.size(), 2);
+    ASSERT_EQ(*map.get(b), "b");
+    ASSERT_EQ(*map.get(c), "c");
+    ASSERT_TRUE(map.get(a) == nullptr);
+    ASSERT_TRUE(!map.erase(a));
+
+    SlotHandle d = map.insert("d"); // Reuses the slot "a" had
+    ASSERT_EQ(d.index, a.index);
+    ASSERT_TRUE(map.get(a) == nullptr); // The old handle is stale
+    ASSERT_EQ(*map.get(d), "d");
+    ASSERT_TRUE(map.get(SlotHandle()) == nullptr);
+    for (std::size_t i = 0; i < map.size(); ++i) {
+        ASSERT_EQ(map.get(map.handleAt(i)), &map.getValues()[i]);
+    }
+
+    // Rooms and inventories hand tools between them by handle
+    Room room("Workshop");
+    Tool hammer(1, "Hammer", "A hammer.", 1);
+    Tool saw(2, "Saw", "A saw.", 1);
+    SlotHandle in_room = room.addObject(&hammer);
+    room.addObject(&saw);
+    Player player(&room);
+    SlotHandle carried = player.takeTool(&hammer);
+    ASSERT_TRUE(room.getObject(in_room) == nullptr);
+    ASSERT_EQ(player.getTool(carried), &hammer);
+    ASSERT_EQ(room.getObjects().size(), 1);
+    room.removeObject(&hammer); // Not in the room: the handle is the inventory's
+    ASSERT_EQ(room.getObjects().size(), 1);
+    player.dropTool(&hammer);
+    ASSERT_TRUE(player.getTool(carried) == nullptr);
+    ASSERT_EQ(room.getObject(hammer.getSlot()), &hammer);
+    return true;
+}
+
+// Test case for characters moving each turn with rooms' occupants kept up to date
+bool testNpcSystem_TickMovesIncrementally() {
+    NpcBehaviour parsed;
+    ASSERT_TRUE(parseNpcBehaviour("follow", parsed));
+    ASSERT_TRUE(parsed == NpcBehaviour::Follow);
+    ASSERT_TRUE(parseNpcBehaviour("", parsed));
+    ASSERT_TRUE(parsed == NpcBehaviour::Idle);
+    ASSERT_TRUE(!parseNpcBehaviour("dance", parsed));
+
+    Room hall(1, "Hall");
+    Room garden(2, "Garden");
+    Room vault(3, "Vault");
+    hall.addExit("east", &garden);
+    garden.addExit("west", &hall);
+    garden.addExit("north", &vault, 7); // Locked: nobody may use it
+
+    Character statue(1, "Statue", "", 1, "");
+    Character dog(2, "Dog", "", 2, "");
+    dog.setBehaviour(NpcBehaviour::Follow);
+    Character cat(3, "Cat", "", 1, "");
+    cat.setBehaviour(NpcBehaviour::Flee);
+    hall.addCharacter(&statue);
+    garden.addCharacter(&dog);
+    hall.addCharacter(&cat);
+
+    NpcSystem npcs;
+    npcs.add(&statue, &hall);
+    npcs.add(&dog, &garden);
+    npcs.add(&cat, &hall);
+    ASSERT_EQ(npcs.size(), 3);
+    ASSERT_EQ(npcs.getMoverCount(), 2); // Idle characters are never visited
+
+    // The player is in the hall: the dog comes in as the cat goes out
+    const std::vector<NpcSystem::Move>& moves = npcs.tick(&hall);
+    ASSERT_EQ(moves.size(), 2);
+    ASSERT_EQ(npcs.getRoom(1), &hall);
+    ASSERT_EQ(npcs.getRoom(2), &garden);
+    ASSERT_EQ(hall.getCharacters().size(), 2);
+    ASSERT_EQ(garden.getCharacters().size(), 1);
+    ASSERT_EQ(garden.getCharacters()[0], &cat);
+    ASSERT_EQ(vault.getCharacters().size(), 0);
+    ASSERT_TRUE(npcs.tick(&hall).empty()); // Everyone is where they want to be
+
+    // Wanderers given the same seed take the same walk
+    auto walk = [](std::uint64_t seed) {
+        Room a(1, "A");
+        Room b(2, "B");
+        a.addExit("east", &b);
+        b.addExit("west", &a);
+        Character wanderer(1, "Wanderer", "", 1, "");
+        wanderer.setBehaviour(NpcBehaviour::Wander);
+        a.addCharacter(&wanderer);
+        NpcSystem system;
+        system.add(&wanderer, &a);
+        system.reseed(seed);
+        std::string path;
+        for (int turn = 0; turn < 64; ++turn) {
+            system.tick(nullptr);
+            path += system.getRoom(0) == &a ? 'a' : 'b';
+        }
+        return path;
+    };
+    std::string path = walk(42);
+    ASSERT_EQ(path, walk(42));
+    ASSERT_TRUE(path.find('a') != std::string::npos && path.find('b') != std::string::npos);
+    return true;
+}
+
+// Test case for region-parallel ticks giving the same world as a serial tick
+bool testNpcSystem_ParallelTickMatchesSerial() {
+    WorkStealingScheduler scheduler(4);
+    std::vector<std::atomic<int>> runs(1000);
+    scheduler.run(runs.size(), [&runs](std::size_t task) { ++runs[task]; });
+    for (const std::atomic<int>& count : runs) {
+        ASSERT_EQ(count.load(), 1);
+    }
+
+    WorldGenOptions options;
+    options.width = options.height = 100;
+    options.character_chance = 0.8; // Enough movers for the tick to go parallel
+    World serial_world = WorldGenerator::generate(options);
+    World parallel_world = WorldGenerator::generate(options);
+    auto addAll = [](World& world, NpcSystem& npcs) {
+        for (const auto& room : world.rooms) {
+            for (Character* character : room->getCharacters()) {
+                npcs.add(character, room.get());
+            }
+        }
+        npcs.reseed(7);
+    };
+    NpcSystem serial, parallel;
+    addAll(serial_world, serial);
+    addAll(parallel_world, parallel);
+    ASSERT_TRUE(parallel.getMoverCount() >= NpcSystem::MIN_PARALLEL_MOVERS);
+    std::size_t regions = parallel.partition(parallel_world.rooms, 256);
+    ASSERT_TRUE(regions >= 20);
+    ASSERT_EQ(parallel.getRegionCount(), regions);
+
+    for (int turn = 0; turn < 20; ++turn) {
+        Room* player_room = serial_world.rooms[turn * 37].get(); // The player and the followers cross regions
+        serial.tick(player_room);
+        parallel.tick(parallel_world.rooms[turn * 37].get(), &scheduler);
+    }
+    ASSERT_EQ(parallel.getMoverCount(), serial.getMoverCount());
+    for (std::size_t npc = 0; npc < serial.size(); ++npc) {
+        ASSERT_EQ(parallel.getRoom(npc)->getId(), serial.getRoom(npc)->getId());
+    }
+    for (std::size_t i = 0; i < serial_world.rooms.size(); ++i) {
+        ASSERT_EQ(parallel_world.rooms[i]->getCharacters().size(), serial_world.rooms[i]->getCharacters().size());
+    }
+    return true;
+}
+
+// Test case for the pieces of real-time mode: frame hand-over, command queue and step pacing
+bool testRealTime_HandOverAndPacing() {
+    TripleBuffer<int> frames;
+    ASSERT_TRUE(!frames.update()); // Nothing published yet
+    frames.getWriteBuffer() = 1;
+    frames.publish();
+    frames.getWriteBuffer() = 2;
+    frames.publish(); // Replaces 1, which was never read
+    ASSERT_TRUE(frames.update());
+    ASSERT_EQ(frames.getReadBuffer(), 2);
+    ASSERT_TRUE(!frames.update());
+    ASSERT_EQ(frames.getReadBuffer(), 2);
+
+    // A reader on another thread only ever sees newer frames
+    TripleBuffer<int> counter;
+    std::thread writer([&counter] {
+        for (int i = 1; i <= 100000; ++i) {
+            counter.getWriteBuffer() = i;
+            counter.publish();
+        }
+    });
+    int last = 0;
+    bool increasing = true;
+    while (last < 100000) {
+        if (counter.update()) {
+            increasing = increasing && counter.getReadBuffer() > last;
+            last = counter.getReadBuffer();
+        }
+    }
+    writer.join();
+    ASSERT_TRUE(increasing);
+
+    SpscQueue<std::string, 4> commands;
+    std::string line = "north";
+    ASSERT_TRUE(commands.tryPush(line));
+    line = "look";
+    ASSERT_TRUE(commands.tryPush(line));
+    line = "east";
+    ASSERT_TRUE(commands.tryPush(line));
+    line = "west";
+    ASSERT_TRUE(!commands.tryPush(line)); // Full; the line is kept
+    ASSERT_EQ(line, "west");
+    ASSERT_TRUE(commands.tryPop(line));
+    ASSERT_EQ(line, "north");
+
+    using namespace std::chrono_literals;
+    FixedStepClock::Clock::time_point start{};
+    FixedStepClock clock(50ms, start, 5);
+    ASSERT_EQ(clock.takeDueSteps(start + 49ms), 0);
+    ASSERT_EQ(clock.takeDueSteps(start + 120ms), 2); // Steps at 50 and 100 ms
+    ASSERT_TRUE(clock.getNextStepTime() == start + 150ms);
+    ASSERT_EQ(clock.takeDueSteps(start + 10s), 5); // A long stall is not replayed in full
+    ASSERT_EQ(clock.getDroppedSteps(), 198 - 5); // Steps at 150 ms to 10 s
+    ASSERT_TRUE(clock.getNextStepTime() == start + 10050ms); // Still on the 50 ms grid
+    ASSERT_EQ(clock.getStepCount(), 7);
+    return true;
+}
+
+// Test case for panels rebuilding only what their changed inputs affect
+bool testPanels_RebuildOnlyWhatChanged() {
+    Panel panel;
+    int builds = 0;
+    auto build = [&builds](std::vector<std::string>& lines) {
+        ++builds;
+        lines.push_back("line " + std::to_string(builds));
+    };
+    panel.refresh(build);
+    panel.refresh(build); // Clean: no strings built
+    ASSERT_EQ(builds, 1);
+    ASSERT_EQ(panel.getVersion(), 1);
+    panel.markDirty();
+    ASSERT_EQ(panel.refresh(build)[0], "line 2");
+    ASSERT_EQ(panel.getVersion(), 2);
+
+    Room hall(1, "Hall");
+    Room garden(2, "Garden");
+    hall.addExit("east", &garden);
+    garden.addExit("west", &hall);
+    SidePanel side;
+    const std::vector<std::string>& lines = side.update(0, &hall);
+    std::uint64_t version = side.getVersion();
+    ASSERT_TRUE(std::find(lines.begin(), lines.end(), "      [X]---[E]") != lines.end());
+    side.update(0, &hall);
+    ASSERT_EQ(side.getVersion(), version); // Nothing changed
+
+    std::vector<const char*> before;
+    for (const std::string& line : lines) {
+        before.push_back(line.data());
+    }
+    std::vector<std::string> old_lines = lines;
+    side.update(15, &hall);
+    ASSERT_TRUE(side.getVersion() != version);
+    std::size_t rebuilt = 0;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        rebuilt += (lines[i] != old_lines[i] || lines[i].data() != before[i]);
+    }
+    ASSERT_EQ(rebuilt, 1); // Only the score line
+    ASSERT_TRUE(std::find(lines.begin(), lines.end(), "Score: 15") != lines.end());
+
+    side.update(15, &garden);
+    ASSERT_TRUE(std::find(lines.begin(), lines.end(), "[W]---[X]") != lines.end());
+    ASSERT_TRUE(!side.isDirty());
+    ASSERT_TRUE(std::find(lines.begin(), lines.end(), "    'search <words>', 'memstats'") != lines.end());
+
+    // A new exit shows once the panel is marked dirty
+    Room cellar(3, "Cellar");
+    garden.addExit("south", &cellar);
+    version = side.getVersion();
+    side.markDirty();
+    side.update(15, &garden);
+    ASSERT_TRUE(!side.isDirty());
+    ASSERT_TRUE(side.getVersion() != version);
+    ASSERT_TRUE(std::find(lines.begin(), lines.end(), "       [S]") != lines.end());
+    ASSERT_TRUE(std::find(lines.begin(), lines.end(), "Score: 15") != lines.end());
+    return true;
+}
+
+// Test case for the analytics kernels and the reports built on them
+bool testAnalytics_KernelsAndReports() {
+    // Odd lengths exercise the tail after the last full vector
+    std::vector<std::int32_t> values;
+    std::vector<std::uint32_t> keys;
+    std::uint32_t state = 12345;
+    for (int i = 0; i < 1003; ++i) {
+        state = state * 1664525u + 1013904223u;
+        values.push_back(static_cast<std::int32_t>(state) / 16);
+        keys.push_back((state >> 8) % 50);
+    }
+    std::int64_t sum = 0;
+    for (std::int32_t value : values) {
+        sum += value;
+    }
+    ASSERT_EQ(AnalyticsKernels::sum(values.data(), values.size()), sum);
+    std::int32_t low = 0, high = 0;
+    AnalyticsKernels::minMax(values.data(), values.size(), low, high);
+    ASSERT_EQ(low, *std::min_element(values.begin(), values.end()));
+    ASSERT_EQ(high, *std::max_element(values.begin(), values.end()));
+    std::vector<std::int32_t> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    for (std::size_t rank : {std::size_t{0}, std::size_t{501}, values.size() - 1}) {
+        ASSERT_EQ(AnalyticsKernels::select(values.data(), values.size(), rank), sorted[rank]);
+    }
+
+    // Few groups take the vector path, many the scattered one
+    for (std::uint32_t groups : {3u, 50u}) {
+        std::vector<std::int64_t> sums(groups, 0), expected_sums(groups, 0);
+        std::vector<std::uint64_t> counts(groups, 0), expected_counts(groups, 0);
+        std::vector<std::uint32_t> group_keys;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            group_keys.push_back(keys[i] % groups);
+            expected_sums[keys[i] % groups] += values[i];
+            ++expected_counts[keys[i] % groups];
+        }
+        AnalyticsKernels::groupSum(group_keys.data(), values.data(), values.size(), groups, sums.data(), counts.data());
+        ASSERT_TRUE(sums == expected_sums);
+        ASSERT_TRUE(counts == expected_counts);
+    }
+    std::vector<std::uint32_t> table = {7, 8, 9};
+    std::vector<std::uint32_t> gathered(keys.size());
+    for (std::uint32_t& key : keys) {
+        key %= 3;
+    }
+    AnalyticsKernels::gather(table.data(), keys.data(), keys.size(), gathered.data());
+    ASSERT_EQ(gathered[1002], table[keys[1002]]);
+
+    // The sample sessions and scores from sql/
+    std::int64_t seconds = 0;
+    ASSERT_TRUE(AnalyticsStore::parseTimestamp("1970-01-02 00:00:01", seconds));
+    ASSERT_EQ(seconds, 86401);
+    ASSERT_TRUE(!AnalyticsStore::parseTimestamp("2023-02-29 00:00:00", seconds));
+    ASSERT_TRUE(!AnalyticsStore::parseTimestamp("2023-02-01 14:00", seconds));
+    AnalyticsStore store;
+    ASSERT_TRUE(store.addSession(101, "Chess", "2023-02-01 14:00:00", "2023-02-01 15:00:00"));
+    ASSERT_TRUE(store.addSession(102, "Checkers", "2023-02-02 16:00:00", "2023-02-02 16:30:00"));
+    ASSERT_TRUE(store.addSession(103, "Chess", "2023-02-03 18:00:00", "2023-02-03 19:30:00"));
+    int rows[][4] = {{1001, 1, 101, 10}, {1002, 2, 101, 5}, {1003, 2, 102, 20},
+                     {1004, 3, 102, 15}, {1005, 1, 103, 12}, {1006, 3, 103, 8}, {1007, 4, 999, 100}};
+    for (const auto& row : rows) {
+        store.addScore(row[0], row[1], row[2], row[3]);
+    }
+    ASSERT_EQ(store.getGameTypes().size(), 2);
+    ASSERT_EQ(store.totalScore().sum, 170);
+    std::vector<AnalyticsStore::GroupStats> by_type = store.scoreByGameType();
+    ASSERT_EQ(by_type[0].sum, 35); // Chess; session 999 is unknown and left out
+    ASSERT_EQ(by_type[0].count, 4);
+    ASSERT_EQ(by_type[1].average(), 17.5);
+    auto by_player = store.scoreByPlayer();
+    ASSERT_EQ(by_player.size(), 4);
+    ASSERT_EQ(by_player[1].first, 2);
+    ASSERT_EQ(by_player[1].second.sum, 25);
+    std::int32_t median = 0;
+    ASSERT_TRUE(store.scorePercentile(50, median));
+    ASSERT_EQ(median, 12);
+    ASSERT_TRUE(!store.scorePercentile(101, median));
+    ASSERT_TRUE(store.sessionDurations() == std::vector<std::int64_t>({3600, 1800, 5400}));
+    ASSERT_EQ(store.durationByGameType()[0].average(), 4500.0);
+    return true;
+}
+
+// Test case for the storage engine's durability, range scans and compaction, and the world store over it
+bool testStorage_RecoveryScansAndCompaction() {
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "quanta_pie_test_store";
+    std::filesystem::remove_all(directory);
+    StorageOptions options;
+    options.memtable_bytes = 2048; // Small tables and blocks, so a few hundred keys exercise every path
+    options.block_bytes = 128;
+    options.max_tables = 3;
+    options.sync_writes = false;
+    auto key = [](int i) {
+        char text[8];
+        std::snprintf(text, sizeof(text), "k%04d", i);
+        return std::string(text);
+    };
+    {
+        StorageEngine engine(options);
+        ASSERT_TRUE(engine.open(directory.string()));
+        for (int i = 0; i < 300; ++i) {
+            ASSERT_TRUE(engine.put(key(i), "v" + std::to_string(i)));
+        }
+        for (int i = 0; i < 300; i += 3) {
+            ASSERT_TRUE(engine.remove(key(i)));
+        }
+        ASSERT_TRUE(engine.put(key(7), "seven"));
+        ASSERT_TRUE(engine.getTableCount() <= options.max_tables); // Merged as they piled up
+    }
+    {
+        std::ofstream torn(directory / "wal.log", std::ios::binary | std::ios::app);
+        torn << "\x01\x02\x03"; // A write cut short by a crash
+    }
+
+    StorageEngine engine(options);
+    ASSERT_TRUE(StorageEngine::exists(directory.string()));
+    ASSERT_TRUE(engine.open(directory.string()));
+    std::string value;
+    ASSERT_TRUE(engine.get(key(7), value)); // Recovered from the log
+    ASSERT_EQ(value, "seven");
+    ASSERT_TRUE(!engine.get(key(9), value)); // Deleted
+    ASSERT_TRUE(engine.get(key(299), value));
+    ASSERT_EQ(value, "v299");
+    std::vector<std::string> keys;
+    engine.scan(key(10), key(20), [&keys](std::string_view k, std::string_view) {
+        keys.emplace_back(k);
+        return true;
+    });
+    ASSERT_TRUE(keys == std::vector<std::string>({key(10), key(11), key(13), key(14), key(16), key(17), key(19)}));
+    ASSERT_TRUE(engine.compact());
+    ASSERT_EQ(engine.getTableCount(), 1);
+    ASSERT_TRUE(engine.get(key(1), value));
+    ASSERT_TRUE(!engine.get(key(3), value));
+
+    // Composite keys order by column, negative numbers first
+    std::filesystem::path world_directory = directory / "world";
+    WorldStore store(options);
+    ASSERT_TRUE(store.open(world_directory.string()));
+    for (int x = -2; x <= 2; ++x) {
+        for (int y = -2; y <= 2; ++y) {
+            ASSERT_TRUE(store.put("terrain", {std::to_string(x), std::to_string(y), x == y ? "#" : "."}));
+        }
+    }
+    std::string tiles;
+    store.scanTerrain(-1, -1, 0, 1, [&tiles](int x, int y, char tile) {
+        tiles += std::to_string(x) + "," + std::to_string(y) + tile + " ";
+        return true;
+    });
+    ASSERT_EQ(tiles, "-1,-1# -1,0. -1,1. 0,-1. 0,0# 0,1. ");
+    ASSERT_TRUE(!store.put("terrain", {"north", "1", "."}));
+
+    std::string sql_path = (directory / "world.sql").string();
+    {
+        std::ofstream sql(sql_path);
+        sql << "INSERT INTO players (player_id, player_name, initial_room_id) VALUES (4, 'Dana', 2);\n"
+            << "INSERT INTO exits (from_room_id, to_room_id, direction) VALUES (1, 2, 'north'), (2, 1, 'south');\n";
+    }
+    ASSERT_TRUE(store.importSQL(sql_path));
+    WorldStore::Row row;
+    ASSERT_TRUE(store.get("players", {4}, row));
+    ASSERT_TRUE(row == WorldStore::Row({"4", "Dana", "", "2"}));
+    ASSERT_TRUE(store.get("exits", {2}, row)); // Numbered in order, having no exit_id
+    ASSERT_EQ(row[3], "south");
+    std::filesystem::remove_all(directory);
+    return true;
+}
+
+// Test case for TileMapView culling, scrolling and run-length drawing
+bool testTileMapView_ScrollsAndMatchesTerrain() {
+    Terrain terrain;
+    for (int y = 0; y < 40; ++y) {
+        for (int x = 0; x < 120; ++x) {
+            if ((x + y) % 17 != 0) { // Diagonal gaps between the runs
+                terrain.setTile(x, y, (y % 5 == 0 || x % 23 == 0) ? '#' : '.');
+            }
+        }
+    }
+    auto expected = [&terrain](int origin_x, int origin_y, int x, int y) {
+        std::vector<std::string> lines;
+        for (int row = 0; row < 7; ++row) {
+            std::string line;
+            for (int column = 0; column < 20; ++column) {
+                bool player = origin_x + column == x && origin_y + row == y;
+                line += player ? TileMapView::PLAYER_TILE : terrain.getTile(origin_x + column, origin_y + row);
+            }
+            lines.push_back(line);
+        }
+        return lines;
+    };
+
+    TileMapView view(terrain);
+    view.resize(20, 7);
+    ASSERT_TRUE(view.update(50, 20) == expected(40, 17, 50, 20));
+    ASSERT_EQ(view.getRowsDrawn(), 7);
+    ASSERT_TRUE(view.update(50, 21) == expected(40, 18, 50, 21)); // One row scrolls in
+    ASSERT_EQ(view.getRowsDrawn(), 1);
+    ASSERT_TRUE(view.update(49, 21) == expected(39, 18, 49, 21)); // One column, and no whole rows
+    ASSERT_EQ(view.getRowsDrawn(), 0);
+    ASSERT_TRUE(view.update(52, 19) == expected(42, 16, 52, 19)); // Diagonally, several at once
+    ASSERT_EQ(view.getRowsDrawn(), 2);
+    std::uint64_t version = view.getVersion();
+    view.update(52, 19);
+    ASSERT_EQ(view.getVersion(), version); // Nothing moved, nothing redrawn
+    ASSERT_TRUE(view.update(1, 1) == expected(0, 0, 1, 1)); // Held at the map's edges
+    ASSERT_TRUE(view.update(119, 39) == expected(100, 33, 119, 39));
+    ASSERT_TRUE(view.update(118, 39) == expected(100, 33, 118, 39)); // The marker moves, the view does not
+    ASSERT_EQ(view.getRowsDrawn(), 0);
+    ASSERT_TRUE(!view.isDirty());
+    view.markDirty();
+    ASSERT_TRUE(view.update(118, 39) == expected(100, 33, 118, 39));
+    ASSERT_EQ(view.getRowsDrawn(), 7); // Dirty: redrawn in full
+    return true;
+}
+
+// Test case for FieldOfView line of sight, its symmetry and the explored map
+bool testFieldOfView_ShadowsSymmetryAndExploration() {
+    Terrain terrain;
+    std::uint64_t state = 42;
+    for (int y = 0; y < 40; ++y) {
+        for (int x = 0; x < 100; ++x) {
+            bool edge = x == 0 || y == 0 || x == 99 || y == 39;
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            bool rubble = x >= 50 && (state >> 33) % 6 == 0; // Scattered walls in the east half
+            terrain.setTile(x, y, edge || rubble ? Terrain::WALL_TILE : Terrain::FLOOR_TILE);
+        }
+    }
+    terrain.setTile(20, 10, Terrain::WALL_TILE); // A pillar in the open west half
+
+    FieldOfView sight(12);
+    ASSERT_TRUE(sight.update(terrain, 16, 10));
+    ASSERT_TRUE(sight.isVisible(16, 10));
+    ASSERT_TRUE(sight.isVisible(20, 10));  // The pillar itself
+    ASSERT_TRUE(!sight.isVisible(22, 10)); // In its shadow
+    ASSERT_TRUE(sight.isVisible(22, 8));
+    ASSERT_TRUE(sight.isVisible(16, 0));   // The outer wall
+    ASSERT_TRUE(!sight.isVisible(16, 23)); // Out of range
+    ASSERT_EQ(sight.getNewlyExploredTop(), 0);
+    ASSERT_EQ(sight.getNewlyExploredBottom(), 22);
+    ASSERT_TRUE(!sight.update(terrain, 16, 10)); // Nothing changed, nothing recomputed
+
+    // Moving keeps what was seen explored, while sight follows the player
+    ASSERT_TRUE(sight.update(terrain, 16, 20));
+    ASSERT_TRUE(sight.isExplored(16, 1) && !sight.isVisible(16, 1));
+    ASSERT_TRUE(sight.isExplored(22, 10)); // Out of the pillar's shadow from here
+    ASSERT_TRUE(sight.getNewlyExploredTop() < 23);
+    ASSERT_EQ(sight.getNewlyExploredBottom(), 32);
+    ASSERT_TRUE(!sight.isExplored(60, 38));
+    terrain.setTile(16, 22, Terrain::WALL_TILE);
+    ASSERT_TRUE(sight.update(terrain, 16, 20)); // The terrain changed
+    ASSERT_TRUE(!sight.isVisible(16, 24));
+
+    // Among the rubble, a tile is seen from another exactly when it sees it back
+    std::vector<FieldOfView> views(30, FieldOfView(10));
+    for (int i = 0; i < 30; ++i) {
+        views[i].update(terrain, 55 + (i * 7) % 30, 5 + (i * 11) % 30);
+    }
+    for (int i = 0; i < 30; ++i) {
+        for (int j = 0; j < 30; ++j) {
+            int xi = 55 + (i * 7) % 30, yi = 5 + (i * 11) % 30, xj = 55 + (j * 7) % 30, yj = 5 + (j * 11) % 30;
+            if (terrain.getTile(xi, yi) == Terrain::FLOOR_TILE && terrain.getTile(xj, yj) == Terrain::FLOOR_TILE) {
+                ASSERT_EQ(views[i].isVisible(xj, yj), views[j].isVisible(xi, yi));
+            }
+        }
+    }
+
+    // The map view shows only explored tiles
+    TileMapView view(terrain);
+    view.resize(40, 3);
+    view.setFog(&sight.getExplored());
+    std::string seen = std::string(4, ' ') + std::string(25, '.') + std::string(11, ' ');
+    std::string standing = seen;
+    standing[16] = TileMapView::PLAYER_TILE;
+    ASSERT_TRUE(view.update(16, 20) == std::vector<std::string>({seen, standing, seen}));
+    return true;
+}
+
+// Test case for sessions over a shared world each seeing only their own changes
+bool testSharedWorld_OverlaysKeepSessionsApart() {
+    World world;
+    world.rooms.push_back(std::make_unique<Room>(1, "Hall"));
+    world.rooms.push_back(std::make_unique<Room>(2, "Vault"));
+    Room* hall = world.rooms[0].get();
+    Room* vault = world.rooms[1].get();
+    hall->addExit("north", vault, 7);
+    vault->addExit("south", hall);
+    world.tools.push_back(std::make_unique<Tool>(7, "Brass Key", "A small brass key.", 1));
+    world.characters.push_back(std::make_unique<Character>(1, "Cat", "A cat.", 1, "Meow."));
+    hall->addCharacter(world.characters[0].get());
+    world.players.push_back(std::make_unique<Player>(1, "Tester", "today", nullptr));
+    auto shared = std::make_shared<const SharedWorld>(std::move(world));
+    Tool* key = shared->getTools()[0].get();
+    Character* cat = shared->getCharacters()[0].get();
+    ASSERT_EQ(shared->getPlayer().getCurrentRoom(), hall);
+    ASSERT_EQ(shared->findRoom(2), vault);
+    ASSERT_EQ(hall->getObjects().size(), 1); // Tools start in their rooms
+    ASSERT_TRUE(hall->getChallenge() != nullptr);
+    ASSERT_EQ(hall->getChallenge()->getChoices()[0].score_change, 10);
+
+    // Taking and dropping change only the taker's view of the rooms
+    WorldOverlay mine, theirs;
+    Player player(shared->getPlayer());
+    player.setWorldOverlay(&mine);
+    player.takeTool(key);
+    ASSERT_TRUE(player.hasTool(7));
+    ASSERT_EQ(mine.getObjects(*hall).size(), 0);
+    ASSERT_EQ(theirs.getObjects(*hall).size(), 1);
+    ASSERT_EQ(hall->getObjects().size(), 1);
+    ASSERT_EQ(mine.getChangedRoomCount(), 1);
+    ASSERT_EQ(theirs.getChangedRoomCount(), 0);
+
+    // An exit opened with its key stays open for that session alone
+    ASSERT_EQ(mine.getExit(*hall, "north", player.getToolBits()), vault);
+    mine.unlockExit(*hall, "north");
+    player.setCurrentRoom(vault);
+    player.dropTool(key);
+    ASSERT_TRUE(!player.hasTool(7));
+    ASSERT_EQ(mine.getObjects(*vault).size(), 1);
+    ASSERT_EQ(vault->getObjects().size(), 0);
+    ASSERT_EQ(mine.getExit(*hall, "north", player.getToolBits()), vault);
+    ASSERT_EQ(theirs.getExit(*hall, "north", player.getToolBits()), nullptr);
+
+    // Characters move, and challenges are resolved, per session
+    mine.moveCharacter(cat, *hall, *vault);
+    ASSERT_EQ(mine.getCharacters(*hall).size(), 0);
+    ASSERT_EQ(mine.getCharacters(*vault).size(), 1);
+    ASSERT_EQ(theirs.getCharacters(*hall).size(), 1);
+    ASSERT_EQ(hall->getCharacters().size(), 1);
+    mine.resolveChallenge(*hall);
+    ASSERT_TRUE(mine.getChallenge(*hall) == nullptr);
+    ASSERT_TRUE(theirs.getChallenge(*hall) == hall->getChallenge());
+    ASSERT_TRUE(mine.getBytes() > theirs.getBytes());
+
+    // Rooms holding what they started with are read from the shared world again
+    ASSERT_EQ(mine.getChangedRoomCount(), 2);
+    player.takeTool(key);
+    player.setCurrentRoom(hall);
+    player.dropTool(key);
+    mine.moveCharacter(cat, *vault, *hall);
+    ASSERT_EQ(mine.getChangedRoomCount(), 0);
+    ASSERT_EQ(&mine.getObjects(*hall), &hall->getObjects());
+    return true;
+}
+
+// Test case for changing a shared world's exits while other threads read them
+bool testSharedWorld_ExitsChangeUnderReaders() {
+    World world;
+    for (int id = 1; id <= 3; ++id) {
+        world.rooms.push_back(std::make_unique<Room>(id, "Room " + std::to_string(id)));
+    }
+    Room* hall = world.rooms[0].get();
+    Room* east = world.rooms[1].get();
+    Room* west = world.rooms[2].get();
+    hall->addExit("east", east);
+    world.players.push_back(std::make_unique<Player>(1, "Tester", "today", nullptr));
+    SharedWorld shared(std::move(world));
+    ASSERT_TRUE(hall->isShared());
+    ASSERT_EQ(shared.getVersion(), 0);
+
+    // A reader keeps the version it read until its section closes
+    {
+        ReadSection reading;
+        const std::map<std::string, Room*>& before = hall->getAllExits();
+        ASSERT_TRUE(shared.setExit(1, "east", 3, 7));
+        ASSERT_EQ(before.at("east"), east);
+        ASSERT_EQ(hall->getExit("east"), west);
+        ASSERT_EQ(hall->getExitKey("east"), 7);
+        ASSERT_TRUE(Epoch::getPendingCount() > 0);
+    }
+    ASSERT_TRUE(Epoch::synchronize());
+    ASSERT_EQ(Epoch::getPendingCount(), 0);
+    ASSERT_EQ(shared.getVersion(), 1);
+    ASSERT_TRUE(!shared.setExit(1, "up", 99));
+    ASSERT_TRUE(shared.removeExit(1, "east"));
+    ASSERT_TRUE(!shared.removeExit(1, "east"));
+    ASSERT_EQ(hall->getExit("east"), nullptr);
+
+    // Readers on other threads see an exit and its key from the same version,
+    // and what they read stays as it was until their section closes
+    std::atomic<bool> stop{false};
+    std::atomic<bool> consistent{true};
+    DynamicBitset no_keys;
+    no_keys.set(0);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                ReadSection reading;
+                if (hall->getExit("east", no_keys) == west) { // West is always locked
+                    consistent = false;
+                }
+                const std::map<std::string, Room*>& exits = hall->getAllExits();
+                Room* first = exits.empty() ? nullptr : exits.begin()->second;
+                for (int check = 0; check < 10; ++check) {
+                    if ((exits.empty() ? nullptr : exits.begin()->second) != first || (first && first != east && first != west)) {
+                        consistent = false;
+                    }
+                }
+            }
+        });
+    }
+    for (int i = 0; i < 2000; ++i) {
+        shared.setExit(1, "east", i % 2 ? 3 : 2, i % 2 ? 7 : 0);
+    }
+    stop = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    ASSERT_TRUE(consistent.load());
+    ASSERT_TRUE(Epoch::synchronize());
+    ASSERT_EQ(Epoch::getPendingCount(), 0);
+    return true;
+}
+
+// Test case for the background log
+bool testLog_WritesStructuredRecords() {
+    std::string path = (std::filesystem::temp_directory_path() / "quanta_pie_test.log").string();
+    std::filesystem::remove(path);
+    Log::info("Not logged before the log is open");
+    ASSERT_TRUE(Log::open(path, LogLevel::Info));
+    Log::debug("Below the level");
+    Log::info("Rooms loaded", {{"count", 3}, {"source", "sql"}});
+    std::thread other([] {
+        for (int i = 0; i < 100; ++i) {
+            Log::warning("From another thread", {{"i", i}});
+        }
+    });
+    other.join();
+    Log::error("Quoted", {{"text", std::string("say \"hi\"")}});
+    Log::close();
+    Log::error("Not logged after the log is closed");
+
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 102);
+    ASSERT_TRUE(lines[0].find(" INFO  Rooms loaded count=3 source=\"sql\"") != std::string::npos);
+    ASSERT_TRUE(lines[1].find(" WARN  From another thread i=0") != std::string::npos);
+    ASSERT_TRUE(lines[100].find("i=99") != std::string::npos);
+    ASSERT_TRUE(lines[101].find(" ERROR Quoted text=\"say \\\"hi\\\"\"") != std::string::npos);
+    ASSERT_EQ(Log::getDroppedCount(), 0);
+    std::filesystem::remove(path);
+    return true;
+}
+
+// Test case for the metrics registry and its Unix socket server
+bool testMetrics_PrometheusOverUnixSocket() {
+    Counter requests("test_requests_total", "Requests handled");
+    Gauge open_files("test_open_files", "Files open");
+    Histogram latency("test_latency_seconds", "Request latency", "", 1e-9);
+
+    // Threads count on different shards; the total is the same
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) {
+                requests.add();
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(requests.get(), 4000);
+    open_files.add(3);
+    open_files.add(-1);
+    ASSERT_EQ(open_files.get(), 2);
+
+    for (std::uint64_t value = 1; value <= 100000; ++value) {
+        latency.record(value);
+    }
+    ASSERT_EQ(latency.getCount(), 100000);
+    std::uint64_t median = latency.getQuantile(0.5);
+    std::uint64_t tail = latency.getQuantile(0.99);
+    ASSERT_TRUE(median > 48500 && median < 51500); // Within the buckets' 3%
+    ASSERT_TRUE(tail > 96000 && tail < 102000);
+    ASSERT_EQ(Histogram::bucketValue(Histogram::bucketOf(17)), 17); // Small values are exact
+
+    std::string exported = Metrics::writePrometheus();
+    ASSERT_TRUE(exported.find("# HELP test_requests_total Requests handled\n# TYPE test_requests_total counter\ntest_requests_total 4000\n") != std::string::npos);
+    ASSERT_TRUE(exported.find("test_open_files 2\n") != std::string::npos);
+    ASSERT_TRUE(exported.find("# TYPE test_latency_seconds summary\n") != std::string::npos);
+    ASSERT_TRUE(exported.find("test_latency_seconds_count 100000\n") != std::string::npos);
+
+#ifndef _WIN32
+    std::string path = (std::filesystem::temp_directory_path() / "quanta_pie_test_metrics.sock").string();
+    MetricsServer server;
+    ASSERT_TRUE(server.start(path));
+    int client = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+    ASSERT_EQ(connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+    std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+    ASSERT_EQ(send(client, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    std::string response;
+    char buffer[4096];
+    for (ssize_t received; (received = recv(client, buffer, sizeof(buffer), 0)) > 0;) {
+        response.append(buffer, static_cast<std::size_t>(received));
+    }
+    close(client);
+    ASSERT_TRUE(response.rfind("HTTP/1.0 200 OK\r\n", 0) == 0);
+    ASSERT_TRUE(response.find("\r\n\r\n# HELP ") != std::string::npos);
+    ASSERT_TRUE(response.find("test_requests_total 4000\n") != std::string::npos);
+    ASSERT_EQ(server.getScrapeCount(), 1);
+    server.stop();
+    ASSERT_TRUE(!std::filesystem::exists(path));
+#endif
+
+    // Metrics leave the registry when destroyed
+    {
+        Counter temporary("test_temporary_total", "Gone at the end of the block");
+        ASSERT_TRUE(Metrics::writePrometheus().find("test_temporary_total") != std::string::npos);
+    }
+    ASSERT_TRUE(Metrics::writePrometheus().find("test_temporary_total") == std::string::npos);
+    return true;
+}
+
 // Function to register all unit tests with the runner
 void registerUnitTests(TestRunner& runner) {
     runner.addTest("testRoom_AddAndGetExit", testRoom_AddAndGetExit);
@@ -182,4 +1486,31 @@ void registerUnitTests(TestRunner& runner) {
     runner.addTest("testScore_Creation", testScore_Creation);
     runner.addTest("testTool_Creation", testTool_Creation);
     runner.addTest("testRoomObject_Creation", testRoomObject_Creation);
+    runner.addTest("testSQLParser_MultiRowInsert", testSQLParser_MultiRowInsert);
+    runner.addTest("testSQLParser_ValuesAndErrors", testSQLParser_ValuesAndErrors);
+    runner.addTest("testTerrain_SetAndGetTile", testTerrain_SetAndGetTile);
+    runner.addTest("testLineEditor_EditAndHistory", testLineEditor_EditAndHistory);
+    runner.addTest("testDialogueExecutor_ChoiceAndTurns", testDialogueExecutor_ChoiceAndTurns);
+    runner.addTest("testDialogueExecutor_ManySuspended", testDialogueExecutor_ManySuspended);
+    runner.addTest("testInputRecording_RoundTrip", testInputRecording_RoundTrip);
+    runner.addTest("testSaveFile_SnapshotAndDeltas", testSaveFile_SnapshotAndDeltas);
+    runner.addTest("testWorldGenerator_DeterministicAndConnected", testWorldGenerator_DeterministicAndConnected);
+    runner.addTest("testMemoryStats_ScopesChargeTheirSubsystem", testMemoryStats_ScopesChargeTheirSubsystem);
+    runner.addTest("testTextLayout_WrapAndCache", testTextLayout_WrapAndCache);
+    runner.addTest("testTextStore_CompressAndDecode", testTextStore_CompressAndDecode);
+    runner.addTest("testSearchIndex_BuildAndRank", testSearchIndex_BuildAndRank);
+    runner.addTest("testRoom_LockedExitNeedsKey", testRoom_LockedExitNeedsKey);
+    runner.addTest("testSlotMap_StableHandles", testSlotMap_StableHandles);
+    runner.addTest("testNpcSystem_TickMovesIncrementally", testNpcSystem_TickMovesIncrementally);
+    runner.addTest("testNpcSystem_ParallelTickMatchesSerial", testNpcSystem_ParallelTickMatchesSerial);
+    runner.addTest("testRealTime_HandOverAndPacing", testRealTime_HandOverAndPacing);
+    runner.addTest("testPanels_RebuildOnlyWhatChanged", testPanels_RebuildOnlyWhatChanged);
+    runner.addTest("testAnalytics_KernelsAndReports", testAnalytics_KernelsAndReports);
+    runner.addTest("testStorage_RecoveryScansAndCompaction", testStorage_RecoveryScansAndCompaction);
+    runner.addTest("testTileMapView_ScrollsAndMatchesTerrain", testTileMapView_ScrollsAndMatchesTerrain);
+    runner.addTest("testFieldOfView_ShadowsSymmetryAndExploration", testFieldOfView_ShadowsSymmetryAndExploration);
+    runner.addTest("testSharedWorld_OverlaysKeepSessionsApart", testSharedWorld_OverlaysKeepSessionsApart);
+    runner.addTest("testSharedWorld_ExitsChangeUnderReaders", testSharedWorld_ExitsChangeUnderReaders);
+    runner.addTest("testLog_WritesStructuredRecords", testLog_WritesStructuredRecords);
+    runner.addTest("testMetrics_PrometheusOverUnixSocket", testMetrics_PrometheusOverUnixSocket);
 }